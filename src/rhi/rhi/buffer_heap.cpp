@@ -0,0 +1,229 @@
+#include "rhi/buffer_heap.hpp"
+
+#include "rhi/graphics_device.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace rhi
+{
+namespace
+{
+uint64_t align_buffer_heap_offset(uint64_t offset, uint64_t alignment) noexcept
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+}
+
+std::expected<std::unique_ptr<Buffer_Heap>, Result> Buffer_Heap::create(
+    Graphics_Device* graphics_device, const Buffer_Heap_Create_Info& create_info) noexcept
+{
+    if (!graphics_device || create_info.block_size < BUFFER_VIEW_OFFSET_ALIGNMENT)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    auto result = std::unique_ptr<Buffer_Heap>(new Buffer_Heap());
+    result->m_graphics_device = graphics_device;
+    result->m_create_info = create_info;
+    return result;
+}
+
+Buffer_Heap::Buffer_Heap() noexcept
+    : m_graphics_device(nullptr)
+    , m_create_info()
+    , m_mutex()
+    , m_blocks()
+    , m_deferred_frees()
+    , m_allocation_count(0)
+    , m_allocated_size(0)
+{}
+
+Buffer_Heap::~Buffer_Heap() noexcept
+{
+    for (auto& block : m_blocks)
+    {
+        m_graphics_device->destroy_buffer(block.buffer);
+    }
+}
+
+std::expected<Buffer_View*, Result> Buffer_Heap::allocate(uint64_t size, uint64_t alignment) noexcept
+{
+    if (size == 0 || alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+    // Ranges are kept aligned, so padding for larger alignments is always a valid free range.
+    alignment = std::max(alignment, BUFFER_VIEW_OFFSET_ALIGNMENT);
+    auto aligned_size = align_buffer_heap_offset(size, BUFFER_VIEW_OFFSET_ALIGNMENT);
+    if (aligned_size > m_create_info.block_size)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    process_deferred_frees();
+
+    Block* block = nullptr;
+    std::optional<uint64_t> offset;
+    for (auto& candidate : m_blocks)
+    {
+        offset = allocate_range(candidate, aligned_size, alignment);
+        if (offset)
+        {
+            block = &candidate;
+            break;
+        }
+    }
+    if (!block)
+    {
+        auto buffer = m_graphics_device->create_buffer({
+            .size = m_create_info.block_size,
+            .heap = m_create_info.heap,
+            .acceleration_structure_memory = false
+        });
+        if (!buffer) return std::unexpected(buffer.error());
+
+        block = &m_blocks.emplace_back();
+        block->buffer = *buffer;
+        insert_free_range(
+            *block, 0, m_create_info.block_size & ~(BUFFER_VIEW_OFFSET_ALIGNMENT - 1));
+        offset = allocate_range(*block, aligned_size, alignment);
+    }
+
+    Buffer_View_Create_Info create_info = {
+        .size = size,
+        .offset = *offset
+    };
+    Buffer_View* buffer_view = nullptr;
+    if (!block->free_buffer_views.empty())
+    {
+        buffer_view = block->free_buffer_views.back();
+        auto result = m_graphics_device->update_buffer_view(buffer_view, create_info);
+        if (result != Result::Success)
+        {
+            insert_free_range(*block, *offset, aligned_size);
+            return std::unexpected(result);
+        }
+        block->free_buffer_views.pop_back();
+    }
+    else
+    {
+        auto created_buffer_view = m_graphics_device->create_buffer_view(block->buffer, create_info);
+        if (!created_buffer_view)
+        {
+            insert_free_range(*block, *offset, aligned_size);
+            return std::unexpected(created_buffer_view.error());
+        }
+        buffer_view = *created_buffer_view;
+    }
+
+    m_allocation_count += 1;
+    m_allocated_size += aligned_size;
+    return buffer_view;
+}
+
+void Buffer_Heap::free(Buffer_View* buffer_view) noexcept
+{
+    if (!buffer_view) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    free_range(buffer_view);
+}
+
+void Buffer_Heap::free_deferred(Buffer_View* buffer_view, Fence* fence, uint64_t value) noexcept
+{
+    if (!buffer_view) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_deferred_frees.push_back({
+        .buffer_view = buffer_view,
+        .fence = fence,
+        .value = value
+    });
+}
+
+Buffer_Heap_Statistics Buffer_Heap::get_statistics() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    return {
+        .block_count = m_blocks.size(),
+        .allocation_count = m_allocation_count,
+        .allocated_size = m_allocated_size
+    };
+}
+
+std::optional<uint64_t> Buffer_Heap::allocate_range(Block& block, uint64_t size, uint64_t alignment) noexcept
+{
+    // Best fit, the smallest free range that still holds the allocation after aligning its offset.
+    for (auto it = block.free_ranges_by_size.lower_bound({ size, 0 }); it != block.free_ranges_by_size.end(); ++it)
+    {
+        auto [range_size, range_offset] = *it;
+        auto offset = align_buffer_heap_offset(range_offset, alignment);
+        auto padding = offset - range_offset;
+        if (padding + size > range_size) continue;
+
+        block.free_ranges_by_size.erase(it);
+        block.free_ranges.erase(range_offset);
+        if (padding > 0)
+        {
+            block.free_ranges.emplace(range_offset, padding);
+            block.free_ranges_by_size.emplace(padding, range_offset);
+        }
+        auto remainder = range_size - padding - size;
+        if (remainder > 0)
+        {
+            block.free_ranges.emplace(offset + size, remainder);
+            block.free_ranges_by_size.emplace(remainder, offset + size);
+        }
+        return offset;
+    }
+    return std::nullopt;
+}
+
+void Buffer_Heap::insert_free_range(Block& block, uint64_t offset, uint64_t size) noexcept
+{
+    auto next = block.free_ranges.lower_bound(offset);
+    if (next != block.free_ranges.end() && offset + size == next->first)
+    {
+        size += next->second;
+        block.free_ranges_by_size.erase({ next->second, next->first });
+        next = block.free_ranges.erase(next);
+    }
+    if (next != block.free_ranges.begin())
+    {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset)
+        {
+            offset = previous->first;
+            size += previous->second;
+            block.free_ranges_by_size.erase({ previous->second, previous->first });
+            block.free_ranges.erase(previous);
+        }
+    }
+    block.free_ranges.emplace(offset, size);
+    block.free_ranges_by_size.emplace(size, offset);
+}
+
+void Buffer_Heap::free_range(Buffer_View* buffer_view) noexcept
+{
+    auto block = std::ranges::find(m_blocks, buffer_view->buffer, &Block::buffer);
+    if (block == m_blocks.end()) return;
+
+    auto aligned_size = align_buffer_heap_offset(buffer_view->size, BUFFER_VIEW_OFFSET_ALIGNMENT);
+    insert_free_range(*block, buffer_view->offset, aligned_size);
+    block->free_buffer_views.push_back(buffer_view);
+    m_allocation_count -= 1;
+    m_allocated_size -= aligned_size;
+}
+
+void Buffer_Heap::process_deferred_frees() noexcept
+{
+    std::erase_if(m_deferred_frees, [this](const Deferred_Free& deferred_free)
+        {
+            if (deferred_free.fence->get_status(deferred_free.value) != Result::Success) return false;
+            free_range(deferred_free.buffer_view);
+            return true;
+        });
+}
+}
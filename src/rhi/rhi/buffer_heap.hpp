@@ -0,0 +1,93 @@
+#pragma once
+
+#include "rhi/resource.hpp"
+#include "rhi/result.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace rhi
+{
+class Graphics_Device;
+struct Fence;
+
+struct Buffer_Heap_Create_Info
+{
+    uint64_t block_size; // Size of every backing buffer, larger allocations are rejected.
+    Memory_Heap_Type heap;
+};
+
+struct Buffer_Heap_Statistics
+{
+    uint64_t block_count;
+    uint64_t allocation_count;
+    uint64_t allocated_size;
+};
+
+// Sub-allocates small buffers such as per-mesh constants or indices from a few large backing buffers,
+// instead of creating a dedicated buffer for each of them.
+// Every allocation is a `Buffer_View` with its own `bindless_index`, its `buffer` and `offset` locate it in the backing buffer.
+// All functions are thread safe.
+class Buffer_Heap
+{
+public:
+    [[nodiscard]] static std::expected<std::unique_ptr<Buffer_Heap>, Result> create(
+        Graphics_Device* graphics_device, const Buffer_Heap_Create_Info& create_info) noexcept;
+    // Destroys the backing buffers and with them every allocation. They must no longer be in use by the GPU.
+    ~Buffer_Heap() noexcept;
+    Buffer_Heap(const Buffer_Heap& other) = delete;
+    Buffer_Heap(Buffer_Heap&& other) = delete;
+    Buffer_Heap& operator=(const Buffer_Heap& other) = delete;
+    Buffer_Heap& operator=(Buffer_Heap&& other) = delete;
+
+    // `alignment` must be a power of two, offsets are at least aligned to `BUFFER_VIEW_OFFSET_ALIGNMENT`.
+    [[nodiscard]] std::expected<Buffer_View*, Result> allocate(
+        uint64_t size, uint64_t alignment = BUFFER_VIEW_OFFSET_ALIGNMENT) noexcept;
+    // The allocation must no longer be in use by the GPU. Its view and `bindless_index` are recycled.
+    void free(Buffer_View* buffer_view) noexcept;
+    // The allocation is freed once `fence` has reached `value`, the fence must outlive the heap or that point.
+    void free_deferred(Buffer_View* buffer_view, Fence* fence, uint64_t value) noexcept;
+
+    [[nodiscard]] Buffer_Heap_Statistics get_statistics() noexcept;
+
+private:
+    // Free ranges are kept both by offset, to merge neighbours, and by size, for best fit allocation.
+    struct Block
+    {
+        Buffer* buffer;
+        std::map<uint64_t, uint64_t> free_ranges;
+        std::set<std::pair<uint64_t, uint64_t>> free_ranges_by_size;
+        std::vector<Buffer_View*> free_buffer_views;
+    };
+
+    Buffer_Heap() noexcept;
+
+    [[nodiscard]] std::optional<uint64_t> allocate_range(Block& block, uint64_t size, uint64_t alignment) noexcept;
+    void insert_free_range(Block& block, uint64_t offset, uint64_t size) noexcept;
+    void free_range(Buffer_View* buffer_view) noexcept;
+    void process_deferred_frees() noexcept;
+
+private:
+    struct Deferred_Free
+    {
+        Buffer_View* buffer_view;
+        Fence* fence;
+        uint64_t value;
+    };
+
+    Graphics_Device* m_graphics_device;
+    Buffer_Heap_Create_Info m_create_info;
+    std::mutex m_mutex;
+    std::vector<Block> m_blocks;
+    std::vector<Deferred_Free> m_deferred_frees;
+    uint64_t m_allocation_count;
+    uint64_t m_allocated_size;
+};
+}
@@ -0,0 +1,195 @@
+#include "rhi/command_list.hpp"
+
+#include "rhi/common/access_state.hpp"
+
+#include <algorithm>
+#include <limits>
+
+namespace rhi
+{
+namespace
+{
+// A barrier between identical read-only accesses is only redundant if it adds no stage,
+// otherwise it chains earlier writes to the new stages.
+bool is_redundant_barrier(Barrier_Pipeline_Stage stage_before, Barrier_Pipeline_Stage stage_after,
+    Barrier_Access access_before, Barrier_Access access_after) noexcept
+{
+    return access_before == access_after
+        && access_before != Barrier_Access::None
+        && !is_write_access(access_before)
+        && (stage_after & ~stage_before) == Barrier_Pipeline_Stage::None;
+}
+
+// A count of zero selects every remaining element.
+bool barrier_ranges_overlap(uint32_t first_a, uint32_t count_a, uint32_t first_b, uint32_t count_b) noexcept
+{
+    auto end_a = count_a > 0 ? uint64_t(first_a) + count_a : std::numeric_limits<uint64_t>::max();
+    auto end_b = count_b > 0 ? uint64_t(first_b) + count_b : std::numeric_limits<uint64_t>::max();
+    return first_a < end_b && first_b < end_a;
+}
+
+bool image_barrier_subresource_ranges_overlap(
+    const Image_Barrier_Subresource_Range& a, const Image_Barrier_Subresource_Range& b) noexcept
+{
+    return barrier_ranges_overlap(a.first_mip_level, a.mip_count, b.first_mip_level, b.mip_count)
+        && barrier_ranges_overlap(a.first_array_index, a.array_size, b.first_array_index, b.array_size)
+        && barrier_ranges_overlap(a.first_plane, a.plane_count, b.first_plane, b.plane_count);
+}
+
+bool image_barrier_subresource_ranges_equal(
+    const Image_Barrier_Subresource_Range& a, const Image_Barrier_Subresource_Range& b) noexcept
+{
+    return a.first_mip_level == b.first_mip_level
+        && a.mip_count == b.mip_count
+        && a.first_array_index == b.first_array_index
+        && a.array_size == b.array_size
+        && a.first_plane == b.first_plane
+        && a.plane_count == b.plane_count;
+}
+}
+
+void Command_List::barrier(const Barrier_Info& barrier_info) noexcept
+{
+    if (!m_batch_barriers)
+    {
+        record_barrier(barrier_info);
+        return;
+    }
+
+    for (const auto& buffer_barrier : barrier_info.buffer_barriers)
+    {
+        queue_buffer_barrier(buffer_barrier);
+    }
+    for (const auto& image_barrier : barrier_info.image_barriers)
+    {
+        queue_image_barrier(image_barrier);
+    }
+    for (const auto& memory_barrier : barrier_info.memory_barriers)
+    {
+        queue_memory_barrier(memory_barrier);
+    }
+}
+
+void Command_List::set_barrier_batching(bool enabled) noexcept
+{
+    if (!enabled)
+    {
+        flush_barriers();
+    }
+    m_batch_barriers = enabled;
+}
+
+void Command_List::reset_barrier_batching() noexcept
+{
+    m_batch_barriers = false;
+    m_queued_buffer_barriers.clear();
+    m_queued_image_barriers.clear();
+    m_queued_memory_barriers.clear();
+}
+
+void Command_List::queue_buffer_barrier(const Buffer_Barrier_Info& barrier_info) noexcept
+{
+    if (is_redundant_barrier(barrier_info.stage_before, barrier_info.stage_after,
+        barrier_info.access_before, barrier_info.access_after))
+    {
+        return;
+    }
+
+    // Nothing is recorded between queued barriers, so both dependencies can be expressed by one.
+    auto queued = std::ranges::find(m_queued_buffer_barriers, barrier_info.buffer, &Buffer_Barrier_Info::buffer);
+    if (queued != m_queued_buffer_barriers.end())
+    {
+        queued->stage_before = queued->stage_before | barrier_info.stage_before;
+        queued->stage_after = queued->stage_after | barrier_info.stage_after;
+        queued->access_before = queued->access_before | barrier_info.access_before;
+        queued->access_after = queued->access_after | barrier_info.access_after;
+        return;
+    }
+    m_queued_buffer_barriers.push_back(barrier_info);
+}
+
+void Command_List::queue_image_barrier(const Image_Barrier_Info& barrier_info) noexcept
+{
+    bool transfers_ownership = barrier_info.queue_type_ownership_transfer_mode != Queue_Type_Ownership_Transfer_Mode::None;
+    if (!transfers_ownership
+        && !barrier_info.discard
+        && barrier_info.layout_before == barrier_info.layout_after
+        && is_redundant_barrier(barrier_info.stage_before, barrier_info.stage_after,
+            barrier_info.access_before, barrier_info.access_after))
+    {
+        return;
+    }
+
+    for (auto& queued : m_queued_image_barriers)
+    {
+        if (queued.image != barrier_info.image
+            || !image_barrier_subresource_ranges_overlap(queued.subresource_range, barrier_info.subresource_range))
+        {
+            continue;
+        }
+
+        bool mergeable = !transfers_ownership
+            && !barrier_info.discard
+            && queued.queue_type_ownership_transfer_mode == Queue_Type_Ownership_Transfer_Mode::None
+            && queued.layout_after == barrier_info.layout_before
+            && image_barrier_subresource_ranges_equal(queued.subresource_range, barrier_info.subresource_range);
+        if (!mergeable)
+        {
+            // Barriers recorded by one call are not ordered, the queued one has to be recorded first.
+            flush_barriers();
+            break;
+        }
+
+        // Accesses only carry over if they happened in the layout the merged barrier starts or ends in.
+        if (queued.layout_before == queued.layout_after)
+        {
+            queued.access_before = queued.access_before | barrier_info.access_before;
+        }
+        if (barrier_info.layout_before == barrier_info.layout_after)
+        {
+            queued.access_after = queued.access_after | barrier_info.access_after;
+        }
+        else
+        {
+            queued.access_after = barrier_info.access_after;
+        }
+        queued.stage_before = queued.stage_before | barrier_info.stage_before;
+        queued.stage_after = queued.stage_after | barrier_info.stage_after;
+        queued.layout_after = barrier_info.layout_after;
+        return;
+    }
+    m_queued_image_barriers.push_back(barrier_info);
+}
+
+void Command_List::queue_memory_barrier(const Memory_Barrier_Info& barrier_info) noexcept
+{
+    if (is_redundant_barrier(barrier_info.stage_before, barrier_info.stage_after,
+        barrier_info.access_before, barrier_info.access_after))
+    {
+        return;
+    }
+
+    if (m_queued_memory_barriers.empty())
+    {
+        m_queued_memory_barriers.push_back(barrier_info);
+        return;
+    }
+    auto& queued = m_queued_memory_barriers.front();
+    queued.stage_before = queued.stage_before | barrier_info.stage_before;
+    queued.stage_after = queued.stage_after | barrier_info.stage_after;
+    queued.access_before = queued.access_before | barrier_info.access_before;
+    queued.access_after = queued.access_after | barrier_info.access_after;
+}
+
+void Command_List::record_queued_barriers() noexcept
+{
+    record_barrier({
+        .buffer_barriers = m_queued_buffer_barriers,
+        .image_barriers = m_queued_image_barriers,
+        .memory_barriers = m_queued_memory_barriers
+    });
+    m_queued_buffer_barriers.clear();
+    m_queued_image_barriers.clear();
+    m_queued_memory_barriers.clear();
+}
+}
@@ -72,6 +72,7 @@ struct Render_Pass_Begin_Info
 {
     std::span<Render_Pass_Color_Attachment_Info> color_attachments;
     Render_Pass_Depth_Attachment_Info depth_stencil_attachment;
+    bool secondary_command_lists; // Vulkan only - the pass contains nothing but `execute_secondary` calls.
 };
 
 enum class Pipeline_Bind_Point
@@ -250,7 +251,19 @@ public:
     [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept = 0;
 
     // Barrier commands
-    virtual void barrier(const Barrier_Info& barrier_info) noexcept = 0;
+    // Records the barriers right away unless barrier batching is enabled.
+    void barrier(const Barrier_Info& barrier_info) noexcept;
+    // While enabled, `barrier` only queues barriers. They are recorded as a single barrier call before the next
+    // draw, dispatch, copy, clear, render pass or ray tracing command, by `flush_barriers` or at submission.
+    // Queued barriers on the same resource are merged, barriers between identical read-only states are dropped.
+    // Disabling it flushes the queued barriers. Command lists are acquired with batching disabled.
+    void set_barrier_batching(bool enabled) noexcept;
+    void flush_barriers() noexcept
+    {
+        if (m_queued_buffer_barriers.empty() && m_queued_image_barriers.empty() && m_queued_memory_barriers.empty()) return;
+
+        record_queued_barriers();
+    }
 
     // Compute commands
     virtual void dispatch(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept = 0;
@@ -258,10 +271,11 @@ public:
 
     // Copy commands
     virtual void copy_buffer(Buffer* src, uint64_t src_offset, Buffer* dst, uint64_t dst_offset, uint64_t size) noexcept = 0;
+    // `src_row_pitch` is the distance between rows in bytes, see `Image_Copy_Footprint`. Zero for tightly packed rows.
     virtual void copy_buffer_to_image(
         Buffer* src, uint64_t src_offset,
         Image* dst, const Offset_3D& dst_offset, const Extent_3D& dst_extent,
-        uint32_t dst_mip_level, uint32_t dst_array_index) noexcept = 0;
+        uint32_t dst_mip_level, uint32_t dst_array_index, uint32_t src_row_pitch = 0) noexcept = 0;
     virtual void copy_image(
         Image* src, const Offset_3D& src_offset, uint32_t src_mip_level, uint32_t src_array_index,
         Image* dst, const Offset_3D& dst_offset, uint32_t dst_mip_level, uint32_t dst_array_index,
@@ -289,6 +303,8 @@ public:
     virtual void draw_mesh_tasks(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept = 0;
     virtual void draw_mesh_tasks_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept = 0;
     virtual void draw_mesh_tasks_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept = 0;
+    // Only inside a render pass whose attachment formats match the ones the secondary list was created with.
+    virtual void execute_secondary(Command_List* command_list) noexcept = 0;
 
     // State commands
     virtual void begin_render_pass(const Render_Pass_Begin_Info& begin_info) noexcept = 0;
@@ -313,13 +329,41 @@ public:
         const Acceleration_Structure_Build_Geometry_Info& build_info, uint64_t scratch_memory_address) noexcept = 0;
     virtual void dispatch_rays(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z, const Shader_Binding_Table& sbt) noexcept = 0;
 
+protected:
+    virtual void record_barrier(const Barrier_Info& barrier_info) noexcept = 0;
+    // Drops queued barriers and disables batching, called when the list is recycled by its pool.
+    void reset_barrier_batching() noexcept;
+
 protected:
     Queue_Type m_queue_type = {};
+
+private:
+    void queue_buffer_barrier(const Buffer_Barrier_Info& barrier_info) noexcept;
+    void queue_image_barrier(const Image_Barrier_Info& barrier_info) noexcept;
+    void queue_memory_barrier(const Memory_Barrier_Info& barrier_info) noexcept;
+    void record_queued_barriers() noexcept;
+
+private:
+    bool m_batch_barriers = false;
+    std::vector<Buffer_Barrier_Info> m_queued_buffer_barriers;
+    std::vector<Image_Barrier_Info> m_queued_image_barriers;
+    std::vector<Memory_Barrier_Info> m_queued_memory_barriers;
+};
+
+// Formats and sample count of the render passes a secondary command list is executed in.
+struct Secondary_Command_List_Create_Info
+{
+    std::span<const Image_Format> color_attachment_formats;
+    Image_Format depth_stencil_format;
+    uint32_t sample_count; // A power of two, zero is treated as one. D3D12 bundles don't inherit it and ignore it.
 };
 
 struct Command_Pool_Create_Info
 {
     Queue_Type queue_type;
+    // `acquire_command_list` may be called from several threads at once. Lists acquired on different threads
+    // can be recorded in parallel, a list must be recorded on the thread that acquired it.
+    bool thread_safe;
 };
 
 class Command_Pool
@@ -327,9 +371,20 @@ class Command_Pool
 public:
     virtual ~Command_Pool() noexcept = default;
 
+    // Recycles every acquired list at once, the GPU must be done with them. Acquiring does not reset or allocate
+    // once the pool has grown to the number of lists used per frame.
     virtual void reset() noexcept = 0;
     virtual Command_List* acquire_command_list() noexcept = 0;
 
+    // Secondary command lists are Vulkan secondary command buffers and D3D12 bundles. They are recorded once and
+    // executed any number of times with `Command_List::execute_secondary`, `reset` does not affect them.
+    // Only state and draw commands may be recorded, no state is inherited from the executing list.
+    virtual Command_List* create_secondary_command_list(const Secondary_Command_List_Create_Info& create_info) noexcept = 0;
+    // Finishes the recording, afterwards the list can be executed.
+    virtual void end_secondary_command_list(Command_List* command_list) noexcept = 0;
+    // The list must no longer be in use by the GPU.
+    virtual void destroy_secondary_command_list(Command_List* command_list) noexcept = 0;
+
 protected:
     Command_Pool() noexcept = default;
 };
@@ -337,13 +392,13 @@ protected:
 }
 
 template<>
-constexpr static bool RHI_ENABLE_BIT_OPERATORS<rhi::Barrier_Pipeline_Stage> = true;
+constexpr bool RHI_ENABLE_BIT_OPERATORS<rhi::Barrier_Pipeline_Stage> = true;
 
 template<>
-constexpr static bool RHI_ENABLE_BIT_OPERATORS<rhi::Barrier_Access> = true;
+constexpr bool RHI_ENABLE_BIT_OPERATORS<rhi::Barrier_Access> = true;
 
 template<>
-constexpr static bool RHI_ENABLE_BIT_OPERATORS<rhi::Acceleration_Structure_Flags> = true;
+constexpr bool RHI_ENABLE_BIT_OPERATORS<rhi::Acceleration_Structure_Flags> = true;
 
 template<>
-constexpr static bool RHI_ENABLE_BIT_OPERATORS<rhi::Acceleration_Structure_Instance_Flags> = true;
+constexpr bool RHI_ENABLE_BIT_OPERATORS<rhi::Acceleration_Structure_Instance_Flags> = true;
@@ -0,0 +1,72 @@
+#include "rhi/command_pool_ring.hpp"
+
+#include "rhi/graphics_device.hpp"
+
+#include <utility>
+
+namespace rhi
+{
+std::expected<std::unique_ptr<Command_Pool_Ring>, Result> Command_Pool_Ring::create(
+    Graphics_Device* graphics_device, const Command_Pool_Ring_Create_Info& create_info) noexcept
+{
+    if (!graphics_device || !create_info.fence || create_info.frame_count == 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    auto result = std::unique_ptr<Command_Pool_Ring>(new Command_Pool_Ring());
+    result->m_fence = create_info.fence;
+    result->m_frames.reserve(create_info.frame_count);
+    for (auto i = 0u; i < create_info.frame_count; ++i)
+    {
+        auto command_pool = graphics_device->create_command_pool({
+            .queue_type = create_info.queue_type,
+            .thread_safe = create_info.thread_safe
+        });
+        if (!command_pool) return std::unexpected(Result::Error_Out_Of_Memory);
+
+        result->m_frames.push_back({
+            .command_pool = std::move(command_pool),
+            .fence_value = 0
+        });
+    }
+    return result;
+}
+
+Command_Pool_Ring::Command_Pool_Ring() noexcept
+    : m_fence(nullptr)
+    , m_frames()
+    , m_frame_index(0)
+{}
+
+Command_Pool_Ring::~Command_Pool_Ring() noexcept
+{}
+
+Command_List* Command_Pool_Ring::acquire_command_list() noexcept
+{
+    return m_frames[m_frame_index].command_pool->acquire_command_list();
+}
+
+void Command_Pool_Ring::end_frame(uint64_t fence_value) noexcept
+{
+    m_frames[m_frame_index].fence_value = fence_value;
+    m_frame_index = (m_frame_index + 1) % uint32_t(m_frames.size());
+
+    auto& frame = m_frames[m_frame_index];
+    if (frame.fence_value != 0)
+    {
+        m_fence->wait_for_value(frame.fence_value);
+    }
+    frame.command_pool->reset();
+}
+
+Command_Pool* Command_Pool_Ring::get_command_pool() const noexcept
+{
+    return m_frames[m_frame_index].command_pool.get();
+}
+
+uint32_t Command_Pool_Ring::get_frame_index() const noexcept
+{
+    return m_frame_index;
+}
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "rhi/command_list.hpp"
+#include "rhi/result.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <vector>
+
+namespace rhi
+{
+class Graphics_Device;
+struct Fence;
+
+struct Command_Pool_Ring_Create_Info
+{
+    Queue_Type queue_type;
+    bool thread_safe; // Passed to every `Command_Pool` of the ring.
+    uint32_t frame_count; // Frames in flight, one `Command_Pool` is created per frame.
+    Fence* fence; // Signaled with the values passed to `Command_Pool_Ring::end_frame`.
+};
+
+// One `Command_Pool` per frame in flight. `end_frame` moves to the next pool, waits until the GPU finished
+// the frame that last used it and resets it once, so acquiring command lists during a frame never resets
+// or allocates after the first few frames.
+class Command_Pool_Ring
+{
+public:
+    [[nodiscard]] static std::expected<std::unique_ptr<Command_Pool_Ring>, Result> create(
+        Graphics_Device* graphics_device, const Command_Pool_Ring_Create_Info& create_info) noexcept;
+    // The GPU must be done with every submitted list.
+    ~Command_Pool_Ring() noexcept;
+    Command_Pool_Ring(const Command_Pool_Ring& other) = delete;
+    Command_Pool_Ring(Command_Pool_Ring&& other) = delete;
+    Command_Pool_Ring& operator=(const Command_Pool_Ring& other) = delete;
+    Command_Pool_Ring& operator=(Command_Pool_Ring&& other) = delete;
+
+    // Acquires from the pool of the current frame.
+    [[nodiscard]] Command_List* acquire_command_list() noexcept;
+    // `fence_value` is signaled once every list acquired during the frame finished executing.
+    void end_frame(uint64_t fence_value) noexcept;
+
+    [[nodiscard]] Command_Pool* get_command_pool() const noexcept;
+    [[nodiscard]] uint32_t get_frame_index() const noexcept;
+
+private:
+    struct Frame
+    {
+        std::unique_ptr<Command_Pool> command_pool;
+        uint64_t fence_value;
+    };
+
+    Command_Pool_Ring() noexcept;
+
+private:
+    Fence* m_fence;
+    std::vector<Frame> m_frames;
+    uint32_t m_frame_index;
+};
+}
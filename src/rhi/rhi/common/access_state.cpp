@@ -0,0 +1,70 @@
+#include "rhi/common/access_state.hpp"
+
+namespace rhi
+{
+Barrier_Access get_write_access(Barrier_Access access) noexcept
+{
+    constexpr auto write_access = Barrier_Access::Shader_Write
+        | Barrier_Access::Color_Attachment_Write
+        | Barrier_Access::Depth_Stencil_Attachment_Write
+        | Barrier_Access::Transfer_Write
+        | Barrier_Access::Unordered_Access_Write
+        | Barrier_Access::Video_Decode_Write
+        | Barrier_Access::Video_Encode_Write
+        | Barrier_Access::Acceleration_Structure_Write;
+    return access & write_access;
+}
+
+bool is_write_access(Barrier_Access access) noexcept
+{
+    return get_write_access(access) != Barrier_Access::None;
+}
+
+bool apply_access(Access_State& state, const Access_Request& request, Image_Barrier_Info& barrier) noexcept
+{
+    barrier.stage_after = request.stage;
+    barrier.access_after = request.access;
+    barrier.access_before = state.write_access;
+    barrier.layout_before = state.layout;
+    barrier.layout_after = request.layout;
+
+    if (state.layout != request.layout)
+    {
+        // A layout transition is a write, later reads have to wait for it as well.
+        barrier.stage_before = state.write_stage | state.read_stage;
+        state = {
+            .layout = request.layout,
+            .write_stage = request.stage,
+            .write_access = request.write ? request.access : Barrier_Access::None,
+            .read_stage = request.write ? Barrier_Pipeline_Stage::None : request.stage,
+            .read_access = request.write ? Barrier_Access::None : request.access
+        };
+        return true;
+    }
+
+    if (request.write)
+    {
+        barrier.stage_before = state.write_stage | state.read_stage;
+        bool wait = barrier.stage_before != Barrier_Pipeline_Stage::None
+            || barrier.access_before != Barrier_Access::None;
+        state = {
+            .layout = request.layout,
+            .write_stage = request.stage,
+            .write_access = request.access,
+            .read_stage = Barrier_Pipeline_Stage::None,
+            .read_access = Barrier_Access::None
+        };
+        return wait;
+    }
+
+    // Reads after the same write only wait once per stage and access.
+    barrier.stage_before = state.write_stage;
+    bool written = state.write_stage != Barrier_Pipeline_Stage::None
+        || state.write_access != Barrier_Access::None;
+    bool visible = (request.stage & ~state.read_stage) == Barrier_Pipeline_Stage::None
+        && (request.access & ~state.read_access) == Barrier_Access::None;
+    state.read_stage = state.read_stage | request.stage;
+    state.read_access = state.read_access | request.access;
+    return written && !visible;
+}
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include "rhi/command_list.hpp"
+
+namespace rhi
+{
+// Synchronization state of a buffer or an image subresource. Reads are tracked until the next write, which has to wait for them.
+struct Access_State
+{
+    Barrier_Image_Layout layout;
+    Barrier_Pipeline_Stage write_stage; // The last write or layout transition.
+    Barrier_Access write_access;
+    Barrier_Pipeline_Stage read_stage;
+    Barrier_Access read_access; // Already made visible to `read_stage`.
+
+    auto operator<=>(const Access_State&) const = default;
+};
+
+struct Access_Request
+{
+    bool used;
+    bool write;
+    Barrier_Pipeline_Stage stage;
+    Barrier_Access access;
+    Barrier_Image_Layout layout;
+};
+
+// The write bits of `access`.
+[[nodiscard]] Barrier_Access get_write_access(Barrier_Access access) noexcept;
+[[nodiscard]] bool is_write_access(Barrier_Access access) noexcept;
+// Returns whether the access has to wait for the previous ones, `barrier` is filled if it does.
+// Only the stages, accesses and layouts of `barrier` are written.
+[[nodiscard]] bool apply_access(Access_State& state, const Access_Request& request, Image_Barrier_Info& barrier) noexcept;
+}
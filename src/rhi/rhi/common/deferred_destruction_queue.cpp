@@ -0,0 +1,114 @@
+#include "rhi/common/deferred_destruction_queue.hpp"
+
+#include "rhi/graphics_device.hpp"
+
+#include <algorithm>
+
+namespace rhi
+{
+void Deferred_Destruction_Queue::push(Buffer* buffer, Fence* fence, uint64_t value)
+{
+    push(Deferred_Destruction_Type::Buffer, buffer, fence, value);
+}
+
+void Deferred_Destruction_Queue::push(Image* image, Fence* fence, uint64_t value)
+{
+    push(Deferred_Destruction_Type::Image, image, fence, value);
+}
+
+void Deferred_Destruction_Queue::push(Sampler* sampler, Fence* fence, uint64_t value)
+{
+    push(Deferred_Destruction_Type::Sampler, sampler, fence, value);
+}
+
+void Deferred_Destruction_Queue::push(Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value)
+{
+    push(Deferred_Destruction_Type::Acceleration_Structure, acceleration_structure, fence, value);
+}
+
+void Deferred_Destruction_Queue::push(Memory_Heap* memory_heap, Fence* fence, uint64_t value)
+{
+    push(Deferred_Destruction_Type::Memory_Heap, memory_heap, fence, value);
+}
+
+void Deferred_Destruction_Queue::process(Graphics_Device* device)
+{
+    // Every fence is queried at most once per call, most resources share the same few frame fences.
+    struct Fence_Status
+    {
+        Fence* fence;
+        uint64_t completed_value;
+        uint64_t pending_value;
+    };
+    std::vector<Fence_Status> fence_statuses;
+    std::vector<Deferred_Destruction> completed;
+
+    {
+        std::unique_lock<std::mutex> lock_guard(m_mutex);
+        if (m_pending.empty()) return;
+
+        auto is_completed = [&fence_statuses](const Deferred_Destruction& destruction)
+        {
+            if (!destruction.fence) return true;
+
+            auto status = std::ranges::find(fence_statuses, destruction.fence, &Fence_Status::fence);
+            if (status == fence_statuses.end())
+            {
+                status = fence_statuses.insert(fence_statuses.end(), { destruction.fence, 0, ~0ull });
+            }
+            if (destruction.value <= status->completed_value) return true;
+            if (destruction.value >= status->pending_value) return false;
+
+            if (destruction.fence->get_status(destruction.value) == Result::Success)
+            {
+                status->completed_value = destruction.value;
+                return true;
+            }
+            status->pending_value = destruction.value;
+            return false;
+        };
+        auto pending_end = std::stable_partition(
+            m_pending.begin(), m_pending.end(),
+            [&is_completed](const Deferred_Destruction& destruction) { return !is_completed(destruction); });
+        completed.assign(pending_end, m_pending.end());
+        m_pending.erase(pending_end, m_pending.end());
+    }
+
+    for (const auto& destruction : completed)
+    {
+        switch (destruction.type)
+        {
+        case Deferred_Destruction_Type::Buffer:
+            device->destroy_buffer(static_cast<Buffer*>(destruction.resource));
+            break;
+        case Deferred_Destruction_Type::Image:
+            device->destroy_image(static_cast<Image*>(destruction.resource));
+            break;
+        case Deferred_Destruction_Type::Sampler:
+            device->destroy_sampler(static_cast<Sampler*>(destruction.resource));
+            break;
+        case Deferred_Destruction_Type::Acceleration_Structure:
+            device->destroy_acceleration_structure(static_cast<Acceleration_Structure*>(destruction.resource));
+            break;
+        case Deferred_Destruction_Type::Memory_Heap:
+            device->destroy_memory_heap(static_cast<Memory_Heap*>(destruction.resource));
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void Deferred_Destruction_Queue::push(Deferred_Destruction_Type type, void* resource, Fence* fence, uint64_t value)
+{
+    if (!resource) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_pending.push_back({
+        .type = type,
+        .resource = resource,
+        .fence = fence,
+        .value = value
+    });
+}
+}
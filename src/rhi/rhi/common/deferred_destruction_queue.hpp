@@ -0,0 +1,57 @@
+#pragma once
+
+#include "rhi/resource.hpp"
+
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace rhi
+{
+class Graphics_Device;
+struct Fence;
+
+enum class Deferred_Destruction_Type
+{
+    Buffer,
+    Image,
+    Sampler,
+    Acceleration_Structure,
+    Memory_Heap
+};
+
+// Resources that were destroyed while still in use by the GPU.
+// They are only handed back to the device once `fence` reached `value`, so their memory
+// and bindless indices can not be recycled while a frame in flight may still access them.
+// The queue itself is always synchronized, but `process` calls the `destroy_*` functions of the device,
+// which are only safe to call concurrently with other resource creation and destruction with `enable_locking`.
+class Deferred_Destruction_Queue
+{
+public:
+    void push(Buffer* buffer, Fence* fence, uint64_t value);
+    void push(Image* image, Fence* fence, uint64_t value);
+    void push(Sampler* sampler, Fence* fence, uint64_t value);
+    void push(Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value);
+    void push(Memory_Heap* memory_heap, Fence* fence, uint64_t value);
+
+    // Destroys every resource whose fence value has completed, using the regular `destroy_*` functions of `device`.
+    // Completed resources are destroyed in push order, so memory heaps pushed after their placed resources outlive them.
+    // Without `enable_locking` this must not run concurrently with any create or destroy call on `device`.
+    void process(Graphics_Device* device);
+
+private:
+    struct Deferred_Destruction
+    {
+        Deferred_Destruction_Type type;
+        void* resource;
+        Fence* fence;
+        uint64_t value;
+    };
+
+    void push(Deferred_Destruction_Type type, void* resource, Fence* fence, uint64_t value);
+
+private:
+    std::mutex m_mutex;
+    std::vector<Deferred_Destruction> m_pending;
+};
+}
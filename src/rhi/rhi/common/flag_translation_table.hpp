@@ -0,0 +1,65 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace rhi
+{
+template<typename Flag, typename Native>
+struct Flag_Translation
+{
+    Flag flag;
+    Native native;
+};
+
+// Translates a flag enum into native flags with one lookup per non-zero byte instead of one test per flag.
+// A native flag is set if any bit of its `flag` is set, like testing every translation on its own.
+template<typename Flag, typename Native>
+requires std::is_enum_v<Flag>
+class Flag_Translation_Table
+{
+public:
+    template<std::size_t Count>
+    consteval explicit Flag_Translation_Table(
+        const std::array<Flag_Translation<Flag, Native>, Count>& translations) noexcept
+        : m_table()
+    {
+        for (const auto& translation : translations)
+        {
+            auto flag = static_cast<Underlying>(translation.flag);
+            for (auto byte = 0u; byte < sizeof(Underlying); ++byte)
+            {
+                auto flag_byte = (flag >> (8 * byte)) & 0xff;
+                if (flag_byte == 0) continue;
+
+                for (auto value = 0u; value < 256; ++value)
+                {
+                    if ((value & flag_byte) != 0)
+                    {
+                        m_table[byte][value] |= static_cast<uint64_t>(translation.native);
+                    }
+                }
+            }
+        }
+    }
+
+    [[nodiscard]] constexpr Native translate(Flag flag) const noexcept
+    {
+        uint64_t result = 0;
+        auto bits = static_cast<Underlying>(flag);
+        for (auto byte = 0u; bits != 0; ++byte)
+        {
+            result |= m_table[byte][bits & 0xff];
+            bits >>= 8;
+        }
+        return static_cast<Native>(result);
+    }
+
+private:
+    using Underlying = std::make_unsigned_t<std::underlying_type_t<Flag>>;
+
+    std::array<std::array<uint64_t, 256>, sizeof(Underlying)> m_table;
+};
+}
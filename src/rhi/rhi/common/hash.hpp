@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace rhi
+{
+constexpr static uint64_t HASH_SEED = 0xcbf29ce484222325ull;
+
+// 64 bit FNV-1a. Used for cache keys and lookups, not suited for anything security related.
+[[nodiscard]] inline uint64_t hash_bytes(const void* data, std::size_t size, uint64_t seed = HASH_SEED) noexcept
+{
+    constexpr uint64_t FNV_PRIME = 0x100000001b3ull;
+
+    auto bytes = static_cast<const uint8_t*>(data);
+    auto hash = seed;
+    for (std::size_t i = 0; i < size; ++i)
+    {
+        hash ^= bytes[i];
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
+// Only scalars, hashing whole structs would include their padding.
+template<typename T>
+requires std::is_scalar_v<T>
+[[nodiscard]] inline uint64_t hash_value(T value, uint64_t seed) noexcept
+{
+    return hash_bytes(&value, sizeof(T), seed);
+}
+}
@@ -1,30 +1,166 @@
 #include "rhi/common/index_free_list.hpp"
 
+#include <algorithm>
+#include <thread>
+
 namespace rhi
 {
+namespace
+{
+uint32_t get_thread_cache_id() noexcept
+{
+    static std::atomic<uint32_t> next_thread_cache_id = 0;
+    thread_local const uint32_t thread_cache_id = next_thread_cache_id.fetch_add(1, std::memory_order_relaxed);
+    return thread_cache_id;
+}
+
+void lock_flag(std::atomic_flag& flag) noexcept
+{
+    while (flag.test_and_set(std::memory_order_acquire))
+    {
+        std::this_thread::yield();
+    }
+}
+
+void unlock_flag(std::atomic_flag& flag) noexcept
+{
+    flag.clear(std::memory_order_release);
+}
+
+uint64_t make_head(uint32_t slot, uint64_t previous_head) noexcept
+{
+    return (((previous_head >> 32) + 1) << 32) | slot;
+}
+}
+
 Index_Free_List::Index_Free_List(uint32_t index_count, uint32_t stride)
-    : m_max_index(stride* index_count)
+    : m_stride(stride)
+    , m_max_index(stride* index_count)
+    , m_head(index_count > 0 ? 0ull : INVALID_INDEX)
+    , m_next_slots(std::make_unique<std::atomic<uint32_t>[]>(index_count))
+    , m_thread_caches()
 {
-    m_indices.reserve(index_count);
-    for (auto i = static_cast<int32_t>(index_count) - 1; i >= 0; --i)
+    // Lower indices are handed out first.
+    for (auto i = 0u; i < index_count; ++i)
     {
-        m_indices.push_back(static_cast<uint32_t>(i) * stride);
+        m_next_slots[i].store(i + 1 < index_count ? i + 1 : INVALID_INDEX, std::memory_order_relaxed);
+    }
+    for (auto& thread_cache : m_thread_caches)
+    {
+        thread_cache.count = 0;
     }
 }
 
 uint32_t Index_Free_List::acquire_index()
 {
-    auto index = ~0u;
-    index = m_indices.back();
-    m_indices.pop_back();
-    return index;
+    auto& thread_cache = get_thread_cache();
+    auto slot = INVALID_INDEX;
+
+    lock_flag(thread_cache.lock);
+    if (thread_cache.count == 0)
+    {
+        std::array<uint32_t, THREAD_CACHE_BATCH_SIZE> slots;
+        thread_cache.count = pop_slots(slots.data(), THREAD_CACHE_BATCH_SIZE);
+        std::reverse_copy(slots.begin(), slots.begin() + thread_cache.count, thread_cache.slots.begin());
+    }
+    if (thread_cache.count > 0)
+    {
+        slot = thread_cache.slots[--thread_cache.count];
+    }
+    unlock_flag(thread_cache.lock);
+
+    if (slot == INVALID_INDEX)
+    {
+        slot = steal_slot(thread_cache);
+    }
+    return slot != INVALID_INDEX ? slot * m_stride : INVALID_INDEX;
 }
 
 void Index_Free_List::release_index(uint32_t index)
 {
-    if (index < m_max_index)
+    if (index >= m_max_index) return;
+
+    auto& thread_cache = get_thread_cache();
+
+    lock_flag(thread_cache.lock);
+    if (thread_cache.count == THREAD_CACHE_CAPACITY)
+    {
+        // Flush the least recently released half, the hot half stays in the cache.
+        push_slots(thread_cache.slots.data(), THREAD_CACHE_BATCH_SIZE);
+        std::copy(
+            thread_cache.slots.begin() + THREAD_CACHE_BATCH_SIZE,
+            thread_cache.slots.end(),
+            thread_cache.slots.begin());
+        thread_cache.count -= THREAD_CACHE_BATCH_SIZE;
+    }
+    thread_cache.slots[thread_cache.count++] = index / m_stride;
+    unlock_flag(thread_cache.lock);
+}
+
+Index_Free_List::Thread_Cache& Index_Free_List::get_thread_cache() noexcept
+{
+    return m_thread_caches[get_thread_cache_id() % THREAD_CACHE_COUNT];
+}
+
+uint32_t Index_Free_List::steal_slot(const Thread_Cache& own_cache) noexcept
+{
+    // Slow path, the global pool is empty but other caches may still hold indices.
+    auto slot = INVALID_INDEX;
+    if (pop_slots(&slot, 1) > 0)
     {
-        m_indices.push_back(index);
+        return slot;
+    }
+    for (auto& thread_cache : m_thread_caches)
+    {
+        if (&thread_cache == &own_cache) continue;
+
+        lock_flag(thread_cache.lock);
+        if (thread_cache.count > 0)
+        {
+            slot = thread_cache.slots[--thread_cache.count];
+        }
+        unlock_flag(thread_cache.lock);
+
+        if (slot != INVALID_INDEX) break;
     }
+    return slot;
+}
+
+uint32_t Index_Free_List::pop_slots(uint32_t* slots, uint32_t max_count) noexcept
+{
+    auto head = m_head.load(std::memory_order_acquire);
+    while (true)
+    {
+        auto top = static_cast<uint32_t>(head);
+        if (top == INVALID_INDEX) return 0;
+
+        // The chain read here is only valid if the head, including its tag, did not change in the meantime.
+        auto count = 0u;
+        auto slot = top;
+        while (slot != INVALID_INDEX && count < max_count)
+        {
+            slots[count++] = slot;
+            slot = m_next_slots[slot].load(std::memory_order_relaxed);
+        }
+        if (m_head.compare_exchange_weak(head, make_head(slot, head), std::memory_order_acq_rel, std::memory_order_acquire))
+        {
+            return count;
+        }
+    }
+}
+
+void Index_Free_List::push_slots(const uint32_t* slots, uint32_t count) noexcept
+{
+    if (count == 0) return;
+
+    for (auto i = 0u; i + 1 < count; ++i)
+    {
+        m_next_slots[slots[i]].store(slots[i + 1], std::memory_order_relaxed);
+    }
+    auto head = m_head.load(std::memory_order_relaxed);
+    do
+    {
+        m_next_slots[slots[count - 1]].store(static_cast<uint32_t>(head), std::memory_order_relaxed);
+    } while (!m_head.compare_exchange_weak(head, make_head(slots[0], head), std::memory_order_release, std::memory_order_relaxed));
 }
 }
@@ -1,19 +1,55 @@
 #pragma once
 
-#include <vector>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
 
 namespace rhi
 {
+// Thread-safe free list of bindless indices.
+// Every thread owns a small cache of indices which is refilled from and flushed to
+// a lock-free global pool in batches, so most calls never touch shared state.
 class Index_Free_List
 {
 public:
+    constexpr static uint32_t INVALID_INDEX = ~0u;
+
     Index_Free_List(uint32_t index_count, uint32_t stride = 1);
 
+    Index_Free_List(const Index_Free_List&) = delete;
+    Index_Free_List& operator=(const Index_Free_List&) = delete;
+
+    // Returns `INVALID_INDEX` if every index is in use.
     [[nodiscard]] uint32_t acquire_index();
     void release_index(uint32_t index);
 
 private:
+    constexpr static uint32_t THREAD_CACHE_COUNT = 32;
+    constexpr static uint32_t THREAD_CACHE_BATCH_SIZE = 32;
+    constexpr static uint32_t THREAD_CACHE_CAPACITY = 2 * THREAD_CACHE_BATCH_SIZE;
+
+    // Threads are assigned caches round robin, only more than `THREAD_CACHE_COUNT` threads share one.
+    struct alignas(64) Thread_Cache
+    {
+        std::atomic_flag lock;
+        uint32_t count;
+        std::array<uint32_t, THREAD_CACHE_CAPACITY> slots;
+    };
+
+    [[nodiscard]] Thread_Cache& get_thread_cache() noexcept;
+    [[nodiscard]] uint32_t steal_slot(const Thread_Cache& own_cache) noexcept;
+
+    // The global pool is a Treiber stack of slots, a slot being `index / stride`.
+    [[nodiscard]] uint32_t pop_slots(uint32_t* slots, uint32_t max_count) noexcept;
+    void push_slots(const uint32_t* slots, uint32_t count) noexcept;
+
+private:
+    const uint32_t m_stride;
     const uint32_t m_max_index;
-    std::vector<uint32_t> m_indices;
+    // The lower 32 bits hold the top slot, the upper 32 bits a tag that is incremented on every change to avoid ABA.
+    std::atomic<uint64_t> m_head;
+    std::unique_ptr<std::atomic<uint32_t>[]> m_next_slots;
+    std::array<Thread_Cache, THREAD_CACHE_COUNT> m_thread_caches;
 };
 }
@@ -0,0 +1,111 @@
+#include "rhi/common/mapped_file.hpp"
+
+#if defined(_WIN32)
+    #include <Windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace rhi
+{
+Mapped_File::Mapped_File() noexcept
+    : m_data(nullptr)
+    , m_size(0)
+{}
+
+Mapped_File::~Mapped_File() noexcept
+{
+    close();
+}
+
+// The view keeps the file alive on both platforms, so no handle outlives `open`.
+#if defined(_WIN32)
+Result Mapped_File::open(const std::filesystem::path& path) noexcept
+{
+    close();
+
+    auto file = CreateFileW(
+        path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+    if (file == INVALID_HANDLE_VALUE) return Result::Error_Unknown;
+
+    LARGE_INTEGER file_size = {};
+    if (!GetFileSizeEx(file, &file_size))
+    {
+        CloseHandle(file);
+        return Result::Error_Unknown;
+    }
+    if (file_size.QuadPart == 0)
+    {
+        CloseHandle(file);
+        return Result::Error_Invalid_Parameters;
+    }
+
+    auto mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    CloseHandle(file);
+    if (mapping == nullptr) return Result::Error_Unknown;
+
+    auto view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+    CloseHandle(mapping);
+    if (view == nullptr) return Result::Error_Unknown;
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = static_cast<std::size_t>(file_size.QuadPart);
+    return Result::Success;
+}
+
+void Mapped_File::close() noexcept
+{
+    if (m_data == nullptr) return;
+
+    UnmapViewOfFile(m_data);
+    m_data = nullptr;
+    m_size = 0;
+}
+#else
+Result Mapped_File::open(const std::filesystem::path& path) noexcept
+{
+    close();
+
+    auto file = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (file < 0) return Result::Error_Unknown;
+
+    struct stat file_stat = {};
+    if (fstat(file, &file_stat) != 0)
+    {
+        ::close(file);
+        return Result::Error_Unknown;
+    }
+    if (file_stat.st_size == 0)
+    {
+        ::close(file);
+        return Result::Error_Invalid_Parameters;
+    }
+
+    auto size = static_cast<std::size_t>(file_stat.st_size);
+    auto view = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, file, 0);
+    ::close(file);
+    if (view == MAP_FAILED) return Result::Error_Unknown;
+
+    m_data = static_cast<const uint8_t*>(view);
+    m_size = size;
+    return Result::Success;
+}
+
+void Mapped_File::close() noexcept
+{
+    if (m_data == nullptr) return;
+
+    munmap(const_cast<uint8_t*>(m_data), m_size);
+    m_data = nullptr;
+    m_size = 0;
+}
+#endif
+
+std::span<const uint8_t> Mapped_File::get_data() const noexcept
+{
+    return { m_data, m_size };
+}
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include "rhi/result.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+
+namespace rhi
+{
+// Read-only mapping of a whole file, pages are only loaded once they are touched.
+class Mapped_File
+{
+public:
+    Mapped_File() noexcept;
+    ~Mapped_File() noexcept;
+
+    Mapped_File(const Mapped_File&) = delete;
+    Mapped_File& operator=(const Mapped_File&) = delete;
+
+    // Returns `Error_Unknown` if the file could not be opened or mapped and `Error_Invalid_Parameters` if it is empty.
+    [[nodiscard]] Result open(const std::filesystem::path& path) noexcept;
+    void close() noexcept;
+
+    [[nodiscard]] std::span<const uint8_t> get_data() const noexcept;
+
+private:
+    const uint8_t* m_data;
+    std::size_t m_size;
+};
+}
@@ -0,0 +1,84 @@
+#include "rhi/common/pipeline_cache_file.hpp"
+
+#include "rhi/common/hash.hpp"
+
+#include <fstream>
+
+namespace rhi
+{
+std::expected<std::vector<uint8_t>, Result> read_pipeline_cache_file(
+    const std::filesystem::path& path, Graphics_API graphics_api) noexcept
+{
+    std::ifstream file(path, std::ios::binary);
+    if (!file) return std::unexpected(Result::Error_Unknown);
+
+    Pipeline_Cache_File_Header header = {};
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+    if (header.magic != PIPELINE_CACHE_FILE_MAGIC
+        || header.version != PIPELINE_CACHE_FILE_VERSION
+        || header.graphics_api != static_cast<uint32_t>(graphics_api))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    // Check the size against the file before allocating, the header may be garbage.
+    std::error_code error;
+    auto file_size = std::filesystem::file_size(path, error);
+    if (error || file_size - sizeof(header) != header.data_size)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::vector<uint8_t> data;
+    try
+    {
+        data.resize(header.data_size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return std::unexpected(Result::Error_Out_Of_Memory);
+    }
+    if (!file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()))
+        || hash_bytes(data.data(), data.size()) != header.data_hash)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+    return data;
+}
+
+Result write_pipeline_cache_file(
+    const std::filesystem::path& path, Graphics_API graphics_api, std::span<const uint8_t> data) noexcept
+{
+    Pipeline_Cache_File_Header header = {
+        .magic = PIPELINE_CACHE_FILE_MAGIC,
+        .version = PIPELINE_CACHE_FILE_VERSION,
+        .graphics_api = static_cast<uint32_t>(graphics_api),
+        .reserved = 0,
+        .data_size = data.size(),
+        .data_hash = hash_bytes(data.data(), data.size())
+    };
+
+    // Written next to the destination and renamed so a crash never leaves a partial cache behind.
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) return Result::Error_Unknown;
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+        if (!file.flush()) return Result::Error_Unknown;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+        return Result::Error_Unknown;
+    }
+    return Result::Success;
+}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "rhi/graphics_device.hpp"
+#include "rhi/result.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <span>
+#include <vector>
+
+namespace rhi
+{
+constexpr static uint32_t PIPELINE_CACHE_FILE_MAGIC = 0x43505452; // "RTPC"
+constexpr static uint32_t PIPELINE_CACHE_FILE_VERSION = 1;
+
+// Header in front of the driver provided cache data. The drivers validate their own data against the device,
+// this only rejects truncated or corrupted files and files written by another graphics API.
+struct Pipeline_Cache_File_Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t graphics_api;
+    uint32_t reserved;
+    uint64_t data_size;
+    uint64_t data_hash;
+};
+
+[[nodiscard]] std::expected<std::vector<uint8_t>, Result> read_pipeline_cache_file(
+    const std::filesystem::path& path, Graphics_API graphics_api) noexcept;
+[[nodiscard]] Result write_pipeline_cache_file(
+    const std::filesystem::path& path, Graphics_API graphics_api, std::span<const uint8_t> data) noexcept;
+}
@@ -0,0 +1,37 @@
+#include "rhi/common/pipeline_compiler.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace rhi
+{
+Pipeline_Compiler::Pipeline_Compiler(Compile_Function&& compile_function) noexcept
+    : m_compile_function(std::move(compile_function))
+    , m_thread_pool_flag()
+    , m_thread_pool()
+{}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> Pipeline_Compiler::enqueue(std::span<Pipeline* const> pipelines)
+{
+    std::call_once(m_thread_pool_flag, [this] {
+        auto thread_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+        m_thread_pool = std::make_unique<Thread_Pool>(thread_count);
+    });
+
+    std::vector<std::shared_ptr<Pipeline_Compile_Task>> tasks;
+    tasks.reserve(pipelines.size());
+    for (auto pipeline : pipelines)
+    {
+        auto& task = tasks.emplace_back(std::make_shared<Pipeline_Compile_Task>(pipeline));
+        m_thread_pool->enqueue([this, task] {
+            task->complete(m_compile_function(task->get_pipeline()));
+        });
+    }
+    return tasks;
+}
+
+void Pipeline_Compiler::shutdown() noexcept
+{
+    m_thread_pool.reset();
+}
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "rhi/graphics_device.hpp"
+#include "rhi/common/thread_pool.hpp"
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace rhi
+{
+// Compiles pipelines for `Graphics_Device::create_pipelines_async` on worker threads.
+// The device creates the `Pipeline` up front, the compile function only fills in its native object
+// and must therefore be thread safe. Workers are started on first use, leaving one core for the caller.
+class Pipeline_Compiler
+{
+public:
+    using Compile_Function = std::function<Result(Pipeline*)>;
+
+    explicit Pipeline_Compiler(Compile_Function&& compile_function) noexcept;
+
+    [[nodiscard]] std::vector<std::shared_ptr<Pipeline_Compile_Task>> enqueue(std::span<Pipeline* const> pipelines);
+    // Finishes every enqueued compilation and stops the workers. Must be called before the device is destroyed.
+    void shutdown() noexcept;
+
+private:
+    Compile_Function m_compile_function;
+    std::once_flag m_thread_pool_flag;
+    std::unique_ptr<Thread_Pool> m_thread_pool;
+};
+}
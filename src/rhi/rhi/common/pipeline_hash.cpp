@@ -0,0 +1,122 @@
+#include "rhi/common/pipeline_hash.hpp"
+
+#include "rhi/common/hash.hpp"
+
+namespace rhi
+{
+uint64_t hash_blend_state(const Pipeline_Blend_State_Info& blend_state_info, uint64_t seed) noexcept
+{
+    auto hash = hash_value(blend_state_info.independent_blend_enable, seed);
+    for (const auto& color_attachment : blend_state_info.color_attachments)
+    {
+        hash = hash_value(color_attachment.blend_enable, hash);
+        hash = hash_value(color_attachment.logic_op_enable, hash);
+        hash = hash_value(color_attachment.color_src_blend, hash);
+        hash = hash_value(color_attachment.color_dst_blend, hash);
+        hash = hash_value(color_attachment.color_blend_op, hash);
+        hash = hash_value(color_attachment.alpha_src_blend, hash);
+        hash = hash_value(color_attachment.alpha_dst_blend, hash);
+        hash = hash_value(color_attachment.alpha_blend_op, hash);
+        hash = hash_value(color_attachment.logic_op, hash);
+        hash = hash_value(color_attachment.color_write_mask, hash);
+    }
+    return hash;
+}
+
+uint64_t hash_rasterizer_state(const Pipeline_Rasterization_State_Info& rasterizer_state_info, uint64_t seed) noexcept
+{
+    auto hash = hash_value(rasterizer_state_info.fill_mode, seed);
+    hash = hash_value(rasterizer_state_info.cull_mode, hash);
+    hash = hash_value(rasterizer_state_info.winding_order, hash);
+    hash = hash_value(rasterizer_state_info.depth_bias, hash);
+    hash = hash_value(rasterizer_state_info.depth_bias_clamp, hash);
+    hash = hash_value(rasterizer_state_info.depth_bias_slope_scale, hash);
+    hash = hash_value(rasterizer_state_info.depth_clip_enable, hash);
+    return hash;
+}
+
+uint64_t hash_stencil_op(const Pipeline_Depth_Stencil_Op_Info& stencil_op_info, uint64_t seed) noexcept
+{
+    auto hash = hash_value(stencil_op_info.fail, seed);
+    hash = hash_value(stencil_op_info.depth_fail, hash);
+    hash = hash_value(stencil_op_info.pass, hash);
+    hash = hash_value(stencil_op_info.comparison_func, hash);
+    hash = hash_value(stencil_op_info.stencil_read_mask, hash);
+    hash = hash_value(stencil_op_info.stencil_write_mask, hash);
+    return hash;
+}
+
+uint64_t hash_depth_stencil_state(const Pipeline_Depth_Stencil_State_Info& depth_stencil_info, uint64_t seed) noexcept
+{
+    auto hash = hash_value(depth_stencil_info.depth_enable, seed);
+    hash = hash_value(depth_stencil_info.depth_write_enable, hash);
+    hash = hash_value(depth_stencil_info.comparison_func, hash);
+    hash = hash_value(depth_stencil_info.stencil_enable, hash);
+    hash = hash_stencil_op(depth_stencil_info.stencil_front_face, hash);
+    hash = hash_stencil_op(depth_stencil_info.stencil_back_face, hash);
+    hash = hash_value(depth_stencil_info.depth_bounds_test_mode, hash);
+    hash = hash_value(depth_stencil_info.depth_bounds_min, hash);
+    hash = hash_value(depth_stencil_info.depth_bounds_max, hash);
+    return hash;
+}
+
+template<typename T>
+uint64_t hash_render_state(const T& create_info, uint64_t seed) noexcept
+{
+    auto hash = hash_blend_state(create_info.blend_state_info, seed);
+    hash = hash_rasterizer_state(create_info.rasterizer_state_info, hash);
+    hash = hash_depth_stencil_state(create_info.depth_stencil_info, hash);
+    hash = hash_value(create_info.primitive_topology, hash);
+    hash = hash_value(create_info.color_attachment_count, hash);
+    for (auto format : create_info.color_attachment_formats)
+    {
+        hash = hash_value(format, hash);
+    }
+    hash = hash_value(create_info.depth_stencil_format, hash);
+    return hash;
+}
+
+uint64_t hash_shader_blob_contents(
+    const void* data, std::size_t data_size, uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept
+{
+    auto hash = hash_bytes(data, data_size);
+    hash = hash_value(groups_x, hash);
+    hash = hash_value(groups_y, hash);
+    hash = hash_value(groups_z, hash);
+    return hash;
+}
+
+uint64_t hash_shader_blob(const Shader_Blob* shader_blob, uint64_t seed) noexcept
+{
+    // Distinguishes a missing stage from an empty one.
+    if (!shader_blob) return hash_value(~0ull, seed);
+
+    return hash_value(shader_blob->content_hash, seed);
+}
+
+uint64_t hash_pipeline(const Graphics_Pipeline_Create_Info& create_info) noexcept
+{
+    auto hash = hash_value(Pipeline_Type::Vertex_Shading, HASH_SEED);
+    hash = hash_shader_blob(create_info.vs, hash);
+    hash = hash_shader_blob(create_info.hs, hash);
+    hash = hash_shader_blob(create_info.ds, hash);
+    hash = hash_shader_blob(create_info.gs, hash);
+    hash = hash_shader_blob(create_info.ps, hash);
+    return hash_render_state(create_info, hash);
+}
+
+uint64_t hash_pipeline(const Compute_Pipeline_Create_Info& create_info) noexcept
+{
+    auto hash = hash_value(Pipeline_Type::Compute, HASH_SEED);
+    return hash_shader_blob(create_info.cs, hash);
+}
+
+uint64_t hash_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept
+{
+    auto hash = hash_value(Pipeline_Type::Mesh_Shading, HASH_SEED);
+    hash = hash_shader_blob(create_info.ts, hash);
+    hash = hash_shader_blob(create_info.ms, hash);
+    hash = hash_shader_blob(create_info.ps, hash);
+    return hash_render_state(create_info, hash);
+}
+}
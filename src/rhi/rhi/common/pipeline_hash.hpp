@@ -0,0 +1,20 @@
+#pragma once
+
+#include "rhi/resource.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+namespace rhi
+{
+[[nodiscard]] uint64_t hash_shader_blob_contents(
+    const void* data, std::size_t data_size, uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept;
+
+// Hashes of the shader contents and the fixed function state, independent of `Shader_Blob` addresses.
+// Equal create infos hash equal across runs, which makes the hashes usable as persistent cache keys.
+// Shader contents are taken from `Shader_Blob::content_hash`, so hashing a pipeline never touches the bytecode.
+[[nodiscard]] uint64_t hash_shader_blob(const Shader_Blob* shader_blob, uint64_t seed) noexcept;
+[[nodiscard]] uint64_t hash_pipeline(const Graphics_Pipeline_Create_Info& create_info) noexcept;
+[[nodiscard]] uint64_t hash_pipeline(const Compute_Pipeline_Create_Info& create_info) noexcept;
+[[nodiscard]] uint64_t hash_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept;
+}
@@ -0,0 +1,78 @@
+#include "rhi/common/pipeline_reflection.hpp"
+
+#include "rhi/command_list.hpp"
+
+#include <algorithm>
+
+namespace rhi
+{
+namespace
+{
+bool has_reflection(const Shader_Blob* shader_blob) noexcept
+{
+    return shader_blob != nullptr
+        && (shader_blob->reflection.flags & Shader_Reflection_Flags::Valid) == Shader_Reflection_Flags::Valid;
+}
+
+bool is_push_constant_size_valid(const Shader_Blob* shader_blob) noexcept
+{
+    return !has_reflection(shader_blob) || shader_blob->reflection.push_constant_size <= PUSH_CONSTANT_MAX_SIZE;
+}
+
+bool is_stage_interface_valid(const Shader_Blob* producer, const Shader_Blob* consumer) noexcept
+{
+    if (!has_reflection(producer) || !has_reflection(consumer)) return true;
+
+    const auto& outputs = producer->reflection.outputs;
+    return std::ranges::all_of(consumer->reflection.inputs, [&](const Shader_Signature_Element& input) {
+        // System values like `SV_Position` or `SV_IsFrontFace` are provided by the rasterizer.
+        if (input.system_value != Shader_System_Value::None) return true;
+        return std::ranges::any_of(outputs, [&](const Shader_Signature_Element& output) {
+            return output.semantic_hash == input.semantic_hash
+                && output.semantic_index == input.semantic_index
+                && (output.component_mask & input.component_mask) == input.component_mask;
+        });
+    });
+}
+}
+
+Result validate_pipeline_reflection(const Graphics_Pipeline_Create_Info& create_info) noexcept
+{
+    for (auto shader_blob : { create_info.vs, create_info.hs, create_info.ds, create_info.gs, create_info.ps })
+    {
+        if (!is_push_constant_size_valid(shader_blob)) return Result::Error_Invalid_Parameters;
+    }
+    auto last_geometry_stage = create_info.gs ? create_info.gs : create_info.ds ? create_info.ds : create_info.vs;
+    if (!is_stage_interface_valid(last_geometry_stage, create_info.ps)) return Result::Error_Invalid_Parameters;
+    return Result::Success;
+}
+
+Result validate_pipeline_reflection(const Compute_Pipeline_Create_Info& create_info) noexcept
+{
+    return is_push_constant_size_valid(create_info.cs) ? Result::Success : Result::Error_Invalid_Parameters;
+}
+
+Result validate_pipeline_reflection(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept
+{
+    for (auto shader_blob : { create_info.ts, create_info.ms, create_info.ps })
+    {
+        if (!is_push_constant_size_valid(shader_blob)) return Result::Error_Invalid_Parameters;
+    }
+    return Result::Success;
+}
+
+uint32_t get_written_color_attachment_mask(const Shader_Blob* ps) noexcept
+{
+    if (!has_reflection(ps)) return ~0u;
+
+    auto mask = 0u;
+    for (const auto& output : ps->reflection.outputs)
+    {
+        if (output.system_value == Shader_System_Value::Target && output.semantic_index < 32)
+        {
+            mask |= 1u << output.semantic_index;
+        }
+    }
+    return mask;
+}
+}
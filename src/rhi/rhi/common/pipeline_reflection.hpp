@@ -0,0 +1,20 @@
+#pragma once
+
+#include "rhi/resource.hpp"
+
+#include <cstdint>
+
+namespace rhi
+{
+// Validates a pipeline against the reflection of its shaders, shaders without reflection are not validated.
+// Returns `Error_Invalid_Parameters` if a stage reads more than `PUSH_CONSTANT_MAX_SIZE` bytes of push constants
+// or if the pixel shader reads an input that the previous stage does not write.
+[[nodiscard]] Result validate_pipeline_reflection(const Graphics_Pipeline_Create_Info& create_info) noexcept;
+[[nodiscard]] Result validate_pipeline_reflection(const Compute_Pipeline_Create_Info& create_info) noexcept;
+// Mesh shader outputs are not part of the reflected signature, only push constants are validated.
+[[nodiscard]] Result validate_pipeline_reflection(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept;
+
+// Bit `i` is set if the pixel shader writes color attachment `i`, every bit is set if it has no reflection.
+// Color writes to the other attachments can be disabled, their contents would be undefined anyway.
+[[nodiscard]] uint32_t get_written_color_attachment_mask(const Shader_Blob* ps) noexcept;
+}
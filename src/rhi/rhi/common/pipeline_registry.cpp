@@ -0,0 +1,32 @@
+#include "rhi/common/pipeline_registry.hpp"
+
+namespace rhi
+{
+Pipeline* Pipeline_Registry::acquire(uint64_t pipeline_hash) noexcept
+{
+    auto it = m_entries.find(pipeline_hash);
+    if (it == m_entries.end()) return nullptr;
+
+    it->second.reference_count += 1;
+    return it->second.pipeline;
+}
+
+void Pipeline_Registry::insert(uint64_t pipeline_hash, Pipeline* pipeline) noexcept
+{
+    m_entries.insert_or_assign(pipeline_hash, Entry{ .pipeline = pipeline, .reference_count = 1 });
+    m_pipeline_hashes.insert_or_assign(pipeline, pipeline_hash);
+}
+
+bool Pipeline_Registry::release(Pipeline* pipeline) noexcept
+{
+    auto hash_it = m_pipeline_hashes.find(pipeline);
+    if (hash_it == m_pipeline_hashes.end()) return true;
+
+    auto entry_it = m_entries.find(hash_it->second);
+    if (--entry_it->second.reference_count > 0) return false;
+
+    m_entries.erase(entry_it);
+    m_pipeline_hashes.erase(hash_it);
+    return true;
+}
+}
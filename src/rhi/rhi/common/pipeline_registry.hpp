@@ -0,0 +1,32 @@
+#pragma once
+
+#include "rhi/resource.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+
+namespace rhi
+{
+// Reference counted pipelines keyed by `hash_pipeline`, so identical create infos share one native pipeline.
+// Not synchronized, the device guards it with its resource lock.
+class Pipeline_Registry
+{
+public:
+    // Returns the registered pipeline with an additional reference or nullptr if there is none.
+    [[nodiscard]] Pipeline* acquire(uint64_t pipeline_hash) noexcept;
+    // Registers `pipeline` with a single reference.
+    void insert(uint64_t pipeline_hash, Pipeline* pipeline) noexcept;
+    // Returns true once the last reference is released or if the pipeline was never registered.
+    [[nodiscard]] bool release(Pipeline* pipeline) noexcept;
+
+private:
+    struct Entry
+    {
+        Pipeline* pipeline;
+        uint32_t reference_count;
+    };
+
+    std::unordered_map<uint64_t, Entry> m_entries;
+    std::unordered_map<const Pipeline*, uint64_t> m_pipeline_hashes;
+};
+}
@@ -91,11 +91,14 @@ public:
         const Buffer_Create_Info& buffer_create_info,
         uint32_t bindless_resource_index = ~0u)
     {
+        auto resource_index = maybe_acquire_resource_index(bindless_resource_index);
+        if (resource_index == NO_RESOURCE_INDEX) return nullptr;
+
         auto buffer = &*m_buffers.emplace();
         buffer->size = buffer_create_info.size;
         buffer->heap_type = buffer_create_info.heap;
         buffer->buffer_view = &*m_buffer_views.emplace();
-        buffer->buffer_view->bindless_index = maybe_acquire_resource_index(bindless_resource_index);
+        buffer->buffer_view->bindless_index = resource_index;
         buffer->buffer_view->size = buffer->size;
         buffer->buffer_view->offset = 0;
         buffer->buffer_view->buffer = buffer;
@@ -110,8 +113,11 @@ public:
         const Buffer_View_Create_Info& buffer_view_create_info,
         uint32_t bindless_resource_index = ~0u)
     {
+        auto resource_index = maybe_acquire_resource_index(bindless_resource_index);
+        if (resource_index == NO_RESOURCE_INDEX) return nullptr;
+
         auto buffer_view = &*m_buffer_views.emplace();
-        buffer_view->bindless_index = maybe_acquire_resource_index(bindless_resource_index);
+        buffer_view->bindless_index = resource_index;
         buffer_view->size = buffer_view_create_info.size;
         buffer_view->offset = buffer_view_create_info.offset;
         buffer_view->buffer = buffer;
@@ -141,6 +147,9 @@ public:
         const Image_Create_Info& image_create_info,
         uint32_t bindless_resource_index = ~0u)
     {
+        auto resource_index = maybe_acquire_resource_index(bindless_resource_index);
+        if (resource_index == NO_RESOURCE_INDEX) return nullptr;
+
         auto image = &*m_images.emplace();
         image->format = image_create_info.format;
         image->width = image_create_info.width;
@@ -151,7 +160,7 @@ public:
         image->usage = image_create_info.usage;
         image->primary_view_type = image_create_info.primary_view_type;
         image->image_view = &*m_image_views.emplace();
-        image->image_view->bindless_index = maybe_acquire_resource_index(bindless_resource_index);
+        image->image_view->bindless_index = resource_index;
         image->image_view->image = image;
         image->image_view_linked_list_head = image->image_view;
 
@@ -175,10 +184,13 @@ public:
         const Image_View_Create_Info& image_view_create_info,
         uint32_t bindless_resource_index = ~0u)
     {
+        auto resource_index = maybe_acquire_resource_index(bindless_resource_index);
+        if (resource_index == NO_RESOURCE_INDEX) return nullptr;
+
         auto image_view = &*m_image_views.emplace();
 
         image_view->image = image;
-        image_view->bindless_index = maybe_acquire_resource_index(bindless_resource_index);
+        image_view->bindless_index = resource_index;
         image_view->next_image_view = image->image_view_linked_list_head;
         image->image_view_linked_list_head = image_view;
 
@@ -220,9 +232,12 @@ public:
     [[nodiscard]] Sampler_Type* acquire_sampler(
         uint32_t bindless_resource_index = ~0u)
     {
+        auto sampler_index = maybe_acquire_sampler_index(bindless_resource_index);
+        if (sampler_index == NO_RESOURCE_INDEX) return nullptr;
+
         auto sampler = &*m_samplers.emplace();
 
-        sampler->bindless_index = maybe_acquire_sampler_index(bindless_resource_index);
+        sampler->bindless_index = sampler_index;
 
         return sampler;
     }
@@ -238,9 +253,12 @@ public:
     [[nodiscard]] Acceleration_Structure_Type* acquire_acceleration_structure(
         uint32_t bindless_resource_index = ~0u)
     {
+        auto resource_index = maybe_acquire_resource_index(bindless_resource_index);
+        if (resource_index == NO_RESOURCE_INDEX) return nullptr;
+
         auto acceleration_structure = &*m_acceleration_structures.emplace();
 
-        acceleration_structure->bindless_index = maybe_acquire_resource_index(bindless_resource_index);
+        acceleration_structure->bindless_index = resource_index;
 
         return acceleration_structure;
     }
@@ -254,6 +272,7 @@ public:
     }
 
 private:
+    // Both return `NO_RESOURCE_INDEX` once every bindless index is in use.
     uint32_t maybe_acquire_resource_index(
         uint32_t bindless_resource_index)
     {
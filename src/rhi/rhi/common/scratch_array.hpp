@@ -0,0 +1,63 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+namespace rhi
+{
+// Fixed-size array for data that only lives during a call, such as the native barriers of `Command_List::barrier`.
+// Up to `Inline_Capacity` elements are stored inline, larger arrays use `spill`, which is owned by the caller
+// and keeps its capacity between calls. Neither case allocates once `spill` has grown.
+template<typename T, std::size_t Inline_Capacity>
+requires std::is_trivially_copyable_v<T>
+class Scratch_Array
+{
+public:
+    Scratch_Array(std::size_t capacity, std::vector<T>& spill) noexcept
+        : m_data(nullptr)
+        , m_size(0)
+    {
+        if (capacity <= Inline_Capacity)
+        {
+            m_data = m_inline.data();
+        }
+        else
+        {
+            if (spill.size() < capacity)
+            {
+                spill.resize(capacity);
+            }
+            m_data = spill.data();
+        }
+    }
+
+    Scratch_Array(const Scratch_Array&) = delete;
+    Scratch_Array& operator=(const Scratch_Array&) = delete;
+
+    // Must not be called more often than the capacity passed to the constructor.
+    void push_back(const T& value) noexcept
+    {
+        m_data[m_size] = value;
+        m_size += 1;
+    }
+
+    [[nodiscard]] T* data() noexcept
+    {
+        return m_data;
+    }
+
+    [[nodiscard]] uint32_t size() const noexcept
+    {
+        return m_size;
+    }
+
+private:
+    // Left uninitialized, only the first `m_size` elements are ever read.
+    std::array<T, Inline_Capacity> m_inline;
+    T* m_data;
+    uint32_t m_size;
+};
+}
@@ -0,0 +1,62 @@
+#include "rhi/common/thread_pool.hpp"
+
+namespace rhi
+{
+Thread_Pool::Thread_Pool(uint32_t thread_count)
+    : m_mutex()
+    , m_condition()
+    , m_tasks()
+    , m_is_stopping(false)
+    , m_threads()
+{
+    m_threads.reserve(thread_count);
+    for (auto i = 0u; i < thread_count; ++i)
+    {
+        m_threads.emplace_back(&Thread_Pool::run, this);
+    }
+}
+
+Thread_Pool::~Thread_Pool() noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock_guard(m_mutex);
+        m_is_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void Thread_Pool::enqueue(std::function<void()>&& task)
+{
+    {
+        std::unique_lock<std::mutex> lock_guard(m_mutex);
+        m_tasks.push_back(std::move(task));
+    }
+    m_condition.notify_one();
+}
+
+uint32_t Thread_Pool::get_thread_count() const noexcept
+{
+    return static_cast<uint32_t>(m_threads.size());
+}
+
+void Thread_Pool::run() noexcept
+{
+    while (true)
+    {
+        std::function<void()> task;
+        {
+            std::unique_lock<std::mutex> lock_guard(m_mutex);
+            m_condition.wait(lock_guard, [this] { return m_is_stopping || !m_tasks.empty(); });
+            if (m_tasks.empty()) return;
+
+            task = std::move(m_tasks.front());
+            m_tasks.pop_front();
+        }
+        task();
+    }
+}
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rhi
+{
+// Fixed set of worker threads executing tasks in FIFO order.
+class Thread_Pool
+{
+public:
+    explicit Thread_Pool(uint32_t thread_count);
+    // Finishes every queued task before joining the workers.
+    ~Thread_Pool() noexcept;
+
+    Thread_Pool(const Thread_Pool&) = delete;
+    Thread_Pool& operator=(const Thread_Pool&) = delete;
+
+    void enqueue(std::function<void()>&& task);
+    [[nodiscard]] uint32_t get_thread_count() const noexcept;
+
+private:
+    void run() noexcept;
+
+private:
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::deque<std::function<void()>> m_tasks;
+    bool m_is_stopping;
+    std::vector<std::thread> m_threads;
+};
+}
@@ -0,0 +1,126 @@
+#include "rhi/common/work_stealing_pool.hpp"
+
+namespace rhi
+{
+Work_Stealing_Pool::Work_Stealing_Pool(uint32_t worker_count)
+    : m_queues()
+    , m_mutex()
+    , m_condition()
+    , m_finished_condition()
+    , m_task(nullptr)
+    , m_generation(0)
+    , m_remaining_task_count(0)
+    , m_is_stopping(false)
+    , m_threads()
+{
+    m_queues.reserve(worker_count + 1);
+    for (auto i = 0u; i < worker_count + 1; ++i)
+    {
+        m_queues.push_back(std::make_unique<Task_Queue>());
+    }
+    m_threads.reserve(worker_count);
+    for (auto i = 0u; i < worker_count; ++i)
+    {
+        m_threads.emplace_back(&Work_Stealing_Pool::work, this, i + 1);
+    }
+}
+
+Work_Stealing_Pool::~Work_Stealing_Pool() noexcept
+{
+    {
+        std::unique_lock<std::mutex> lock_guard(m_mutex);
+        m_is_stopping = true;
+    }
+    m_condition.notify_all();
+    for (auto& thread : m_threads)
+    {
+        thread.join();
+    }
+}
+
+void Work_Stealing_Pool::run(uint32_t task_count, const std::function<void(uint32_t, uint32_t)>& task) noexcept
+{
+    if (task_count == 0) return;
+
+    m_task = &task;
+    m_remaining_task_count = task_count;
+    // Contiguous ranges per thread, neighbouring tasks tend to touch the same data.
+    auto thread_count = get_thread_count();
+    for (auto thread_index = 0u; thread_index < thread_count; ++thread_index)
+    {
+        auto& queue = *m_queues[thread_index];
+        std::unique_lock<std::mutex> lock_guard(queue.mutex);
+        for (auto index = uint64_t(task_count) * thread_index / thread_count;
+            index < uint64_t(task_count) * (thread_index + 1) / thread_count;
+            ++index)
+        {
+            queue.tasks.push_front(uint32_t(index));
+        }
+    }
+    {
+        std::unique_lock<std::mutex> lock_guard(m_mutex);
+        m_generation += 1;
+    }
+    m_condition.notify_all();
+
+    while (execute_task(0)) {}
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_finished_condition.wait(lock_guard, [this] { return m_remaining_task_count == 0; });
+    m_task = nullptr;
+}
+
+uint32_t Work_Stealing_Pool::get_thread_count() const noexcept
+{
+    return static_cast<uint32_t>(m_queues.size());
+}
+
+void Work_Stealing_Pool::work(uint32_t thread_index) noexcept
+{
+    uint64_t generation = 0;
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock_guard(m_mutex);
+            m_condition.wait(lock_guard, [this, generation] { return m_is_stopping || m_generation != generation; });
+            if (m_is_stopping) return;
+            generation = m_generation;
+        }
+        while (execute_task(thread_index)) {}
+    }
+}
+
+bool Work_Stealing_Pool::execute_task(uint32_t thread_index) noexcept
+{
+    uint32_t index = 0;
+    bool found = false;
+    for (auto i = 0u; i < m_queues.size() && !found; ++i)
+    {
+        auto victim = (thread_index + i) % m_queues.size();
+        auto& queue = *m_queues[victim];
+        std::unique_lock<std::mutex> lock_guard(queue.mutex);
+        if (queue.tasks.empty()) continue;
+
+        if (victim == thread_index)
+        {
+            index = queue.tasks.back();
+            queue.tasks.pop_back();
+        }
+        else
+        {
+            index = queue.tasks.front();
+            queue.tasks.pop_front();
+        }
+        found = true;
+    }
+    if (!found) return false;
+
+    (*m_task)(index, thread_index);
+    if (m_remaining_task_count.fetch_sub(1) == 1)
+    {
+        std::unique_lock<std::mutex> lock_guard(m_mutex);
+        m_finished_condition.notify_all();
+    }
+    return true;
+}
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace rhi
+{
+// Worker threads with one task queue each, meant for short tasks of uneven cost such as recording command lists.
+// Every thread takes tasks from the back of its own queue and steals from the front of the others once it ran out.
+class Work_Stealing_Pool
+{
+public:
+    explicit Work_Stealing_Pool(uint32_t worker_count);
+    ~Work_Stealing_Pool() noexcept;
+
+    Work_Stealing_Pool(const Work_Stealing_Pool&) = delete;
+    Work_Stealing_Pool& operator=(const Work_Stealing_Pool&) = delete;
+
+    // Calls `task(index, thread_index)` for every index below `task_count` and returns once all calls finished.
+    // The calling thread helps with thread index zero, the workers use the indices up to `get_thread_count`.
+    // Must not be called from multiple threads at once.
+    void run(uint32_t task_count, const std::function<void(uint32_t, uint32_t)>& task) noexcept;
+    // Includes the thread calling `run`.
+    [[nodiscard]] uint32_t get_thread_count() const noexcept;
+
+private:
+    struct Task_Queue
+    {
+        std::mutex mutex;
+        std::deque<uint32_t> tasks;
+    };
+
+    void work(uint32_t thread_index) noexcept;
+    // Returns false if every queue was empty.
+    bool execute_task(uint32_t thread_index) noexcept;
+
+private:
+    std::vector<std::unique_ptr<Task_Queue>> m_queues;
+    std::mutex m_mutex;
+    std::condition_variable m_condition;
+    std::condition_variable m_finished_condition;
+    const std::function<void(uint32_t, uint32_t)>* m_task;
+    uint64_t m_generation;
+    std::atomic<uint32_t> m_remaining_task_count;
+    bool m_is_stopping;
+    std::vector<std::thread> m_threads;
+};
+}
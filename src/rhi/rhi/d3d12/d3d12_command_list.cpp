@@ -3,8 +3,12 @@
 #include "rhi/d3d12/d3d12_command_list.hpp"
 #include "rhi/d3d12/d3d12_graphics_device.hpp"
 #include "rhi/d3d12/d3d12_resource.hpp"
+#include "rhi/common/flag_translation_table.hpp"
+#include "rhi/common/scratch_array.hpp"
 
+#include <algorithm>
 #include <array>
+#include <iterator>
 #include <vector>
 #include <WinPixEventRuntime/pix3.h>
 
@@ -107,150 +111,91 @@ auto translate_barrier_Image_layout(
     }
 }
 
+constexpr static auto D3D12_PIPELINE_STAGE_TRANSLATION_TABLE = Flag_Translation_Table<Barrier_Pipeline_Stage, D3D12_BARRIER_SYNC>(
+    std::to_array<Flag_Translation<Barrier_Pipeline_Stage, D3D12_BARRIER_SYNC>>({
+        { Barrier_Pipeline_Stage::Draw_Indirect, D3D12_BARRIER_SYNC_EXECUTE_INDIRECT },
+        { Barrier_Pipeline_Stage::Vertex_Input, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Vertex_Shader, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Hull_Shader, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Domain_Shader, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Geometry_Shader, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Pixel_Shader, D3D12_BARRIER_SYNC_PIXEL_SHADING },
+        { Barrier_Pipeline_Stage::Early_Fragment_Tests, D3D12_BARRIER_SYNC_DEPTH_STENCIL },
+        { Barrier_Pipeline_Stage::Late_Fragment_Tests, D3D12_BARRIER_SYNC_DEPTH_STENCIL },
+        { Barrier_Pipeline_Stage::Color_Attachment_Output, D3D12_BARRIER_SYNC_RENDER_TARGET },
+        { Barrier_Pipeline_Stage::Compute_Shader, D3D12_BARRIER_SYNC_COMPUTE_SHADING },
+        { Barrier_Pipeline_Stage::All_Transfer,
+            D3D12_BARRIER_SYNC_COPY |
+            D3D12_BARRIER_SYNC_RESOLVE |
+            D3D12_BARRIER_SYNC_COPY_RAYTRACING_ACCELERATION_STRUCTURE |
+            D3D12_BARRIER_SYNC_RENDER_TARGET },
+        { Barrier_Pipeline_Stage::Host, D3D12_BARRIER_SYNC_NONE },
+        { Barrier_Pipeline_Stage::All_Graphics, D3D12_BARRIER_SYNC_DRAW | D3D12_BARRIER_SYNC_EXECUTE_INDIRECT },
+        { Barrier_Pipeline_Stage::All_Commands, D3D12_BARRIER_SYNC_ALL },
+        { Barrier_Pipeline_Stage::Copy, D3D12_BARRIER_SYNC_COPY },
+        { Barrier_Pipeline_Stage::Resolve, D3D12_BARRIER_SYNC_RESOLVE },
+        { Barrier_Pipeline_Stage::Blit, D3D12_BARRIER_SYNC_RENDER_TARGET },
+        { Barrier_Pipeline_Stage::Clear, D3D12_BARRIER_SYNC_RENDER_TARGET },
+        { Barrier_Pipeline_Stage::Index_Input, D3D12_BARRIER_SYNC_INDEX_INPUT },
+        { Barrier_Pipeline_Stage::Vertex_Attribute_Input, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Pre_Rasterization_Stages, D3D12_BARRIER_SYNC_NON_PIXEL_SHADING },
+        { Barrier_Pipeline_Stage::Video_Decode, D3D12_BARRIER_SYNC_VIDEO_DECODE },
+        { Barrier_Pipeline_Stage::Video_Encode, D3D12_BARRIER_SYNC_VIDEO_ENCODE },
+        { Barrier_Pipeline_Stage::Acceleration_Structure_Build, D3D12_BARRIER_SYNC_BUILD_RAYTRACING_ACCELERATION_STRUCTURE },
+        { Barrier_Pipeline_Stage::Ray_Tracing_Shader, D3D12_BARRIER_SYNC_RAYTRACING },
+        { Barrier_Pipeline_Stage::Amplification_Shader, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Mesh_Shader, D3D12_BARRIER_SYNC_VERTEX_SHADING },
+        { Barrier_Pipeline_Stage::Acceleration_Structure_Copy, D3D12_BARRIER_SYNC_COPY_RAYTRACING_ACCELERATION_STRUCTURE }
+    }));
+
+constexpr static auto D3D12_ACCESS_TRANSLATION_TABLE = Flag_Translation_Table<Barrier_Access, D3D12_BARRIER_ACCESS>(
+    std::to_array<Flag_Translation<Barrier_Access, D3D12_BARRIER_ACCESS>>({
+        { Barrier_Access::Indirect_Command_Read, D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT },
+        { Barrier_Access::Index_Read, D3D12_BARRIER_ACCESS_INDEX_BUFFER },
+        { Barrier_Access::Vertex_Attribute_Read, D3D12_BARRIER_ACCESS_VERTEX_BUFFER },
+        { Barrier_Access::Constant_Buffer_View, D3D12_BARRIER_ACCESS_CONSTANT_BUFFER },
+        { Barrier_Access::Shader_Read, D3D12_BARRIER_ACCESS_SHADER_RESOURCE },
+        { Barrier_Access::Shader_Write, D3D12_BARRIER_ACCESS_SHADER_RESOURCE },
+        { Barrier_Access::Color_Attachment_Read, D3D12_BARRIER_ACCESS_RENDER_TARGET },
+        { Barrier_Access::Color_Attachment_Write, D3D12_BARRIER_ACCESS_RENDER_TARGET },
+        { Barrier_Access::Depth_Stencil_Attachment_Read, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ },
+        { Barrier_Access::Depth_Stencil_Attachment_Write, D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE },
+        { Barrier_Access::Transfer_Read, D3D12_BARRIER_ACCESS_COPY_SOURCE },
+        { Barrier_Access::Transfer_Write, D3D12_BARRIER_ACCESS_COPY_DEST },
+        { Barrier_Access::Shader_Sampled_Read, D3D12_BARRIER_ACCESS_SHADER_RESOURCE },
+        { Barrier_Access::Unordered_Access_Read,
+            // D3D12_BARRIER_ACCESS_SHADER_RESOURCE | // Invalid
+            D3D12_BARRIER_ACCESS_UNORDERED_ACCESS },
+        { Barrier_Access::Unordered_Access_Write, D3D12_BARRIER_ACCESS_UNORDERED_ACCESS },
+        { Barrier_Access::Video_Decode_Read, D3D12_BARRIER_ACCESS_VIDEO_DECODE_READ },
+        { Barrier_Access::Video_Decode_Write, D3D12_BARRIER_ACCESS_VIDEO_DECODE_WRITE },
+        { Barrier_Access::Video_Encode_Read, D3D12_BARRIER_ACCESS_VIDEO_ENCODE_READ },
+        { Barrier_Access::Video_Encode_Write, D3D12_BARRIER_ACCESS_VIDEO_ENCODE_WRITE },
+        { Barrier_Access::Shading_Rate_Attachment, D3D12_BARRIER_ACCESS_SHADING_RATE_SOURCE },
+        { Barrier_Access::Acceleration_Structure_Read, D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_READ },
+        { Barrier_Access::Acceleration_Structure_Write, D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_WRITE }
+    }));
+
 auto translate_barrier_pipeline_stage_flags(Barrier_Pipeline_Stage stage)
 {
-    auto check_stage = [stage](auto flag)
-    {
-        return ((flag & stage) != Barrier_Pipeline_Stage::None);
-    };
-    auto apply_stages = [&](auto flag, auto d3d12_flag)
-    {
-        return check_stage(flag) ? d3d12_flag : D3D12_BARRIER_SYNC_NONE;
-    };
-    auto result = D3D12_BARRIER_SYNC_NONE;
-    result |= apply_stages(Barrier_Pipeline_Stage::Draw_Indirect,
-        D3D12_BARRIER_SYNC_EXECUTE_INDIRECT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Vertex_Input,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Vertex_Shader,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Hull_Shader,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Domain_Shader,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Geometry_Shader,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Pixel_Shader,
-        D3D12_BARRIER_SYNC_PIXEL_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Early_Fragment_Tests,
-        D3D12_BARRIER_SYNC_DEPTH_STENCIL);
-    result |= apply_stages(Barrier_Pipeline_Stage::Late_Fragment_Tests,
-        D3D12_BARRIER_SYNC_DEPTH_STENCIL);
-    result |= apply_stages(Barrier_Pipeline_Stage::Color_Attachment_Output,
-        D3D12_BARRIER_SYNC_RENDER_TARGET);
-    result |= apply_stages(Barrier_Pipeline_Stage::Compute_Shader,
-        D3D12_BARRIER_SYNC_COMPUTE_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::All_Transfer,
-        D3D12_BARRIER_SYNC_COPY |
-        D3D12_BARRIER_SYNC_RESOLVE |
-        D3D12_BARRIER_SYNC_COPY_RAYTRACING_ACCELERATION_STRUCTURE |
-        D3D12_BARRIER_SYNC_RENDER_TARGET);
-    result |= apply_stages(Barrier_Pipeline_Stage::Host,
-        D3D12_BARRIER_SYNC_NONE);
-    result |= apply_stages(Barrier_Pipeline_Stage::All_Graphics,
-        D3D12_BARRIER_SYNC_DRAW |
-        D3D12_BARRIER_SYNC_EXECUTE_INDIRECT);
-    result |= apply_stages(Barrier_Pipeline_Stage::All_Commands,
-        D3D12_BARRIER_SYNC_ALL);
-    result |= apply_stages(Barrier_Pipeline_Stage::Copy,
-        D3D12_BARRIER_SYNC_COPY);
-    result |= apply_stages(Barrier_Pipeline_Stage::Resolve,
-        D3D12_BARRIER_SYNC_RESOLVE);
-    result |= apply_stages(Barrier_Pipeline_Stage::Blit,
-        D3D12_BARRIER_SYNC_RENDER_TARGET);
-    result |= apply_stages(Barrier_Pipeline_Stage::Clear,
-        D3D12_BARRIER_SYNC_RENDER_TARGET);
-    result |= apply_stages(Barrier_Pipeline_Stage::Index_Input,
-        D3D12_BARRIER_SYNC_INDEX_INPUT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Vertex_Attribute_Input,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Pre_Rasterization_Stages,
-        D3D12_BARRIER_SYNC_NON_PIXEL_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Video_Decode,
-        D3D12_BARRIER_SYNC_VIDEO_DECODE);
-    result |= apply_stages(Barrier_Pipeline_Stage::Video_Encode,
-        D3D12_BARRIER_SYNC_VIDEO_ENCODE);
-    result |= apply_stages(Barrier_Pipeline_Stage::Acceleration_Structure_Build,
-        D3D12_BARRIER_SYNC_BUILD_RAYTRACING_ACCELERATION_STRUCTURE);
-    result |= apply_stages(Barrier_Pipeline_Stage::Ray_Tracing_Shader,
-        D3D12_BARRIER_SYNC_RAYTRACING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Amplification_Shader,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Mesh_Shader,
-        D3D12_BARRIER_SYNC_VERTEX_SHADING);
-    result |= apply_stages(Barrier_Pipeline_Stage::Acceleration_Structure_Copy,
-        D3D12_BARRIER_SYNC_COPY_RAYTRACING_ACCELERATION_STRUCTURE);
-    return result;
+    return D3D12_PIPELINE_STAGE_TRANSLATION_TABLE.translate(stage);
 }
 
 auto translate_barrier_access_flags(Barrier_Access access)
 {
-    auto check_access = [access](auto flag)
-    {
-        return ((flag & access) != Barrier_Access::None);
-    };
-    auto apply_access = [&](auto flag, auto d3d12_flag)
-    {
-        return check_access(flag) ? d3d12_flag : D3D12_BARRIER_ACCESS_COMMON;
-    };
-
     if (access == Barrier_Access::None)
     {
         return D3D12_BARRIER_ACCESS_NO_ACCESS;
     }
-
-    auto result = D3D12_BARRIER_ACCESS_COMMON;
-    result |= apply_access(Barrier_Access::Indirect_Command_Read,
-        D3D12_BARRIER_ACCESS_INDIRECT_ARGUMENT);
-    result |= apply_access(Barrier_Access::Index_Read,
-        D3D12_BARRIER_ACCESS_INDEX_BUFFER);
-    result |= apply_access(Barrier_Access::Vertex_Attribute_Read,
-        D3D12_BARRIER_ACCESS_VERTEX_BUFFER);
-    result |= apply_access(Barrier_Access::Constant_Buffer_View,
-        D3D12_BARRIER_ACCESS_CONSTANT_BUFFER);
-    result |= apply_access(Barrier_Access::Shader_Read,
-        D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
-    result |= apply_access(Barrier_Access::Shader_Write,
-        D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
-    result |= apply_access(Barrier_Access::Color_Attachment_Read,
-        D3D12_BARRIER_ACCESS_RENDER_TARGET);
-    result |= apply_access(Barrier_Access::Color_Attachment_Write,
-        D3D12_BARRIER_ACCESS_RENDER_TARGET);
-    result |= apply_access(Barrier_Access::Depth_Stencil_Attachment_Read,
-        D3D12_BARRIER_ACCESS_DEPTH_STENCIL_READ);
-    result |= apply_access(Barrier_Access::Depth_Stencil_Attachment_Write,
-        D3D12_BARRIER_ACCESS_DEPTH_STENCIL_WRITE);
-    result |= apply_access(Barrier_Access::Transfer_Read,
-        D3D12_BARRIER_ACCESS_COPY_SOURCE);
-    result |= apply_access(Barrier_Access::Transfer_Write,
-        D3D12_BARRIER_ACCESS_COPY_DEST);
-    result |= apply_access(Barrier_Access::Shader_Sampled_Read,
-        D3D12_BARRIER_ACCESS_SHADER_RESOURCE);
-    result |= apply_access(Barrier_Access::Unordered_Access_Read,
-        // D3D12_BARRIER_ACCESS_SHADER_RESOURCE | // Invalid
-        D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
-    result |= apply_access(Barrier_Access::Unordered_Access_Write,
-        D3D12_BARRIER_ACCESS_UNORDERED_ACCESS);
-    result |= apply_access(Barrier_Access::Video_Decode_Read,
-        D3D12_BARRIER_ACCESS_VIDEO_DECODE_READ);
-    result |= apply_access(Barrier_Access::Video_Decode_Write,
-        D3D12_BARRIER_ACCESS_VIDEO_DECODE_WRITE);
-    result |= apply_access(Barrier_Access::Video_Encode_Read,
-        D3D12_BARRIER_ACCESS_VIDEO_ENCODE_READ);
-    result |= apply_access(Barrier_Access::Video_Encode_Write,
-        D3D12_BARRIER_ACCESS_VIDEO_ENCODE_WRITE);
-    result |= apply_access(Barrier_Access::Shading_Rate_Attachment,
-        D3D12_BARRIER_ACCESS_SHADING_RATE_SOURCE);
-    result |= apply_access(Barrier_Access::Acceleration_Structure_Read,
-        D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_READ);
-    result |= apply_access(Barrier_Access::Acceleration_Structure_Write,
-        D3D12_BARRIER_ACCESS_RAYTRACING_ACCELERATION_STRUCTURE_WRITE);
-    return result;
+    return D3D12_ACCESS_TRANSLATION_TABLE.translate(access);
 }
 
 D3D12_Command_List::D3D12_Command_List(D3D12_Command_List_Underlying_Type cmd, D3D12_Graphics_Device* device) noexcept
     : m_cmd(cmd)
     , m_device(device)
+    , m_buffer_barrier_spill()
+    , m_texture_barrier_spill()
+    , m_global_barrier_spill()
 {
     auto type = cmd->GetType();
     switch (type)
@@ -280,20 +225,25 @@ Graphics_API D3D12_Command_List::get_graphics_api() const noexcept
     return Graphics_API::D3D12;
 }
 
-void D3D12_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
+// Larger barrier batches use the spill storage of the command list.
+constexpr static std::size_t BARRIER_INLINE_CAPACITY = 16;
+
+void D3D12_Command_List::record_barrier(const Barrier_Info& barrier_info) noexcept
 {
     uint32_t num_barrier_groups = 0;
     std::array<D3D12_BARRIER_GROUP, 3> barrier_groups = {};
-    std::vector<D3D12_BUFFER_BARRIER> buffer_barriers = {};
-    std::vector<D3D12_TEXTURE_BARRIER> texture_barriers = {};
-    std::vector<D3D12_GLOBAL_BARRIER> global_barriers = {};
+    Scratch_Array<D3D12_BUFFER_BARRIER, BARRIER_INLINE_CAPACITY> buffer_barriers(
+        barrier_info.buffer_barriers.size(), m_buffer_barrier_spill);
+    Scratch_Array<D3D12_TEXTURE_BARRIER, BARRIER_INLINE_CAPACITY> texture_barriers(
+        barrier_info.image_barriers.size(), m_texture_barrier_spill);
+    Scratch_Array<D3D12_GLOBAL_BARRIER, BARRIER_INLINE_CAPACITY> global_barriers(
+        barrier_info.memory_barriers.size(), m_global_barrier_spill);
 
     if (barrier_info.buffer_barriers.size() > 0)
     {
         auto& barrier_group = barrier_groups[num_barrier_groups];
         barrier_group.Type = D3D12_BARRIER_TYPE_BUFFER;
         barrier_group.NumBarriers = uint32_t(barrier_info.buffer_barriers.size());
-        buffer_barriers.reserve(barrier_group.NumBarriers);
         barrier_group.pBufferBarriers = buffer_barriers.data();
         for (const auto& buffer_barrier : barrier_info.buffer_barriers)
         {
@@ -316,7 +266,6 @@ void D3D12_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
         auto& barrier_group = barrier_groups[num_barrier_groups];
         barrier_group.Type = D3D12_BARRIER_TYPE_TEXTURE;
         barrier_group.NumBarriers = uint32_t(barrier_info.image_barriers.size());
-        texture_barriers.reserve(barrier_group.NumBarriers);
         barrier_group.pTextureBarriers = texture_barriers.data();
 
         for (const auto& texture_barrier : barrier_info.image_barriers)
@@ -353,7 +302,10 @@ void D3D12_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
             texture_barriers.push_back(D3D12_TEXTURE_BARRIER{
                 .SyncBefore = translate_barrier_pipeline_stage_flags(texture_barrier.stage_before),
                 .SyncAfter = translate_barrier_pipeline_stage_flags(texture_barrier.stage_after),
-                .AccessBefore = translate_barrier_access_flags(texture_barrier.access_before),
+                // D3D12 rejects accesses before an undefined layout.
+                .AccessBefore = layout_before == D3D12_BARRIER_LAYOUT_UNDEFINED
+                    ? D3D12_BARRIER_ACCESS_NO_ACCESS
+                    : translate_barrier_access_flags(texture_barrier.access_before),
                 .AccessAfter = translate_barrier_access_flags(texture_barrier.access_after),
                 .LayoutBefore = layout_before,
                 .LayoutAfter = layout_after,
@@ -380,7 +332,6 @@ void D3D12_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
         auto& barrier_group = barrier_groups[num_barrier_groups];
         barrier_group.Type = D3D12_BARRIER_TYPE_GLOBAL;
         barrier_group.NumBarriers = uint32_t(barrier_info.memory_barriers.size());
-        global_barriers.reserve(barrier_group.NumBarriers);
         barrier_group.pGlobalBarriers = global_barriers.data();
         for (const auto& global_barrier : barrier_info.memory_barriers)
         {
@@ -400,11 +351,13 @@ void D3D12_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
 
 void D3D12_Command_List::dispatch(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept
 {
+    flush_barriers();
     m_cmd->Dispatch(groups_x, groups_y, groups_z);
 }
 
 void D3D12_Command_List::dispatch_indirect(Buffer* buffer, uint64_t offset) noexcept
 {
+    flush_barriers();
     if (!buffer) return;
 
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
@@ -419,6 +372,7 @@ void D3D12_Command_List::copy_buffer(
     uint64_t dst_offset,
     uint64_t size) noexcept
 {
+    flush_barriers();
     if (!src || !dst) return;
 
     auto d3d12_src = static_cast<D3D12_Buffer*>(src);
@@ -439,16 +393,18 @@ uint32_t calculate_subresource(
 void D3D12_Command_List::copy_buffer_to_image(
     Buffer* src, uint64_t src_offset,
     Image* dst, const Offset_3D& dst_offset, const Extent_3D& dst_extent,
-    uint32_t dst_mip_level, uint32_t dst_array_index) noexcept
+    uint32_t dst_mip_level, uint32_t dst_array_index, uint32_t src_row_pitch) noexcept
 {
+    flush_barriers();
     if (!src || !dst) return;
 
     const auto info = get_image_format_info(dst->format);
-    uint32_t row_pitch = dst_extent.x * info.bytes;
-    if (info.is_block_compressed)
-    {
-        row_pitch /= info.block_size_x;
-    }
+    // Footprints of block compressed images cover whole blocks, even for mips smaller than a block.
+    uint32_t footprint_width = (dst_extent.x + info.block_size_x - 1) / info.block_size_x * info.block_size_x;
+    uint32_t footprint_height = (dst_extent.y + info.block_size_y - 1) / info.block_size_y * info.block_size_y;
+    uint32_t row_pitch = src_row_pitch > 0
+        ? src_row_pitch
+        : footprint_width / info.block_size_x * info.bytes;
 
     D3D12_TEXTURE_COPY_LOCATION copy_src = {
         .pResource = static_cast<D3D12_Buffer*>(src)->resource,
@@ -457,8 +413,8 @@ void D3D12_Command_List::copy_buffer_to_image(
             .Offset = src_offset,
             .Footprint = {
                 .Format = translate_format(dst->format),
-                .Width = dst_extent.x,
-                .Height = dst_extent.y,
+                .Width = footprint_width,
+                .Height = footprint_height,
                 .Depth = dst_extent.z,
                 .RowPitch = row_pitch
             }
@@ -482,6 +438,7 @@ void D3D12_Command_List::copy_image(
     Image* dst, const Offset_3D& dst_offset, uint32_t dst_mip_level, uint32_t dst_array_index,
     const Extent_3D& extent) noexcept
 {
+    flush_barriers();
     if (!src || !dst) return;
 
     D3D12_TEXTURE_COPY_LOCATION copy_src = {
@@ -516,6 +473,7 @@ void D3D12_Command_List::copy_image_to_buffer(
     uint32_t src_mip_level, uint32_t src_array_index,
     Buffer* dst, uint64_t dst_offset) noexcept
 {
+    flush_barriers();
     if (!src || !dst) return;
 
     const auto info = get_image_format_info(src->format);
@@ -562,6 +520,7 @@ void D3D12_Command_List::copy_image_to_buffer(
 
 void D3D12_Command_List::fill_buffer(Buffer_View* dst, uint32_t value) noexcept
 {
+    flush_barriers();
     if (!dst || !dst->buffer) return;
 
     auto d3d12_dst = static_cast<D3D12_Buffer*>(dst->buffer);
@@ -609,6 +568,7 @@ void D3D12_Command_List::end_debug_region() noexcept
 
 void D3D12_Command_List::clear_color_attachment(Image_View* image, float r, float g, float b, float a) noexcept
 {
+    flush_barriers();
     float rgba[] = {r,g,b,a};
     m_cmd->ClearRenderTargetView(
         m_device->get_cpu_descriptor_handle(
@@ -619,6 +579,7 @@ void D3D12_Command_List::clear_color_attachment(Image_View* image, float r, floa
 
 void D3D12_Command_List::clear_depth_stencil_attachment(Image_View* image, float d, uint8_t s) noexcept
 {
+    flush_barriers();
     m_cmd->ClearDepthStencilView(
         m_device->get_cpu_descriptor_handle(
             static_cast<D3D12_Image_View*>(image)->rtv_dsv_index,
@@ -633,11 +594,13 @@ void D3D12_Command_List::draw(
     uint32_t vertex_offset,
     uint32_t instance_offset) noexcept
 {
+    flush_barriers();
     m_cmd->DrawInstanced(vertex_count, instance_count, vertex_offset, instance_offset);
 }
 
 void D3D12_Command_List::draw_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
 {
+    flush_barriers();
     if (!buffer) return;
 
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
@@ -652,6 +615,7 @@ void D3D12_Command_List::draw_indirect_count(
     Buffer* count_buffer,
     uint64_t count_offset) noexcept
 {
+    flush_barriers();
     if (!buffer || !count_buffer) return;
 
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
@@ -660,6 +624,12 @@ void D3D12_Command_List::draw_indirect_count(
         max_draw_count, d3d12_buffer->resource, offset, d3d12_count_buffer->resource, count_offset);
 }
 
+void D3D12_Command_List::execute_secondary(Command_List* command_list) noexcept
+{
+    flush_barriers();
+    m_cmd->ExecuteBundle(static_cast<D3D12_Command_List*>(command_list)->get_internal_command_list());
+}
+
 void D3D12_Command_List::draw_indexed(
     uint32_t index_count,
     uint32_t instance_count,
@@ -667,11 +637,13 @@ void D3D12_Command_List::draw_indexed(
     uint32_t vertex_offset,
     uint32_t instance_offset) noexcept
 {
+    flush_barriers();
     m_cmd->DrawIndexedInstanced(index_count, instance_count, index_offset, vertex_offset, instance_offset);
 }
 
 void D3D12_Command_List::draw_indexed_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
 {
+    flush_barriers();
     if (!buffer) return;
 
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
@@ -686,6 +658,7 @@ void D3D12_Command_List::draw_indexed_indirect_count(
     Buffer* count_buffer,
     uint64_t count_offset) noexcept
 {
+    flush_barriers();
     if (!buffer || !count_buffer) return;
 
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
@@ -696,11 +669,13 @@ void D3D12_Command_List::draw_indexed_indirect_count(
 
 void D3D12_Command_List::draw_mesh_tasks(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept
 {
+    flush_barriers();
     m_cmd->DispatchMesh(groups_x, groups_y, groups_z);
 }
 
 void D3D12_Command_List::draw_mesh_tasks_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
 {
+    flush_barriers();
     if (!buffer) return;
 
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
@@ -715,6 +690,7 @@ void D3D12_Command_List::draw_mesh_tasks_indirect_count(
     Buffer* count_buffer,
     uint64_t count_offset) noexcept
 {
+    flush_barriers();
     if (!buffer || !count_buffer) return;
 
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
@@ -819,6 +795,7 @@ D3D12_CPU_DESCRIPTOR_HANDLE get_rtv_dsv_cpu_descriptor_handle_safe(
 
 void D3D12_Command_List::begin_render_pass(const Render_Pass_Begin_Info& begin_info) noexcept
 {
+    flush_barriers();
     uint32_t render_target_count = uint32_t(begin_info.color_attachments.size());
     std::array<D3D12_RENDER_PASS_RENDER_TARGET_DESC,
         PIPELINE_COLOR_ATTACHMENTS_MAX> render_pass_render_targets = {};
@@ -865,6 +842,7 @@ void D3D12_Command_List::begin_render_pass(const Render_Pass_Begin_Info& begin_i
 
 void D3D12_Command_List::end_render_pass() noexcept
 {
+    flush_barriers();
     m_cmd->EndRenderPass();
 }
 
@@ -1028,6 +1006,11 @@ void D3D12_Command_List::set_stencil_reference(uint8_t reference) noexcept
     m_cmd->OMSetStencilRef(reference);
 }
 
+void D3D12_Command_List::reset() noexcept
+{
+    reset_barrier_batching();
+}
+
 ID3D12GraphicsCommandList7* D3D12_Command_List::get_internal_command_list() const noexcept
 {
     return m_cmd;
@@ -1036,6 +1019,7 @@ ID3D12GraphicsCommandList7* D3D12_Command_List::get_internal_command_list() cons
 void D3D12_Command_List::build_acceleration_structure(
     const Acceleration_Structure_Build_Geometry_Info& build_info, uint64_t scratch_memory_address) noexcept
 {
+    flush_barriers();
     D3D12_BUILD_RAYTRACING_ACCELERATION_STRUCTURE_INPUTS inputs = {
         .Flags = std::bit_cast<D3D12_RAYTRACING_ACCELERATION_STRUCTURE_BUILD_FLAGS>(build_info.flags),
         .NumDescs = build_info.geometry_or_instance_count,
@@ -1114,6 +1098,7 @@ void D3D12_Command_List::build_acceleration_structure(
 
 void D3D12_Command_List::dispatch_rays(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z, const Shader_Binding_Table& sbt) noexcept
 {
+    flush_barriers();
     D3D12_DISPATCH_RAYS_DESC dispatch_rays_desc = {
         .RayGenerationShaderRecord = {
             .StartAddress = sbt.ray_gen.gpu_address,
@@ -1165,38 +1150,60 @@ D3D12_Command_Pool::D3D12_Command_Pool(
     const Command_Pool_Create_Info& create_info) noexcept
     : m_type(translate_command_list_type(create_info.queue_type))
     , m_device(device)
-    , m_unused()
+    , m_use_mutex(create_info.thread_safe)
+    , m_mutex()
+    , m_allocators()
+    , m_command_lists()
     , m_used()
+    , m_unused()
+    , m_secondary_allocators()
+    , m_secondary_command_lists()
 {}
 
 D3D12_Command_Pool::~D3D12_Command_Pool() noexcept
 {
-    reset();
-    for (auto cmd_alloc : m_unused)
+    for (auto cmd_alloc : m_allocators)
     {
         cmd_alloc.cmd->Release();
         cmd_alloc.alloc->Release();
     }
-    for (auto cmd_alloc : m_used)
+    for (auto cmd_alloc : m_secondary_allocators)
     {
         cmd_alloc.cmd->Release();
         cmd_alloc.alloc->Release();
     }
     m_command_lists.clear();
+    m_secondary_command_lists.clear();
 }
 
 void D3D12_Command_Pool::reset() noexcept
 {
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    // Only allocators that recorded since the last reset hold memory worth releasing.
+    for (auto index : m_used)
+    {
+        m_allocators[index].alloc->Reset();
+        m_command_lists[index].reset();
+    }
     m_unused.insert(m_unused.end(), m_used.begin(), m_used.end());
     m_used.clear();
-    m_command_lists.clear();
 }
 
 Command_List* D3D12_Command_Pool::acquire_command_list() noexcept
 {
-    auto cmd_alloc = D3D12_Command_List_Allocator{};
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    uint32_t index = 0;
     if (m_unused.empty())
     {
+        auto cmd_alloc = D3D12_Command_List_Allocator{};
         m_device->get_context()->device->CreateCommandList1(
             0,
             m_type,
@@ -1204,14 +1211,24 @@ Command_List* D3D12_Command_Pool::acquire_command_list() noexcept
             IID_PPV_ARGS(&cmd_alloc.cmd));
         m_device->get_context()->device->CreateCommandAllocator(
             m_type, IID_PPV_ARGS(&cmd_alloc.alloc));
+        index = uint32_t(m_allocators.size());
+        m_allocators.push_back(cmd_alloc);
+        m_command_lists.emplace_back(cmd_alloc.cmd, m_device);
     }
     else
     {
-        cmd_alloc = m_unused.back();
+        index = m_unused.back();
         m_unused.pop_back();
     }
-    m_used.push_back(cmd_alloc);
-    cmd_alloc.alloc->Reset();
+    m_used.push_back(index);
+    // The list owns its allocator, recording it does not need the lock.
+    auto cmd_alloc = m_allocators[index];
+    auto command_list = &m_command_lists[index];
+    if (m_use_mutex)
+    {
+        lock_guard.unlock();
+    }
+
     cmd_alloc.cmd->Reset(cmd_alloc.alloc, nullptr);
     auto context = m_device->get_context();
     auto descriptor_heaps = std::to_array({
@@ -1227,6 +1244,62 @@ Command_List* D3D12_Command_Pool::acquire_command_list() noexcept
             cmd_alloc.cmd->SetGraphicsRootSignature(context->bindless_root_signature);
         }
     }
-    return m_command_lists.emplace_back(std::make_unique<D3D12_Command_List>(cmd_alloc.cmd, m_device)).get();
+    return command_list;
+}
+
+Command_List* D3D12_Command_Pool::create_secondary_command_list(
+    [[maybe_unused]] const Secondary_Command_List_Create_Info& create_info) noexcept
+{
+    // Bundles do not need the render pass formats.
+    auto cmd_alloc = D3D12_Command_List_Allocator{};
+    m_device->get_context()->device->CreateCommandList1(
+        0,
+        D3D12_COMMAND_LIST_TYPE_BUNDLE,
+        D3D12_COMMAND_LIST_FLAG_NONE,
+        IID_PPV_ARGS(&cmd_alloc.cmd));
+    m_device->get_context()->device->CreateCommandAllocator(
+        D3D12_COMMAND_LIST_TYPE_BUNDLE, IID_PPV_ARGS(&cmd_alloc.alloc));
+    cmd_alloc.cmd->Reset(cmd_alloc.alloc, nullptr);
+
+    // The heaps have to match the ones of the executing list.
+    auto context = m_device->get_context();
+    auto descriptor_heaps = std::to_array({
+        context->resource_descriptor_heap,
+        context->sampler_descriptor_heap
+        });
+    cmd_alloc.cmd->SetDescriptorHeaps(uint32_t(descriptor_heaps.size()), descriptor_heaps.data());
+    cmd_alloc.cmd->SetComputeRootSignature(context->bindless_root_signature);
+    cmd_alloc.cmd->SetGraphicsRootSignature(context->bindless_root_signature);
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    m_secondary_allocators.push_back(cmd_alloc);
+    return m_secondary_command_lists.emplace_back(std::make_unique<D3D12_Command_List>(cmd_alloc.cmd, m_device)).get();
+}
+
+void D3D12_Command_Pool::end_secondary_command_list(Command_List* command_list) noexcept
+{
+    static_cast<D3D12_Command_List*>(command_list)->get_internal_command_list()->Close();
+}
+
+void D3D12_Command_Pool::destroy_secondary_command_list(Command_List* command_list) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    auto secondary_command_list = std::ranges::find_if(m_secondary_command_lists,
+        [command_list](const auto& secondary_command_list) { return secondary_command_list.get() == command_list; });
+    if (secondary_command_list == m_secondary_command_lists.end()) return;
+
+    auto index = std::distance(m_secondary_command_lists.begin(), secondary_command_list);
+    m_secondary_allocators[index].cmd->Release();
+    m_secondary_allocators[index].alloc->Release();
+    m_secondary_allocators.erase(m_secondary_allocators.begin() + index);
+    m_secondary_command_lists.erase(secondary_command_list);
 }
 }
@@ -3,7 +3,10 @@
 #include "rhi/command_list.hpp"
 
 #include <agility_sdk/d3d12.h>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <vector>
 
 namespace rhi::d3d12
 {
@@ -23,10 +26,7 @@ public:
     D3D12_Command_List(D3D12_Command_List_Underlying_Type cmd, D3D12_Graphics_Device* device) noexcept;
 
     // Meta commands
-    virtual [[nodiscard]] Graphics_API get_graphics_api() const noexcept override;
-
-    // Barrier commands
-    virtual void barrier(const Barrier_Info& barrier_info) noexcept override;
+    [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept override;
 
     // Compute commands
     virtual void dispatch(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept override;
@@ -37,7 +37,7 @@ public:
     virtual void copy_buffer_to_image(
         Buffer* src, uint64_t src_offset,
         Image* dst, const Offset_3D& dst_offset, const Extent_3D& dst_extent,
-        uint32_t dst_mip_level, uint32_t dst_array_index) noexcept override;
+        uint32_t dst_mip_level, uint32_t dst_array_index, uint32_t src_row_pitch = 0) noexcept override;
     virtual void copy_image(
         Image* src, const Offset_3D& src_offset, uint32_t src_mip_level, uint32_t src_array_index,
         Image* dst, const Offset_3D& dst_offset, uint32_t dst_mip_level, uint32_t dst_array_index,
@@ -65,6 +65,7 @@ public:
     virtual void draw_mesh_tasks(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept override;
     virtual void draw_mesh_tasks_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept override;
     virtual void draw_mesh_tasks_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept override;
+    virtual void execute_secondary(Command_List* command_list) noexcept override;
 
     // State commands
     virtual void begin_render_pass(const Render_Pass_Begin_Info& begin_info) noexcept override;
@@ -82,12 +83,21 @@ public:
         const Acceleration_Structure_Build_Geometry_Info& build_info, uint64_t scratch_memory_address) noexcept override;
     virtual void dispatch_rays(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z, const Shader_Binding_Table& sbt) noexcept override;
 
+    // Called by the pool once the GPU is done with the list.
+    void reset() noexcept;
+
     [[nodiscard]] D3D12_Command_List_Underlying_Type get_internal_command_list() const noexcept;
 
+protected:
+    virtual void record_barrier(const Barrier_Info& barrier_info) noexcept override;
+
 private:
     D3D12_Command_List_Underlying_Type m_cmd;
     D3D12_Graphics_Device* m_device;
-
+    // Reused by every `barrier` call that does not fit into the inline storage.
+    std::vector<D3D12_BUFFER_BARRIER> m_buffer_barrier_spill;
+    std::vector<D3D12_TEXTURE_BARRIER> m_texture_barrier_spill;
+    std::vector<D3D12_GLOBAL_BARRIER> m_global_barrier_spill;
 };
 
 class D3D12_Command_Pool final : public Command_Pool
@@ -99,11 +109,23 @@ public:
     virtual void reset() noexcept override;
     virtual Command_List* acquire_command_list() noexcept override;
 
+    virtual Command_List* create_secondary_command_list(const Secondary_Command_List_Create_Info& create_info) noexcept override;
+    virtual void end_secondary_command_list(Command_List* command_list) noexcept override;
+    virtual void destroy_secondary_command_list(Command_List* command_list) noexcept override;
+
 private:
     D3D12_COMMAND_LIST_TYPE m_type;
     D3D12_Graphics_Device* m_device;
-    std::vector<D3D12_Command_List_Allocator> m_used;
-    std::vector<D3D12_Command_List_Allocator> m_unused;
-    std::vector<std::unique_ptr<D3D12_Command_List>> m_command_lists;
+    bool m_use_mutex;
+    std::mutex m_mutex;
+    // Lists are created once and reused with their allocator, both stored at the same index.
+    // The deque keeps the addresses of the lists stable.
+    std::vector<D3D12_Command_List_Allocator> m_allocators;
+    std::deque<D3D12_Command_List> m_command_lists;
+    std::vector<uint32_t> m_used;
+    std::vector<uint32_t> m_unused;
+    // Every bundle owns its allocator, stored at the same index.
+    std::vector<D3D12_Command_List_Allocator> m_secondary_allocators;
+    std::vector<std::unique_ptr<D3D12_Command_List>> m_secondary_command_lists;
 };
 }
@@ -4,6 +4,11 @@
 #include "rhi/d3d12/d3d12_swapchain.hpp"
 #include "rhi/d3d12/d3d12_pso.hpp"
 #include "rhi/d3d12/d3d12_descriptor_util.hpp"
+#include "rhi/shader_archive.hpp"
+#include "rhi/shader_container.hpp"
+#include "rhi/common/pipeline_cache_file.hpp"
+#include "rhi/common/pipeline_hash.hpp"
+#include "rhi/common/pipeline_reflection.hpp"
 
 #include <D3D12MemAlloc.h>
 #include <dxgidebug.h>
@@ -355,6 +360,12 @@ D3D12_Graphics_Device::D3D12_Graphics_Device(const Graphics_Device_Create_Info&
     , m_direct_queue_mutex()
     , m_compute_queue_mutex()
     , m_copy_queue_mutex()
+    , m_deferred_destruction_queue()
+    , m_pipeline_registry()
+    , m_pipeline_compiler([this](Pipeline* pipeline) { return compile_pipeline(static_cast<D3D12_Pipeline*>(pipeline)); })
+    , m_pipeline_library_mutex()
+    , m_pipeline_library(nullptr)
+    , m_pipeline_library_data()
     , m_fences()
     , m_buffers()
     , m_buffer_views()
@@ -363,10 +374,10 @@ D3D12_Graphics_Device::D3D12_Graphics_Device(const Graphics_Device_Create_Info&
     , m_samplers()
     , m_shader_blobs()
     , m_pipelines()
-    , m_resource_descriptor_indices()
-    , m_sampler_descriptor_indices()
-    , m_rtv_descriptor_indices()
-    , m_dsv_descriptor_indices()
+    , m_resource_descriptor_indices(MAX_RESOURCE_INDEX - create_info.reserved_bindless_resource_index_count, 2)
+    , m_sampler_descriptor_indices(MAX_SAMPLER_INDEX - create_info.reserved_bindless_sampler_index_count)
+    , m_rtv_descriptor_indices(MAX_RTV_DSV_DESCRIPTORS)
+    , m_dsv_descriptor_indices(MAX_RTV_DSV_DESCRIPTORS)
 {
     D3D12_Context_Create_Info context_create_info = {
         .enable_validation = create_info.enable_validation,
@@ -393,33 +404,15 @@ D3D12_Graphics_Device::D3D12_Graphics_Device(const Graphics_Device_Create_Info&
     m_descriptor_increment_sizes = acquire_descriptor_increment_sizes();
     m_indirect_signatures = create_execute_indirect_signatures();
 
-    m_max_dynamic_resource_index = MAX_RESOURCE_INDEX - create_info.reserved_bindless_resource_index_count;
-    m_max_dynamic_sampler_index = MAX_SAMPLER_INDEX - create_info.reserved_bindless_sampler_index_count;
-
-    m_resource_descriptor_indices.reserve(m_max_dynamic_resource_index);
-    for (auto i = static_cast<int32_t>(m_max_dynamic_resource_index) - 1; i >= 0; --i)
-    {
-        m_resource_descriptor_indices.push_back(uint32_t(i * 2));
-    }
-    m_sampler_descriptor_indices.reserve(m_max_dynamic_sampler_index);
-    for (auto i = static_cast<int32_t>(m_max_dynamic_sampler_index) - 1; i >= 0; --i)
-    {
-        m_sampler_descriptor_indices.push_back(uint32_t(i));
-    }
-    m_rtv_descriptor_indices.reserve(MAX_RTV_DSV_DESCRIPTORS);
-    for (auto i = static_cast<int32_t>(MAX_RTV_DSV_DESCRIPTORS) - 1; i >= 0; --i)
-    {
-        m_rtv_descriptor_indices.push_back(uint32_t(i));
-    }
-    m_dsv_descriptor_indices.reserve(MAX_RTV_DSV_DESCRIPTORS);
-    for (auto i = static_cast<int32_t>(MAX_RTV_DSV_DESCRIPTORS) - 1; i >= 0; --i)
+    if (FAILED(m_context.device->CreatePipelineLibrary(nullptr, 0, IID_PPV_ARGS(&m_pipeline_library))))
     {
-        m_dsv_descriptor_indices.push_back(uint32_t(i));
+        m_pipeline_library = nullptr;
     }
 }
 
 D3D12_Graphics_Device::~D3D12_Graphics_Device() noexcept
 {
+    m_pipeline_compiler.shutdown();
     await_context(&m_context);
 
     // Release everything that was not released by the user
@@ -440,6 +433,10 @@ D3D12_Graphics_Device::~D3D12_Graphics_Device() noexcept
             image.allocation->Release();
         }
     }
+    for (auto& memory_heap : m_memory_heaps)
+    {
+        memory_heap.allocation->Release();
+    }
     for (auto& pipeline : m_pipelines)
     {
         if (pipeline.type == Pipeline_Type::Ray_Tracing)
@@ -458,6 +455,10 @@ D3D12_Graphics_Device::~D3D12_Graphics_Device() noexcept
         }
     }
 
+    if (m_pipeline_library)
+    {
+        m_pipeline_library->Release();
+    }
     m_indirect_signatures.draw_indirect->Release();
     m_indirect_signatures.draw_indexed_indirect->Release();
     m_indirect_signatures.draw_mesh_tasks_indirect->Release();
@@ -561,14 +562,8 @@ bool should_create_buffer_uav(D3D12_Buffer* buffer) noexcept
     return create_uav;
 }
 
-std::expected<Buffer*, Result> D3D12_Graphics_Device::create_buffer(const Buffer_Create_Info& create_info, uint32_t index) noexcept
+D3D12_RESOURCE_DESC1 make_buffer_resource_desc(const Buffer_Create_Info& create_info) noexcept
 {
-    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
-    if (m_use_mutex)
-    {
-        lock_guard.lock();
-    }
-
     D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_USE_TIGHT_ALIGNMENT;
     if (create_info.heap == Memory_Heap_Type::GPU ||
         create_info.heap == Memory_Heap_Type::CPU_Visible_GPU)
@@ -581,7 +576,7 @@ std::expected<Buffer*, Result> D3D12_Graphics_Device::create_buffer(const Buffer
         flags |= D3D12_RESOURCE_FLAG_RAYTRACING_ACCELERATION_STRUCTURE;
     }
 
-    D3D12_RESOURCE_DESC1 resource_desc = {
+    return {
         .Dimension = D3D12_RESOURCE_DIMENSION_BUFFER,
         .Alignment = 0,
         .Width = create_info.size,
@@ -594,24 +589,44 @@ std::expected<Buffer*, Result> D3D12_Graphics_Device::create_buffer(const Buffer
         .Flags = flags,
         .SamplerFeedbackMipRegion = {}
     };
-    D3D12MA::ALLOCATION_DESC allocation_desc = {
-        .Flags = D3D12MA::ALLOCATION_FLAG_NONE,
-        .HeapType = d3d12_cast<D3D12_HEAP_TYPE>(create_info.heap),
-        .ExtraHeapFlags = D3D12_HEAP_FLAG_NONE,
-        .CustomPool = nullptr,
-        .pPrivateData = nullptr
-    };
+}
+
+std::expected<Buffer*, Result> D3D12_Graphics_Device::create_buffer(const Buffer_Create_Info& create_info, uint32_t index) noexcept
+{
+    return create_buffer_in_memory(create_info, index, nullptr, 0);
+}
+
+std::expected<Buffer*, Result> D3D12_Graphics_Device::create_buffer_in_memory(
+    const Buffer_Create_Info& create_info, uint32_t index, D3D12_Memory_Heap* memory_heap, uint64_t offset) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto resource_desc = make_buffer_resource_desc(create_info);
     D3D12MA::Allocation* allocation = nullptr;
     ID3D12Resource2* resource = nullptr;
 
-    auto result = result_from_hresult(m_allocator->CreateResource3(
-        &allocation_desc, &resource_desc, D3D12_BARRIER_LAYOUT_UNDEFINED,
-        nullptr, 0, nullptr, &allocation, IID_PPV_ARGS(&resource)));
+    auto result = create_resource(
+        resource_desc, d3d12_cast<D3D12_HEAP_TYPE>(create_info.heap), memory_heap, offset, &allocation, &resource);
     if (result != Result::Success)
     {
         return std::unexpected(result);
     }
 
+    auto bindless_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    if (bindless_index == NO_RESOURCE_INDEX)
+    {
+        resource->Release();
+        if (allocation)
+        {
+            allocation->Release();
+        }
+        return std::unexpected(Result::Error_Out_Of_Descriptors);
+    }
+
     void* mapped_data = nullptr;
     if (create_info.heap != Memory_Heap_Type::GPU)
     {
@@ -622,7 +637,7 @@ std::expected<Buffer*, Result> D3D12_Graphics_Device::create_buffer(const Buffer
     buffer->size = create_info.size;
     buffer->heap_type = create_info.heap;
     buffer->buffer_view = &*m_buffer_views.emplace();
-    buffer->buffer_view->bindless_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    buffer->buffer_view->bindless_index = bindless_index;
     buffer->buffer_view->size = buffer->size;
     buffer->buffer_view->offset = 0;
     buffer->buffer_view->buffer = buffer;
@@ -631,7 +646,7 @@ std::expected<Buffer*, Result> D3D12_Graphics_Device::create_buffer(const Buffer
     buffer->gpu_address = resource->GetGPUVirtualAddress();
     buffer->resource = resource;
     buffer->allocation = allocation;
-    buffer->flags = flags;
+    buffer->flags = resource_desc.Flags;
     buffer->buffer_view_linked_list_head = buffer->buffer_view;
 
     bool create_srv = should_create_buffer_srv(buffer);
@@ -658,8 +673,11 @@ std::expected<Buffer_View*, Result> D3D12_Graphics_Device::create_buffer_view(
         lock_guard.lock();
     }
 
+    auto bindless_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    if (bindless_index == NO_RESOURCE_INDEX) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
     auto buffer_view = &*m_buffer_views.emplace();
-    buffer_view->bindless_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    buffer_view->bindless_index = bindless_index;
     buffer_view->size = create_info.size;
     buffer_view->offset = create_info.offset;
     buffer_view->buffer = buffer;
@@ -675,6 +693,34 @@ std::expected<Buffer_View*, Result> D3D12_Graphics_Device::create_buffer_view(
     return buffer_view;
 }
 
+Result D3D12_Graphics_Device::update_buffer_view(
+    Buffer_View* buffer_view, const Buffer_View_Create_Info& create_info) noexcept
+{
+    if (!buffer_view) return Result::Error_Invalid_Parameters;
+
+    if (create_info.size + create_info.offset > buffer_view->buffer->size)
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    buffer_view->size = create_info.size;
+    buffer_view->offset = create_info.offset;
+
+    auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer_view->buffer);
+    bool create_srv = should_create_buffer_srv(d3d12_buffer);
+    bool create_uav = should_create_buffer_uav(d3d12_buffer);
+
+    create_buffer_view_descriptors(buffer_view, create_srv, create_uav);
+
+    return Result::Success;
+}
+
 void D3D12_Graphics_Device::destroy_buffer(Buffer* buffer) noexcept
 {
     if (!buffer) return;
@@ -688,10 +734,12 @@ void D3D12_Graphics_Device::destroy_buffer(Buffer* buffer) noexcept
     auto d3d12_buffer = static_cast<D3D12_Buffer*>(buffer);
     d3d12_buffer->resource->Release();
     d3d12_buffer->resource = nullptr;
-    d3d12_buffer->allocation->Release();
-    d3d12_buffer->allocation = nullptr;
+    if (d3d12_buffer->allocation)
+    {
+        d3d12_buffer->allocation->Release();
+        d3d12_buffer->allocation = nullptr;
+    }
 
-    release_descriptor_index(buffer->buffer_view->bindless_index, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
     auto next_buffer_view = d3d12_buffer->buffer_view_linked_list_head;
     while (next_buffer_view != nullptr)
     {
@@ -704,14 +752,8 @@ void D3D12_Graphics_Device::destroy_buffer(Buffer* buffer) noexcept
     m_buffers.erase(m_buffers.get_iterator(d3d12_buffer));
 }
 
-std::expected<Image*, Result> D3D12_Graphics_Device::create_image(const Image_Create_Info& create_info, uint32_t index) noexcept
+D3D12_RESOURCE_DESC1 make_image_resource_desc(const Image_Create_Info& create_info) noexcept
 {
-    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
-    if (m_use_mutex)
-    {
-        lock_guard.lock();
-    }
-
     D3D12_RESOURCE_FLAGS flags = D3D12_RESOURCE_FLAG_USE_TIGHT_ALIGNMENT;
     if (uint32_t(create_info.usage & Image_Usage::Color_Attachment) > 0)
     {
@@ -725,12 +767,6 @@ std::expected<Image*, Result> D3D12_Graphics_Device::create_image(const Image_Cr
     {
         flags |= D3D12_RESOURCE_FLAG_ALLOW_UNORDERED_ACCESS;
     }
-    // illegal to be both color and depth attachment.
-    if ((create_info.usage & (Image_Usage::Color_Attachment | Image_Usage::Depth_Stencil_Attachment))
-        == (Image_Usage::Color_Attachment | Image_Usage::Depth_Stencil_Attachment))
-    {
-        return std::unexpected(Result::Error_Invalid_Parameters);
-    }
 
     bool is_array_type = false;
     switch (create_info.primary_view_type)
@@ -776,7 +812,7 @@ std::expected<Image*, Result> D3D12_Graphics_Device::create_image(const Image_Cr
         break;
     }
 
-    D3D12_RESOURCE_DESC1 resource_desc = {
+    return {
         .Dimension = dimension,
         .Alignment = 0,
         .Width = create_info.width,
@@ -789,23 +825,60 @@ std::expected<Image*, Result> D3D12_Graphics_Device::create_image(const Image_Cr
         .Flags = flags,
         .SamplerFeedbackMipRegion = {}
     };
-    D3D12MA::ALLOCATION_DESC allocation_desc = {
-        .Flags = D3D12MA::ALLOCATION_FLAG_NONE,
-        .HeapType = D3D12_HEAP_TYPE_DEFAULT,
-        .ExtraHeapFlags = D3D12_HEAP_FLAG_NONE,
-        .CustomPool = nullptr,
-        .pPrivateData = nullptr
-    };
+}
+
+std::expected<Image*, Result> D3D12_Graphics_Device::create_image(const Image_Create_Info& create_info, uint32_t index) noexcept
+{
+    return create_image_in_memory(create_info, index, nullptr, 0);
+}
+
+std::expected<Image*, Result> D3D12_Graphics_Device::create_image_in_memory(
+    const Image_Create_Info& create_info, uint32_t index, D3D12_Memory_Heap* memory_heap, uint64_t offset) noexcept
+{
+    // illegal to be both color and depth attachment.
+    if ((create_info.usage & (Image_Usage::Color_Attachment | Image_Usage::Depth_Stencil_Attachment))
+        == (Image_Usage::Color_Attachment | Image_Usage::Depth_Stencil_Attachment))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto resource_desc = make_image_resource_desc(create_info);
     D3D12MA::Allocation* allocation = nullptr;
     ID3D12Resource2* resource = nullptr;
-    auto result = result_from_hresult(m_allocator->CreateResource3(
-        &allocation_desc, &resource_desc, D3D12_BARRIER_LAYOUT_UNDEFINED,
-        nullptr, 0, nullptr, &allocation, IID_PPV_ARGS(&resource)));
+    auto result = create_resource(
+        resource_desc, D3D12_HEAP_TYPE_DEFAULT, memory_heap, offset, &allocation, &resource);
     if (result != Result::Success)
     {
         return std::unexpected(result);
     }
 
+    bool is_rtv = bool(create_info.usage & Image_Usage::Color_Attachment);
+    bool is_dsv = bool(create_info.usage & Image_Usage::Depth_Stencil_Attachment);
+
+    auto bindless_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    auto rtv_dsv_index = is_rtv
+        ? create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_RTV)
+        : is_dsv
+            ? create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_DSV)
+            : ~0u;
+    if (bindless_index == NO_RESOURCE_INDEX || ((is_rtv || is_dsv) && rtv_dsv_index == NO_RESOURCE_INDEX))
+    {
+        release_descriptor_index(bindless_index, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        release_descriptor_index(rtv_dsv_index, is_rtv ? D3D12_DESCRIPTOR_HEAP_TYPE_RTV : D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+        resource->Release();
+        if (allocation)
+        {
+            allocation->Release();
+        }
+        return std::unexpected(Result::Error_Out_Of_Descriptors);
+    }
+
     auto image = &*m_images.emplace();
     image->format = create_info.format;
     image->width = create_info.width;
@@ -816,17 +889,9 @@ std::expected<Image*, Result> D3D12_Graphics_Device::create_image(const Image_Cr
     image->usage = create_info.usage;
     image->primary_view_type = create_info.primary_view_type;
     image->image_view = &*m_image_views.emplace();
-    image->image_view->bindless_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+    image->image_view->bindless_index = bindless_index;
     image->image_view->image = image;
-
-    bool is_rtv = bool(image->usage & Image_Usage::Color_Attachment);
-    bool is_dsv = bool(image->usage & Image_Usage::Depth_Stencil_Attachment);
-
-    static_cast<D3D12_Image_View*>(image->image_view)->rtv_dsv_index = is_rtv
-        ? create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_RTV)
-        : is_dsv
-            ? create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_DSV)
-            : ~0u;
+    static_cast<D3D12_Image_View*>(image->image_view)->rtv_dsv_index = rtv_dsv_index;
     // HACK: internal descriptor type should not be visible
     // TODO: overhaul how descriptor type is used
     image->image_view->descriptor_type = is_rtv
@@ -872,6 +937,140 @@ std::expected<Image*, Result> D3D12_Graphics_Device::create_image(const Image_Cr
     return image;
 }
 
+std::expected<Memory_Heap*, Result> D3D12_Graphics_Device::create_memory_heap(
+    const Memory_Heap_Create_Info& create_info) noexcept
+{
+    // Tier 1 heaps only hold buffers, render target and depth stencil images or other images.
+    if (create_info.size == 0
+        || m_context.features.options.ResourceHeapTier < D3D12_RESOURCE_HEAP_TIER_2)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    D3D12MA::ALLOCATION_DESC allocation_desc = {
+        .Flags = D3D12MA::ALLOCATION_FLAG_COMMITTED,
+        .HeapType = d3d12_cast<D3D12_HEAP_TYPE>(create_info.heap),
+        .ExtraHeapFlags = D3D12_HEAP_FLAG_NONE,
+        .CustomPool = nullptr,
+        .pPrivateData = nullptr
+    };
+    D3D12_RESOURCE_ALLOCATION_INFO allocation_info = {
+        .SizeInBytes = (create_info.size + D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1)
+            & ~uint64_t(D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT - 1),
+        .Alignment = D3D12_DEFAULT_RESOURCE_PLACEMENT_ALIGNMENT
+    };
+    D3D12MA::Allocation* allocation = nullptr;
+    auto result = result_from_hresult(m_allocator->AllocateMemory(&allocation_desc, &allocation_info, &allocation));
+    if (result != Result::Success)
+    {
+        return std::unexpected(result);
+    }
+
+    auto memory_heap = &*m_memory_heaps.emplace();
+    memory_heap->size = create_info.size;
+    memory_heap->heap_type = create_info.heap;
+    memory_heap->allocation = allocation;
+
+    return memory_heap;
+}
+
+void D3D12_Graphics_Device::destroy_memory_heap(Memory_Heap* memory_heap) noexcept
+{
+    if (!memory_heap) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto d3d12_memory_heap = static_cast<D3D12_Memory_Heap*>(memory_heap);
+    d3d12_memory_heap->allocation->Release();
+    m_memory_heaps.erase(m_memory_heaps.get_iterator(d3d12_memory_heap));
+}
+
+Memory_Requirements D3D12_Graphics_Device::get_memory_requirements(const Buffer_Create_Info& create_info) noexcept
+{
+    auto resource_desc = make_buffer_resource_desc(create_info);
+    auto allocation_info = m_context.device->GetResourceAllocationInfo2(0, 1, &resource_desc, nullptr);
+    return {
+        .size = allocation_info.SizeInBytes,
+        .alignment = allocation_info.Alignment
+    };
+}
+
+Memory_Requirements D3D12_Graphics_Device::get_memory_requirements(const Image_Create_Info& create_info) noexcept
+{
+    auto resource_desc = make_image_resource_desc(create_info);
+    auto allocation_info = m_context.device->GetResourceAllocationInfo2(0, 1, &resource_desc, nullptr);
+    return {
+        .size = allocation_info.SizeInBytes,
+        .alignment = allocation_info.Alignment
+    };
+}
+
+std::expected<Buffer*, Result> D3D12_Graphics_Device::create_placed_buffer(
+    const Buffer_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset, uint32_t index) noexcept
+{
+    if (!memory_heap || create_info.heap != memory_heap->heap_type
+        || !is_placement_valid(get_memory_requirements(create_info), memory_heap, offset))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    return create_buffer_in_memory(create_info, index, static_cast<D3D12_Memory_Heap*>(memory_heap), offset);
+}
+
+std::expected<Image*, Result> D3D12_Graphics_Device::create_placed_image(
+    const Image_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset, uint32_t index) noexcept
+{
+    if (!memory_heap || memory_heap->heap_type != Memory_Heap_Type::GPU
+        || !is_placement_valid(get_memory_requirements(create_info), memory_heap, offset))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    return create_image_in_memory(create_info, index, static_cast<D3D12_Memory_Heap*>(memory_heap), offset);
+}
+
+Result D3D12_Graphics_Device::create_resource(
+    const D3D12_RESOURCE_DESC1& resource_desc, D3D12_HEAP_TYPE heap_type,
+    D3D12_Memory_Heap* memory_heap, uint64_t offset,
+    D3D12MA::Allocation** allocation, ID3D12Resource2** resource) noexcept
+{
+    if (memory_heap)
+    {
+        *allocation = nullptr;
+        return result_from_hresult(m_allocator->CreateAliasingResource2(
+            memory_heap->allocation, offset, &resource_desc, D3D12_BARRIER_LAYOUT_UNDEFINED,
+            nullptr, 0, nullptr, IID_PPV_ARGS(resource)));
+    }
+
+    D3D12MA::ALLOCATION_DESC allocation_desc = {
+        .Flags = D3D12MA::ALLOCATION_FLAG_NONE,
+        .HeapType = heap_type,
+        .ExtraHeapFlags = D3D12_HEAP_FLAG_NONE,
+        .CustomPool = nullptr,
+        .pPrivateData = nullptr
+    };
+    return result_from_hresult(m_allocator->CreateResource3(
+        &allocation_desc, &resource_desc, D3D12_BARRIER_LAYOUT_UNDEFINED,
+        nullptr, 0, nullptr, allocation, IID_PPV_ARGS(resource)));
+}
+
+bool D3D12_Graphics_Device::is_placement_valid(
+    const Memory_Requirements& memory_requirements, Memory_Heap* memory_heap, uint64_t offset) const noexcept
+{
+    return offset % memory_requirements.alignment == 0
+        && offset + memory_requirements.size <= memory_heap->size;
+}
+
 std::expected<Image_View*, Result> D3D12_Graphics_Device::create_image_view(
     Image* image, const Image_View_Create_Info& create_info, uint32_t index) noexcept
 {
@@ -883,6 +1082,23 @@ std::expected<Image_View*, Result> D3D12_Graphics_Device::create_image_view(
         lock_guard.lock();
     }
 
+    auto descriptor_index = NO_RESOURCE_INDEX;
+    switch (create_info.descriptor_type)
+    {
+    case Descriptor_Type::Resource:
+        descriptor_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        break;
+    case Descriptor_Type::Color_Attachment:
+        descriptor_index = create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+        break;
+    case Descriptor_Type::Depth_Stencil_Attachment:
+        descriptor_index = create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+        break;
+    default:
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+    if (descriptor_index == NO_RESOURCE_INDEX) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
     auto d3d12_image = static_cast<D3D12_Image*>(image);
     auto image_view = &*m_image_views.emplace();
 
@@ -895,7 +1111,7 @@ std::expected<Image_View*, Result> D3D12_Graphics_Device::create_image_view(
     {
     case Descriptor_Type::Resource:
     {
-        image_view->bindless_index = (index != NO_RESOURCE_INDEX) ? (index * 2) : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        image_view->bindless_index = descriptor_index;
         auto srv_desc = make_texture_srv(
             translate_format(d3d12_image->format),
             d3d12_cast<D3D12_SRV_DIMENSION>(create_info.view_type),
@@ -934,7 +1150,7 @@ std::expected<Image_View*, Result> D3D12_Graphics_Device::create_image_view(
     }
     case Descriptor_Type::Color_Attachment:
     {
-        image_view->rtv_dsv_index = create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_RTV);
+        image_view->rtv_dsv_index = descriptor_index;
         auto rtv_desc = make_full_texture_rtv(
             translate_format(d3d12_image->format),
             d3d12_cast<D3D12_RTV_DIMENSION>(create_info.view_type),
@@ -949,7 +1165,7 @@ std::expected<Image_View*, Result> D3D12_Graphics_Device::create_image_view(
     }
     case Descriptor_Type::Depth_Stencil_Attachment:
     {
-        image_view->rtv_dsv_index = create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_DSV);
+        image_view->rtv_dsv_index = descriptor_index;
         auto dsv_desc = make_full_texture_dsv(
             translate_format(d3d12_image->format),
             d3d12_cast<D3D12_DSV_DIMENSION>(create_info.view_type),
@@ -981,8 +1197,11 @@ void D3D12_Graphics_Device::destroy_image(Image* image) noexcept
     auto d3d12_image = static_cast<D3D12_Image*>(image);
     d3d12_image->resource->Release();
     d3d12_image->resource = nullptr;
-    d3d12_image->allocation->Release();
-    d3d12_image->allocation = nullptr;
+    if (d3d12_image->allocation)
+    {
+        d3d12_image->allocation->Release();
+        d3d12_image->allocation = nullptr;
+    }
 
     auto next_image_view = d3d12_image->image_view_linked_list_head;
     while (next_image_view != nullptr)
@@ -1018,6 +1237,9 @@ std::expected<Sampler*, Result> D3D12_Graphics_Device::create_sampler(const Samp
         lock_guard.lock();
     }
 
+    auto descriptor_index = index != NO_RESOURCE_INDEX ? index : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
+    if (descriptor_index == NO_RESOURCE_INDEX) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
     auto sampler = &*m_samplers.emplace();
     D3D12_SAMPLER_DESC sampler_desc = {
         .Filter = d3d12_cast<D3D12_FILTER>(
@@ -1043,7 +1265,6 @@ std::expected<Sampler*, Result> D3D12_Graphics_Device::create_sampler(const Samp
         .MinLOD = create_info.min_lod,
         .MaxLOD = create_info.max_lod
     };
-    auto descriptor_index = index != NO_RESOURCE_INDEX ? index : create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
     auto dest_descriptor = get_cpu_descriptor_handle(descriptor_index, D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER);
     m_context.device->CreateSampler(&sampler_desc, dest_descriptor);
     sampler->bindless_index = descriptor_index;
@@ -1083,6 +1304,14 @@ std::expected<Acceleration_Structure*, Result> D3D12_Graphics_Device::create_acc
     auto gpu_address = d3d12_buffer->resource->GetGPUVirtualAddress();
     gpu_address += create_info.offset;
 
+    auto bindless_index = (create_info.type == Acceleration_Structure_Type::Top_Level)
+        ? create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV)
+        : NO_RESOURCE_INDEX;
+    if (create_info.type == Acceleration_Structure_Type::Top_Level && bindless_index == NO_RESOURCE_INDEX)
+    {
+        return std::unexpected(Result::Error_Out_Of_Descriptors);
+    }
+
     auto acceleration_structure = &*m_acceleration_structures.emplace();
     acceleration_structure->buffer = create_info.buffer;
     acceleration_structure->address = gpu_address;
@@ -1100,15 +1329,14 @@ std::expected<Acceleration_Structure*, Result> D3D12_Graphics_Device::create_acc
             }
         };
 
-        auto index = create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
-        auto descriptor = get_cpu_descriptor_handle(index, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
+        auto descriptor = get_cpu_descriptor_handle(bindless_index, D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV);
 
         m_context.device->CreateShaderResourceView(
             nullptr,
             &srv_desc,
             descriptor);
 
-        acceleration_structure->bindless_index = index;
+        acceleration_structure->bindless_index = bindless_index;
     }
 
     return acceleration_structure;
@@ -1143,6 +1371,9 @@ std::expected<Shader_Blob*, Result> D3D12_Graphics_Device::create_shader_blob(
         return std::unexpected(Result::Error_Invalid_Parameters);
     }
 
+    auto content_hash = hash_shader_blob_contents(
+        create_info.data, create_info.data_size, create_info.groups_x, create_info.groups_y, create_info.groups_z);
+
     std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
     if (m_use_mutex)
     {
@@ -1150,11 +1381,14 @@ std::expected<Shader_Blob*, Result> D3D12_Graphics_Device::create_shader_blob(
     }
 
     auto blob = &*m_shader_blobs.emplace();
-    blob->data.resize(create_info.data_size);
+    blob->storage.assign(
+        static_cast<const uint8_t*>(create_info.data),
+        static_cast<const uint8_t*>(create_info.data) + create_info.data_size);
+    blob->data = blob->storage;
     blob->groups_x = create_info.groups_x;
     blob->groups_y = create_info.groups_y;
     blob->groups_z = create_info.groups_z;
-    memcpy(blob->data.data(), create_info.data, create_info.data_size);
+    blob->content_hash = content_hash;
     return blob;
 }
 
@@ -1162,40 +1396,79 @@ Result D3D12_Graphics_Device::recreate_shader_blob(Shader_Blob* shader_blob, con
 {
     if (!shader_blob) return Result::Error_Invalid_Parameters;
 
-    shader_blob->data.clear();
-    shader_blob->data.resize(create_info.data_size);
+    shader_blob->storage.assign(
+        static_cast<const uint8_t*>(create_info.data),
+        static_cast<const uint8_t*>(create_info.data) + create_info.data_size);
+    shader_blob->data = shader_blob->storage;
     shader_blob->groups_x = create_info.groups_x;
     shader_blob->groups_y = create_info.groups_y;
     shader_blob->groups_z = create_info.groups_z;
-    memcpy(shader_blob->data.data(), create_info.data, create_info.data_size);
+    shader_blob->reflection = {};
+    shader_blob->content_hash = hash_shader_blob_contents(
+        shader_blob->data.data(),
+        shader_blob->data.size(),
+        shader_blob->groups_x,
+        shader_blob->groups_y,
+        shader_blob->groups_z);
 
     return Result::Success;
 }
 
-Result D3D12_Graphics_Device::recreate_shader_blob_deserialize_memory(Shader_Blob* shader_blob, void* memory) noexcept
+Result D3D12_Graphics_Device::recreate_shader_blob_deserialize_memory(
+    Shader_Blob* shader_blob, const void* memory, uint64_t memory_size) noexcept
 {
     if (!shader_blob || !memory) return Result::Error_Invalid_Parameters;
 
-    uint8_t* blob_ptr = static_cast<uint8_t*>(memory);
-    memcpy(&shader_blob->groups_x, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    memcpy(&shader_blob->groups_y, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    memcpy(&shader_blob->groups_z, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    uint32_t dxil_blob_size = 0;
-    memcpy(&dxil_blob_size, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    // spir-v blob size
-    blob_ptr += sizeof(uint32_t);
-
-    shader_blob->data.clear();
-    shader_blob->data.resize(dxil_blob_size);
-    memcpy(shader_blob->data.data(), blob_ptr, dxil_blob_size);
+    auto contents = read_shader_container({ static_cast<const uint8_t*>(memory), memory_size });
+    if (!contents) return contents.error();
+    if (contents->dxil.empty()) return Result::Error_Invalid_Parameters;
+    auto reflection = read_shader_reflection(contents->reflection);
+    if (!reflection) return reflection.error();
+
+    shader_blob->storage.assign(contents->dxil.begin(), contents->dxil.end());
+    shader_blob->data = shader_blob->storage;
+    shader_blob->groups_x = contents->groups_x;
+    shader_blob->groups_y = contents->groups_y;
+    shader_blob->groups_z = contents->groups_z;
+    shader_blob->reflection = std::move(*reflection);
+    shader_blob->content_hash = hash_shader_blob_contents(
+        shader_blob->data.data(),
+        shader_blob->data.size(),
+        shader_blob->groups_x,
+        shader_blob->groups_y,
+        shader_blob->groups_z);
 
     return Result::Success;
 }
 
+std::expected<Shader_Blob*, Result> D3D12_Graphics_Device::create_shader_blob(
+    const Shader_Archive& archive, uint32_t entry_index) noexcept
+{
+    if (entry_index >= archive.get_entry_count()) return std::unexpected(Result::Error_Invalid_Parameters);
+
+    const auto& entry = archive.get_entry(entry_index);
+    auto data = archive.get_section_data(entry.dxil);
+    if (data.empty()) return std::unexpected(Result::Error_Invalid_Parameters);
+    auto reflection = read_shader_reflection(archive.get_section_data(entry.reflection));
+    if (!reflection) return std::unexpected(reflection.error());
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    // Only the DXIL section is referenced, its pages are loaded by the driver on pipeline creation.
+    auto blob = &*m_shader_blobs.emplace();
+    blob->data = data;
+    blob->groups_x = entry.groups_x;
+    blob->groups_y = entry.groups_y;
+    blob->groups_z = entry.groups_z;
+    blob->reflection = std::move(*reflection);
+    blob->content_hash = entry.dxil.content_hash;
+    return blob;
+}
+
 void D3D12_Graphics_Device::destroy_shader_blob(Shader_Blob* shader_blob) noexcept
 {
     if (shader_blob == nullptr) return;
@@ -1212,12 +1485,63 @@ void D3D12_Graphics_Device::destroy_shader_blob(Shader_Blob* shader_blob) noexce
 std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
     const Graphics_Pipeline_Create_Info& create_info) noexcept
 {
+    auto pipeline_hash = hash_pipeline(create_info);
+    if (auto pipeline = acquire_registered_pipeline(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    ID3D12PipelineState* pso = nullptr;
+    auto result = compile_pipeline(create_info, &pso);
+    if (result != Result::Success)
+    {
+        return std::unexpected(result);
+    }
+
     std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
     if (m_use_mutex)
     {
         lock_guard.lock();
     }
 
+    // Another thread may have compiled the same pipeline in the meantime.
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        pso->Release();
+        return pipeline;
+    }
+
+    auto pipeline = &*m_pipelines.emplace();
+    pipeline->type = Pipeline_Type::Vertex_Shading;
+    pipeline->vertex_shading_info = create_info;
+    pipeline->pso = pso;
+    pipeline->rtpso = nullptr;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
+    return pipeline;
+}
+
+void disable_unwritten_render_targets(D3D12_BLEND_DESC& blend_desc, const Shader_Blob* ps) noexcept
+{
+    // Without independent blending every render target uses the first description.
+    auto written_color_attachments = get_written_color_attachment_mask(ps);
+    if (!blend_desc.IndependentBlendEnable && written_color_attachments != 0) return;
+
+    auto render_target_count = blend_desc.IndependentBlendEnable ? PIPELINE_COLOR_ATTACHMENTS_MAX : 1;
+    for (auto i = 0u; i < render_target_count; ++i)
+    {
+        if ((written_color_attachments & (1u << i)) == 0)
+        {
+            blend_desc.RenderTarget[i].RenderTargetWriteMask = 0;
+        }
+    }
+}
+
+Result D3D12_Graphics_Device::compile_pipeline(
+    const Graphics_Pipeline_Create_Info& create_info, ID3D12PipelineState** pso) noexcept
+{
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return validation_result;
+
     Graphics_Pipeline_Desc graphics_pipeline_stream = {
         .root_signature = { .data = m_context.bindless_root_signature },
         .vs = { .data = d3d12_cast<D3D12_SHADER_BYTECODE>(create_info.vs) },
@@ -1239,6 +1563,7 @@ std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
         .cached_pso = { .data = {} },
         .flags = { .data = { D3D12_PIPELINE_STATE_FLAG_NONE } },
     };
+    disable_unwritten_render_targets(graphics_pipeline_stream.blend_state.data, create_info.ps);
     for (auto i = 0; i < PIPELINE_COLOR_ATTACHMENTS_MAX; ++i)
     {
         graphics_pipeline_stream.render_target_formats.data.RTFormats[i] = translate_format(
@@ -1248,29 +1573,52 @@ std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
         .SizeInBytes = sizeof(graphics_pipeline_stream),
         .pPipelineStateSubobjectStream = &graphics_pipeline_stream
     };
+    return load_or_create_pipeline_state(hash_pipeline(create_info), stream_desc, pso);
+}
+
+std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
+    const Compute_Pipeline_Create_Info& create_info) noexcept
+{
+    auto pipeline_hash = hash_pipeline(create_info);
+    if (auto pipeline = acquire_registered_pipeline(pipeline_hash))
+    {
+        return pipeline;
+    }
+
     ID3D12PipelineState* pso = nullptr;
-    auto result = result_from_hresult(m_context.device->CreatePipelineState(&stream_desc, IID_PPV_ARGS(&pso)));
+    auto result = compile_pipeline(create_info, &pso);
     if (result != Result::Success)
     {
         return std::unexpected(result);
     }
 
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    // Another thread may have compiled the same pipeline in the meantime.
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        pso->Release();
+        return pipeline;
+    }
+
     auto pipeline = &*m_pipelines.emplace();
-    pipeline->type = Pipeline_Type::Vertex_Shading;
-    pipeline->vertex_shading_info = create_info;
+    pipeline->type = Pipeline_Type::Compute;
+    pipeline->compute_shading_info = create_info;
     pipeline->pso = pso;
     pipeline->rtpso = nullptr;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
     return pipeline;
 }
 
-std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
-    const Compute_Pipeline_Create_Info& create_info) noexcept
+Result D3D12_Graphics_Device::compile_pipeline(
+    const Compute_Pipeline_Create_Info& create_info, ID3D12PipelineState** pso) noexcept
 {
-    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
-    if (m_use_mutex)
-    {
-        lock_guard.lock();
-    }
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return validation_result;
 
     D3D12_COMPUTE_PIPELINE_STATE_DESC compute_pipeline_desc = {
         .pRootSignature = m_context.bindless_root_signature,
@@ -1279,30 +1627,52 @@ std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
         .CachedPSO = {},
         .Flags = D3D12_PIPELINE_STATE_FLAG_NONE
     };
-    ID3D12PipelineState* pso;
-    auto result = result_from_hresult(m_context.device->CreateComputePipelineState(
-        &compute_pipeline_desc, IID_PPV_ARGS(&pso)));
+    return load_or_create_pipeline_state(hash_pipeline(create_info), compute_pipeline_desc, pso);
+}
+
+std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
+    const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept
+{
+    auto pipeline_hash = hash_pipeline(create_info);
+    if (auto pipeline = acquire_registered_pipeline(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    ID3D12PipelineState* pso = nullptr;
+    auto result = compile_pipeline(create_info, &pso);
     if (result != Result::Success)
     {
         return std::unexpected(result);
     }
 
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    // Another thread may have compiled the same pipeline in the meantime.
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        pso->Release();
+        return pipeline;
+    }
+
     auto pipeline = &*m_pipelines.emplace();
-    pipeline->type = Pipeline_Type::Compute;
-    pipeline->compute_shading_info = create_info;
+    pipeline->type = Pipeline_Type::Mesh_Shading;
+    pipeline->mesh_shading_info = create_info;
     pipeline->pso = pso;
     pipeline->rtpso = nullptr;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
     return pipeline;
 }
 
-std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
-    const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept
+Result D3D12_Graphics_Device::compile_pipeline(
+    const Mesh_Shading_Pipeline_Create_Info& create_info, ID3D12PipelineState** pso) noexcept
 {
-    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
-    if (m_use_mutex)
-    {
-        lock_guard.lock();
-    }
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return validation_result;
 
     Mesh_Shader_Pipeline_Desc mesh_pipeline_stream = {
         .root_signature = {.data = m_context.bindless_root_signature },
@@ -1322,6 +1692,7 @@ std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
         .cached_pso = {.data = {} },
         .flags = {.data = { D3D12_PIPELINE_STATE_FLAG_NONE } },
     };
+    disable_unwritten_render_targets(mesh_pipeline_stream.blend_state.data, create_info.ps);
     for (auto i = 0; i < PIPELINE_COLOR_ATTACHMENTS_MAX; ++i)
     {
         mesh_pipeline_stream.render_target_formats.data.RTFormats[i] = translate_format(
@@ -1331,19 +1702,7 @@ std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(
         .SizeInBytes = sizeof(mesh_pipeline_stream),
         .pPipelineStateSubobjectStream = &mesh_pipeline_stream
     };
-    ID3D12PipelineState* pso = nullptr;
-    auto result = result_from_hresult(m_context.device->CreatePipelineState(&stream_desc, IID_PPV_ARGS(&pso)));
-    if (result != Result::Success)
-    {
-        return std::unexpected(result);
-    }
-
-    auto pipeline = &*m_pipelines.emplace();
-    pipeline->type = Pipeline_Type::Mesh_Shading;
-    pipeline->mesh_shading_info = create_info;
-    pipeline->pso = pso;
-    pipeline->rtpso = nullptr;
-    return pipeline;
+    return load_or_create_pipeline_state(hash_pipeline(create_info), stream_desc, pso);
 }
 
 std::expected<Pipeline*, Result> D3D12_Graphics_Device::create_pipeline(const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept
@@ -1463,6 +1822,8 @@ void D3D12_Graphics_Device::destroy_pipeline(Pipeline* pipeline) noexcept
         lock_guard.lock();
     }
 
+    if (!m_pipeline_registry.release(pipeline)) return;
+
     auto d3d12_pipeline = static_cast<D3D12_Pipeline*>(pipeline);
     if (d3d12_pipeline->pso)
         d3d12_pipeline->pso->Release();
@@ -1474,8 +1835,111 @@ void D3D12_Graphics_Device::destroy_pipeline(Pipeline* pipeline) noexcept
     m_pipelines.erase(m_pipelines.get_iterator(d3d12_pipeline));
 }
 
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> D3D12_Graphics_Device::create_pipelines_async(
+    std::span<const Graphics_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Vertex_Shading;
+            pipeline->vertex_shading_info = create_info;
+            pipeline->pso = nullptr;
+            pipeline->rtpso = nullptr;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> D3D12_Graphics_Device::create_pipelines_async(
+    std::span<const Compute_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Compute;
+            pipeline->compute_shading_info = create_info;
+            pipeline->pso = nullptr;
+            pipeline->rtpso = nullptr;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> D3D12_Graphics_Device::create_pipelines_async(
+    std::span<const Mesh_Shading_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Mesh_Shading;
+            pipeline->mesh_shading_info = create_info;
+            pipeline->pso = nullptr;
+            pipeline->rtpso = nullptr;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+Pipeline* D3D12_Graphics_Device::acquire_registered_pipeline(uint64_t pipeline_hash) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    return m_pipeline_registry.acquire(pipeline_hash);
+}
+
+Result D3D12_Graphics_Device::compile_pipeline(D3D12_Pipeline* pipeline) noexcept
+{
+    switch (pipeline->type)
+    {
+    case Pipeline_Type::Vertex_Shading:
+        return compile_pipeline(pipeline->vertex_shading_info, &pipeline->pso);
+    case Pipeline_Type::Compute:
+        return compile_pipeline(pipeline->compute_shading_info, &pipeline->pso);
+    case Pipeline_Type::Mesh_Shading:
+        return compile_pipeline(pipeline->mesh_shading_info, &pipeline->pso);
+    default:
+        return Result::Error_Invalid_Parameters;
+    }
+}
+
 Result D3D12_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
 {
+    process_deferred_destructions();
+
     std::mutex* queue_mutex = nullptr;
     ID3D12CommandQueue* command_queue = nullptr;
     switch (submit_info.queue_type)
@@ -1521,6 +1985,7 @@ Result D3D12_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
     command_lists.reserve(command_list_count);
     for (auto command_list : submit_info.command_lists)
     {
+        command_list->flush_barriers();
         auto d3d12_command_list = static_cast<D3D12_Command_List*>(command_list)->get_internal_command_list();
         d3d12_command_list->Close();
         command_lists.push_back(d3d12_command_list);
@@ -1558,6 +2023,87 @@ void D3D12_Graphics_Device::name_resource(Image* image, const char* name) noexce
     d3d12_image->resource->SetName(std::wstring(str.begin(), str.end()).c_str());
 }
 
+// Descriptors are written on the CPU immediately, there is nothing to batch.
+void D3D12_Graphics_Device::begin_resource_batch() noexcept
+{}
+
+void D3D12_Graphics_Device::end_resource_batch() noexcept
+{}
+
+void D3D12_Graphics_Device::destroy_buffer_deferred(Buffer* buffer, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(buffer, fence, value);
+}
+
+void D3D12_Graphics_Device::destroy_image_deferred(Image* image, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(image, fence, value);
+}
+
+void D3D12_Graphics_Device::destroy_sampler_deferred(Sampler* sampler, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(sampler, fence, value);
+}
+
+void D3D12_Graphics_Device::destroy_acceleration_structure_deferred(
+    Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(acceleration_structure, fence, value);
+}
+
+void D3D12_Graphics_Device::destroy_memory_heap_deferred(Memory_Heap* memory_heap, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(memory_heap, fence, value);
+}
+
+void D3D12_Graphics_Device::process_deferred_destructions() noexcept
+{
+    m_deferred_destruction_queue.process(this);
+}
+
+Result D3D12_Graphics_Device::load_pipeline_cache(const std::filesystem::path& path) noexcept
+{
+    auto data = read_pipeline_cache_file(path, Graphics_API::D3D12);
+    if (!data) return data.error();
+
+    std::unique_lock<std::mutex> lock_guard(m_pipeline_library_mutex);
+
+    // Pipeline libraries can not be merged, the loaded library replaces the current one.
+    ID3D12PipelineLibrary1* pipeline_library = nullptr;
+    auto hresult = m_context.device->CreatePipelineLibrary(data->data(), data->size(), IID_PPV_ARGS(&pipeline_library));
+    if (FAILED(hresult))
+    {
+        // A driver update or a different adapter invalidates the library, the current one is kept.
+        return hresult == D3D12_ERROR_DRIVER_VERSION_MISMATCH || hresult == D3D12_ERROR_ADAPTER_NOT_FOUND
+            ? Result::Error_Invalid_Parameters
+            : Result::Error_Unknown;
+    }
+
+    if (m_pipeline_library)
+    {
+        m_pipeline_library->Release();
+    }
+    m_pipeline_library = pipeline_library;
+    m_pipeline_library_data = std::move(*data);
+    return Result::Success;
+}
+
+Result D3D12_Graphics_Device::save_pipeline_cache(const std::filesystem::path& path) noexcept
+{
+    std::vector<uint8_t> data;
+    {
+        std::unique_lock<std::mutex> lock_guard(m_pipeline_library_mutex);
+        if (!m_pipeline_library) return Result::Error_Unknown;
+
+        data.resize(m_pipeline_library->GetSerializedSize());
+        if (FAILED(m_pipeline_library->Serialize(data.data(), data.size())))
+        {
+            return Result::Error_Unknown;
+        }
+    }
+    return write_pipeline_cache_file(path, Graphics_API::D3D12, data);
+}
+
 D3D12_CPU_DESCRIPTOR_HANDLE D3D12_Graphics_Device::get_cpu_descriptor_handle(
     uint32_t index, D3D12_DESCRIPTOR_HEAP_TYPE type) const noexcept
 {
@@ -1712,23 +2258,12 @@ void D3D12_Graphics_Device::create_srv_and_uav(
 
 uint32_t D3D12_Graphics_Device::create_descriptor_index_blocking(D3D12_DESCRIPTOR_HEAP_TYPE type) noexcept
 {
-    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
-    if (m_use_mutex)
-    {
-        lock_guard.lock();
-    }
-
+    // The index free lists synchronize themselves, `m_resource_mutex` is not needed.
     return create_descriptor_index(type);
 }
 
 void D3D12_Graphics_Device::release_descriptor_index_blocking(uint32_t index, D3D12_DESCRIPTOR_HEAP_TYPE type) noexcept
 {
-    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
-    if (m_use_mutex)
-    {
-        lock_guard.lock();
-    }
-
     release_descriptor_index(index, type);
 }
 
@@ -1786,29 +2321,19 @@ void D3D12_Graphics_Device::create_srv_uav_rtv_dsv(
 
 uint32_t D3D12_Graphics_Device::create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE type) noexcept
 {
-    uint32_t index = ~0u;
     switch (type)
     {
     case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV:
-        index = m_resource_descriptor_indices.back();
-        m_resource_descriptor_indices.pop_back();
-        break;
+        return m_resource_descriptor_indices.acquire_index();
     case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER:
-        index = m_sampler_descriptor_indices.back();
-        m_sampler_descriptor_indices.pop_back();
-        break;
+        return m_sampler_descriptor_indices.acquire_index();
     case D3D12_DESCRIPTOR_HEAP_TYPE_RTV:
-        index = m_rtv_descriptor_indices.back();
-        m_rtv_descriptor_indices.pop_back();
-        break;
+        return m_rtv_descriptor_indices.acquire_index();
     case D3D12_DESCRIPTOR_HEAP_TYPE_DSV:
-        index = m_dsv_descriptor_indices.back();
-        m_dsv_descriptor_indices.pop_back();
-        break;
+        return m_dsv_descriptor_indices.acquire_index();
     default:
-        break;
+        return NO_RESOURCE_INDEX;
     }
-    return index;
 }
 
 void D3D12_Graphics_Device::release_descriptor_index(uint32_t index, D3D12_DESCRIPTOR_HEAP_TYPE type) noexcept
@@ -1816,28 +2341,75 @@ void D3D12_Graphics_Device::release_descriptor_index(uint32_t index, D3D12_DESCR
     switch (type)
     {
     case D3D12_DESCRIPTOR_HEAP_TYPE_CBV_SRV_UAV:
-        if (index < m_max_dynamic_resource_index * 2)
-        {
-            m_resource_descriptor_indices.push_back(index);
-        }
+        m_resource_descriptor_indices.release_index(index);
         break;
     case D3D12_DESCRIPTOR_HEAP_TYPE_SAMPLER:
-        if (index < m_max_dynamic_sampler_index)
-        {
-            m_sampler_descriptor_indices.push_back(index);
-        }
+        m_sampler_descriptor_indices.release_index(index);
         break;
     case D3D12_DESCRIPTOR_HEAP_TYPE_RTV:
-        m_rtv_descriptor_indices.push_back(index);
+        m_rtv_descriptor_indices.release_index(index);
         break;
     case D3D12_DESCRIPTOR_HEAP_TYPE_DSV:
-        m_dsv_descriptor_indices.push_back(index);
+        m_dsv_descriptor_indices.release_index(index);
         break;
     default:
         break;
     }
 }
 
+Result D3D12_Graphics_Device::load_or_create_pipeline_state(
+    uint64_t pipeline_hash, const D3D12_PIPELINE_STATE_STREAM_DESC& stream_desc, ID3D12PipelineState** pso) noexcept
+{
+    auto name = std::to_wstring(pipeline_hash);
+    {
+        std::unique_lock<std::mutex> lock_guard(m_pipeline_library_mutex);
+        if (m_pipeline_library
+            && SUCCEEDED(m_pipeline_library->LoadPipeline(name.c_str(), &stream_desc, IID_PPV_ARGS(pso))))
+        {
+            return Result::Success;
+        }
+    }
+
+    auto result = result_from_hresult(m_context.device->CreatePipelineState(&stream_desc, IID_PPV_ARGS(pso)));
+    if (result == Result::Success)
+    {
+        // Storing fails if the name exists already, which only happens if the stored pipeline did not match
+        // or another thread compiled the same pipeline concurrently.
+        std::unique_lock<std::mutex> lock_guard(m_pipeline_library_mutex);
+        if (m_pipeline_library)
+        {
+            m_pipeline_library->StorePipeline(name.c_str(), *pso);
+        }
+    }
+    return result;
+}
+
+Result D3D12_Graphics_Device::load_or_create_pipeline_state(
+    uint64_t pipeline_hash, const D3D12_COMPUTE_PIPELINE_STATE_DESC& compute_pipeline_desc, ID3D12PipelineState** pso) noexcept
+{
+    auto name = std::to_wstring(pipeline_hash);
+    {
+        std::unique_lock<std::mutex> lock_guard(m_pipeline_library_mutex);
+        if (m_pipeline_library
+            && SUCCEEDED(m_pipeline_library->LoadComputePipeline(name.c_str(), &compute_pipeline_desc, IID_PPV_ARGS(pso))))
+        {
+            return Result::Success;
+        }
+    }
+
+    auto result = result_from_hresult(m_context.device->CreateComputePipelineState(
+        &compute_pipeline_desc, IID_PPV_ARGS(pso)));
+    if (result == Result::Success)
+    {
+        std::unique_lock<std::mutex> lock_guard(m_pipeline_library_mutex);
+        if (m_pipeline_library)
+        {
+            m_pipeline_library->StorePipeline(name.c_str(), *pso);
+        }
+    }
+    return result;
+}
+
 Descriptor_Increment_Sizes D3D12_Graphics_Device::acquire_descriptor_increment_sizes() noexcept
 {
     return Descriptor_Increment_Sizes {
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "rhi/graphics_device.hpp"
+#include "rhi/common/deferred_destruction_queue.hpp"
+#include "rhi/common/index_free_list.hpp"
+#include "rhi/common/pipeline_compiler.hpp"
+#include "rhi/common/pipeline_registry.hpp"
 #include "rhi/d3d12/d3d12_resource.hpp"
 
 #include <agility_sdk/d3d12.h>
 #include <dxgi1_6.h>
 #include <mutex>
 #include <plf_colony.h>
+#include <vector>
 
 namespace D3D12MA
 {
@@ -104,7 +109,7 @@ struct D3D12_Fence : public Fence
 {
     ID3D12Fence1* fence;
 
-    virtual [[nodiscard]] Result get_status(uint64_t value) noexcept override;
+    [[nodiscard]] virtual Result get_status(uint64_t value) noexcept override;
     virtual Result wait_for_value(uint64_t value) noexcept override;
 };
 
@@ -117,56 +122,80 @@ public:
     virtual Result wait_idle() noexcept override;
     virtual Result queue_wait_idle(Queue_Type queue, uint64_t timeout) noexcept override;
 
-    virtual [[nodiscard]] Graphics_API get_graphics_api() const noexcept override;
+    [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept override;
 
-    virtual [[nodiscard]] std::unique_ptr<Swapchain> create_swapchain(
+    [[nodiscard]] virtual std::unique_ptr<Swapchain> create_swapchain(
         const Swapchain_Win32_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::unique_ptr<Command_Pool> create_command_pool(
+    [[nodiscard]] virtual std::unique_ptr<Command_Pool> create_command_pool(
         const Command_Pool_Create_Info& create_info) noexcept override;
 
-    virtual [[nodsicard]] std::expected<Fence*, Result> create_fence(uint64_t initial_value) noexcept override;
+    [[nodiscard]] virtual std::expected<Fence*, Result> create_fence(uint64_t initial_value) noexcept override;
     virtual void destroy_fence(Fence* fence) noexcept override;
 
-        virtual [[nodiscard]] std::expected<Buffer*, Result> create_buffer(
+        [[nodiscard]] virtual std::expected<Buffer*, Result> create_buffer(
         const Buffer_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
-    virtual [[nodiscard]] std::expected<Buffer_View*, Result> create_buffer_view(
+    [[nodiscard]] virtual std::expected<Buffer_View*, Result> create_buffer_view(
         Buffer* buffer, const Buffer_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual Result update_buffer_view(
+        Buffer_View* buffer_view, const Buffer_View_Create_Info& create_info) noexcept override;
     virtual void destroy_buffer(Buffer* buffer) noexcept override;
 
-        virtual [[nodiscard]] std::expected<Image*, Result> create_image(
+    [[nodiscard]] virtual std::expected<Memory_Heap*, Result> create_memory_heap(
+        const Memory_Heap_Create_Info& create_info) noexcept override;
+    virtual void destroy_memory_heap(Memory_Heap* memory_heap) noexcept override;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Buffer_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Image_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual std::expected<Buffer*, Result> create_placed_buffer(
+        const Buffer_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual std::expected<Image*, Result> create_placed_image(
+        const Image_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+
+        [[nodiscard]] virtual std::expected<Image*, Result> create_image(
         const Image_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
-    virtual [[nodiscard]] std::expected<Image_View*, Result> create_image_view(
+    [[nodiscard]] virtual std::expected<Image_View*, Result> create_image_view(
         Image* image, const Image_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
     virtual void destroy_image(Image* image) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Sampler*, Result> create_sampler(
+    [[nodiscard]] virtual std::expected<Sampler*, Result> create_sampler(
         const Sampler_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
     virtual void destroy_sampler(Sampler* sampler) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Acceleration_Structure*, Result> create_acceleration_structure(
+    [[nodiscard]] virtual std::expected<Acceleration_Structure*, Result> create_acceleration_structure(
         const Acceleration_Structure_Create_Info& create_info) noexcept override;
     virtual void destroy_acceleration_structure(Acceleration_Structure* acceleration_structure) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Shader_Blob*, Result> create_shader_blob(
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
         const Shader_Blob_Create_Info& create_info) noexcept override;
     virtual Result recreate_shader_blob(Shader_Blob* shader_blob, const Shader_Blob_Create_Info& create_info) noexcept override;
-    virtual Result recreate_shader_blob_deserialize_memory(Shader_Blob* shader_blob, void* memory) noexcept override;
+    virtual Result recreate_shader_blob_deserialize_memory(
+        Shader_Blob* shader_blob, const void* memory, uint64_t memory_size) noexcept override;
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
+        const Shader_Archive& archive, uint32_t entry_index) noexcept override;
     virtual void destroy_shader_blob(Shader_Blob* shader_blob) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Graphics_Pipeline_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Compute_Pipeline_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept override;
     virtual void destroy_pipeline(Pipeline* pipeline) noexcept override;
 
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Graphics_Pipeline_Create_Info> create_infos) noexcept override;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Compute_Pipeline_Create_Info> create_infos) noexcept override;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Mesh_Shading_Pipeline_Create_Info> create_infos) noexcept override;
+
     [[nodiscard]] Acceleration_Structure_Build_Sizes get_acceleration_structure_build_sizes(
         const Acceleration_Structure_Build_Geometry_Info& build_info) noexcept override;
-    virtual [[nodiscard]] const Ray_Tracing_Pipeline_Properties& get_ray_tracing_pipeline_properties() const noexcept override;
-    virtual [[nodiscard]] Result get_ray_tracing_shader_group_handles(
+    [[nodiscard]] virtual const Ray_Tracing_Pipeline_Properties& get_ray_tracing_pipeline_properties() const noexcept override;
+    [[nodiscard]] virtual Result get_ray_tracing_shader_group_handles(
         Pipeline* pipeline, uint32_t first_group, uint32_t group_count, void* dst) const noexcept override;
 
     virtual Result submit(const Submit_Info& submit_info) noexcept override;
@@ -174,6 +203,20 @@ public:
     virtual void name_resource(Buffer* buffer, const char* name) noexcept override;
     virtual void name_resource(Image* image, const char* name) noexcept override;
 
+    virtual void begin_resource_batch() noexcept override;
+    virtual void end_resource_batch() noexcept override;
+
+    virtual void destroy_buffer_deferred(Buffer* buffer, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_image_deferred(Image* image, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_sampler_deferred(Sampler* sampler, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_acceleration_structure_deferred(
+        Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_memory_heap_deferred(Memory_Heap* memory_heap, Fence* fence, uint64_t value) noexcept override;
+    virtual void process_deferred_destructions() noexcept override;
+
+    virtual Result load_pipeline_cache(const std::filesystem::path& path) noexcept override;
+    virtual Result save_pipeline_cache(const std::filesystem::path& path) noexcept override;
+
     [[nodiscard]] D3D12_CPU_DESCRIPTOR_HANDLE get_cpu_descriptor_handle(
         uint32_t index, D3D12_DESCRIPTOR_HEAP_TYPE type) const noexcept;
     [[nodiscard]] D3D12_GPU_DESCRIPTOR_HANDLE get_gpu_descriptor_handle(
@@ -191,6 +234,18 @@ public:
     void release_custom_allocated_image(D3D12_Image* image) noexcept;
 
 private:
+    // Both allocate dedicated memory if `memory_heap` is nullptr and place the resource in it otherwise.
+    [[nodiscard]] std::expected<Buffer*, Result> create_buffer_in_memory(
+        const Buffer_Create_Info& create_info, uint32_t index, D3D12_Memory_Heap* memory_heap, uint64_t offset) noexcept;
+    [[nodiscard]] std::expected<Image*, Result> create_image_in_memory(
+        const Image_Create_Info& create_info, uint32_t index, D3D12_Memory_Heap* memory_heap, uint64_t offset) noexcept;
+    [[nodiscard]] Result create_resource(
+        const D3D12_RESOURCE_DESC1& resource_desc, D3D12_HEAP_TYPE heap_type,
+        D3D12_Memory_Heap* memory_heap, uint64_t offset,
+        D3D12MA::Allocation** allocation, ID3D12Resource2** resource) noexcept;
+    [[nodiscard]] bool is_placement_valid(
+        const Memory_Requirements& memory_requirements, Memory_Heap* memory_heap, uint64_t offset) const noexcept;
+
     void create_initial_buffer_descriptors(D3D12_Buffer* buffer, bool create_srv, bool create_uav) noexcept;
     void create_buffer_view_descriptors(D3D12_Buffer_View* buffer_view, bool create_srv, bool create_uav) noexcept;
     void create_initial_image_descriptors(D3D12_Image* image) noexcept;
@@ -210,10 +265,22 @@ private:
         const D3D12_RENDER_TARGET_VIEW_DESC* rtv_desc,
         const D3D12_DEPTH_STENCIL_VIEW_DESC* dsv_desc) noexcept;
 
-    // Only use inside resource creation and destruction. Not guarded by mutex.
+    // Thread safe, returns `NO_RESOURCE_INDEX` once every descriptor of the heap is in use.
     [[nodiscard]] uint32_t create_descriptor_index(D3D12_DESCRIPTOR_HEAP_TYPE type) noexcept;
     void release_descriptor_index(uint32_t index, D3D12_DESCRIPTOR_HEAP_TYPE type) noexcept;
 
+    // Thread safe and never touch `m_resource_mutex`, so pipelines can be compiled on any number of threads.
+    [[nodiscard]] Result compile_pipeline(const Graphics_Pipeline_Create_Info& create_info, ID3D12PipelineState** pso) noexcept;
+    [[nodiscard]] Result compile_pipeline(const Compute_Pipeline_Create_Info& create_info, ID3D12PipelineState** pso) noexcept;
+    [[nodiscard]] Result compile_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info, ID3D12PipelineState** pso) noexcept;
+    [[nodiscard]] Result compile_pipeline(D3D12_Pipeline* pipeline) noexcept;
+    [[nodiscard]] Pipeline* acquire_registered_pipeline(uint64_t pipeline_hash) noexcept;
+    // Pipelines are looked up by `pipeline_hash` in the pipeline library and stored on a miss.
+    [[nodiscard]] Result load_or_create_pipeline_state(
+        uint64_t pipeline_hash, const D3D12_PIPELINE_STATE_STREAM_DESC& stream_desc, ID3D12PipelineState** pso) noexcept;
+    [[nodiscard]] Result load_or_create_pipeline_state(
+        uint64_t pipeline_hash, const D3D12_COMPUTE_PIPELINE_STATE_DESC& compute_pipeline_desc, ID3D12PipelineState** pso) noexcept;
+
     [[nodiscard]] Descriptor_Increment_Sizes acquire_descriptor_increment_sizes() noexcept;
     [[nodiscard]] Indirect_Signatures create_execute_indirect_signatures() noexcept;
 
@@ -230,9 +297,23 @@ private:
     std::mutex m_compute_queue_mutex;
     std::mutex m_copy_queue_mutex;
 
+    Deferred_Destruction_Queue m_deferred_destruction_queue;
+
+    // Guarded by `m_resource_mutex`.
+    Pipeline_Registry m_pipeline_registry;
+    Pipeline_Compiler m_pipeline_compiler;
+
+    // Always synchronized as pipelines are compiled on worker threads.
+    std::mutex m_pipeline_library_mutex;
+    // May be nullptr if the driver does not support pipeline libraries.
+    ID3D12PipelineLibrary1* m_pipeline_library;
+    // The library references the serialized data it was created from, it must outlive the library.
+    std::vector<uint8_t> m_pipeline_library_data;
+
     plf::colony<D3D12_Fence> m_fences;
     plf::colony<D3D12_Buffer> m_buffers;
     plf::colony<D3D12_Buffer_View> m_buffer_views;
+    plf::colony<D3D12_Memory_Heap> m_memory_heaps;
     plf::colony<D3D12_Image> m_images;
     plf::colony<D3D12_Image_View> m_image_views;
     plf::colony<D3D12_Sampler> m_samplers;
@@ -240,11 +321,9 @@ private:
     plf::colony<Shader_Blob> m_shader_blobs;
     plf::colony<D3D12_Pipeline> m_pipelines;
 
-    uint32_t m_max_dynamic_resource_index;
-    uint32_t m_max_dynamic_sampler_index;
-    std::vector<uint32_t> m_resource_descriptor_indices;
-    std::vector<uint32_t> m_sampler_descriptor_indices;
-    std::vector<uint32_t> m_rtv_descriptor_indices;
-    std::vector<uint32_t> m_dsv_descriptor_indices;
+    Index_Free_List m_resource_descriptor_indices;
+    Index_Free_List m_sampler_descriptor_indices;
+    Index_Free_List m_rtv_descriptor_indices;
+    Index_Free_List m_dsv_descriptor_indices;
 };
 }
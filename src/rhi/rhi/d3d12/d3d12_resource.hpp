@@ -14,17 +14,22 @@ namespace rhi::d3d12
 struct D3D12_Buffer : public Buffer
 {
     ID3D12Resource2* resource;
-    D3D12MA::Allocation* allocation;
+    D3D12MA::Allocation* allocation; // nullptr for placed buffers.
     D3D12_RESOURCE_FLAGS flags;
 };
 
 // No extra members required in D3D12
 using D3D12_Buffer_View = Buffer_View;
 
+struct D3D12_Memory_Heap : public Memory_Heap
+{
+    D3D12MA::Allocation* allocation;
+};
+
 struct D3D12_Image : public Image
 {
     ID3D12Resource2* resource;
-    D3D12MA::Allocation* allocation;
+    D3D12MA::Allocation* allocation; // nullptr for placed images.
 };
 
 // TODO: remove; Allocate RTVs/DSVs on demand.
@@ -6,9 +6,40 @@
 #if defined(RHI_GRAPHICS_API_VULKAN)
     #include "rhi/vulkan/vulkan_graphics_device.hpp"
 #endif
+#if defined(RHI_GRAPHICS_API_NULL)
+    #include "rhi/null/null_graphics_device.hpp"
+#endif
 
 namespace rhi
 {
+Pipeline_Compile_Task::Pipeline_Compile_Task(Pipeline* pipeline) noexcept
+    : m_pipeline(pipeline)
+    , m_status(Result::Wait_Timeout)
+{}
+
+Result Pipeline_Compile_Task::get_status() const noexcept
+{
+    return m_status.load(std::memory_order_acquire);
+}
+
+Result Pipeline_Compile_Task::wait() const noexcept
+{
+    m_status.wait(Result::Wait_Timeout, std::memory_order_acquire);
+    return get_status();
+}
+
+Pipeline* Pipeline_Compile_Task::get_pipeline() const noexcept
+{
+    return m_pipeline;
+}
+
+void Pipeline_Compile_Task::complete(Result result) noexcept
+{
+    // Publishes the native pipeline object written by the worker.
+    m_status.store(result, std::memory_order_release);
+    m_status.notify_all();
+}
+
 std::unique_ptr<Graphics_Device> Graphics_Device::create(const Graphics_Device_Create_Info& create_info) noexcept
 {
     switch (create_info.graphics_api)
@@ -20,6 +51,10 @@ std::unique_ptr<Graphics_Device> Graphics_Device::create(const Graphics_Device_C
 #ifdef RHI_GRAPHICS_API_VULKAN
     case Graphics_API::Vulkan:
         return std::make_unique<vulkan::Vulkan_Graphics_Device>(create_info);
+#endif
+#ifdef RHI_GRAPHICS_API_NULL
+    case Graphics_API::Null:
+        return std::make_unique<null::Null_Graphics_Device>(create_info);
 #endif
     default:
         return nullptr;
@@ -5,13 +5,18 @@
 #include "rhi/command_list.hpp"
 #include "rhi/queue_type.hpp"
 
+#include <atomic>
 #include <memory>
 #include <expected>
+#include <filesystem>
 #include <span>
+#include <vector>
 
 namespace rhi
 {
 class Command_List;
+class Pipeline_Compiler;
+class Shader_Archive;
 class Swapchain;
 struct Swapchain_Win32_Create_Info;
 
@@ -23,11 +28,14 @@ enum class Graphics_API
 #ifdef RHI_GRAPHICS_API_VULKAN
     Vulkan = 1,
 #endif
+#ifdef RHI_GRAPHICS_API_NULL
+    Null = 2,
+#endif
 };
 
 struct Fence
 {
-    virtual [[nodiscard]] Result get_status(uint64_t value) noexcept = 0;
+    [[nodiscard]] virtual Result get_status(uint64_t value) noexcept = 0;
     virtual Result wait_for_value(uint64_t value) noexcept = 0;
 };
 
@@ -37,6 +45,28 @@ struct Submit_Fence_Info
     uint64_t value;
 };
 
+// Tracks a pipeline that is compiled on a worker thread, see `Graphics_Device::create_pipelines_async`.
+class Pipeline_Compile_Task
+{
+public:
+    explicit Pipeline_Compile_Task(Pipeline* pipeline) noexcept;
+
+    // Returns `Wait_Timeout` while compiling, afterwards `Success` or the error the compilation failed with.
+    [[nodiscard]] Result get_status() const noexcept;
+    Result wait() const noexcept;
+    // The pipeline must not be used before the compilation succeeded. It has to be destroyed even if it failed.
+    [[nodiscard]] Pipeline* get_pipeline() const noexcept;
+
+private:
+    friend class Pipeline_Compiler;
+
+    void complete(Result result) noexcept;
+
+private:
+    Pipeline* m_pipeline;
+    std::atomic<Result> m_status;
+};
+
 struct Submit_Info
 {
     Queue_Type queue_type;
@@ -68,7 +98,7 @@ struct Graphics_Device_Create_Info
 class Graphics_Device
 {
 public:
-    static [[nodiscard]] std::unique_ptr<Graphics_Device> create(const Graphics_Device_Create_Info& create_info) noexcept;
+    [[nodiscard]] static std::unique_ptr<Graphics_Device> create(const Graphics_Device_Create_Info& create_info) noexcept;
     virtual ~Graphics_Device() noexcept = default;
     Graphics_Device(const Graphics_Device& other) = delete;
     Graphics_Device(Graphics_Device&& other) = delete;
@@ -78,60 +108,132 @@ public:
     virtual Result wait_idle() noexcept = 0;
     virtual Result queue_wait_idle(Queue_Type queue, uint64_t timeout) noexcept = 0;
 
-    virtual [[nodiscard]] Graphics_API get_graphics_api() const noexcept = 0;
+    [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept = 0;
 
-    virtual [[nodiscard]] std::unique_ptr<Swapchain> create_swapchain(
+    [[nodiscard]] virtual std::unique_ptr<Swapchain> create_swapchain(
         const Swapchain_Win32_Create_Info& create_info) noexcept = 0;
-    virtual [[nodiscard]] std::unique_ptr<Command_Pool> create_command_pool(
+    [[nodiscard]] virtual std::unique_ptr<Command_Pool> create_command_pool(
         const Command_Pool_Create_Info& create_info) noexcept = 0;
 
-    virtual [[nodsicard]] std::expected<Fence*, Result> create_fence(uint64_t initial_value) noexcept = 0;
+    [[nodiscard]] virtual std::expected<Fence*, Result> create_fence(uint64_t initial_value) noexcept = 0;
     virtual void destroy_fence(Fence* fence) noexcept = 0;
 
-    virtual [[nodiscard]] std::expected<Buffer*, Result> create_buffer(
+    [[nodiscard]] virtual std::expected<Buffer*, Result> create_buffer(
         const Buffer_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept = 0;
-    virtual [[nodiscard]] std::expected<Buffer_View*, Result> create_buffer_view(
+    [[nodiscard]] virtual std::expected<Buffer_View*, Result> create_buffer_view(
         Buffer* buffer, const Buffer_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept = 0;
+    // Points an existing view at another range of its buffer, keeping its bindless index.
+    // The view must no longer be in use by the GPU.
+    [[nodiscard]] virtual Result update_buffer_view(
+        Buffer_View* buffer_view, const Buffer_View_Create_Info& create_info) noexcept = 0;
     virtual void destroy_buffer(Buffer* buffer) noexcept = 0;
 
-    virtual [[nodiscard]] std::expected<Image*, Result> create_image(
+    // Buffers and every kind of image may share a heap. D3D12 devices with resource heap tier 1 can not do that,
+    // creating a heap fails with `Error_Invalid_Parameters` on them.
+    [[nodiscard]] virtual std::expected<Memory_Heap*, Result> create_memory_heap(
+        const Memory_Heap_Create_Info& create_info) noexcept = 0;
+    // Every resource placed in the heap has to be destroyed first.
+    virtual void destroy_memory_heap(Memory_Heap* memory_heap) noexcept = 0;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Buffer_Create_Info& create_info) noexcept = 0;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Image_Create_Info& create_info) noexcept = 0;
+    // Placed resources use the memory of `memory_heap` at `offset`, which must satisfy `get_memory_requirements`.
+    // Buffers must match the heap type, images require a `GPU` heap. Destroying a placed resource does not free any memory.
+    // On Vulkan resources that can't use the memory type the heap was allocated from are rejected.
+    // Before its first use a placed image must be transitioned from `Undefined` with `discard` set,
+    // a placed buffer needs a barrier against the previous users of its memory.
+    [[nodiscard]] virtual std::expected<Buffer*, Result> create_placed_buffer(
+        const Buffer_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept = 0;
+    [[nodiscard]] virtual std::expected<Image*, Result> create_placed_image(
+        const Image_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept = 0;
+
+    [[nodiscard]] virtual std::expected<Image*, Result> create_image(
         const Image_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept = 0;
-    virtual [[nodiscard]] std::expected<Image_View*, Result> create_image_view(
+    [[nodiscard]] virtual std::expected<Image_View*, Result> create_image_view(
         Image* image, const Image_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept = 0;
     virtual void destroy_image(Image* image) noexcept = 0;
 
-    virtual [[nodiscard]] std::expected<Sampler*, Result> create_sampler(
+    [[nodiscard]] virtual std::expected<Sampler*, Result> create_sampler(
         const Sampler_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept = 0;
     virtual void destroy_sampler(Sampler* sampler) noexcept = 0;
 
-    virtual [[nodiscard]] std::expected<Acceleration_Structure*, Result> create_acceleration_structure(
+    [[nodiscard]] virtual std::expected<Acceleration_Structure*, Result> create_acceleration_structure(
         const Acceleration_Structure_Create_Info& create_info) noexcept = 0;
     virtual void destroy_acceleration_structure(Acceleration_Structure* acceleration_structure) noexcept = 0;
 
-    virtual [[nodiscard]] std::expected<Shader_Blob*, Result> create_shader_blob(
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
         const Shader_Blob_Create_Info& create_info) noexcept = 0;
     virtual Result recreate_shader_blob(Shader_Blob* shader_blob, const Shader_Blob_Create_Info& create_info) noexcept = 0;
-    virtual Result recreate_shader_blob_deserialize_memory(Shader_Blob* shader_blob, void* memory) noexcept = 0;
+    // Reads a shader container written by `write_shader_container` and keeps the IR for this graphics API.
+    // Returns `Error_Invalid_Parameters` and leaves the blob unchanged if the container is invalid or lacks that IR.
+    virtual Result recreate_shader_blob_deserialize_memory(
+        Shader_Blob* shader_blob, const void* memory, uint64_t memory_size) noexcept = 0;
+    // The blob references the archive entry's bytecode for this graphics API without copying it,
+    // the archive must outlive the blob. Recreating the blob switches it back to owned bytecode.
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
+        const Shader_Archive& archive, uint32_t entry_index) noexcept = 0;
     virtual void destroy_shader_blob(Shader_Blob* shader_blob) noexcept = 0;
 
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(const Graphics_Pipeline_Create_Info& create_info) noexcept = 0;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(const Compute_Pipeline_Create_Info& create_info) noexcept = 0;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept = 0;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept = 0;
+    // Graphics, compute and mesh shading pipelines are deduplicated by shader contents and fixed function state.
+    // Creating an identical pipeline returns the existing one with an additional reference,
+    // it is only destroyed once `destroy_pipeline` was called for every reference.
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(const Graphics_Pipeline_Create_Info& create_info) noexcept = 0;
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(const Compute_Pipeline_Create_Info& create_info) noexcept = 0;
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept = 0;
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept = 0;
     virtual void destroy_pipeline(Pipeline* pipeline) noexcept = 0;
 
-    virtual [[nodiscard]] Acceleration_Structure_Build_Sizes get_acceleration_structure_build_sizes(
+    // Compiles the pipelines on worker threads and returns one task per create info, in the same order.
+    // Compilation never holds the resource lock, so other threads may keep creating resources meanwhile.
+    // The shader blobs must stay alive and unchanged until the tasks completed.
+    // A pipeline must not be destroyed before its task completed.
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Graphics_Pipeline_Create_Info> create_infos) noexcept = 0;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Compute_Pipeline_Create_Info> create_infos) noexcept = 0;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Mesh_Shading_Pipeline_Create_Info> create_infos) noexcept = 0;
+
+    [[nodiscard]] virtual Acceleration_Structure_Build_Sizes get_acceleration_structure_build_sizes(
         const Acceleration_Structure_Build_Geometry_Info& build_info) noexcept = 0;
-    virtual [[nodiscard]] const Ray_Tracing_Pipeline_Properties& get_ray_tracing_pipeline_properties() const noexcept = 0;
+    [[nodiscard]] virtual const Ray_Tracing_Pipeline_Properties& get_ray_tracing_pipeline_properties() const noexcept = 0;
     // Copies all the handles into dst
-    virtual [[nodiscard]] Result get_ray_tracing_shader_group_handles(
+    [[nodiscard]] virtual Result get_ray_tracing_shader_group_handles(
         Pipeline* pipeline, uint32_t first_group, uint32_t group_count, void* dst) const noexcept = 0;
 
+    // Processes deferred destructions first, see `process_deferred_destructions`.
     virtual Result submit(const Submit_Info& submit_info) noexcept = 0;
 
     virtual void name_resource(Buffer* buffer, const char* name) noexcept = 0;
     virtual void name_resource(Image* image, const char* name) noexcept = 0;
 
+    // Descriptors of resources created between these calls are written in bulk on `end_resource_batch` or
+    // the next `submit`, whichever comes first. Batches may be nested, use them around large resource loads.
+    virtual void begin_resource_batch() noexcept = 0;
+    virtual void end_resource_batch() noexcept = 0;
+
+    // Deferred destruction, the resource is destroyed once `fence` has reached `value`.
+    // The resource must not be used by new work afterwards and the fence must outlive it.
+    // Safe to call from any thread, even without `enable_locking`.
+    virtual void destroy_buffer_deferred(Buffer* buffer, Fence* fence, uint64_t value) noexcept = 0;
+    virtual void destroy_image_deferred(Image* image, Fence* fence, uint64_t value) noexcept = 0;
+    virtual void destroy_sampler_deferred(Sampler* sampler, Fence* fence, uint64_t value) noexcept = 0;
+    virtual void destroy_acceleration_structure_deferred(
+        Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value) noexcept = 0;
+    virtual void destroy_memory_heap_deferred(Memory_Heap* memory_heap, Fence* fence, uint64_t value) noexcept = 0;
+    // Destroys every deferred resource whose fence value has completed. Also done at the start of every `submit`.
+    // Runs the regular `destroy_*` functions, so without `enable_locking` neither this nor `submit` may run
+    // concurrently with any other create or destroy call.
+    virtual void process_deferred_destructions() noexcept = 0;
+
+    // Every pipeline is created through a device wide pipeline cache which can be persisted across runs.
+    // Load it before creating pipelines, D3D12 replaces its pipeline library instead of merging into it.
+    // A file written by another driver or device is rejected with `Error_Invalid_Parameters`
+    // and the current cache stays in use.
+    virtual Result load_pipeline_cache(const std::filesystem::path& path) noexcept = 0;
+    virtual Result save_pipeline_cache(const std::filesystem::path& path) noexcept = 0;
+
 protected:
     Graphics_Device() noexcept = default;
 };
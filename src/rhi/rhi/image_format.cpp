@@ -1,6 +1,8 @@
 #include "rhi/image_format.hpp"
 
 #include <array>
+#include <numeric>
+#include <utility>
 
 namespace rhi
 {
@@ -785,4 +787,24 @@ Image_Format_Info get_image_format_info(Image_Format format) noexcept
         std::unreachable();
     }
 }
+
+Image_Copy_Footprint get_image_copy_footprint(
+    Image_Format format, uint32_t width, uint32_t height, uint32_t depth) noexcept
+{
+    const auto info = get_image_format_info(format);
+    auto row_size = (width + info.block_size_x - 1) / info.block_size_x * info.bytes;
+    auto row_count = (height + info.block_size_y - 1) / info.block_size_y;
+    // Vulkan takes the row length in texels, so the pitch has to be a whole number of texels or blocks.
+    auto row_pitch_alignment = info.bytes > 0
+        ? std::lcm(IMAGE_COPY_ROW_PITCH_ALIGNMENT, info.bytes)
+        : IMAGE_COPY_ROW_PITCH_ALIGNMENT;
+    auto row_pitch = (row_size + row_pitch_alignment - 1) / row_pitch_alignment * row_pitch_alignment;
+    return {
+        .row_size = row_size,
+        .row_pitch = row_pitch,
+        .row_count = row_count,
+        .depth = depth,
+        .size = uint64_t(row_pitch) * row_count * depth
+    };
+}
 }
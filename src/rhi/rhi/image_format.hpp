@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string_view>
 
 namespace rhi
@@ -88,6 +89,23 @@ struct Image_Format_Info
     uint8_t block_size_y;
 };
 
+// D3D12 requires these for buffer to image copies, they also satisfy every Vulkan requirement.
+constexpr static uint32_t IMAGE_COPY_ROW_PITCH_ALIGNMENT = 256;
+constexpr static uint64_t IMAGE_COPY_OFFSET_ALIGNMENT = 512;
+
+// Layout of one subresource in a buffer, rows are rows of blocks for block compressed formats.
+struct Image_Copy_Footprint
+{
+    uint32_t row_size; // Tightly packed size of a row in bytes.
+    uint32_t row_pitch; // Aligned to `IMAGE_COPY_ROW_PITCH_ALIGNMENT` and a multiple of the texel or block size.
+    uint32_t row_count; // Per depth slice.
+    uint32_t depth;
+    uint64_t size;
+};
+
 Image_Format_Info get_image_format_info(std::string_view string_format) noexcept;
 Image_Format_Info get_image_format_info(Image_Format format) noexcept;
+// Partial blocks at the edges of smaller mips count as whole blocks.
+Image_Copy_Footprint get_image_copy_footprint(
+    Image_Format format, uint32_t width, uint32_t height, uint32_t depth) noexcept;
 }
@@ -0,0 +1,420 @@
+#include "rhi/image_state_tracker.hpp"
+
+#include "rhi/command_pool_ring.hpp"
+#include "rhi/graphics_device.hpp"
+#include "rhi/image_format.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <utility>
+
+namespace rhi
+{
+namespace
+{
+uint32_t get_image_state_tracker_plane_count(const Image* image) noexcept
+{
+    auto format_info = get_image_format_info(image->format);
+    return format_info.is_depth && format_info.is_stencil ? 2u : 1u;
+}
+
+uint32_t get_image_state_tracker_subresource_count(const Image* image) noexcept
+{
+    return get_image_state_tracker_plane_count(image) * image->array_size * image->mip_levels;
+}
+
+// A count of zero selects every remaining element, the first one still has to exist.
+bool is_image_state_tracker_range_valid(uint32_t first, uint32_t count, uint32_t size) noexcept
+{
+    return first < size && uint64_t(first) + count <= size;
+}
+
+bool is_image_state_tracker_state_valid(const Image_State_Info& state) noexcept
+{
+    if (!state.image) return false;
+
+    const auto& range = state.subresource_range;
+    return is_image_state_tracker_range_valid(range.first_mip_level, range.mip_count, state.image->mip_levels)
+        && is_image_state_tracker_range_valid(range.first_array_index, range.array_size, state.image->array_size)
+        && is_image_state_tracker_range_valid(
+            range.first_plane, range.plane_count, get_image_state_tracker_plane_count(state.image));
+}
+
+bool is_same_image_state_tracker_transition(const Image_Barrier_Info& a, const Image_Barrier_Info& b) noexcept
+{
+    return a.image == b.image
+        && a.stage_before == b.stage_before
+        && a.stage_after == b.stage_after
+        && a.access_before == b.access_before
+        && a.access_after == b.access_after
+        && a.layout_before == b.layout_before
+        && a.layout_after == b.layout_after;
+}
+
+// Subresources are visited mip level first, so only consecutive mip levels of one array slice and plane are merged.
+void push_image_state_tracker_barrier(std::vector<Image_Barrier_Info>& barriers, const Image_Barrier_Info& barrier) noexcept
+{
+    if (!barriers.empty())
+    {
+        auto& previous = barriers.back();
+        if (is_same_image_state_tracker_transition(previous, barrier)
+            && previous.subresource_range.first_plane == barrier.subresource_range.first_plane
+            && previous.subresource_range.first_array_index == barrier.subresource_range.first_array_index
+            && previous.subresource_range.first_mip_level + previous.subresource_range.mip_count
+                == barrier.subresource_range.first_mip_level)
+        {
+            previous.subresource_range.mip_count += 1;
+            return;
+        }
+    }
+    barriers.push_back(barrier);
+}
+
+// Then consecutive array slices of one plane with the same mip range.
+void merge_image_state_tracker_array_slices(std::vector<Image_Barrier_Info>& barriers) noexcept
+{
+    if (barriers.empty()) return;
+    std::size_t merged = 0;
+    for (std::size_t i = 1; i < barriers.size(); ++i)
+    {
+        auto& previous = barriers[merged];
+        const auto& barrier = barriers[i];
+        if (is_same_image_state_tracker_transition(previous, barrier)
+            && previous.subresource_range.first_plane == barrier.subresource_range.first_plane
+            && previous.subresource_range.first_mip_level == barrier.subresource_range.first_mip_level
+            && previous.subresource_range.mip_count == barrier.subresource_range.mip_count
+            && previous.subresource_range.first_array_index + previous.subresource_range.array_size
+                == barrier.subresource_range.first_array_index)
+        {
+            previous.subresource_range.array_size += barrier.subresource_range.array_size;
+        }
+        else
+        {
+            barriers[++merged] = barrier;
+        }
+    }
+    barriers.resize(merged + 1);
+}
+
+// Finally the planes of depth stencil images, Vulkan transitions both in one barrier as it ignores the plane range.
+void merge_image_state_tracker_planes(std::vector<Image_Barrier_Info>& barriers) noexcept
+{
+    std::size_t merged = 0;
+    for (std::size_t i = 0; i < barriers.size(); ++i)
+    {
+        const auto& barrier = barriers[i];
+        auto previous = std::find_if(barriers.begin(), barriers.begin() + merged,
+            [&barrier](const Image_Barrier_Info& other)
+            {
+                return is_same_image_state_tracker_transition(other, barrier)
+                    && other.subresource_range.first_mip_level == barrier.subresource_range.first_mip_level
+                    && other.subresource_range.mip_count == barrier.subresource_range.mip_count
+                    && other.subresource_range.first_array_index == barrier.subresource_range.first_array_index
+                    && other.subresource_range.array_size == barrier.subresource_range.array_size
+                    && other.subresource_range.first_plane + other.subresource_range.plane_count
+                        == barrier.subresource_range.first_plane;
+            });
+        if (previous != barriers.begin() + merged)
+        {
+            previous->subresource_range.plane_count += barrier.subresource_range.plane_count;
+        }
+        else
+        {
+            barriers[merged++] = barrier;
+        }
+    }
+    barriers.resize(merged);
+}
+
+Image_Barrier_Info make_image_state_tracker_barrier(
+    Image* image, uint32_t mip_level, uint32_t array_index, uint32_t plane) noexcept
+{
+    return {
+        .stage_before = Barrier_Pipeline_Stage::None,
+        .stage_after = Barrier_Pipeline_Stage::None,
+        .access_before = Barrier_Access::None,
+        .access_after = Barrier_Access::None,
+        .layout_before = Barrier_Image_Layout::Undefined,
+        .layout_after = Barrier_Image_Layout::Undefined,
+        .queue_type_ownership_transfer_target_queue = Queue_Type::Graphics,
+        .queue_type_ownership_transfer_mode = Queue_Type_Ownership_Transfer_Mode::None,
+        .image = image,
+        .subresource_range = {
+            .first_mip_level = mip_level,
+            .mip_count = 1,
+            .first_array_index = array_index,
+            .array_size = 1,
+            .first_plane = plane,
+            .plane_count = 1
+        },
+        .discard = false
+    };
+}
+}
+
+std::expected<std::unique_ptr<Image_State_Tracker>, Result> Image_State_Tracker::create(
+    Graphics_Device* graphics_device, const Image_State_Tracker_Create_Info& create_info) noexcept
+{
+    auto command_pool_ring = Command_Pool_Ring::create(graphics_device, {
+        .queue_type = create_info.queue_type,
+        .thread_safe = false,
+        .frame_count = create_info.frame_count,
+        .fence = create_info.fence
+    });
+    if (!command_pool_ring) return std::unexpected(command_pool_ring.error());
+
+    auto result = std::unique_ptr<Image_State_Tracker>(new Image_State_Tracker());
+    result->m_graphics_device = graphics_device;
+    result->m_queue_type = create_info.queue_type;
+    result->m_command_pool_ring = std::move(*command_pool_ring);
+    return result;
+}
+
+Image_State_Tracker::Image_State_Tracker() noexcept
+    : m_graphics_device(nullptr)
+    , m_queue_type(Queue_Type::Graphics)
+    , m_command_pool_ring()
+    , m_mutex()
+    , m_command_list_states()
+    , m_free_command_list_states()
+    , m_image_states()
+    , m_barriers()
+    , m_command_lists()
+{}
+
+Image_State_Tracker::~Image_State_Tracker() noexcept = default;
+
+void Image_State_Tracker::register_image(Image* image, Barrier_Image_Layout initial_layout) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_image_states[image].assign(get_image_state_tracker_subresource_count(image), {
+        .layout = initial_layout,
+        .write_stage = Barrier_Pipeline_Stage::None,
+        .write_access = Barrier_Access::None,
+        .read_stage = Barrier_Pipeline_Stage::None,
+        .read_access = Barrier_Access::None
+    });
+}
+
+void Image_State_Tracker::forget_image(Image* image) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_image_states.erase(image);
+}
+
+Result Image_State_Tracker::transition(Command_List* command_list, std::span<const Image_State_Info> states) noexcept
+{
+    for (const auto& state : states)
+    {
+        if (!is_image_state_tracker_state_valid(state)) return Result::Error_Invalid_Parameters;
+    }
+
+    auto list_state = acquire_command_list_state(command_list);
+    list_state->barriers.clear();
+    for (const auto& state : states)
+    {
+        auto image = state.image;
+        auto& subresources = list_state->images[image];
+        if (subresources.empty())
+        {
+            subresources.resize(get_image_state_tracker_subresource_count(image));
+        }
+
+        const auto& range = state.subresource_range;
+        auto plane_count = get_image_state_tracker_plane_count(image);
+        auto plane_end = range.plane_count > 0 ? range.first_plane + range.plane_count : plane_count;
+        auto array_end = range.array_size > 0 ? range.first_array_index + range.array_size : image->array_size;
+        auto mip_end = range.mip_count > 0 ? range.first_mip_level + range.mip_count : image->mip_levels;
+        Access_Request request = {
+            .used = true,
+            .write = is_write_access(state.access),
+            .stage = state.stage,
+            .access = state.access,
+            .layout = state.layout
+        };
+        for (auto plane = range.first_plane; plane < plane_end; ++plane)
+        {
+            for (auto array_index = range.first_array_index; array_index < array_end; ++array_index)
+            {
+                for (auto mip_level = range.first_mip_level; mip_level < mip_end; ++mip_level)
+                {
+                    auto& subresource = subresources[(plane * image->array_size + array_index) * image->mip_levels + mip_level];
+                    auto barrier = make_image_state_tracker_barrier(image, mip_level, array_index, plane);
+                    if (record_access(subresource, request, barrier))
+                    {
+                        push_image_state_tracker_barrier(list_state->barriers, barrier);
+                    }
+                }
+            }
+        }
+    }
+    merge_image_state_tracker_array_slices(list_state->barriers);
+    merge_image_state_tracker_planes(list_state->barriers);
+    if (!list_state->barriers.empty())
+    {
+        command_list->barrier({
+            .buffer_barriers = {},
+            .image_barriers = list_state->barriers,
+            .memory_barriers = {}
+        });
+    }
+    return Result::Success;
+}
+
+Result Image_State_Tracker::submit(const Submit_Info& submit_info) noexcept
+{
+    if (submit_info.queue_type != m_queue_type) return Result::Error_Invalid_Parameters;
+
+    // Held until the device submit, so the queue sees the lists in the order their states were resolved.
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_command_lists.clear();
+    for (auto command_list : submit_info.command_lists)
+    {
+        auto list_state = m_command_list_states.find(command_list);
+        if (list_state == m_command_list_states.end())
+        {
+            m_command_lists.push_back(command_list);
+            continue;
+        }
+
+        // The first accesses of the list wait for the state left behind by the lists submitted before it.
+        m_barriers.clear();
+        for (auto& [image, subresources] : list_state->second->images)
+        {
+            auto& states = m_image_states[image];
+            if (states.empty())
+            {
+                states.resize(get_image_state_tracker_subresource_count(image), {
+                    .layout = Barrier_Image_Layout::Undefined,
+                    .write_stage = Barrier_Pipeline_Stage::None,
+                    .write_access = Barrier_Access::None,
+                    .read_stage = Barrier_Pipeline_Stage::None,
+                    .read_access = Barrier_Access::None
+                });
+            }
+            for (uint32_t subresource = 0; subresource < subresources.size(); ++subresource)
+            {
+                const auto& subresource_state = subresources[subresource];
+                if (!subresource_state.used) continue;
+
+                auto mip_level = subresource % image->mip_levels;
+                auto array_index = subresource / image->mip_levels % image->array_size;
+                auto plane = subresource / image->mip_levels / image->array_size;
+                auto barrier = make_image_state_tracker_barrier(image, mip_level, array_index, plane);
+                if (apply_access(states[subresource], subresource_state.entry, barrier))
+                {
+                    push_image_state_tracker_barrier(m_barriers, barrier);
+                }
+                if (subresource_state.entry_closed)
+                {
+                    states[subresource] = subresource_state.state;
+                }
+            }
+        }
+        merge_image_state_tracker_array_slices(m_barriers);
+        merge_image_state_tracker_planes(m_barriers);
+        if (!m_barriers.empty())
+        {
+            auto prologue = m_command_pool_ring->acquire_command_list();
+            prologue->barrier({
+                .buffer_barriers = {},
+                .image_barriers = m_barriers,
+                .memory_barriers = {}
+            });
+            m_command_lists.push_back(prologue);
+        }
+        m_command_lists.push_back(command_list);
+
+        list_state->second->images.clear();
+        m_free_command_list_states.push_back(std::move(list_state->second));
+        m_command_list_states.erase(list_state);
+    }
+
+    auto expanded_submit_info = submit_info;
+    expanded_submit_info.command_lists = m_command_lists;
+    return m_graphics_device->submit(expanded_submit_info);
+}
+
+void Image_State_Tracker::end_frame(uint64_t fence_value) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_command_pool_ring->end_frame(fence_value);
+}
+
+Access_State Image_State_Tracker::get_state(
+    Image* image, uint32_t mip_level, uint32_t array_index, uint32_t plane) const noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    auto states = m_image_states.find(image);
+    if (states == m_image_states.end())
+    {
+        return {
+            .layout = Barrier_Image_Layout::Undefined,
+            .write_stage = Barrier_Pipeline_Stage::None,
+            .write_access = Barrier_Access::None,
+            .read_stage = Barrier_Pipeline_Stage::None,
+            .read_access = Barrier_Access::None
+        };
+    }
+    return states->second[(plane * image->array_size + array_index) * image->mip_levels + mip_level];
+}
+
+Image_State_Tracker::Command_List_State* Image_State_Tracker::acquire_command_list_state(
+    Command_List* command_list) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    auto& list_state = m_command_list_states[command_list];
+    if (!list_state)
+    {
+        if (m_free_command_list_states.empty())
+        {
+            list_state = std::make_unique<Command_List_State>();
+        }
+        else
+        {
+            list_state = std::move(m_free_command_list_states.back());
+            m_free_command_list_states.pop_back();
+        }
+    }
+    return list_state.get();
+}
+
+bool Image_State_Tracker::record_access(
+    Subresource_State& subresource, const Access_Request& request, Image_Barrier_Info& barrier) noexcept
+{
+    if (!subresource.used)
+    {
+        subresource.used = true;
+        subresource.entry = request;
+        subresource.entry_closed = request.write;
+        subresource.state = {
+            .layout = request.layout,
+            .write_stage = request.write ? request.stage : Barrier_Pipeline_Stage::None,
+            .write_access = request.write ? request.access : Barrier_Access::None,
+            .read_stage = Barrier_Pipeline_Stage::None,
+            .read_access = Barrier_Access::None
+        };
+        return false;
+    }
+
+    if (!subresource.entry_closed)
+    {
+        // Reads in the entry layout are made visible by the barrier recorded at submit.
+        if (!request.write && request.layout == subresource.entry.layout)
+        {
+            subresource.entry.stage = subresource.entry.stage | request.stage;
+            subresource.entry.access = subresource.entry.access | request.access;
+            return false;
+        }
+        subresource.entry_closed = true;
+        subresource.state = {
+            .layout = subresource.entry.layout,
+            .write_stage = Barrier_Pipeline_Stage::None,
+            .write_access = Barrier_Access::None,
+            .read_stage = subresource.entry.stage,
+            .read_access = subresource.entry.access
+        };
+    }
+    return apply_access(subresource.state, request, barrier);
+}
+}
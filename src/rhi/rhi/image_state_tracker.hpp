@@ -0,0 +1,110 @@
+#pragma once
+
+#include "rhi/command_list.hpp"
+#include "rhi/result.hpp"
+#include "rhi/common/access_state.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace rhi
+{
+class Command_Pool_Ring;
+class Graphics_Device;
+struct Fence;
+struct Submit_Info;
+
+struct Image_State_Tracker_Create_Info
+{
+    Queue_Type queue_type; // Every list passed to the tracker is submitted to this queue.
+    uint32_t frame_count; // Frames in flight, the lists recording deferred barriers are recycled after as many frames.
+    Fence* fence; // Signaled with the values passed to `Image_State_Tracker::end_frame`.
+};
+
+// A `mip_count`, `array_size` or `plane_count` of zero selects every remaining mip level, array index or plane.
+struct Image_State_Info
+{
+    Image* image;
+    Barrier_Pipeline_Stage stage;
+    Barrier_Access access;
+    Barrier_Image_Layout layout;
+    Image_Barrier_Subresource_Range subresource_range;
+};
+
+// Tracks the layout and pending accesses of every mip level, array index and plane, so callers only name
+// the state they need next and `transition` records the barriers it requires.
+// The state earlier command lists leave behind is unknown while recording, so the first access of each
+// subresource in a list is resolved by `submit`, which records its barriers into a list submitted right before it.
+// On Vulkan both planes of a depth stencil image share one layout and have to be transitioned together,
+// identical transitions of both planes are recorded as a single barrier.
+// All functions are thread safe, `submit` holds the tracker's lock until the device submit returned.
+class Image_State_Tracker
+{
+public:
+    [[nodiscard]] static std::expected<std::unique_ptr<Image_State_Tracker>, Result> create(
+        Graphics_Device* graphics_device, const Image_State_Tracker_Create_Info& create_info) noexcept;
+    // The GPU must be done with every list submitted through the tracker.
+    ~Image_State_Tracker() noexcept;
+    Image_State_Tracker(const Image_State_Tracker& other) = delete;
+    Image_State_Tracker(Image_State_Tracker&& other) = delete;
+    Image_State_Tracker& operator=(const Image_State_Tracker& other) = delete;
+    Image_State_Tracker& operator=(Image_State_Tracker&& other) = delete;
+
+    // Every subresource starts in `initial_layout`. Images that were never registered start in `Undefined`,
+    // their contents are discarded by their first transition.
+    void register_image(Image* image, Barrier_Image_Layout initial_layout) noexcept;
+    // Must be called before the image is destroyed and after the last list using it was submitted.
+    void forget_image(Image* image) noexcept;
+
+    // Records the barriers into the state described by `states`. Barriers of subresources whose first access in
+    // `command_list` this is are deferred to `submit`. Lists may be recorded on different threads.
+    // Returns `Error_Invalid_Parameters` and records nothing if a range exceeds its image.
+    [[nodiscard]] Result transition(Command_List* command_list, std::span<const Image_State_Info> states) noexcept;
+    // Resolves the deferred barriers of the lists in submission order and forwards the submit to the device.
+    // Every list passed to `transition` must be submitted through the tracker.
+    [[nodiscard]] Result submit(const Submit_Info& submit_info) noexcept;
+    void end_frame(uint64_t fence_value) noexcept;
+
+    // State as of the last `submit`.
+    [[nodiscard]] Access_State get_state(Image* image, uint32_t mip_level, uint32_t array_index, uint32_t plane) const noexcept;
+
+private:
+    struct Subresource_State
+    {
+        bool used;
+        // Accesses before the first write or layout transition in the list, they wait for the earlier lists.
+        Access_Request entry;
+        bool entry_closed;
+        Access_State state; // Only valid once the entry is closed.
+    };
+
+    struct Command_List_State
+    {
+        std::unordered_map<Image*, std::vector<Subresource_State>> images;
+        std::vector<Image_Barrier_Info> barriers;
+    };
+
+    Image_State_Tracker() noexcept;
+
+    [[nodiscard]] Command_List_State* acquire_command_list_state(Command_List* command_list) noexcept;
+    [[nodiscard]] static bool record_access(
+        Subresource_State& subresource, const Access_Request& request, Image_Barrier_Info& barrier) noexcept;
+
+private:
+    Graphics_Device* m_graphics_device;
+    Queue_Type m_queue_type;
+    std::unique_ptr<Command_Pool_Ring> m_command_pool_ring;
+    mutable std::mutex m_mutex;
+    std::unordered_map<Command_List*, std::unique_ptr<Command_List_State>> m_command_list_states;
+    std::vector<std::unique_ptr<Command_List_State>> m_free_command_list_states;
+    // Ordered by plane, then array index and then mip level.
+    std::unordered_map<Image*, std::vector<Access_State>> m_image_states;
+    std::vector<Image_Barrier_Info> m_barriers;
+    std::vector<Command_List*> m_command_lists;
+};
+}
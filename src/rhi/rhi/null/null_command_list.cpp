@@ -0,0 +1,418 @@
+#include "rhi/null/null_command_list.hpp"
+
+#include "rhi/graphics_device.hpp"
+#include "rhi/null/null_graphics_device.hpp"
+
+#include <cstddef>
+#include <cstring>
+
+namespace rhi::null
+{
+constexpr static std::size_t COMMAND_ALIGNMENT = alignof(uint64_t);
+constexpr static std::size_t INITIAL_COMMAND_STREAM_SIZE = 1ull << 16;
+
+Null_Command_List::Null_Command_List(Null_Graphics_Device* device, Queue_Type queue_type) noexcept
+    : m_device(device)
+    , m_command_stream()
+    , m_command_count(0)
+{
+    m_queue_type = queue_type;
+    m_command_stream.reserve(INITIAL_COMMAND_STREAM_SIZE);
+}
+
+Graphics_API Null_Command_List::get_graphics_api() const noexcept
+{
+    return Graphics_API::Null;
+}
+
+void Null_Command_List::record_barrier(const Barrier_Info& barrier_info) noexcept
+{
+    auto header_offset = begin_command(Null_Command_Type::Barrier);
+    uint32_t counts[] = {
+        uint32_t(barrier_info.buffer_barriers.size()),
+        uint32_t(barrier_info.image_barriers.size()),
+        uint32_t(barrier_info.memory_barriers.size())
+    };
+    write(counts, sizeof(counts));
+    write(barrier_info.buffer_barriers.data(), barrier_info.buffer_barriers.size_bytes());
+    write(barrier_info.image_barriers.data(), barrier_info.image_barriers.size_bytes());
+    write(barrier_info.memory_barriers.data(), barrier_info.memory_barriers.size_bytes());
+    end_command(header_offset);
+}
+
+void Null_Command_List::dispatch(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Dispatch, groups_x, groups_y, groups_z);
+}
+
+void Null_Command_List::dispatch_indirect(Buffer* buffer, uint64_t offset) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Dispatch_Indirect, buffer, offset);
+}
+
+void Null_Command_List::copy_buffer(Buffer* src, uint64_t src_offset, Buffer* dst, uint64_t dst_offset, uint64_t size) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Copy_Buffer, src, src_offset, dst, dst_offset, size);
+}
+
+void Null_Command_List::copy_buffer_to_image(
+    Buffer* src, uint64_t src_offset,
+    Image* dst, const Offset_3D& dst_offset, const Extent_3D& dst_extent,
+    uint32_t dst_mip_level, uint32_t dst_array_index, uint32_t src_row_pitch) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Copy_Buffer_To_Image,
+        src, src_offset, dst, dst_offset, dst_extent, dst_mip_level, dst_array_index, src_row_pitch);
+}
+
+void Null_Command_List::copy_image(
+    Image* src, const Offset_3D& src_offset, uint32_t src_mip_level, uint32_t src_array_index,
+    Image* dst, const Offset_3D& dst_offset, uint32_t dst_mip_level, uint32_t dst_array_index,
+    const Extent_3D& extent) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Copy_Image,
+        src, src_offset, src_mip_level, src_array_index,
+        dst, dst_offset, dst_mip_level, dst_array_index,
+        extent);
+}
+
+void Null_Command_List::copy_image_to_buffer(
+    Image* src, const Offset_3D& src_offset, const Extent_3D& src_extent,
+    uint32_t src_mip_level, uint32_t src_array_index,
+    Buffer* dst, uint64_t dst_offset) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Copy_Image_To_Buffer,
+        src, src_offset, src_extent, src_mip_level, src_array_index, dst, dst_offset);
+}
+
+void Null_Command_List::fill_buffer(Buffer_View* dst, uint32_t value) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Fill_Buffer, dst, value);
+}
+
+void Null_Command_List::begin_debug_region(const char* name, float r, float g, float b) noexcept
+{
+    auto header_offset = begin_command(Null_Command_Type::Begin_Debug_Region);
+    auto name_length = uint32_t(name ? std::strlen(name) : 0);
+    write(&r, sizeof(r));
+    write(&g, sizeof(g));
+    write(&b, sizeof(b));
+    write(&name_length, sizeof(name_length));
+    write(name, name_length);
+    end_command(header_offset);
+}
+
+void Null_Command_List::add_debug_marker(const char* name, float r, float g, float b) noexcept
+{
+    auto header_offset = begin_command(Null_Command_Type::Add_Debug_Marker);
+    auto name_length = uint32_t(name ? std::strlen(name) : 0);
+    write(&r, sizeof(r));
+    write(&g, sizeof(g));
+    write(&b, sizeof(b));
+    write(&name_length, sizeof(name_length));
+    write(name, name_length);
+    end_command(header_offset);
+}
+
+void Null_Command_List::end_debug_region() noexcept
+{
+    encode(Null_Command_Type::End_Debug_Region);
+}
+
+void Null_Command_List::clear_color_attachment(Image_View* image, float r, float g, float b, float a) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Clear_Color_Attachment, image, r, g, b, a);
+}
+
+void Null_Command_List::clear_depth_stencil_attachment(Image_View* image, float d, uint8_t s) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Clear_Depth_Stencil_Attachment, image, d, s);
+}
+
+void Null_Command_List::draw(
+    uint32_t vertex_count, uint32_t instance_count, uint32_t vertex_offset, uint32_t instance_offset) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw, vertex_count, instance_count, vertex_offset, instance_offset);
+}
+
+void Null_Command_List::draw_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Indirect, buffer, offset, count);
+}
+
+void Null_Command_List::draw_indirect_count(
+    Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Indirect_Count, buffer, offset, max_draw_count, count_buffer, count_offset);
+}
+
+void Null_Command_List::draw_indexed(
+    uint32_t index_count, uint32_t instance_count, uint32_t index_offset, uint32_t vertex_offset, uint32_t instance_offset) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Indexed, index_count, instance_count, index_offset, vertex_offset, instance_offset);
+}
+
+void Null_Command_List::draw_indexed_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Indexed_Indirect, buffer, offset, count);
+}
+
+void Null_Command_List::draw_indexed_indirect_count(
+    Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Indexed_Indirect_Count, buffer, offset, max_draw_count, count_buffer, count_offset);
+}
+
+void Null_Command_List::draw_mesh_tasks(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Mesh_Tasks, groups_x, groups_y, groups_z);
+}
+
+void Null_Command_List::draw_mesh_tasks_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Mesh_Tasks_Indirect, buffer, offset, count);
+}
+
+void Null_Command_List::draw_mesh_tasks_indirect_count(
+    Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Draw_Mesh_Tasks_Indirect_Count, buffer, offset, max_draw_count, count_buffer, count_offset);
+}
+
+void Null_Command_List::execute_secondary(Command_List* command_list) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Execute_Secondary, command_list);
+}
+
+void Null_Command_List::begin_render_pass(const Render_Pass_Begin_Info& begin_info) noexcept
+{
+    flush_barriers();
+    auto header_offset = begin_command(Null_Command_Type::Begin_Render_Pass);
+    auto color_attachment_count = uint32_t(begin_info.color_attachments.size());
+    write(&color_attachment_count, sizeof(color_attachment_count));
+    write(begin_info.color_attachments.data(), begin_info.color_attachments.size_bytes());
+    write(&begin_info.depth_stencil_attachment, sizeof(begin_info.depth_stencil_attachment));
+    write(&begin_info.secondary_command_lists, sizeof(begin_info.secondary_command_lists));
+    end_command(header_offset);
+}
+
+void Null_Command_List::end_render_pass() noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::End_Render_Pass);
+}
+
+void Null_Command_List::set_pipeline(Pipeline* pipeline) noexcept
+{
+    encode(Null_Command_Type::Set_Pipeline, pipeline);
+}
+
+void Null_Command_List::set_depth_bounds(float min, float max) noexcept
+{
+    encode(Null_Command_Type::Set_Depth_Bounds, min, max);
+}
+
+void Null_Command_List::set_index_buffer(Buffer* buffer, Index_Type index_type) noexcept
+{
+    set_index_buffer(buffer, index_type, 0, buffer ? buffer->size : 0);
+}
+
+void Null_Command_List::set_index_buffer(Buffer* buffer, Index_Type index_type, uint64_t offset, uint64_t size) noexcept
+{
+    encode(Null_Command_Type::Set_Index_Buffer, buffer, index_type, offset, size);
+}
+
+void Null_Command_List::set_push_constants(const void* data, uint32_t size, Pipeline_Bind_Point bind_point) noexcept
+{
+    auto header_offset = begin_command(Null_Command_Type::Set_Push_Constants);
+    write(&bind_point, sizeof(bind_point));
+    write(&size, sizeof(size));
+    write(data, size);
+    end_command(header_offset);
+}
+
+void Null_Command_List::set_scissor(int32_t x, int32_t y, uint32_t width, uint32_t height) noexcept
+{
+    encode(Null_Command_Type::Set_Scissor, x, y, width, height);
+}
+
+void Null_Command_List::set_viewport(float x, float y, float width, float height, float min_depth, float max_depth) noexcept
+{
+    encode(Null_Command_Type::Set_Viewport, x, y, width, height, min_depth, max_depth);
+}
+
+void Null_Command_List::set_stencil_reference(uint8_t reference) noexcept
+{
+    encode(Null_Command_Type::Set_Stencil_Reference, reference);
+}
+
+void Null_Command_List::build_acceleration_structure(
+    const Acceleration_Structure_Build_Geometry_Info& build_info, uint64_t scratch_memory_address) noexcept
+{
+    flush_barriers();
+    auto header_offset = begin_command(Null_Command_Type::Build_Acceleration_Structure);
+    write(&build_info, sizeof(build_info));
+    write(&scratch_memory_address, sizeof(scratch_memory_address));
+    if (build_info.type == Acceleration_Structure_Type::Bottom_Level && build_info.geometry)
+    {
+        write(build_info.geometry, sizeof(Acceleration_Structure_Geometry_Data) * build_info.geometry_or_instance_count);
+    }
+    end_command(header_offset);
+}
+
+void Null_Command_List::dispatch_rays(
+    uint32_t groups_x, uint32_t groups_y, uint32_t groups_z, const Shader_Binding_Table& sbt) noexcept
+{
+    flush_barriers();
+    encode(Null_Command_Type::Dispatch_Rays, groups_x, groups_y, groups_z, sbt);
+}
+
+void Null_Command_List::reset() noexcept
+{
+    m_command_stream.clear();
+    m_command_count = 0;
+    reset_barrier_batching();
+}
+
+std::span<const uint8_t> Null_Command_List::get_command_stream() const noexcept
+{
+    return m_command_stream;
+}
+
+uint64_t Null_Command_List::get_command_count() const noexcept
+{
+    return m_command_count;
+}
+
+std::size_t Null_Command_List::begin_command(Null_Command_Type type) noexcept
+{
+    auto header_offset = m_command_stream.size();
+    Null_Command_Header header = {
+        .type = type,
+        .size = 0
+    };
+    write(&header, sizeof(header));
+    return header_offset;
+}
+
+void Null_Command_List::write(const void* data, std::size_t size) noexcept
+{
+    if (size == 0) return;
+
+    auto offset = m_command_stream.size();
+    m_command_stream.resize(offset + size);
+    std::memcpy(m_command_stream.data() + offset, data, size);
+}
+
+void Null_Command_List::end_command(std::size_t header_offset) noexcept
+{
+    auto aligned_size = (m_command_stream.size() + COMMAND_ALIGNMENT - 1) & ~(COMMAND_ALIGNMENT - 1);
+    m_command_stream.resize(aligned_size);
+    auto payload_size = uint32_t(aligned_size - header_offset - sizeof(Null_Command_Header));
+    std::memcpy(
+        m_command_stream.data() + header_offset + offsetof(Null_Command_Header, size),
+        &payload_size,
+        sizeof(payload_size));
+    m_command_count += 1;
+}
+
+Null_Command_Pool::Null_Command_Pool(
+    Null_Graphics_Device* device,
+    const Command_Pool_Create_Info& create_info) noexcept
+    : m_queue_type(create_info.queue_type)
+    , m_device(device)
+    , m_use_mutex(create_info.thread_safe)
+    , m_mutex()
+    , m_used()
+    , m_unused()
+    , m_command_lists()
+    , m_secondary_command_lists()
+{}
+
+Null_Command_Pool::~Null_Command_Pool() noexcept
+{
+    reset();
+    m_command_lists.clear();
+}
+
+void Null_Command_Pool::reset() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    for (auto command_list : m_used)
+    {
+        command_list->reset();
+    }
+    m_unused.insert(m_unused.end(), m_used.begin(), m_used.end());
+    m_used.clear();
+}
+
+Command_List* Null_Command_Pool::acquire_command_list() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    Null_Command_List* command_list = nullptr;
+    if (m_unused.empty())
+    {
+        command_list = m_command_lists.emplace_back(std::make_unique<Null_Command_List>(m_device, m_queue_type)).get();
+    }
+    else
+    {
+        command_list = m_unused.back();
+        m_unused.pop_back();
+    }
+    m_used.push_back(command_list);
+    return command_list;
+}
+
+Command_List* Null_Command_Pool::create_secondary_command_list(
+    [[maybe_unused]] const Secondary_Command_List_Create_Info& create_info) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    return m_secondary_command_lists.emplace_back(std::make_unique<Null_Command_List>(m_device, m_queue_type)).get();
+}
+
+void Null_Command_Pool::end_secondary_command_list([[maybe_unused]] Command_List* command_list) noexcept
+{}
+
+void Null_Command_Pool::destroy_secondary_command_list(Command_List* command_list) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    std::erase_if(m_secondary_command_lists, [command_list](const auto& secondary_command_list)
+        {
+            return secondary_command_list.get() == command_list;
+        });
+}
+}
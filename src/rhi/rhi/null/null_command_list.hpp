@@ -0,0 +1,176 @@
+#pragma once
+
+#include "rhi/command_list.hpp"
+
+#include <memory>
+#include <mutex>
+#include <span>
+#include <type_traits>
+#include <vector>
+
+namespace rhi::null
+{
+class Null_Graphics_Device;
+
+enum class Null_Command_Type : uint32_t
+{
+    Barrier,
+    Dispatch,
+    Dispatch_Indirect,
+    Copy_Buffer,
+    Copy_Buffer_To_Image,
+    Copy_Image,
+    Copy_Image_To_Buffer,
+    Fill_Buffer,
+    Begin_Debug_Region,
+    Add_Debug_Marker,
+    End_Debug_Region,
+    Clear_Color_Attachment,
+    Clear_Depth_Stencil_Attachment,
+    Draw,
+    Draw_Indirect,
+    Draw_Indirect_Count,
+    Draw_Indexed,
+    Draw_Indexed_Indirect,
+    Draw_Indexed_Indirect_Count,
+    Draw_Mesh_Tasks,
+    Draw_Mesh_Tasks_Indirect,
+    Draw_Mesh_Tasks_Indirect_Count,
+    Execute_Secondary,
+    Begin_Render_Pass,
+    End_Render_Pass,
+    Set_Pipeline,
+    Set_Depth_Bounds,
+    Set_Index_Buffer,
+    Set_Push_Constants,
+    Set_Scissor,
+    Set_Viewport,
+    Set_Stencil_Reference,
+    Build_Acceleration_Structure,
+    Dispatch_Rays
+};
+
+// Every encoded command starts with this header, followed by `size` bytes of tightly packed arguments.
+// `size` is padded so that every header is 8 byte aligned inside the command stream.
+struct Null_Command_Header
+{
+    Null_Command_Type type;
+    uint32_t size;
+};
+
+class Null_Command_List final : public Command_List
+{
+public:
+    Null_Command_List(Null_Graphics_Device* device, Queue_Type queue_type) noexcept;
+
+    // Meta commands
+    [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept override;
+
+    // Compute commands
+    virtual void dispatch(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept override;
+    virtual void dispatch_indirect(Buffer* buffer, uint64_t offset) noexcept override;
+
+    // Copy commands
+    virtual void copy_buffer(Buffer* src, uint64_t src_offset, Buffer* dst, uint64_t dst_offset, uint64_t size) noexcept override;
+    virtual void copy_buffer_to_image(
+        Buffer* src, uint64_t src_offset,
+        Image* dst, const Offset_3D& dst_offset, const Extent_3D& dst_extent,
+        uint32_t dst_mip_level, uint32_t dst_array_index, uint32_t src_row_pitch = 0) noexcept override;
+    virtual void copy_image(
+        Image* src, const Offset_3D& src_offset, uint32_t src_mip_level, uint32_t src_array_index,
+        Image* dst, const Offset_3D& dst_offset, uint32_t dst_mip_level, uint32_t dst_array_index,
+        const Extent_3D& extent) noexcept override;
+    virtual void copy_image_to_buffer(
+        Image* src, const Offset_3D& src_offset, const Extent_3D& src_extent,
+        uint32_t src_mip_level, uint32_t src_array_index,
+        Buffer* dst, uint64_t dst_offset) noexcept override;
+    virtual void fill_buffer(Buffer_View* dst, uint32_t value) noexcept override;
+
+    // Debug commands
+    virtual void begin_debug_region(const char* name, float r, float g, float b) noexcept override;
+    virtual void add_debug_marker(const char* name, float r, float g, float b)  noexcept override;
+    virtual void end_debug_region() noexcept override;
+
+    // Draw commands
+    virtual void clear_color_attachment(Image_View* image, float r, float g, float b, float a) noexcept override;
+    virtual void clear_depth_stencil_attachment(Image_View* image, float d, uint8_t s) noexcept override;
+    virtual void draw(uint32_t vertex_count, uint32_t instance_count, uint32_t vertex_offset, uint32_t instance_offset) noexcept override;
+    virtual void draw_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept override;
+    virtual void draw_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept override;
+    virtual void draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t index_offset, uint32_t vertex_offset, uint32_t instance_offset) noexcept override;
+    virtual void draw_indexed_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept override;
+    virtual void draw_indexed_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept override;
+    virtual void draw_mesh_tasks(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept override;
+    virtual void draw_mesh_tasks_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept override;
+    virtual void draw_mesh_tasks_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept override;
+    virtual void execute_secondary(Command_List* command_list) noexcept override;
+
+    // State commands
+    virtual void begin_render_pass(const Render_Pass_Begin_Info& begin_info) noexcept override;
+    virtual void end_render_pass() noexcept override;
+    virtual void set_pipeline(Pipeline* pipeline) noexcept override;
+    virtual void set_depth_bounds(float min, float max) noexcept override;
+    virtual void set_index_buffer(Buffer* buffer, Index_Type index_type) noexcept override;
+    virtual void set_index_buffer(Buffer* buffer, Index_Type index_type, uint64_t offset, uint64_t size) noexcept override;
+    virtual void set_push_constants(const void* data, uint32_t size, Pipeline_Bind_Point bind_point) noexcept override;
+    virtual void set_scissor(int32_t x, int32_t y, uint32_t width, uint32_t height) noexcept override;
+    virtual void set_viewport(float x, float y, float width, float height, float min_depth, float max_depth) noexcept override;
+    virtual void set_stencil_reference(uint8_t reference) noexcept override;
+
+    virtual void build_acceleration_structure(
+        const Acceleration_Structure_Build_Geometry_Info& build_info, uint64_t scratch_memory_address) noexcept override;
+    virtual void dispatch_rays(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z, const Shader_Binding_Table& sbt) noexcept override;
+
+    // Clears the encoded commands but keeps the allocated stream memory.
+    void reset() noexcept;
+
+    [[nodiscard]] std::span<const uint8_t> get_command_stream() const noexcept;
+    [[nodiscard]] uint64_t get_command_count() const noexcept;
+
+protected:
+    virtual void record_barrier(const Barrier_Info& barrier_info) noexcept override;
+
+private:
+    [[nodiscard]] std::size_t begin_command(Null_Command_Type type) noexcept;
+    void write(const void* data, std::size_t size) noexcept;
+    void end_command(std::size_t header_offset) noexcept;
+
+    template<typename... Args>
+    void encode(Null_Command_Type type, const Args&... args) noexcept
+    {
+        static_assert((std::is_trivially_copyable_v<Args> && ...));
+        auto header_offset = begin_command(type);
+        (write(&args, sizeof(Args)), ...);
+        end_command(header_offset);
+    }
+
+private:
+    Null_Graphics_Device* m_device;
+    std::vector<uint8_t> m_command_stream;
+    uint64_t m_command_count;
+};
+
+class Null_Command_Pool final : public Command_Pool
+{
+public:
+    Null_Command_Pool(Null_Graphics_Device* device, const Command_Pool_Create_Info& create_info) noexcept;
+    virtual ~Null_Command_Pool() noexcept;
+
+    virtual void reset() noexcept override;
+    virtual Command_List* acquire_command_list() noexcept override;
+
+    virtual Command_List* create_secondary_command_list(const Secondary_Command_List_Create_Info& create_info) noexcept override;
+    virtual void end_secondary_command_list(Command_List* command_list) noexcept override;
+    virtual void destroy_secondary_command_list(Command_List* command_list) noexcept override;
+
+private:
+    Queue_Type m_queue_type;
+    Null_Graphics_Device* m_device;
+    bool m_use_mutex;
+    std::mutex m_mutex;
+    std::vector<Null_Command_List*> m_used;
+    std::vector<Null_Command_List*> m_unused;
+    std::vector<std::unique_ptr<Null_Command_List>> m_command_lists;
+    std::vector<std::unique_ptr<Null_Command_List>> m_secondary_command_lists;
+};
+}
@@ -0,0 +1,1082 @@
+#include "rhi/null/null_graphics_device.hpp"
+
+#include "rhi/null/null_command_list.hpp"
+#include "rhi/null/null_swapchain.hpp"
+#include "rhi/image_format.hpp"
+#include "rhi/shader_archive.hpp"
+#include "rhi/shader_container.hpp"
+#include "rhi/common/pipeline_cache_file.hpp"
+#include "rhi/common/pipeline_hash.hpp"
+#include "rhi/common/pipeline_reflection.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace rhi::null
+{
+// Start away from zero so that a null gpu address is never handed out.
+constexpr static uint64_t NULL_GPU_ADDRESS_BASE = 1ull << 32;
+
+Null_Graphics_Device::Null_Graphics_Device(const Graphics_Device_Create_Info& create_info) noexcept
+    : m_ray_tracing_pipeline_properties({
+        .shader_group_handle_size = 32,
+        .shader_group_handle_alignment = 32,
+        .shader_group_base_alignment = 64,
+        .max_recursion_depth = 31
+        })
+    , m_use_mutex(create_info.enable_locking)
+    , m_next_gpu_address(NULL_GPU_ADDRESS_BASE)
+    , m_next_pipeline_id(0)
+    , m_pipeline_cache_mutex()
+    , m_pipeline_cache()
+    , m_pending_submits()
+    , m_submit_statistics()
+    , m_resource_pool(std::make_unique<Null_Resource_Pool>(
+        MAX_RESOURCE_INDEX - create_info.reserved_bindless_resource_index_count,
+        MAX_SAMPLER_INDEX - create_info.reserved_bindless_sampler_index_count,
+        2, // Same stride as the other backends so bindless indices match.
+        decltype(m_resource_pool)::element_type::Deleters {
+            .buffer_delete_function = [](Null_Buffer* buffer) {
+                if (buffer)
+                {
+                    buffer->memory = {};
+                    buffer->name = {};
+                    buffer->data = nullptr;
+                }
+            },
+            .buffer_view_delete_function = []([[maybe_unused]] Null_Buffer_View* buffer_view) {},
+            .image_delete_function = [](Null_Image* image) {
+                if (image)
+                {
+                    image->name = {};
+                }
+            },
+            .image_view_delete_function = []([[maybe_unused]] Null_Image_View* image_view) {},
+            .sampler_delete_function = []([[maybe_unused]] Null_Sampler* sampler) {},
+            .acceleration_structure_delete_function = []([[maybe_unused]] Null_Acceleration_Structure* acceleration_structure) {}
+        }))
+    , m_pipeline_registry()
+    , m_pipeline_compiler([this](Pipeline* pipeline) { return compile_pipeline(static_cast<Null_Pipeline*>(pipeline)); })
+{}
+
+Null_Graphics_Device::~Null_Graphics_Device() noexcept
+{
+    m_pipeline_compiler.shutdown();
+    wait_idle();
+    m_resource_pool.reset();
+}
+
+Result Null_Graphics_Device::wait_idle() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_queue_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    retire_pending_submits();
+    for (const auto& pending_submits : m_pending_submits)
+    {
+        if (!pending_submits.empty())
+        {
+            return Result::Wait_Timeout;
+        }
+    }
+    return Result::Success;
+}
+
+Result Null_Graphics_Device::queue_wait_idle(Queue_Type queue, [[maybe_unused]] uint64_t timeout) noexcept
+{
+    auto queue_slot = get_queue_slot(queue);
+    if (queue_slot >= QUEUE_COUNT)
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_queue_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    retire_pending_submits();
+    return m_pending_submits[queue_slot].empty()
+        ? Result::Success
+        : Result::Wait_Timeout;
+}
+
+Graphics_API Null_Graphics_Device::get_graphics_api() const noexcept
+{
+    return Graphics_API::Null;
+}
+
+std::unique_ptr<Swapchain> Null_Graphics_Device::create_swapchain(const Swapchain_Win32_Create_Info& create_info) noexcept
+{
+    return std::make_unique<Null_Swapchain>(this, create_info);
+}
+
+std::unique_ptr<Command_Pool> Null_Graphics_Device::create_command_pool(const Command_Pool_Create_Info& create_info) noexcept
+{
+    return std::make_unique<Null_Command_Pool>(this, create_info);
+}
+
+std::expected<Fence*, Result> Null_Graphics_Device::create_fence(uint64_t initial_value) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    Null_Fence* fence = &*m_fences.emplace();
+    fence->value = initial_value;
+    fence->device = this;
+    return fence;
+}
+
+void Null_Graphics_Device::destroy_fence(Fence* fence) noexcept
+{
+    if (!fence) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_fences.erase(m_fences.get_iterator(static_cast<Null_Fence*>(fence)));
+}
+
+std::expected<Buffer*, Result> Null_Graphics_Device::create_buffer(
+    const Buffer_Create_Info& create_info, uint32_t index) noexcept
+{
+    if (create_info.size == 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* buffer = m_resource_pool->acquire_buffer(create_info, index);
+    if (!buffer) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
+    if (create_info.heap != Memory_Heap_Type::GPU)
+    {
+        buffer->memory.resize(create_info.size);
+        buffer->data = buffer->memory.data();
+    }
+    else
+    {
+        buffer->data = nullptr;
+    }
+    buffer->gpu_address = allocate_gpu_address(create_info.size);
+
+    return buffer;
+}
+
+std::expected<Buffer_View*, Result> Null_Graphics_Device::create_buffer_view(
+    Buffer* buffer, const Buffer_View_Create_Info& create_info, uint32_t index) noexcept
+{
+    if (!buffer) return std::unexpected(Result::Error_Invalid_Parameters);
+
+    if (create_info.size + create_info.offset > buffer->size)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* buffer_view = m_resource_pool->acquire_buffer_view(buffer, create_info, index);
+    if (!buffer_view) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
+    return buffer_view;
+}
+
+Result Null_Graphics_Device::update_buffer_view(
+    Buffer_View* buffer_view, const Buffer_View_Create_Info& create_info) noexcept
+{
+    if (!buffer_view) return Result::Error_Invalid_Parameters;
+
+    if (create_info.size + create_info.offset > buffer_view->buffer->size)
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    buffer_view->size = create_info.size;
+    buffer_view->offset = create_info.offset;
+
+    return Result::Success;
+}
+
+void Null_Graphics_Device::destroy_buffer(Buffer* buffer) noexcept
+{
+    if (!buffer) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_resource_pool->release_buffer(buffer);
+}
+
+std::expected<Memory_Heap*, Result> Null_Graphics_Device::create_memory_heap(
+    const Memory_Heap_Create_Info& create_info) noexcept
+{
+    if (create_info.size == 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* memory_heap = &*m_memory_heaps.emplace();
+    memory_heap->size = create_info.size;
+    memory_heap->heap_type = create_info.heap;
+    if (create_info.heap != Memory_Heap_Type::GPU)
+    {
+        memory_heap->memory.resize(create_info.size);
+    }
+    memory_heap->gpu_address = allocate_gpu_address(create_info.size);
+
+    return memory_heap;
+}
+
+void Null_Graphics_Device::destroy_memory_heap(Memory_Heap* memory_heap) noexcept
+{
+    if (!memory_heap) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_memory_heaps.erase(m_memory_heaps.get_iterator(static_cast<Null_Memory_Heap*>(memory_heap)));
+}
+
+Memory_Requirements Null_Graphics_Device::get_memory_requirements(const Buffer_Create_Info& create_info) noexcept
+{
+    return {
+        .size = (create_info.size + NULL_GPU_ADDRESS_ALIGNMENT - 1) & ~(NULL_GPU_ADDRESS_ALIGNMENT - 1),
+        .alignment = NULL_GPU_ADDRESS_ALIGNMENT
+    };
+}
+
+Memory_Requirements Null_Graphics_Device::get_memory_requirements(const Image_Create_Info& create_info) noexcept
+{
+    uint64_t size = 0;
+    for (uint32_t mip_level = 0; mip_level < create_info.mip_levels; ++mip_level)
+    {
+        size += get_image_copy_footprint(
+            create_info.format,
+            std::max(create_info.width >> mip_level, 1u),
+            std::max(create_info.height >> mip_level, 1u),
+            std::max(create_info.depth >> mip_level, 1u)).size;
+    }
+    size *= std::max<uint64_t>(create_info.array_size, 1);
+    return {
+        .size = (std::max<uint64_t>(size, 1) + NULL_PLACED_IMAGE_ALIGNMENT - 1) & ~(NULL_PLACED_IMAGE_ALIGNMENT - 1),
+        .alignment = NULL_PLACED_IMAGE_ALIGNMENT
+    };
+}
+
+std::expected<Buffer*, Result> Null_Graphics_Device::create_placed_buffer(
+    const Buffer_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset, uint32_t index) noexcept
+{
+    if (create_info.size == 0 || !memory_heap || create_info.heap != memory_heap->heap_type
+        || !is_placement_valid(get_memory_requirements(create_info), memory_heap, offset))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* buffer = m_resource_pool->acquire_buffer(create_info, index);
+    if (!buffer) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
+    auto* null_memory_heap = static_cast<Null_Memory_Heap*>(memory_heap);
+    buffer->data = null_memory_heap->memory.empty()
+        ? nullptr
+        : null_memory_heap->memory.data() + offset;
+    buffer->gpu_address = null_memory_heap->gpu_address + offset;
+
+    return buffer;
+}
+
+std::expected<Image*, Result> Null_Graphics_Device::create_placed_image(
+    const Image_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset, uint32_t index) noexcept
+{
+    if (!memory_heap || memory_heap->heap_type != Memory_Heap_Type::GPU
+        || !is_placement_valid(get_memory_requirements(create_info), memory_heap, offset))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    return create_image(create_info, index);
+}
+
+Result Null_Fence::get_status(uint64_t value) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(device->m_fence_mutex);
+    return this->value >= value
+        ? Result::Success
+        : Result::Wait_Timeout;
+}
+
+Result Null_Fence::wait_for_value(uint64_t value) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(device->m_fence_mutex);
+    device->m_fence_condition.wait(lock_guard, [this, value]() { return this->value >= value; });
+    return Result::Success;
+}
+
+std::expected<Image*, Result> Null_Graphics_Device::create_image(const Image_Create_Info& create_info, uint32_t index) noexcept
+{
+    // illegal to be both color and depth attachment.
+    if ((create_info.usage & (Image_Usage::Color_Attachment | Image_Usage::Depth_Stencil_Attachment))
+        == (Image_Usage::Color_Attachment | Image_Usage::Depth_Stencil_Attachment))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* image = m_resource_pool->acquire_image(create_info, index);
+    if (!image) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
+    image->image_view->next_image_view = nullptr;
+
+    return image;
+}
+
+std::expected<Image_View*, Result> Null_Graphics_Device::create_image_view(
+    Image* image, const Image_View_Create_Info& create_info, uint32_t index) noexcept
+{
+    if (!image) return std::unexpected(Result::Error_Invalid_Parameters);
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* image_view = m_resource_pool->acquire_image_view(image, create_info, index);
+    if (!image_view) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
+    image_view->descriptor_type = create_info.descriptor_type;
+
+    return image_view;
+}
+
+void Null_Graphics_Device::destroy_image(Image* image) noexcept
+{
+    if (!image) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_resource_pool->release_image(image);
+}
+
+std::expected<Sampler*, Result> Null_Graphics_Device::create_sampler(const Sampler_Create_Info& create_info, uint32_t index) noexcept
+{
+    // A sampler with comparison must have a comparison function
+    if (create_info.comparison_func == Comparison_Func::None &&
+        create_info.reduction == Sampler_Reduction_Type::Comparison)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* sampler = m_resource_pool->acquire_sampler(index);
+    if (!sampler) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
+    return sampler;
+}
+
+void Null_Graphics_Device::destroy_sampler(Sampler* sampler) noexcept
+{
+    if (!sampler) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_resource_pool->release_sampler(sampler);
+}
+
+std::expected<Acceleration_Structure*, Result> Null_Graphics_Device::create_acceleration_structure(
+    const Acceleration_Structure_Create_Info& create_info) noexcept
+{
+    if (!create_info.buffer || create_info.offset + create_info.size > create_info.buffer->size)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+    if (create_info.offset % 256 != 0)
+    {
+        return std::unexpected(Result::Error_Acceleration_Structure_Invalid_Alignment);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* acceleration_structure = m_resource_pool->acquire_acceleration_structure(NO_RESOURCE_INDEX);
+    if (!acceleration_structure) return std::unexpected(Result::Error_Out_Of_Descriptors);
+
+    acceleration_structure->buffer = create_info.buffer;
+    acceleration_structure->address = create_info.buffer->gpu_address + create_info.offset;
+    acceleration_structure->type = create_info.type;
+
+    return acceleration_structure;
+}
+
+void Null_Graphics_Device::destroy_acceleration_structure(Acceleration_Structure* acceleration_structure) noexcept
+{
+    if (!acceleration_structure) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_resource_pool->release_acceleration_structure(acceleration_structure);
+}
+
+std::expected<Shader_Blob*, Result> Null_Graphics_Device::create_shader_blob(const Shader_Blob_Create_Info& create_info) noexcept
+{
+    static_assert(
+        sizeof(decltype(Shader_Blob::data)::value_type) == sizeof(uint8_t),
+        "Size of blob changed.");
+
+    if (create_info.data == nullptr || create_info.data_size == 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    auto content_hash = hash_shader_blob_contents(
+        create_info.data, create_info.data_size, create_info.groups_x, create_info.groups_y, create_info.groups_z);
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto blob = &*m_shader_blobs.emplace();
+    blob->storage.assign(
+        static_cast<const uint8_t*>(create_info.data),
+        static_cast<const uint8_t*>(create_info.data) + create_info.data_size);
+    blob->data = blob->storage;
+    blob->groups_x = create_info.groups_x;
+    blob->groups_y = create_info.groups_y;
+    blob->groups_z = create_info.groups_z;
+    blob->content_hash = content_hash;
+    return blob;
+}
+
+Result Null_Graphics_Device::recreate_shader_blob(Shader_Blob* shader_blob, const Shader_Blob_Create_Info& create_info) noexcept
+{
+    if (!shader_blob) return Result::Error_Invalid_Parameters;
+
+    shader_blob->storage.assign(
+        static_cast<const uint8_t*>(create_info.data),
+        static_cast<const uint8_t*>(create_info.data) + create_info.data_size);
+    shader_blob->data = shader_blob->storage;
+    shader_blob->groups_x = create_info.groups_x;
+    shader_blob->groups_y = create_info.groups_y;
+    shader_blob->groups_z = create_info.groups_z;
+    shader_blob->reflection = {};
+    shader_blob->content_hash = hash_shader_blob_contents(
+        shader_blob->data.data(),
+        shader_blob->data.size(),
+        shader_blob->groups_x,
+        shader_blob->groups_y,
+        shader_blob->groups_z);
+
+    return Result::Success;
+}
+
+Result Null_Graphics_Device::recreate_shader_blob_deserialize_memory(
+    Shader_Blob* shader_blob, const void* memory, uint64_t memory_size) noexcept
+{
+    if (!shader_blob || !memory) return Result::Error_Invalid_Parameters;
+
+    auto contents = read_shader_container({ static_cast<const uint8_t*>(memory), memory_size });
+    if (!contents) return contents.error();
+    if (contents->dxil.empty()) return Result::Error_Invalid_Parameters;
+    auto reflection = read_shader_reflection(contents->reflection);
+    if (!reflection) return reflection.error();
+
+    shader_blob->storage.assign(contents->dxil.begin(), contents->dxil.end());
+    shader_blob->data = shader_blob->storage;
+    shader_blob->groups_x = contents->groups_x;
+    shader_blob->groups_y = contents->groups_y;
+    shader_blob->groups_z = contents->groups_z;
+    shader_blob->reflection = std::move(*reflection);
+    shader_blob->content_hash = hash_shader_blob_contents(
+        shader_blob->data.data(),
+        shader_blob->data.size(),
+        shader_blob->groups_x,
+        shader_blob->groups_y,
+        shader_blob->groups_z);
+
+    return Result::Success;
+}
+
+std::expected<Shader_Blob*, Result> Null_Graphics_Device::create_shader_blob(
+    const Shader_Archive& archive, uint32_t entry_index) noexcept
+{
+    if (entry_index >= archive.get_entry_count()) return std::unexpected(Result::Error_Invalid_Parameters);
+
+    const auto& entry = archive.get_entry(entry_index);
+    auto data = archive.get_section_data(entry.dxil);
+    if (data.empty()) return std::unexpected(Result::Error_Invalid_Parameters);
+    auto reflection = read_shader_reflection(archive.get_section_data(entry.reflection));
+    if (!reflection) return std::unexpected(reflection.error());
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    // Only the DXIL section is referenced, its pages are loaded by the driver on pipeline creation.
+    auto blob = &*m_shader_blobs.emplace();
+    blob->data = data;
+    blob->groups_x = entry.groups_x;
+    blob->groups_y = entry.groups_y;
+    blob->groups_z = entry.groups_z;
+    blob->reflection = std::move(*reflection);
+    blob->content_hash = entry.dxil.content_hash;
+    return blob;
+}
+
+void Null_Graphics_Device::destroy_shader_blob(Shader_Blob* shader_blob) noexcept
+{
+    if (shader_blob == nullptr) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_shader_blobs.erase(m_shader_blobs.get_iterator(shader_blob));
+}
+
+std::expected<Pipeline*, Result> Null_Graphics_Device::create_pipeline(const Graphics_Pipeline_Create_Info& create_info) noexcept
+{
+    if (!create_info.vs) return std::unexpected(Result::Error_Invalid_Parameters);
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return std::unexpected(validation_result);
+    auto pipeline_hash = hash_pipeline(create_info);
+    record_pipeline(pipeline_hash);
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    auto pipeline = &*m_pipelines.emplace();
+    pipeline->type = Pipeline_Type::Vertex_Shading;
+    pipeline->vertex_shading_info = create_info;
+    pipeline->id = m_next_pipeline_id++;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
+
+    return pipeline;
+}
+
+std::expected<Pipeline*, Result> Null_Graphics_Device::create_pipeline(const Compute_Pipeline_Create_Info& create_info) noexcept
+{
+    if (!create_info.cs) return std::unexpected(Result::Error_Invalid_Parameters);
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return std::unexpected(validation_result);
+    auto pipeline_hash = hash_pipeline(create_info);
+    record_pipeline(pipeline_hash);
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    auto pipeline = &*m_pipelines.emplace();
+    pipeline->type = Pipeline_Type::Compute;
+    pipeline->compute_shading_info = create_info;
+    pipeline->id = m_next_pipeline_id++;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
+
+    return pipeline;
+}
+
+std::expected<Pipeline*, Result> Null_Graphics_Device::create_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept
+{
+    if (!create_info.ms) return std::unexpected(Result::Error_Invalid_Parameters);
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return std::unexpected(validation_result);
+    auto pipeline_hash = hash_pipeline(create_info);
+    record_pipeline(pipeline_hash);
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    auto pipeline = &*m_pipelines.emplace();
+    pipeline->type = Pipeline_Type::Mesh_Shading;
+    pipeline->mesh_shading_info = create_info;
+    pipeline->id = m_next_pipeline_id++;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
+
+    return pipeline;
+}
+
+std::expected<Pipeline*, Result> Null_Graphics_Device::create_pipeline(const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept
+{
+    if (create_info.max_recursion_depth > m_ray_tracing_pipeline_properties.max_recursion_depth)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto pipeline = &*m_pipelines.emplace();
+    pipeline->type = Pipeline_Type::Ray_Tracing;
+    pipeline->ray_tracing_info = create_info;
+    pipeline->id = m_next_pipeline_id++;
+
+    return pipeline;
+}
+
+void Null_Graphics_Device::destroy_pipeline(Pipeline* pipeline) noexcept
+{
+    if (pipeline == nullptr) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    if (!m_pipeline_registry.release(pipeline)) return;
+
+    m_pipelines.erase(m_pipelines.get_iterator(static_cast<Null_Pipeline*>(pipeline)));
+}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> Null_Graphics_Device::create_pipelines_async(
+    std::span<const Graphics_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Vertex_Shading;
+            pipeline->vertex_shading_info = create_info;
+            pipeline->id = m_next_pipeline_id++;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> Null_Graphics_Device::create_pipelines_async(
+    std::span<const Compute_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Compute;
+            pipeline->compute_shading_info = create_info;
+            pipeline->id = m_next_pipeline_id++;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> Null_Graphics_Device::create_pipelines_async(
+    std::span<const Mesh_Shading_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Mesh_Shading;
+            pipeline->mesh_shading_info = create_info;
+            pipeline->id = m_next_pipeline_id++;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+Acceleration_Structure_Build_Sizes Null_Graphics_Device::get_acceleration_structure_build_sizes(
+    const Acceleration_Structure_Build_Geometry_Info& build_info) noexcept
+{
+    // Rough per primitive sizes, only meant to keep the caller side allocations realistic.
+    constexpr static uint64_t NODE_SIZE = 64;
+    constexpr static uint64_t SCRATCH_NODE_SIZE = 32;
+
+    uint64_t primitive_count = 0;
+    if (build_info.type == Acceleration_Structure_Type::Bottom_Level)
+    {
+        for (auto i = 0u; i < build_info.geometry_or_instance_count; ++i)
+        {
+            const auto& geometry = build_info.geometry[i];
+            primitive_count += geometry.type == Acceleration_Structure_Geometry_Type::Triangles
+                ? geometry.geometry.triangles.index_count / 3
+                : geometry.geometry.aabbs.aabb_count;
+        }
+    }
+    else
+    {
+        primitive_count = build_info.geometry_or_instance_count;
+    }
+
+    auto align = [](uint64_t size) {
+        return (size + NULL_GPU_ADDRESS_ALIGNMENT - 1) & ~(NULL_GPU_ADDRESS_ALIGNMENT - 1);
+    };
+    auto scratch_size = align(NULL_GPU_ADDRESS_ALIGNMENT + primitive_count * SCRATCH_NODE_SIZE);
+    bool allow_update = static_cast<uint32_t>(build_info.flags & Acceleration_Structure_Flags::Allow_Update) > 0u;
+
+    Acceleration_Structure_Build_Sizes result = {
+        .acceleration_structure_size = align(NULL_GPU_ADDRESS_ALIGNMENT + primitive_count * NODE_SIZE),
+        .acceleration_structure_scratch_build_size = scratch_size,
+        .acceleration_structure_scratch_update_size = allow_update ? scratch_size : 0
+    };
+    return result;
+}
+
+const Ray_Tracing_Pipeline_Properties& Null_Graphics_Device::get_ray_tracing_pipeline_properties() const noexcept
+{
+    return m_ray_tracing_pipeline_properties;
+}
+
+Result Null_Graphics_Device::get_ray_tracing_shader_group_handles(
+    Pipeline* pipeline, uint32_t first_group, uint32_t group_count, void* dst) const noexcept
+{
+    if (!pipeline || !dst || pipeline->type != Pipeline_Type::Ray_Tracing)
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    // Handles are unique per pipeline and group so SBT contents can still be compared.
+    const auto handle_size = m_ray_tracing_pipeline_properties.shader_group_handle_size;
+    auto* handle_ptr = static_cast<uint8_t*>(dst);
+    auto pipeline_id = static_cast<Null_Pipeline*>(pipeline)->id;
+    for (auto i = 0u; i < group_count; ++i)
+    {
+        uint32_t group_index = first_group + i;
+        memset(handle_ptr, 0, handle_size);
+        memcpy(handle_ptr, &pipeline_id, sizeof(pipeline_id));
+        memcpy(handle_ptr + sizeof(pipeline_id), &group_index, sizeof(group_index));
+        handle_ptr += handle_size;
+    }
+    return Result::Success;
+}
+
+Result Null_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
+{
+    process_deferred_destructions();
+
+    auto queue_slot = get_queue_slot(submit_info.queue_type);
+    if (queue_slot >= QUEUE_COUNT)
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_queue_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    m_submit_statistics.submit_count += 1;
+    m_submit_statistics.command_list_count += submit_info.command_lists.size();
+    for (auto* command_list : submit_info.command_lists)
+    {
+        command_list->flush_barriers();
+        const auto* null_command_list = static_cast<const Null_Command_List*>(command_list);
+        m_submit_statistics.command_count += null_command_list->get_command_count();
+        m_submit_statistics.command_stream_size += null_command_list->get_command_stream().size();
+    }
+
+    m_pending_submits[queue_slot].push_back({
+        .wait_infos = { submit_info.wait_infos.begin(), submit_info.wait_infos.end() },
+        .signal_infos = { submit_info.signal_infos.begin(), submit_info.signal_infos.end() }
+        });
+    retire_pending_submits();
+
+    return Result::Success;
+}
+
+void Null_Graphics_Device::name_resource(Buffer* buffer, const char* name) noexcept
+{
+    if (!buffer || !name) return;
+
+    static_cast<Null_Buffer*>(buffer)->name = name;
+}
+
+void Null_Graphics_Device::name_resource(Image* image, const char* name) noexcept
+{
+    if (!image || !name) return;
+
+    static_cast<Null_Image*>(image)->name = name;
+}
+
+void Null_Graphics_Device::begin_resource_batch() noexcept
+{}
+
+void Null_Graphics_Device::end_resource_batch() noexcept
+{}
+
+void Null_Graphics_Device::destroy_buffer_deferred(Buffer* buffer, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(buffer, fence, value);
+}
+
+void Null_Graphics_Device::destroy_image_deferred(Image* image, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(image, fence, value);
+}
+
+void Null_Graphics_Device::destroy_sampler_deferred(Sampler* sampler, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(sampler, fence, value);
+}
+
+void Null_Graphics_Device::destroy_acceleration_structure_deferred(
+    Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(acceleration_structure, fence, value);
+}
+
+void Null_Graphics_Device::destroy_memory_heap_deferred(Memory_Heap* memory_heap, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(memory_heap, fence, value);
+}
+
+void Null_Graphics_Device::process_deferred_destructions() noexcept
+{
+    m_deferred_destruction_queue.process(this);
+}
+
+Result Null_Graphics_Device::load_pipeline_cache(const std::filesystem::path& path) noexcept
+{
+    auto data = read_pipeline_cache_file(path, Graphics_API::Null);
+    if (!data) return data.error();
+    if (data->size() % sizeof(uint64_t) != 0) return Result::Error_Invalid_Parameters;
+
+    std::unique_lock<std::mutex> lock_guard(m_pipeline_cache_mutex);
+
+    for (auto offset = 0ull; offset < data->size(); offset += sizeof(uint64_t))
+    {
+        uint64_t pipeline_hash;
+        memcpy(&pipeline_hash, data->data() + offset, sizeof(pipeline_hash));
+        m_pipeline_cache.insert(pipeline_hash);
+    }
+    return Result::Success;
+}
+
+Result Null_Graphics_Device::save_pipeline_cache(const std::filesystem::path& path) noexcept
+{
+    std::vector<uint64_t> pipeline_hashes;
+    {
+        std::unique_lock<std::mutex> lock_guard(m_pipeline_cache_mutex);
+        pipeline_hashes.assign(m_pipeline_cache.begin(), m_pipeline_cache.end());
+    }
+    std::ranges::sort(pipeline_hashes);
+
+    return write_pipeline_cache_file(
+        path,
+        Graphics_API::Null,
+        { reinterpret_cast<const uint8_t*>(pipeline_hashes.data()), pipeline_hashes.size() * sizeof(uint64_t) });
+}
+
+Null_Submit_Statistics Null_Graphics_Device::get_submit_statistics() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_queue_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    return m_submit_statistics;
+}
+
+uint64_t Null_Graphics_Device::allocate_gpu_address(uint64_t size) noexcept
+{
+    auto address = m_next_gpu_address;
+    auto aligned_size = (std::max<uint64_t>(size, 1) + NULL_GPU_ADDRESS_ALIGNMENT - 1) & ~(NULL_GPU_ADDRESS_ALIGNMENT - 1);
+    m_next_gpu_address += aligned_size;
+    return address;
+}
+
+bool Null_Graphics_Device::is_placement_valid(
+    const Memory_Requirements& memory_requirements, Memory_Heap* memory_heap, uint64_t offset) const noexcept
+{
+    return offset % memory_requirements.alignment == 0
+        && offset + memory_requirements.size <= memory_heap->size;
+}
+
+Result Null_Graphics_Device::compile_pipeline(Null_Pipeline* pipeline) noexcept
+{
+    switch (pipeline->type)
+    {
+    case Pipeline_Type::Vertex_Shading:
+        if (!pipeline->vertex_shading_info.vs) return Result::Error_Invalid_Parameters;
+        if (validate_pipeline_reflection(pipeline->vertex_shading_info) != Result::Success) return Result::Error_Invalid_Parameters;
+        record_pipeline(hash_pipeline(pipeline->vertex_shading_info));
+        return Result::Success;
+    case Pipeline_Type::Compute:
+        if (!pipeline->compute_shading_info.cs) return Result::Error_Invalid_Parameters;
+        if (validate_pipeline_reflection(pipeline->compute_shading_info) != Result::Success) return Result::Error_Invalid_Parameters;
+        record_pipeline(hash_pipeline(pipeline->compute_shading_info));
+        return Result::Success;
+    case Pipeline_Type::Mesh_Shading:
+        if (!pipeline->mesh_shading_info.ms) return Result::Error_Invalid_Parameters;
+        if (validate_pipeline_reflection(pipeline->mesh_shading_info) != Result::Success) return Result::Error_Invalid_Parameters;
+        record_pipeline(hash_pipeline(pipeline->mesh_shading_info));
+        return Result::Success;
+    default:
+        return Result::Error_Invalid_Parameters;
+    }
+}
+
+void Null_Graphics_Device::record_pipeline(uint64_t pipeline_hash) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_pipeline_cache_mutex);
+    m_pipeline_cache.insert(pipeline_hash);
+}
+
+bool Null_Graphics_Device::is_submit_ready(const std::vector<Submit_Fence_Info>& wait_infos) const noexcept
+{
+    return std::ranges::all_of(wait_infos, [](const Submit_Fence_Info& wait_info) {
+        return static_cast<Null_Fence*>(wait_info.fence)->value >= wait_info.value;
+    });
+}
+
+void Null_Graphics_Device::signal_fences(const std::vector<Submit_Fence_Info>& signal_infos) noexcept
+{
+    for (const auto& signal_info : signal_infos)
+    {
+        auto* fence = static_cast<Null_Fence*>(signal_info.fence);
+        fence->value = std::max(fence->value, signal_info.value);
+    }
+}
+
+void Null_Graphics_Device::retire_pending_submits() noexcept
+{
+    // Retiring a submit on one queue can unblock the head of another, iterate until nothing moves.
+    std::unique_lock<std::mutex> fence_lock_guard(m_fence_mutex);
+    bool retired_any = true;
+    while (retired_any)
+    {
+        retired_any = false;
+        for (auto& pending_submits : m_pending_submits)
+        {
+            while (!pending_submits.empty() && is_submit_ready(pending_submits.front().wait_infos))
+            {
+                signal_fences(pending_submits.front().signal_infos);
+                pending_submits.pop_front();
+                retired_any = true;
+            }
+        }
+    }
+    fence_lock_guard.unlock();
+    m_fence_condition.notify_all();
+}
+
+uint32_t Null_Graphics_Device::get_queue_slot(Queue_Type queue_type) const noexcept
+{
+    return static_cast<uint32_t>(queue_type);
+}
+}
@@ -0,0 +1,209 @@
+#pragma once
+
+#include "rhi/graphics_device.hpp"
+#include "rhi/common/deferred_destruction_queue.hpp"
+#include "rhi/common/pipeline_compiler.hpp"
+#include "rhi/common/pipeline_registry.hpp"
+#include "rhi/common/resource_pool.hpp"
+#include "rhi/null/null_resource.hpp"
+
+#include <array>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <plf_colony.h>
+#include <unordered_set>
+
+namespace rhi::null
+{
+class Null_Graphics_Device;
+
+struct Null_Fence : public Fence
+{
+    uint64_t value;
+    Null_Graphics_Device* device;
+
+    [[nodiscard]] virtual Result get_status(uint64_t value) noexcept override;
+    virtual Result wait_for_value(uint64_t value) noexcept override;
+};
+
+using Null_Resource_Pool = Resource_Pool<
+    Null_Buffer,
+    Null_Buffer_View,
+    Null_Image,
+    Null_Image_View,
+    Null_Sampler,
+    Null_Acceleration_Structure>;
+
+// Accumulated CPU side work that went through `Null_Graphics_Device::submit`.
+struct Null_Submit_Statistics
+{
+    uint64_t submit_count;
+    uint64_t command_list_count;
+    uint64_t command_count;
+    uint64_t command_stream_size;
+};
+
+class Null_Graphics_Device final : public Graphics_Device
+{
+public:
+    Null_Graphics_Device(const Graphics_Device_Create_Info& create_info) noexcept;
+    virtual ~Null_Graphics_Device() noexcept override;
+
+    virtual Result wait_idle() noexcept override;
+    virtual Result queue_wait_idle(Queue_Type queue, uint64_t timeout) noexcept override;
+
+    [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept override;
+
+    [[nodiscard]] virtual std::unique_ptr<Swapchain> create_swapchain(
+        const Swapchain_Win32_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual std::unique_ptr<Command_Pool> create_command_pool(
+        const Command_Pool_Create_Info& create_info) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Fence*, Result> create_fence(uint64_t initial_value) noexcept override;
+    virtual void destroy_fence(Fence* fence) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Buffer*, Result> create_buffer(
+        const Buffer_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual std::expected<Buffer_View*, Result> create_buffer_view(
+        Buffer* buffer, const Buffer_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual Result update_buffer_view(
+        Buffer_View* buffer_view, const Buffer_View_Create_Info& create_info) noexcept override;
+    virtual void destroy_buffer(Buffer* buffer) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Memory_Heap*, Result> create_memory_heap(
+        const Memory_Heap_Create_Info& create_info) noexcept override;
+    virtual void destroy_memory_heap(Memory_Heap* memory_heap) noexcept override;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Buffer_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Image_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual std::expected<Buffer*, Result> create_placed_buffer(
+        const Buffer_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual std::expected<Image*, Result> create_placed_image(
+        const Image_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Image*, Result> create_image(
+        const Image_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual std::expected<Image_View*, Result> create_image_view(
+        Image* image, const Image_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    virtual void destroy_image(Image* image) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Sampler*, Result> create_sampler(
+        const Sampler_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    virtual void destroy_sampler(Sampler* sampler) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Acceleration_Structure*, Result> create_acceleration_structure(
+        const Acceleration_Structure_Create_Info& create_info) noexcept override;
+    virtual void destroy_acceleration_structure(Acceleration_Structure* acceleration_structure) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
+        const Shader_Blob_Create_Info& create_info) noexcept override;
+    virtual Result recreate_shader_blob(Shader_Blob* shader_blob, const Shader_Blob_Create_Info& create_info) noexcept override;
+    virtual Result recreate_shader_blob_deserialize_memory(
+        Shader_Blob* shader_blob, const void* memory, uint64_t memory_size) noexcept override;
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
+        const Shader_Archive& archive, uint32_t entry_index) noexcept override;
+    virtual void destroy_shader_blob(Shader_Blob* shader_blob) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
+        const Graphics_Pipeline_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
+        const Compute_Pipeline_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
+        const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
+        const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept override;
+    virtual void destroy_pipeline(Pipeline* pipeline) noexcept override;
+
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Graphics_Pipeline_Create_Info> create_infos) noexcept override;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Compute_Pipeline_Create_Info> create_infos) noexcept override;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Mesh_Shading_Pipeline_Create_Info> create_infos) noexcept override;
+
+    [[nodiscard]] virtual Acceleration_Structure_Build_Sizes get_acceleration_structure_build_sizes(
+        const Acceleration_Structure_Build_Geometry_Info& build_info) noexcept override;
+    [[nodiscard]] virtual const Ray_Tracing_Pipeline_Properties& get_ray_tracing_pipeline_properties() const noexcept override;
+    [[nodiscard]] virtual Result get_ray_tracing_shader_group_handles(
+        Pipeline* pipeline, uint32_t first_group, uint32_t group_count, void* dst) const noexcept override;
+
+    virtual Result submit(const Submit_Info& submit_info) noexcept override;
+
+    virtual void name_resource(Buffer* buffer, const char* name) noexcept override;
+    virtual void name_resource(Image* image, const char* name) noexcept override;
+
+    virtual void begin_resource_batch() noexcept override;
+    virtual void end_resource_batch() noexcept override;
+
+    virtual void destroy_buffer_deferred(Buffer* buffer, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_image_deferred(Image* image, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_sampler_deferred(Sampler* sampler, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_acceleration_structure_deferred(
+        Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_memory_heap_deferred(Memory_Heap* memory_heap, Fence* fence, uint64_t value) noexcept override;
+    virtual void process_deferred_destructions() noexcept override;
+
+    virtual Result load_pipeline_cache(const std::filesystem::path& path) noexcept override;
+    virtual Result save_pipeline_cache(const std::filesystem::path& path) noexcept override;
+
+    [[nodiscard]] Null_Submit_Statistics get_submit_statistics() noexcept;
+
+private:
+    friend struct Null_Fence;
+
+    // A submission whose wait fences were not yet reached when it was submitted.
+    // It is retired in order once every wait is satisfied, emulating an in-order GPU queue.
+    struct Pending_Submit
+    {
+        std::vector<Submit_Fence_Info> wait_infos;
+        std::vector<Submit_Fence_Info> signal_infos;
+    };
+
+    [[nodiscard]] uint64_t allocate_gpu_address(uint64_t size) noexcept;
+    [[nodiscard]] bool is_placement_valid(
+        const Memory_Requirements& memory_requirements, Memory_Heap* memory_heap, uint64_t offset) const noexcept;
+    // Thread safe, validates the pipeline and records it in the pipeline cache.
+    [[nodiscard]] Result compile_pipeline(Null_Pipeline* pipeline) noexcept;
+    void record_pipeline(uint64_t pipeline_hash) noexcept;
+    // Both expect `m_fence_mutex` to be held.
+    [[nodiscard]] bool is_submit_ready(const std::vector<Submit_Fence_Info>& wait_infos) const noexcept;
+    void signal_fences(const std::vector<Submit_Fence_Info>& signal_infos) noexcept;
+    void retire_pending_submits() noexcept;
+    [[nodiscard]] uint32_t get_queue_slot(Queue_Type queue_type) const noexcept;
+
+private:
+    constexpr static uint32_t QUEUE_COUNT = 5;
+
+    Ray_Tracing_Pipeline_Properties m_ray_tracing_pipeline_properties;
+
+    bool m_use_mutex;
+    std::mutex m_resource_mutex;
+    std::mutex m_queue_mutex;
+
+    // Fence values are always synchronized, waiting on a fence from another thread must work without `enable_locking`.
+    std::mutex m_fence_mutex;
+    std::condition_variable m_fence_condition;
+
+    uint64_t m_next_gpu_address;
+    uint64_t m_next_pipeline_id;
+    // There is nothing to compile, the cache only records which pipelines were created so it round-trips.
+    // Always synchronized as pipelines are compiled on worker threads.
+    std::mutex m_pipeline_cache_mutex;
+    std::unordered_set<uint64_t> m_pipeline_cache;
+    std::array<std::deque<Pending_Submit>, QUEUE_COUNT> m_pending_submits;
+    Null_Submit_Statistics m_submit_statistics;
+
+    std::unique_ptr<Null_Resource_Pool> m_resource_pool;
+    Deferred_Destruction_Queue m_deferred_destruction_queue;
+    // Guarded by `m_resource_mutex`.
+    Pipeline_Registry m_pipeline_registry;
+    Pipeline_Compiler m_pipeline_compiler;
+
+    plf::colony<Null_Fence> m_fences;
+    plf::colony<Null_Memory_Heap> m_memory_heaps;
+    plf::colony<Shader_Blob> m_shader_blobs;
+    plf::colony<Null_Pipeline> m_pipelines;
+};
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include "rhi/resource.hpp"
+
+#include <string>
+#include <vector>
+
+namespace rhi::null
+{
+// Alignment of the fake gpu addresses handed out by the null backend.
+constexpr static uint64_t NULL_GPU_ADDRESS_ALIGNMENT = 256;
+// Placement alignment of images, matching the default resource placement alignment of D3D12.
+constexpr static uint64_t NULL_PLACED_IMAGE_ALIGNMENT = 64 * 1024;
+
+struct Null_Buffer : public Buffer
+{
+    std::vector<uint8_t> memory; // Only allocated for CPU visible heaps.
+    std::string name;
+};
+
+struct Null_Memory_Heap : public Memory_Heap
+{
+    std::vector<uint8_t> memory; // Only allocated for CPU visible heaps.
+    uint64_t gpu_address;
+};
+
+struct Null_Buffer_View : public Buffer_View
+{};
+
+struct Null_Image : public Image
+{
+    std::string name;
+};
+
+struct Null_Image_View : public Image_View
+{};
+
+struct Null_Sampler : public Sampler
+{};
+
+struct Null_Pipeline : public Pipeline
+{
+    uint64_t id;
+};
+
+struct Null_Acceleration_Structure : public Acceleration_Structure
+{};
+}
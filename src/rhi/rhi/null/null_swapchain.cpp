@@ -0,0 +1,100 @@
+#include "rhi/null/null_swapchain.hpp"
+#include "rhi/null/null_graphics_device.hpp"
+
+#include <algorithm>
+
+namespace rhi::null
+{
+Null_Swapchain::Null_Swapchain(Null_Graphics_Device* graphics_device, const Swapchain_Win32_Create_Info& create_info) noexcept
+    : m_device(graphics_device)
+    , m_image_count(std::clamp(create_info.image_count, 1u, MAX_SWAPCHAIN_IMAGES))
+    , m_format(create_info.preferred_format)
+    , m_images()
+    , m_current_image_index(0u)
+{
+    recreate_resources();
+}
+
+Null_Swapchain::~Null_Swapchain() noexcept
+{
+    destroy_resources();
+}
+
+void Null_Swapchain::acquire_next_image() noexcept
+{
+    m_current_image_index = (m_current_image_index + 1) % m_image_count;
+}
+
+void Null_Swapchain::present() noexcept
+{}
+
+void Null_Swapchain::change_format(Image_Format format) noexcept
+{
+    if (format == m_format) return;
+
+    m_format = format;
+    recreate_resources();
+}
+
+Swapchain_Resize_Info Null_Swapchain::query_resize() noexcept
+{
+    return {
+        .is_size_changed = false,
+        .width = NULL_SWAPCHAIN_WIDTH,
+        .height = NULL_SWAPCHAIN_HEIGHT
+    };
+}
+
+Image_Format Null_Swapchain::get_image_format() noexcept
+{
+    return m_format;
+}
+
+Image_View* Null_Swapchain::get_current_image_view() noexcept
+{
+    return m_images[m_current_image_index]->image_view;
+}
+
+uint32_t Null_Swapchain::get_width() const noexcept
+{
+    return NULL_SWAPCHAIN_WIDTH;
+}
+
+uint32_t Null_Swapchain::get_height() const noexcept
+{
+    return NULL_SWAPCHAIN_HEIGHT;
+}
+
+void Null_Swapchain::recreate_resources() noexcept
+{
+    destroy_resources();
+
+    Image_Create_Info image_create_info = {
+        .format = m_format,
+        .width = NULL_SWAPCHAIN_WIDTH,
+        .height = NULL_SWAPCHAIN_HEIGHT,
+        .depth = 1,
+        .array_size = 1,
+        .mip_levels = 1,
+        .usage = Image_Usage::Color_Attachment,
+        .primary_view_type = Image_View_Type::Texture_2D
+    };
+    for (auto i = 0u; i < m_image_count; ++i)
+    {
+        m_images[i] = m_device->create_image(image_create_info).value_or(nullptr);
+    }
+    m_current_image_index = 0;
+}
+
+void Null_Swapchain::destroy_resources() noexcept
+{
+    for (auto& image : m_images)
+    {
+        if (image)
+        {
+            m_device->destroy_image(image);
+            image = nullptr;
+        }
+    }
+}
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include "rhi/swapchain.hpp"
+
+#include <array>
+
+namespace rhi::null
+{
+class Null_Graphics_Device;
+
+constexpr static auto MAX_SWAPCHAIN_IMAGES = 8u;
+// There is no window surface to query, the null swapchain always presents at this extent.
+constexpr static uint32_t NULL_SWAPCHAIN_WIDTH = 1920;
+constexpr static uint32_t NULL_SWAPCHAIN_HEIGHT = 1080;
+
+class Null_Swapchain : public Swapchain
+{
+public:
+    Null_Swapchain(
+        Null_Graphics_Device* graphics_device,
+        const Swapchain_Win32_Create_Info& create_info) noexcept;
+    virtual ~Null_Swapchain() noexcept;
+
+    virtual void acquire_next_image() noexcept override;
+    virtual void present() noexcept override;
+    virtual void change_format(Image_Format format) noexcept override;
+
+    [[nodiscard]] virtual Swapchain_Resize_Info query_resize() noexcept override;
+    [[nodiscard]] virtual Image_Format get_image_format() noexcept override;
+    [[nodiscard]] virtual Image_View* get_current_image_view() noexcept override;
+    [[nodiscard]] virtual uint32_t get_width() const noexcept override;
+    [[nodiscard]] virtual uint32_t get_height() const noexcept override;
+
+private:
+    void recreate_resources() noexcept;
+    void destroy_resources() noexcept;
+
+private:
+    Null_Graphics_Device* m_device;
+    uint32_t m_image_count;
+    Image_Format m_format;
+    std::array<Image*, MAX_SWAPCHAIN_IMAGES> m_images;
+    uint32_t m_current_image_index;
+};
+}
@@ -0,0 +1,679 @@
+#include "rhi/render_graph.hpp"
+
+#include "rhi/graphics_device.hpp"
+#include "rhi/image_format.hpp"
+#include "rhi/queue_type.hpp"
+#include "rhi/transient_heap.hpp"
+#include "rhi/common/work_stealing_pool.hpp"
+
+#include <algorithm>
+#include <iterator>
+#include <optional>
+#include <utility>
+
+namespace rhi
+{
+namespace
+{
+bool is_same_render_graph_transition(const Image_Barrier_Info& a, const Image_Barrier_Info& b) noexcept
+{
+    return a.stage_before == b.stage_before
+        && a.stage_after == b.stage_after
+        && a.access_before == b.access_before
+        && a.access_after == b.access_after
+        && a.layout_before == b.layout_before
+        && a.layout_after == b.layout_after;
+}
+
+bool render_graph_accesses_overlap(const Render_Graph_Image_Access& a, const Render_Graph_Image_Access& b) noexcept
+{
+    return a.image == b.image
+        && a.first_mip_level < b.first_mip_level + b.mip_count
+        && b.first_mip_level < a.first_mip_level + a.mip_count
+        && a.first_array_index < b.first_array_index + b.array_size
+        && b.first_array_index < a.first_array_index + a.array_size;
+}
+}
+
+std::expected<std::unique_ptr<Render_Graph>, Result> Render_Graph::create(
+    Graphics_Device* graphics_device, const Render_Graph_Create_Info& create_info) noexcept
+{
+    auto transient_heap = Transient_Heap::create(graphics_device, { .fence = create_info.fence });
+    if (!transient_heap) return std::unexpected(transient_heap.error());
+
+    auto result = std::unique_ptr<Render_Graph>(new Render_Graph());
+    result->m_graphics_device = graphics_device;
+    result->m_transient_heap = std::move(*transient_heap);
+    result->m_work_stealing_pool = std::make_unique<Work_Stealing_Pool>(create_info.recording_thread_count);
+    return result;
+}
+
+Render_Graph::Render_Graph() noexcept
+    : m_graphics_device(nullptr)
+    , m_transient_heap()
+    , m_work_stealing_pool()
+    , m_images()
+    , m_buffers()
+    , m_passes()
+    , m_compiled(false)
+    , m_command_lists()
+    , m_image_states()
+    , m_buffer_states()
+    , m_tracked_image_states()
+    , m_tracked_buffer_states()
+    , m_statistics()
+{}
+
+Render_Graph::~Render_Graph() noexcept = default;
+
+uint32_t Render_Graph::import_image(Image* image, Barrier_Image_Layout initial_layout) noexcept
+{
+    auto imported = std::ranges::find_if(m_images, [image](const Image_Resource& resource)
+        {
+            return !resource.transient && resource.image == image;
+        });
+    if (imported != m_images.end()) return uint32_t(std::distance(m_images.begin(), imported));
+
+    Image_Create_Info create_info = {};
+    if (image)
+    {
+        create_info = {
+            .format = image->format,
+            .width = image->width,
+            .height = image->height,
+            .depth = image->depth,
+            .array_size = image->array_size,
+            .mip_levels = image->mip_levels,
+            .usage = image->usage,
+            .primary_view_type = image->primary_view_type
+        };
+    }
+    m_images.push_back({
+        .image = image,
+        .create_info = create_info,
+        .transient = false,
+        .initial_layout = initial_layout,
+        .first_pass = 0,
+        .first_layout = Barrier_Image_Layout::Undefined
+    });
+    return uint32_t(m_images.size() - 1);
+}
+
+uint32_t Render_Graph::import_buffer(Buffer* buffer) noexcept
+{
+    auto imported = std::ranges::find_if(m_buffers, [buffer](const Buffer_Resource& resource)
+        {
+            return !resource.transient && resource.buffer == buffer;
+        });
+    if (imported != m_buffers.end()) return uint32_t(std::distance(m_buffers.begin(), imported));
+
+    m_buffers.push_back({
+        .buffer = buffer,
+        .create_info = buffer
+            ? Buffer_Create_Info{ .size = buffer->size, .heap = buffer->heap_type, .acceleration_structure_memory = false }
+            : Buffer_Create_Info{},
+        .transient = false
+    });
+    return uint32_t(m_buffers.size() - 1);
+}
+
+uint32_t Render_Graph::create_image(const Image_Create_Info& create_info) noexcept
+{
+    m_images.push_back({
+        .image = nullptr,
+        .create_info = create_info,
+        .transient = true,
+        .initial_layout = Barrier_Image_Layout::Undefined,
+        .first_pass = 0,
+        .first_layout = Barrier_Image_Layout::Undefined
+    });
+    return uint32_t(m_images.size() - 1);
+}
+
+uint32_t Render_Graph::create_buffer(const Buffer_Create_Info& create_info) noexcept
+{
+    m_buffers.push_back({
+        .buffer = nullptr,
+        .create_info = create_info,
+        .transient = true
+    });
+    return uint32_t(m_buffers.size() - 1);
+}
+
+void Render_Graph::add_pass(const Render_Graph_Pass_Info& pass_info) noexcept
+{
+    auto& pass = m_passes.emplace_back();
+    pass.name = pass_info.name;
+    for (const auto& access : pass_info.image_reads) pass.image_accesses.push_back({ access, false });
+    for (const auto& access : pass_info.image_writes) pass.image_accesses.push_back({ access, true });
+    for (const auto& access : pass_info.buffer_reads) pass.buffer_accesses.push_back({ access, false });
+    for (const auto& access : pass_info.buffer_writes) pass.buffer_accesses.push_back({ access, true });
+    pass.side_effects = pass_info.side_effects;
+    pass.record = pass_info.record;
+    pass.culled = false;
+}
+
+Result Render_Graph::compile() noexcept
+{
+    m_compiled = false;
+    auto result = validate_passes();
+    if (result != Result::Success) return result;
+
+    cull_passes();
+    result = place_transient_resources();
+    if (result != Result::Success) return result;
+
+    build_barriers();
+    m_compiled = true;
+    return Result::Success;
+}
+
+void Render_Graph::execute(Command_List* command_list) noexcept
+{
+    if (!m_compiled) return;
+
+    for (auto& pass : m_passes)
+    {
+        if (pass.culled) continue;
+        record_pass(pass, command_list);
+    }
+    commit_tracked_states();
+}
+
+std::span<Command_List*> Render_Graph::execute_parallel(Command_Pool* command_pool) noexcept
+{
+    if (!m_compiled) return {};
+
+    std::vector<Pass*> passes;
+    for (auto& pass : m_passes)
+    {
+        if (!pass.culled) passes.push_back(&pass);
+    }
+    // Two lists per thread leave work to steal when passes differ in cost.
+    auto command_list_count = std::min(uint32_t(passes.size()), 2 * m_work_stealing_pool->get_thread_count());
+    m_command_lists.assign(command_list_count, nullptr);
+    m_work_stealing_pool->run(command_list_count,
+        [this, &passes, command_pool, command_list_count](uint32_t index, uint32_t)
+        {
+            auto command_list = command_pool->acquire_command_list();
+            auto first_pass = uint64_t(passes.size()) * index / command_list_count;
+            auto last_pass = uint64_t(passes.size()) * (index + 1) / command_list_count;
+            for (auto pass = first_pass; pass < last_pass; ++pass)
+            {
+                record_pass(*passes[pass], command_list);
+            }
+            m_command_lists[index] = command_list;
+        });
+    commit_tracked_states();
+    return m_command_lists;
+}
+
+void Render_Graph::record_pass(Pass& pass, Command_List* command_list) noexcept
+{
+    if (pass.name) command_list->begin_debug_region(pass.name, 0.0f, 0.0f, 0.0f);
+    if (!pass.image_barriers.empty() || !pass.buffer_barriers.empty() || !pass.memory_barriers.empty())
+    {
+        command_list->barrier({
+            .buffer_barriers = pass.buffer_barriers,
+            .image_barriers = pass.image_barriers,
+            .memory_barriers = pass.memory_barriers
+        });
+    }
+    if (pass.record) pass.record(command_list);
+    if (pass.name) command_list->end_debug_region();
+}
+
+void Render_Graph::commit_tracked_states() noexcept
+{
+    for (uint32_t image = 0; image < m_images.size(); ++image)
+    {
+        if (m_images[image].transient) continue;
+        m_tracked_image_states[m_images[image].image] = m_image_states[image];
+    }
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer)
+    {
+        if (m_buffers[buffer].transient) continue;
+        m_tracked_buffer_states[m_buffers[buffer].buffer] = m_buffer_states[buffer];
+    }
+    m_compiled = false;
+}
+
+void Render_Graph::end_frame(uint64_t fence_value) noexcept
+{
+    m_transient_heap->end_frame(fence_value);
+    m_images.clear();
+    m_buffers.clear();
+    m_passes.clear();
+    m_command_lists.clear();
+    m_image_states.clear();
+    m_buffer_states.clear();
+    m_compiled = false;
+}
+
+Image* Render_Graph::get_image(uint32_t image) const noexcept
+{
+    return image < m_images.size()
+        ? m_images[image].image
+        : nullptr;
+}
+
+Buffer* Render_Graph::get_buffer(uint32_t buffer) const noexcept
+{
+    return buffer < m_buffers.size()
+        ? m_buffers[buffer].buffer
+        : nullptr;
+}
+
+void Render_Graph::forget_image(Image* image) noexcept
+{
+    m_tracked_image_states.erase(image);
+}
+
+void Render_Graph::forget_buffer(Buffer* buffer) noexcept
+{
+    m_tracked_buffer_states.erase(buffer);
+}
+
+Render_Graph_Statistics Render_Graph::get_statistics() const noexcept
+{
+    return m_statistics;
+}
+
+Result Render_Graph::validate_passes() noexcept
+{
+    for (const auto& resource : m_images)
+    {
+        if (!resource.transient && !resource.image) return Result::Error_Invalid_Parameters;
+    }
+    for (const auto& resource : m_buffers)
+    {
+        if (!resource.transient && !resource.buffer) return Result::Error_Invalid_Parameters;
+    }
+
+    for (auto& pass : m_passes)
+    {
+        for (auto& [access, write] : pass.image_accesses)
+        {
+            if (access.image >= m_images.size()) return Result::Error_Invalid_Parameters;
+
+            const auto& create_info = m_images[access.image].create_info;
+            if (access.first_mip_level >= create_info.mip_levels
+                || access.first_array_index >= create_info.array_size)
+            {
+                return Result::Error_Invalid_Parameters;
+            }
+            if (access.mip_count == 0) access.mip_count = create_info.mip_levels - access.first_mip_level;
+            if (access.array_size == 0) access.array_size = create_info.array_size - access.first_array_index;
+            if (access.first_mip_level + access.mip_count > create_info.mip_levels
+                || access.first_array_index + access.array_size > create_info.array_size)
+            {
+                return Result::Error_Invalid_Parameters;
+            }
+        }
+        for (uint32_t i = 0; i < pass.image_accesses.size(); ++i)
+        {
+            for (uint32_t j = i + 1; j < pass.image_accesses.size(); ++j)
+            {
+                const auto& a = pass.image_accesses[i].access;
+                const auto& b = pass.image_accesses[j].access;
+                if (a.layout != b.layout && render_graph_accesses_overlap(a, b))
+                {
+                    return Result::Error_Invalid_Parameters;
+                }
+            }
+        }
+        for (const auto& [access, write] : pass.buffer_accesses)
+        {
+            if (access.buffer >= m_buffers.size()) return Result::Error_Invalid_Parameters;
+        }
+    }
+    return Result::Success;
+}
+
+void Render_Graph::cull_passes() noexcept
+{
+    // Walks the passes backwards, a pass is needed if it accesses a resource that a later needed pass accesses.
+    // Any access keeps earlier writers alive, since a write is not known to overwrite every texel it declares.
+    std::vector<bool> images_needed(m_images.size());
+    std::vector<bool> buffers_needed(m_buffers.size());
+    for (uint32_t image = 0; image < m_images.size(); ++image) images_needed[image] = !m_images[image].transient;
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer) buffers_needed[buffer] = !m_buffers[buffer].transient;
+
+    m_statistics = {
+        .pass_count = m_passes.size(),
+        .culled_pass_count = 0,
+        .barrier_count = 0,
+        .barrier_call_count = 0
+    };
+    for (auto pass = m_passes.rbegin(); pass != m_passes.rend(); ++pass)
+    {
+        bool needed = pass->side_effects
+            || std::ranges::any_of(pass->image_accesses, [&images_needed](const Image_Access& image_access)
+                {
+                    return image_access.write && images_needed[image_access.access.image];
+                })
+            || std::ranges::any_of(pass->buffer_accesses, [&buffers_needed](const Buffer_Access& buffer_access)
+                {
+                    return buffer_access.write && buffers_needed[buffer_access.access.buffer];
+                });
+        pass->culled = !needed;
+        if (!needed)
+        {
+            m_statistics.culled_pass_count += 1;
+            continue;
+        }
+
+        for (const auto& image_access : pass->image_accesses) images_needed[image_access.access.image] = true;
+        for (const auto& buffer_access : pass->buffer_accesses) buffers_needed[buffer_access.access.buffer] = true;
+    }
+}
+
+Result Render_Graph::place_transient_resources() noexcept
+{
+    std::vector<std::optional<Transient_Resource_Lifetime>> image_lifetimes(m_images.size());
+    std::vector<std::optional<Transient_Resource_Lifetime>> buffer_lifetimes(m_buffers.size());
+    auto extend_lifetime = [](std::optional<Transient_Resource_Lifetime>& lifetime, uint32_t pass_index,
+        Barrier_Pipeline_Stage stage, Barrier_Access access, Barrier_Image_Layout layout)
+        {
+            if (!lifetime)
+            {
+                lifetime = Transient_Resource_Lifetime{
+                    .first_pass = pass_index,
+                    .last_pass = pass_index,
+                    .first_stage = Barrier_Pipeline_Stage::None,
+                    .first_access = Barrier_Access::None,
+                    .first_layout = layout,
+                    .last_stage = Barrier_Pipeline_Stage::None,
+                    .last_access = Barrier_Access::None
+                };
+            }
+            if (lifetime->first_pass == pass_index)
+            {
+                // The aliasing barrier transitions the whole image into a single layout.
+                if (lifetime->first_layout != layout) return false;
+                lifetime->first_stage = lifetime->first_stage | stage;
+                lifetime->first_access = lifetime->first_access | access;
+            }
+            if (lifetime->last_pass != pass_index)
+            {
+                lifetime->last_pass = pass_index;
+                lifetime->last_stage = Barrier_Pipeline_Stage::None;
+                lifetime->last_access = Barrier_Access::None;
+            }
+            lifetime->last_stage = lifetime->last_stage | stage;
+            lifetime->last_access = lifetime->last_access | access;
+            return true;
+        };
+
+    uint32_t pass_index = 0;
+    for (const auto& pass : m_passes)
+    {
+        if (pass.culled) continue;
+
+        for (const auto& [access, write] : pass.image_accesses)
+        {
+            if (!m_images[access.image].transient) continue;
+            if (!extend_lifetime(image_lifetimes[access.image], pass_index, access.stage, access.access, access.layout))
+            {
+                return Result::Error_Invalid_Parameters;
+            }
+        }
+        for (const auto& [access, write] : pass.buffer_accesses)
+        {
+            if (!m_buffers[access.buffer].transient) continue;
+            extend_lifetime(buffer_lifetimes[access.buffer], pass_index,
+                access.stage, access.access, Barrier_Image_Layout::Undefined);
+        }
+        pass_index += 1;
+    }
+
+    std::vector<uint32_t> image_handles(m_images.size());
+    std::vector<uint32_t> buffer_handles(m_buffers.size());
+    for (uint32_t image = 0; image < m_images.size(); ++image)
+    {
+        if (!image_lifetimes[image]) continue;
+        image_handles[image] = m_transient_heap->declare_image(m_images[image].create_info, *image_lifetimes[image]);
+    }
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer)
+    {
+        if (!buffer_lifetimes[buffer]) continue;
+        buffer_handles[buffer] = m_transient_heap->declare_buffer(m_buffers[buffer].create_info, *buffer_lifetimes[buffer]);
+    }
+    auto result = m_transient_heap->compile();
+    if (result != Result::Success) return result;
+
+    for (uint32_t image = 0; image < m_images.size(); ++image)
+    {
+        auto& resource = m_images[image];
+        if (!resource.transient) continue;
+        resource.image = image_lifetimes[image] ? m_transient_heap->get_image(image_handles[image]) : nullptr;
+        resource.first_pass = image_lifetimes[image] ? image_lifetimes[image]->first_pass : 0;
+        resource.first_layout = image_lifetimes[image] ? image_lifetimes[image]->first_layout : Barrier_Image_Layout::Undefined;
+    }
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer)
+    {
+        if (!m_buffers[buffer].transient) continue;
+        m_buffers[buffer].buffer = buffer_lifetimes[buffer] ? m_transient_heap->get_buffer(buffer_handles[buffer]) : nullptr;
+    }
+    return Result::Success;
+}
+
+void Render_Graph::build_barriers() noexcept
+{
+    constexpr static Access_State UNUSED_STATE = {
+        .layout = Barrier_Image_Layout::Undefined,
+        .write_stage = Barrier_Pipeline_Stage::None,
+        .write_access = Barrier_Access::None,
+        .read_stage = Barrier_Pipeline_Stage::None,
+        .read_access = Barrier_Access::None
+    };
+
+    m_image_states.resize(m_images.size());
+    for (uint32_t image = 0; image < m_images.size(); ++image)
+    {
+        const auto& resource = m_images[image];
+        auto& states = m_image_states[image];
+        auto subresource_count = uint32_t(resource.create_info.mip_levels) * resource.create_info.array_size;
+        auto tracked_states = resource.transient
+            ? m_tracked_image_states.end()
+            : m_tracked_image_states.find(resource.image);
+        if (tracked_states != m_tracked_image_states.end() && tracked_states->second.size() == subresource_count)
+        {
+            states = tracked_states->second;
+        }
+        else
+        {
+            auto state = UNUSED_STATE;
+            state.layout = resource.transient ? Barrier_Image_Layout::Undefined : resource.initial_layout;
+            states.assign(subresource_count, state);
+        }
+    }
+    m_buffer_states.resize(m_buffers.size());
+    for (uint32_t buffer = 0; buffer < m_buffers.size(); ++buffer)
+    {
+        const auto& resource = m_buffers[buffer];
+        auto tracked_state = resource.transient
+            ? m_tracked_buffer_states.end()
+            : m_tracked_buffer_states.find(resource.buffer);
+        m_buffer_states[buffer] = tracked_state != m_tracked_buffer_states.end()
+            ? tracked_state->second
+            : UNUSED_STATE;
+    }
+
+    uint32_t pass_index = 0;
+    for (auto& pass : m_passes)
+    {
+        pass.image_barriers.clear();
+        pass.buffer_barriers.clear();
+        pass.memory_barriers.clear();
+        if (pass.culled) continue;
+
+        // The aliasing barriers of the transient heap are batched into the same call.
+        auto transient_barriers = m_transient_heap->get_pass_barriers(pass_index);
+        pass.image_barriers.assign(transient_barriers.image_barriers.begin(), transient_barriers.image_barriers.end());
+        pass.buffer_barriers.assign(transient_barriers.buffer_barriers.begin(), transient_barriers.buffer_barriers.end());
+        pass.memory_barriers.assign(transient_barriers.memory_barriers.begin(), transient_barriers.memory_barriers.end());
+
+        for (uint32_t i = 0; i < pass.image_accesses.size(); ++i)
+        {
+            auto image = pass.image_accesses[i].access.image;
+            bool first_access = std::none_of(pass.image_accesses.begin(), pass.image_accesses.begin() + i,
+                [image](const Image_Access& image_access) { return image_access.access.image == image; });
+            if (first_access) build_image_barriers(pass, pass_index, image);
+        }
+        for (uint32_t i = 0; i < pass.buffer_accesses.size(); ++i)
+        {
+            auto buffer = pass.buffer_accesses[i].access.buffer;
+            bool first_access = std::none_of(pass.buffer_accesses.begin(), pass.buffer_accesses.begin() + i,
+                [buffer](const Buffer_Access& buffer_access) { return buffer_access.access.buffer == buffer; });
+            if (first_access) build_buffer_barriers(pass, buffer);
+        }
+
+        m_statistics.barrier_count += pass.image_barriers.size() + pass.buffer_barriers.size() + pass.memory_barriers.size();
+        m_statistics.barrier_call_count +=
+            !pass.image_barriers.empty() || !pass.buffer_barriers.empty() || !pass.memory_barriers.empty() ? 1 : 0;
+        pass_index += 1;
+    }
+}
+
+void Render_Graph::build_image_barriers(Pass& pass, uint32_t pass_index, uint32_t image) noexcept
+{
+    const auto& resource = m_images[image];
+    auto& states = m_image_states[image];
+    uint32_t mip_levels = resource.create_info.mip_levels;
+    uint32_t array_size = resource.create_info.array_size;
+
+    std::vector<Access_Request> requests(states.size(), {
+        .used = false,
+        .write = false,
+        .stage = Barrier_Pipeline_Stage::None,
+        .access = Barrier_Access::None,
+        .layout = Barrier_Image_Layout::Undefined
+    });
+    for (const auto& [access, write] : pass.image_accesses)
+    {
+        if (access.image != image) continue;
+        for (uint32_t array_index = access.first_array_index; array_index < access.first_array_index + access.array_size; ++array_index)
+        {
+            for (uint32_t mip_level = access.first_mip_level; mip_level < access.first_mip_level + access.mip_count; ++mip_level)
+            {
+                auto& request = requests[array_index * mip_levels + mip_level];
+                request.used = true;
+                request.write = request.write || write;
+                request.stage = request.stage | access.stage;
+                request.access = request.access | access.access;
+                request.layout = access.layout;
+            }
+        }
+    }
+
+    if (resource.transient && resource.first_pass == pass_index)
+    {
+        // The aliasing barrier already discarded every subresource into the first layout.
+        std::ranges::fill(states, Access_State{
+            .layout = resource.first_layout,
+            .write_stage = Barrier_Pipeline_Stage::None,
+            .write_access = Barrier_Access::None,
+            .read_stage = Barrier_Pipeline_Stage::None,
+            .read_access = Barrier_Access::None
+        });
+    }
+
+    auto format_info = get_image_format_info(resource.create_info.format);
+    auto image_barriers_begin = pass.image_barriers.size();
+    for (uint32_t array_index = 0; array_index < array_size; ++array_index)
+    {
+        for (uint32_t mip_level = 0; mip_level < mip_levels; ++mip_level)
+        {
+            auto subresource = array_index * mip_levels + mip_level;
+            if (!requests[subresource].used) continue;
+
+            Image_Barrier_Info barrier = {
+                .stage_before = Barrier_Pipeline_Stage::None,
+                .stage_after = Barrier_Pipeline_Stage::None,
+                .access_before = Barrier_Access::None,
+                .access_after = Barrier_Access::None,
+                .layout_before = Barrier_Image_Layout::Undefined,
+                .layout_after = Barrier_Image_Layout::Undefined,
+                .queue_type_ownership_transfer_target_queue = Queue_Type::Graphics,
+                .queue_type_ownership_transfer_mode = Queue_Type_Ownership_Transfer_Mode::None,
+                .image = resource.image,
+                .subresource_range = {
+                    .first_mip_level = mip_level,
+                    .mip_count = 1,
+                    .first_array_index = array_index,
+                    .array_size = 1,
+                    .first_plane = 0,
+                    .plane_count = format_info.is_depth && format_info.is_stencil ? 2u : 1u
+                },
+                .discard = false
+            };
+            if (!apply_access(states[subresource], requests[subresource], barrier)) continue;
+
+            // Consecutive mip levels of an array slice with the same transition share a barrier.
+            if (pass.image_barriers.size() > image_barriers_begin)
+            {
+                auto& previous = pass.image_barriers.back();
+                if (is_same_render_graph_transition(previous, barrier)
+                    && previous.subresource_range.first_array_index == array_index
+                    && previous.subresource_range.first_mip_level + previous.subresource_range.mip_count == mip_level)
+                {
+                    previous.subresource_range.mip_count += 1;
+                    continue;
+                }
+            }
+            pass.image_barriers.push_back(barrier);
+        }
+    }
+
+    // Then consecutive array slices with the same mip range.
+    if (pass.image_barriers.size() <= image_barriers_begin) return;
+    auto merged = image_barriers_begin;
+    for (auto i = image_barriers_begin + 1; i < pass.image_barriers.size(); ++i)
+    {
+        auto& previous = pass.image_barriers[merged];
+        const auto& barrier = pass.image_barriers[i];
+        if (is_same_render_graph_transition(previous, barrier)
+            && previous.subresource_range.first_mip_level == barrier.subresource_range.first_mip_level
+            && previous.subresource_range.mip_count == barrier.subresource_range.mip_count
+            && previous.subresource_range.first_array_index + previous.subresource_range.array_size
+                == barrier.subresource_range.first_array_index)
+        {
+            previous.subresource_range.array_size += barrier.subresource_range.array_size;
+        }
+        else
+        {
+            pass.image_barriers[++merged] = barrier;
+        }
+    }
+    pass.image_barriers.resize(merged + 1);
+}
+
+void Render_Graph::build_buffer_barriers(Pass& pass, uint32_t buffer) noexcept
+{
+    Access_Request request = {
+        .used = true,
+        .write = false,
+        .stage = Barrier_Pipeline_Stage::None,
+        .access = Barrier_Access::None,
+        .layout = Barrier_Image_Layout::Undefined
+    };
+    for (const auto& [access, write] : pass.buffer_accesses)
+    {
+        if (access.buffer != buffer) continue;
+        request.write = request.write || write;
+        request.stage = request.stage | access.stage;
+        request.access = request.access | access.access;
+    }
+
+    Image_Barrier_Info barrier = {};
+    if (!apply_access(m_buffer_states[buffer], request, barrier)) return;
+    pass.buffer_barriers.push_back({
+        .stage_before = barrier.stage_before,
+        .stage_after = barrier.stage_after,
+        .access_before = barrier.access_before,
+        .access_after = barrier.access_after,
+        .buffer = m_buffers[buffer].buffer
+    });
+}
+}
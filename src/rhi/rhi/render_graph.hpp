@@ -0,0 +1,184 @@
+#pragma once
+
+#include "rhi/command_list.hpp"
+#include "rhi/resource.hpp"
+#include "rhi/result.hpp"
+#include "rhi/common/access_state.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <functional>
+#include <memory>
+#include <span>
+#include <unordered_map>
+#include <vector>
+
+namespace rhi
+{
+class Graphics_Device;
+class Transient_Heap;
+class Work_Stealing_Pool;
+struct Fence;
+
+struct Render_Graph_Create_Info
+{
+    Fence* fence; // Signaled with the values passed to `Render_Graph::end_frame`.
+    uint32_t recording_thread_count; // Worker threads used by `execute_parallel` besides the calling thread.
+};
+
+// A `mip_count` or `array_size` of zero selects every remaining mip level or array index.
+struct Render_Graph_Image_Access
+{
+    uint32_t image;
+    Barrier_Pipeline_Stage stage;
+    Barrier_Access access;
+    Barrier_Image_Layout layout;
+    uint32_t first_mip_level;
+    uint32_t mip_count;
+    uint32_t first_array_index;
+    uint32_t array_size;
+};
+
+struct Render_Graph_Buffer_Access
+{
+    uint32_t buffer;
+    Barrier_Pipeline_Stage stage;
+    Barrier_Access access;
+};
+
+struct Render_Graph_Pass_Info
+{
+    const char* name; // Recorded as a debug region if not null.
+    std::span<const Render_Graph_Image_Access> image_reads;
+    std::span<const Render_Graph_Image_Access> image_writes;
+    std::span<const Render_Graph_Buffer_Access> buffer_reads;
+    std::span<const Render_Graph_Buffer_Access> buffer_writes;
+    bool side_effects; // Never culled, for example readbacks or the transition to `Present`.
+    std::function<void(Command_List*)> record;
+};
+
+struct Render_Graph_Statistics
+{
+    uint64_t pass_count;
+    uint64_t culled_pass_count;
+    uint64_t barrier_count;
+    uint64_t barrier_call_count;
+};
+
+// Records a frame as a list of passes that declare how they access images and buffers.
+// `compile` culls passes whose writes are never read, places transient resources in a `Transient_Heap`
+// and computes the barriers of every pass from the tracked state of each subresource,
+// `execute` then records the passes in declaration order with at most one `barrier` call before each of them.
+// The state of imported resources is kept across frames. All passes have to be recorded on one queue. Not thread safe.
+class Render_Graph
+{
+public:
+    [[nodiscard]] static std::expected<std::unique_ptr<Render_Graph>, Result> create(
+        Graphics_Device* graphics_device, const Render_Graph_Create_Info& create_info) noexcept;
+    // Transient resources are destroyed once the fence reaches the value of the last `end_frame`.
+    ~Render_Graph() noexcept;
+    Render_Graph(const Render_Graph& other) = delete;
+    Render_Graph(Render_Graph&& other) = delete;
+    Render_Graph& operator=(const Render_Graph& other) = delete;
+    Render_Graph& operator=(Render_Graph&& other) = delete;
+
+    // Return a handle that is valid until `end_frame`. Imported resources are outputs of the frame,
+    // passes writing them are never culled. `initial_layout` is only used if the image is not tracked yet.
+    [[nodiscard]] uint32_t import_image(
+        Image* image, Barrier_Image_Layout initial_layout = Barrier_Image_Layout::Undefined) noexcept;
+    [[nodiscard]] uint32_t import_buffer(Buffer* buffer) noexcept;
+    // Transient resources only live during the frame, their contents are undefined at their first use.
+    [[nodiscard]] uint32_t create_image(const Image_Create_Info& create_info) noexcept;
+    [[nodiscard]] uint32_t create_buffer(const Buffer_Create_Info& create_info) noexcept;
+    // A subresource may be used in a single layout per pass. Reads and writes of the same subresource are merged.
+    void add_pass(const Render_Graph_Pass_Info& pass_info) noexcept;
+    // Must be called once per frame, after every pass was added.
+    [[nodiscard]] Result compile() noexcept;
+    // Records every pass that was not culled. The tracked state of imported resources is updated.
+    void execute(Command_List* command_list) noexcept;
+    // Like `execute`, but consecutive passes are recorded into separate command lists on worker threads,
+    // so `record` may be called concurrently. `command_pool` must be `thread_safe`.
+    // Returns the lists in submission order, the span stays valid until `end_frame`.
+    [[nodiscard]] std::span<Command_List*> execute_parallel(Command_Pool* command_pool) noexcept;
+    void end_frame(uint64_t fence_value) noexcept;
+
+    // Valid after `compile`. Transient resources only used by culled passes are null.
+    [[nodiscard]] Image* get_image(uint32_t image) const noexcept;
+    [[nodiscard]] Buffer* get_buffer(uint32_t buffer) const noexcept;
+    // Stops tracking the state of a resource, must be called before an imported resource is destroyed.
+    void forget_image(Image* image) noexcept;
+    void forget_buffer(Buffer* buffer) noexcept;
+
+    [[nodiscard]] Render_Graph_Statistics get_statistics() const noexcept;
+
+private:
+    struct Image_Resource
+    {
+        Image* image;
+        Image_Create_Info create_info;
+        bool transient;
+        Barrier_Image_Layout initial_layout;
+        uint32_t first_pass; // Index of the first pass that was not culled, only used for transient images.
+        Barrier_Image_Layout first_layout;
+    };
+
+    struct Buffer_Resource
+    {
+        Buffer* buffer;
+        Buffer_Create_Info create_info;
+        bool transient;
+    };
+
+    struct Image_Access
+    {
+        Render_Graph_Image_Access access;
+        bool write;
+    };
+
+    struct Buffer_Access
+    {
+        Render_Graph_Buffer_Access access;
+        bool write;
+    };
+
+    struct Pass
+    {
+        const char* name;
+        std::vector<Image_Access> image_accesses;
+        std::vector<Buffer_Access> buffer_accesses;
+        bool side_effects;
+        std::function<void(Command_List*)> record;
+        bool culled;
+        std::vector<Image_Barrier_Info> image_barriers;
+        std::vector<Buffer_Barrier_Info> buffer_barriers;
+        std::vector<Memory_Barrier_Info> memory_barriers;
+    };
+
+    Render_Graph() noexcept;
+
+    [[nodiscard]] Result validate_passes() noexcept;
+    void cull_passes() noexcept;
+    [[nodiscard]] Result place_transient_resources() noexcept;
+    void build_barriers() noexcept;
+    void build_image_barriers(Pass& pass, uint32_t pass_index, uint32_t image) noexcept;
+    void build_buffer_barriers(Pass& pass, uint32_t buffer) noexcept;
+    void record_pass(Pass& pass, Command_List* command_list) noexcept;
+    void commit_tracked_states() noexcept;
+
+private:
+    Graphics_Device* m_graphics_device;
+    std::unique_ptr<Transient_Heap> m_transient_heap;
+    std::unique_ptr<Work_Stealing_Pool> m_work_stealing_pool;
+    std::vector<Image_Resource> m_images;
+    std::vector<Buffer_Resource> m_buffers;
+    std::vector<Pass> m_passes;
+    bool m_compiled;
+    std::vector<Command_List*> m_command_lists;
+    // State of every subresource at the end of the frame, ordered by array index and then mip level.
+    std::vector<std::vector<Access_State>> m_image_states;
+    std::vector<Access_State> m_buffer_states;
+    std::unordered_map<Image*, std::vector<Access_State>> m_tracked_image_states;
+    std::unordered_map<Buffer*, Access_State> m_tracked_buffer_states;
+    Render_Graph_Statistics m_statistics;
+};
+}
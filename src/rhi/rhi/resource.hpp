@@ -1,11 +1,13 @@
 #pragma once
 
 #include <array>
+#include <span>
 #include <vector>
 #include <string_view>
 
 #include "rhi/acceleration_structure.hpp"
 #include "rhi/image_format.hpp"
+#include "rhi/shader_reflection.hpp"
 #include "rhi/common/bitmask.hpp"
 
 namespace rhi
@@ -13,6 +15,8 @@ namespace rhi
 constexpr static uint32_t NO_RESOURCE_INDEX = ~0u;
 constexpr static uint32_t MAX_RESOURCE_INDEX = 500000;
 constexpr static uint32_t MAX_SAMPLER_INDEX = 2048;
+// Storage buffer descriptors require their offset to be aligned to `minStorageBufferOffsetAlignment`, which is at most 256.
+constexpr static uint64_t BUFFER_VIEW_OFFSET_ALIGNMENT = 256;
 
 constexpr static uint32_t PIPELINE_COLOR_ATTACHMENTS_MAX = 8;
 
@@ -217,6 +221,29 @@ enum class Image_Sample_Address_Mode
     Border = 4
 };
 
+struct Memory_Heap_Create_Info
+{
+    uint64_t size;
+    Memory_Heap_Type heap;
+
+    auto operator<=>(const Memory_Heap_Create_Info&) const = default;
+};
+
+// Backs placed resources, resources placed at overlapping ranges alias each other's memory.
+struct Memory_Heap
+{
+    uint64_t size;
+    Memory_Heap_Type heap_type;
+
+    auto operator<=>(const Memory_Heap&) const = default;
+};
+
+struct Memory_Requirements
+{
+    uint64_t size;
+    uint64_t alignment;
+};
+
 struct Buffer_Create_Info
 {
     uint64_t size;
@@ -356,12 +383,13 @@ struct Shader_Blob_Create_Info
 
 struct Shader_Blob
 {
-    std::vector<uint8_t> data;
+    std::span<const uint8_t> data; // Either views `storage` or the mapping of a `Shader_Archive`.
+    std::vector<uint8_t> storage;
     uint32_t groups_x;
     uint32_t groups_y;
     uint32_t groups_z;
-
-    auto operator<=>(const Shader_Blob&) const = default;
+    uint64_t content_hash; // Kept up to date by the `Graphics_Device`, identifies identical pipelines.
+    Shader_Reflection reflection; // Only set for blobs created from a shader container or archive.
 };
 
 struct Pipeline_Rasterization_State_Info
@@ -537,7 +565,7 @@ struct Pipeline
 }
 
 template<>
-constexpr static bool RHI_ENABLE_BIT_OPERATORS<rhi::Image_Usage> = true;
+constexpr bool RHI_ENABLE_BIT_OPERATORS<rhi::Image_Usage> = true;
 
 template<>
-constexpr static bool RHI_ENABLE_BIT_OPERATORS<rhi::Color_Component> = true;
+constexpr bool RHI_ENABLE_BIT_OPERATORS<rhi::Color_Component> = true;
@@ -8,6 +8,7 @@ enum class Result
     Wait_Timeout,
     Error_Wait_Failed,
     Error_Out_Of_Memory,
+    Error_Out_Of_Descriptors, // Every bindless, RTV or DSV index is in use
     Error_Invalid_Parameters,
     Error_Device_Lost,
     Error_No_Resource, // Create a view of a destroyed resource
@@ -0,0 +1,209 @@
+#include "rhi/shader_archive.hpp"
+
+#include "rhi/common/hash.hpp"
+#include "rhi/common/pipeline_hash.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+namespace rhi
+{
+uint64_t hash_shader_archive_entry_name(std::string_view name) noexcept
+{
+    return hash_bytes(name.data(), name.size());
+}
+
+uint64_t align_shader_archive_offset(uint64_t offset) noexcept
+{
+    return (offset + SHADER_ARCHIVE_SECTION_ALIGNMENT - 1) & ~(SHADER_ARCHIVE_SECTION_ALIGNMENT - 1);
+}
+
+Shader_Archive::Shader_Archive() noexcept
+    : m_file()
+    , m_entries()
+{}
+
+std::expected<std::unique_ptr<Shader_Archive>, Result> Shader_Archive::open(
+    const std::filesystem::path& path) noexcept
+{
+    std::unique_ptr<Shader_Archive> archive(new (std::nothrow) Shader_Archive());
+    if (!archive) return std::unexpected(Result::Error_Out_Of_Memory);
+
+    auto result = archive->m_file.open(path);
+    if (result != Result::Success) return std::unexpected(result);
+
+    auto data = archive->m_file.get_data();
+    Shader_Archive_Header header = {};
+    if (data.size() < sizeof(header)) return std::unexpected(Result::Error_Invalid_Parameters);
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != SHADER_ARCHIVE_MAGIC
+        || header.version != SHADER_ARCHIVE_VERSION
+        || header.file_size != data.size()
+        || header.entry_count > (data.size() - sizeof(header)) / sizeof(Shader_Archive_Entry))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    // The mapping is page aligned and the entries directly follow the header, they are used in place.
+    archive->m_entries = {
+        reinterpret_cast<const Shader_Archive_Entry*>(data.data() + sizeof(header)),
+        header.entry_count };
+    if (!archive->validate()) return std::unexpected(Result::Error_Invalid_Parameters);
+    return archive;
+}
+
+uint32_t Shader_Archive::find_entry(std::string_view name) const noexcept
+{
+    auto name_hash = hash_shader_archive_entry_name(name);
+    auto it = std::ranges::lower_bound(m_entries, name_hash, {}, &Shader_Archive_Entry::name_hash);
+    if (it == m_entries.end() || it->name_hash != name_hash) return SHADER_ARCHIVE_NO_ENTRY;
+    return static_cast<uint32_t>(it - m_entries.begin());
+}
+
+uint32_t Shader_Archive::get_entry_count() const noexcept
+{
+    return static_cast<uint32_t>(m_entries.size());
+}
+
+const Shader_Archive_Entry& Shader_Archive::get_entry(uint32_t index) const noexcept
+{
+    return m_entries[index];
+}
+
+std::span<const uint8_t> Shader_Archive::get_section_data(const Shader_Archive_Section& section) const noexcept
+{
+    return m_file.get_data().subspan(section.offset, section.size);
+}
+
+bool Shader_Archive::validate() const noexcept
+{
+    auto file_size = m_file.get_data().size();
+    auto sections_begin = sizeof(Shader_Archive_Header) + m_entries.size_bytes();
+    auto is_valid_section = [&](const Shader_Archive_Section& section) {
+        return section.offset % SHADER_ARCHIVE_SECTION_ALIGNMENT == 0
+            && section.offset >= sections_begin
+            && section.offset <= file_size
+            && section.size <= file_size - section.offset;
+    };
+
+    for (auto i = 0ull; i < m_entries.size(); ++i)
+    {
+        const auto& entry = m_entries[i];
+        if (!is_valid_section(entry.dxil)
+            || !is_valid_section(entry.spirv)
+            || !is_valid_section(entry.reflection))
+        {
+            return false;
+        }
+        // Lookups binary search the entries.
+        if (i > 0 && m_entries[i - 1].name_hash >= entry.name_hash) return false;
+    }
+    return true;
+}
+
+Result write_shader_archive(
+    const std::filesystem::path& path, std::span<const Shader_Archive_Source> sources) noexcept
+{
+    std::vector<std::pair<uint64_t, const Shader_Archive_Source*>> sorted_sources;
+    std::vector<Shader_Archive_Entry> entries;
+    // Sections in file order. Sources passing the same bytecode share one section, e.g. permutations that compiled identically.
+    std::vector<std::span<const uint8_t>> section_data;
+    std::map<std::tuple<const uint8_t*, std::size_t, uint32_t, uint32_t, uint32_t>, Shader_Archive_Section> sections;
+    auto offset = align_shader_archive_offset(sizeof(Shader_Archive_Header) + sources.size() * sizeof(Shader_Archive_Entry));
+    auto make_section = [&](std::span<const uint8_t> data, const Shader_Archive_Source& source) {
+        auto [it, inserted] = sections.try_emplace({ data.data(), data.size(), source.groups_x, source.groups_y, source.groups_z });
+        if (inserted)
+        {
+            it->second = {
+                .offset = offset,
+                .size = data.size(),
+                .content_hash = hash_shader_blob_contents(
+                    data.data(), data.size(), source.groups_x, source.groups_y, source.groups_z)
+            };
+            section_data.push_back(data);
+            offset = align_shader_archive_offset(offset + data.size());
+        }
+        return it->second;
+    };
+    try
+    {
+        sorted_sources.reserve(sources.size());
+        entries.resize(sources.size());
+        for (const auto& source : sources)
+        {
+            sorted_sources.emplace_back(hash_shader_archive_entry_name(source.name), &source);
+        }
+        std::ranges::sort(sorted_sources, {}, &std::pair<uint64_t, const Shader_Archive_Source*>::first);
+
+        for (auto i = 0ull; i < entries.size(); ++i)
+        {
+            const auto& [name_hash, source] = sorted_sources[i];
+            if (i > 0 && sorted_sources[i - 1].first == name_hash) return Result::Error_Invalid_Parameters;
+
+            entries[i] = {
+                .name_hash = name_hash,
+                .groups_x = source->groups_x,
+                .groups_y = source->groups_y,
+                .groups_z = source->groups_z,
+                .reserved = 0,
+                .dxil = make_section(source->dxil, *source),
+                .spirv = make_section(source->spirv, *source),
+                .reflection = make_section(source->reflection, *source)
+            };
+        }
+    }
+    catch (const std::bad_alloc&)
+    {
+        return Result::Error_Out_Of_Memory;
+    }
+
+    Shader_Archive_Header header = {
+        .magic = SHADER_ARCHIVE_MAGIC,
+        .version = SHADER_ARCHIVE_VERSION,
+        .entry_count = static_cast<uint32_t>(entries.size()),
+        .reserved = 0,
+        .file_size = offset
+    };
+
+    // Written next to the destination and renamed so a crash never leaves a partial archive behind.
+    auto temp_path = path;
+    temp_path += ".tmp";
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        if (!file) return Result::Error_Unknown;
+
+        constexpr static std::array<char, SHADER_ARCHIVE_SECTION_ALIGNMENT> padding = {};
+        uint64_t written_size = 0;
+        auto write_aligned = [&](const void* data, uint64_t size) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written_size += size;
+            auto padding_size = align_shader_archive_offset(written_size) - written_size;
+            file.write(padding.data(), static_cast<std::streamsize>(padding_size));
+            written_size += padding_size;
+        };
+
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        written_size += sizeof(header);
+        write_aligned(entries.data(), entries.size() * sizeof(Shader_Archive_Entry));
+        for (auto data : section_data)
+        {
+            write_aligned(data.data(), data.size());
+        }
+        if (!file.flush()) return Result::Error_Unknown;
+    }
+    std::error_code error;
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+        return Result::Error_Unknown;
+    }
+    return Result::Success;
+}
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "rhi/result.hpp"
+#include "rhi/common/mapped_file.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <filesystem>
+#include <memory>
+#include <span>
+#include <string_view>
+
+namespace rhi
+{
+constexpr static uint32_t SHADER_ARCHIVE_MAGIC = 0x41535452; // "RTSA"
+constexpr static uint32_t SHADER_ARCHIVE_VERSION = 2;
+// Sections are handed to the drivers straight from the mapping, SPIR-V requires at least 4 byte alignment.
+constexpr static uint64_t SHADER_ARCHIVE_SECTION_ALIGNMENT = 16;
+constexpr static uint32_t SHADER_ARCHIVE_NO_ENTRY = ~0u;
+
+struct Shader_Archive_Section
+{
+    uint64_t offset;
+    uint64_t size;
+    uint64_t content_hash; // Becomes `Shader_Blob::content_hash`, so creating a blob never touches the bytecode.
+};
+
+struct Shader_Archive_Entry
+{
+    uint64_t name_hash;
+    uint32_t groups_x;
+    uint32_t groups_y;
+    uint32_t groups_z;
+    uint32_t reserved;
+    Shader_Archive_Section dxil;
+    Shader_Archive_Section spirv;
+    Shader_Archive_Section reflection; // Written by `write_shader_reflection`, may be empty.
+};
+
+// The header is followed by the entries sorted by `name_hash`, followed by the aligned DXIL, SPIR-V and reflection sections.
+struct Shader_Archive_Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t entry_count;
+    uint32_t reserved;
+    uint64_t file_size;
+};
+
+struct Shader_Archive_Source
+{
+    std::string_view name;
+    std::span<const uint8_t> dxil;
+    std::span<const uint8_t> spirv;
+    std::span<const uint8_t> reflection;
+    uint32_t groups_x;
+    uint32_t groups_y;
+    uint32_t groups_z;
+};
+
+// Shader archive memory-mapped from disk. Shader blobs created from it reference the mapping
+// instead of copying the bytecode, the archive must outlive every blob created from it.
+class Shader_Archive
+{
+public:
+    // Returns `Error_Invalid_Parameters` if the file is not a valid archive.
+    [[nodiscard]] static std::expected<std::unique_ptr<Shader_Archive>, Result> open(
+        const std::filesystem::path& path) noexcept;
+
+    // Returns `SHADER_ARCHIVE_NO_ENTRY` if no entry has the name.
+    [[nodiscard]] uint32_t find_entry(std::string_view name) const noexcept;
+    [[nodiscard]] uint32_t get_entry_count() const noexcept;
+    [[nodiscard]] const Shader_Archive_Entry& get_entry(uint32_t index) const noexcept;
+    [[nodiscard]] std::span<const uint8_t> get_section_data(const Shader_Archive_Section& section) const noexcept;
+
+private:
+    Shader_Archive() noexcept;
+
+    [[nodiscard]] bool validate() const noexcept;
+
+private:
+    Mapped_File m_file;
+    std::span<const Shader_Archive_Entry> m_entries;
+};
+
+// Entry names must be unique, the archive only stores their hashes.
+// Sources passing the same `dxil`, `spirv` or `reflection` span share its section in the archive.
+[[nodiscard]] Result write_shader_archive(
+    const std::filesystem::path& path, std::span<const Shader_Archive_Source> sources) noexcept;
+}
@@ -2,6 +2,8 @@
 
 #include "rhi/graphics_device.hpp"
 
+#include <cstring>
+
 namespace rhi
 {
 [[nodiscard]] constexpr uint64_t pow2_align_up(uint64_t x, uint64_t a) noexcept
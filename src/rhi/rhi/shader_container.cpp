@@ -0,0 +1,146 @@
+#include "rhi/shader_container.hpp"
+
+#include "rhi/common/hash.hpp"
+
+#include <array>
+#include <cstring>
+#include <utility>
+
+namespace rhi
+{
+uint64_t align_shader_container_offset(uint64_t offset) noexcept
+{
+    return (offset + SHADER_CONTAINER_SECTION_ALIGNMENT - 1) & ~(SHADER_CONTAINER_SECTION_ALIGNMENT - 1);
+}
+
+std::expected<std::vector<uint8_t>, Result> write_shader_container(
+    const Shader_Container_Contents& contents) noexcept
+{
+    constexpr static uint32_t SECTION_COUNT = 3;
+
+    std::array<Shader_Container_Section, SECTION_COUNT> sections = {};
+    std::array<std::span<const uint8_t>, SECTION_COUNT> section_data = {
+        contents.dxil,
+        contents.spirv,
+        contents.reflection
+    };
+    std::array<Shader_Container_Section_Type, SECTION_COUNT> section_types = {
+        Shader_Container_Section_Type::DXIL,
+        Shader_Container_Section_Type::SPIRV,
+        Shader_Container_Section_Type::Reflection
+    };
+
+    auto offset = align_shader_container_offset(sizeof(Shader_Container_Header) + sizeof(sections));
+    for (auto i = 0u; i < SECTION_COUNT; ++i)
+    {
+        sections[i] = {
+            .type = section_types[i],
+            .reserved = 0,
+            .offset = offset,
+            .size = section_data[i].size()
+        };
+        offset = align_shader_container_offset(offset + section_data[i].size());
+    }
+
+    std::vector<uint8_t> result;
+    try
+    {
+        result.resize(offset);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return std::unexpected(Result::Error_Out_Of_Memory);
+    }
+
+    // Padding stays zeroed, the content hash covers it.
+    memcpy(result.data() + sizeof(Shader_Container_Header), sections.data(), sizeof(sections));
+    for (auto i = 0u; i < SECTION_COUNT; ++i)
+    {
+        if (section_data[i].empty()) continue;
+        memcpy(result.data() + sections[i].offset, section_data[i].data(), section_data[i].size());
+    }
+
+    Shader_Container_Header header = {
+        .magic = SHADER_CONTAINER_MAGIC,
+        .version = SHADER_CONTAINER_VERSION,
+        .section_count = SECTION_COUNT,
+        .groups_x = contents.groups_x,
+        .groups_y = contents.groups_y,
+        .groups_z = contents.groups_z,
+        .size = result.size(),
+        .content_hash = hash_bytes(
+            result.data() + sizeof(Shader_Container_Header),
+            result.size() - sizeof(Shader_Container_Header))
+    };
+    memcpy(result.data(), &header, sizeof(header));
+    return result;
+}
+
+std::expected<Shader_Container_Contents, Result> read_shader_container(
+    std::span<const uint8_t> data) noexcept
+{
+    Shader_Container_Header header = {};
+    if (data.size() < sizeof(header)) return std::unexpected(Result::Error_Invalid_Parameters);
+    memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != SHADER_CONTAINER_MAGIC
+        || header.version != SHADER_CONTAINER_VERSION
+        || header.size > data.size()
+        || header.size < sizeof(header)
+        || header.section_count > (header.size - sizeof(header)) / sizeof(Shader_Container_Section))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+    // Trailing bytes past `header.size` are allowed, the container may be embedded in a larger buffer.
+    data = data.first(header.size);
+    if (hash_bytes(data.data() + sizeof(header), data.size() - sizeof(header)) != header.content_hash)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    Shader_Container_Contents contents = {
+        .groups_x = header.groups_x,
+        .groups_y = header.groups_y,
+        .groups_z = header.groups_z,
+        .dxil = {},
+        .spirv = {},
+        .reflection = {}
+    };
+    auto sections_end = sizeof(header) + header.section_count * sizeof(Shader_Container_Section);
+    bool has_dxil = false;
+    bool has_spirv = false;
+    bool has_reflection = false;
+    for (auto i = 0u; i < header.section_count; ++i)
+    {
+        Shader_Container_Section section = {};
+        memcpy(&section, data.data() + sizeof(header) + i * sizeof(section), sizeof(section));
+        if (section.offset % SHADER_CONTAINER_SECTION_ALIGNMENT != 0
+            || section.offset < sections_end
+            || section.offset > data.size()
+            || section.size > data.size() - section.offset)
+        {
+            return std::unexpected(Result::Error_Invalid_Parameters);
+        }
+
+        auto section_data = data.subspan(section.offset, section.size);
+        switch (section.type)
+        {
+        case Shader_Container_Section_Type::DXIL:
+            if (std::exchange(has_dxil, true)) return std::unexpected(Result::Error_Invalid_Parameters);
+            contents.dxil = section_data;
+            break;
+        case Shader_Container_Section_Type::SPIRV:
+            if (std::exchange(has_spirv, true)) return std::unexpected(Result::Error_Invalid_Parameters);
+            contents.spirv = section_data;
+            break;
+        case Shader_Container_Section_Type::Reflection:
+            if (std::exchange(has_reflection, true)) return std::unexpected(Result::Error_Invalid_Parameters);
+            contents.reflection = section_data;
+            break;
+        default:
+            // Unknown sections are skipped so additive changes do not need a new version.
+            break;
+        }
+    }
+    return contents;
+}
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "rhi/result.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <vector>
+
+namespace rhi
+{
+constexpr static uint32_t SHADER_CONTAINER_MAGIC = 0x43535452; // "RTSC"
+constexpr static uint32_t SHADER_CONTAINER_VERSION = 1;
+// Section offsets are aligned relative to the container, so a container placed at an aligned address can be used in place.
+constexpr static uint64_t SHADER_CONTAINER_SECTION_ALIGNMENT = 16;
+
+enum class Shader_Container_Section_Type : uint32_t
+{
+    DXIL,
+    SPIRV,
+    Reflection // Written by `write_shader_reflection`.
+};
+
+// The header is followed by `section_count` sections and the aligned section data.
+// `content_hash` covers everything after the header.
+struct Shader_Container_Header
+{
+    uint32_t magic;
+    uint32_t version;
+    uint32_t section_count;
+    uint32_t groups_x;
+    uint32_t groups_y;
+    uint32_t groups_z;
+    uint64_t size;
+    uint64_t content_hash;
+};
+
+struct Shader_Container_Section
+{
+    Shader_Container_Section_Type type;
+    uint32_t reserved;
+    uint64_t offset;
+    uint64_t size;
+};
+
+// Either IR may be empty if the shader was only compiled for one graphics API.
+// `reflection` is empty for containers written without reflection, see `read_shader_reflection`.
+struct Shader_Container_Contents
+{
+    uint32_t groups_x;
+    uint32_t groups_y;
+    uint32_t groups_z;
+    std::span<const uint8_t> dxil;
+    std::span<const uint8_t> spirv;
+    std::span<const uint8_t> reflection;
+};
+
+[[nodiscard]] std::expected<std::vector<uint8_t>, Result> write_shader_container(
+    const Shader_Container_Contents& contents) noexcept;
+// The returned spans point into `data`. Returns `Error_Invalid_Parameters` for truncated, corrupted,
+// or unknown versions of containers. `data` needs no particular alignment.
+[[nodiscard]] std::expected<Shader_Container_Contents, Result> read_shader_container(
+    std::span<const uint8_t> data) noexcept;
+}
@@ -0,0 +1,99 @@
+#include "rhi/shader_reflection.hpp"
+
+#include "rhi/common/hash.hpp"
+
+#include <cstring>
+
+namespace rhi
+{
+uint64_t hash_shader_semantic(std::string_view semantic) noexcept
+{
+    auto hash = 0ull;
+    for (auto character : semantic)
+    {
+        auto upper = character >= 'a' && character <= 'z' ? char(character - 'a' + 'A') : character;
+        hash = hash_value(upper, hash);
+    }
+    return hash;
+}
+
+std::expected<std::vector<uint8_t>, Result> write_shader_reflection(
+    const Shader_Reflection& reflection) noexcept
+{
+    Shader_Reflection_Header header = {
+        .flags = reflection.flags,
+        .push_constant_size = reflection.push_constant_size,
+        .wave_size_min = reflection.wave_size_min,
+        .wave_size_max = reflection.wave_size_max,
+        .input_count = uint32_t(reflection.inputs.size()),
+        .output_count = uint32_t(reflection.outputs.size())
+    };
+    auto inputs_size = reflection.inputs.size() * sizeof(Shader_Signature_Element);
+    auto outputs_size = reflection.outputs.size() * sizeof(Shader_Signature_Element);
+
+    std::vector<uint8_t> result;
+    try
+    {
+        result.resize(sizeof(header) + inputs_size + outputs_size);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return std::unexpected(Result::Error_Out_Of_Memory);
+    }
+    memcpy(result.data(), &header, sizeof(header));
+    if (inputs_size > 0)
+    {
+        memcpy(result.data() + sizeof(header), reflection.inputs.data(), inputs_size);
+    }
+    if (outputs_size > 0)
+    {
+        memcpy(result.data() + sizeof(header) + inputs_size, reflection.outputs.data(), outputs_size);
+    }
+    return result;
+}
+
+std::expected<Shader_Reflection, Result> read_shader_reflection(
+    std::span<const uint8_t> data) noexcept
+{
+    Shader_Reflection_Header header = {};
+    if (data.empty()) return Shader_Reflection();
+    if (data.size() < sizeof(header)) return std::unexpected(Result::Error_Invalid_Parameters);
+    memcpy(&header, data.data(), sizeof(header));
+    auto element_count = uint64_t(header.input_count) + header.output_count;
+    if (element_count > (data.size() - sizeof(header)) / sizeof(Shader_Signature_Element))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    Shader_Reflection reflection = {
+        .flags = header.flags,
+        .push_constant_size = header.push_constant_size,
+        .wave_size_min = header.wave_size_min,
+        .wave_size_max = header.wave_size_max,
+        .inputs = {},
+        .outputs = {}
+    };
+    try
+    {
+        reflection.inputs.resize(header.input_count);
+        reflection.outputs.resize(header.output_count);
+    }
+    catch (const std::bad_alloc&)
+    {
+        return std::unexpected(Result::Error_Out_Of_Memory);
+    }
+    auto inputs_size = reflection.inputs.size() * sizeof(Shader_Signature_Element);
+    if (inputs_size > 0)
+    {
+        memcpy(reflection.inputs.data(), data.data() + sizeof(header), inputs_size);
+    }
+    if (!reflection.outputs.empty())
+    {
+        memcpy(
+            reflection.outputs.data(),
+            data.data() + sizeof(header) + inputs_size,
+            reflection.outputs.size() * sizeof(Shader_Signature_Element));
+    }
+    return reflection;
+}
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include "rhi/result.hpp"
+#include "rhi/common/bitmask.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <span>
+#include <string_view>
+#include <vector>
+
+namespace rhi
+{
+enum class Shader_Reflection_Flags : uint32_t
+{
+    None = 0x0,
+    Valid = 0x1, // Set for reflected shaders, blobs created from raw bytecode carry no reflection.
+    Uses_16_Bit_Types = 0x2,
+    Uses_Resource_Heap = 0x4,
+    Uses_Sampler_Heap = 0x8
+};
+
+enum class Shader_System_Value : uint32_t
+{
+    None,
+    Position,
+    Target,
+    Depth,
+    Other // Generated by the hardware, e.g. `SV_VertexID`, never written by the previous stage.
+};
+
+struct Shader_Signature_Element
+{
+    uint64_t semantic_hash; // See `hash_shader_semantic`.
+    uint32_t semantic_index;
+    Shader_System_Value system_value;
+    uint32_t component_mask; // Components read by an input or written by an output, bit `i` for component `i`.
+    uint32_t reserved;
+};
+
+struct Shader_Reflection
+{
+    Shader_Reflection_Flags flags;
+    uint32_t push_constant_size; // In bytes, zero if the shader reads no push constants.
+    uint32_t wave_size_min; // Both zero if the shader runs with any wave size.
+    uint32_t wave_size_max;
+    std::vector<Shader_Signature_Element> inputs;
+    std::vector<Shader_Signature_Element> outputs;
+};
+
+// Serialized reflection, the header is followed by the input and then the output signature elements.
+struct Shader_Reflection_Header
+{
+    Shader_Reflection_Flags flags;
+    uint32_t push_constant_size;
+    uint32_t wave_size_min;
+    uint32_t wave_size_max;
+    uint32_t input_count;
+    uint32_t output_count;
+};
+
+// Semantics are case insensitive, they are hashed upper case.
+[[nodiscard]] uint64_t hash_shader_semantic(std::string_view semantic) noexcept;
+
+[[nodiscard]] std::expected<std::vector<uint8_t>, Result> write_shader_reflection(
+    const Shader_Reflection& reflection) noexcept;
+// Returns `Error_Invalid_Parameters` if `data` is truncated. `data` needs no particular alignment.
+// Empty `data` is read as a shader without reflection.
+[[nodiscard]] std::expected<Shader_Reflection, Result> read_shader_reflection(
+    std::span<const uint8_t> data) noexcept;
+}
+
+template<>
+constexpr bool RHI_ENABLE_BIT_OPERATORS<rhi::Shader_Reflection_Flags> = true;
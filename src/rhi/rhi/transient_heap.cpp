@@ -0,0 +1,356 @@
+#include "rhi/transient_heap.hpp"
+
+#include "rhi/graphics_device.hpp"
+#include "rhi/image_format.hpp"
+#include "rhi/queue_type.hpp"
+#include "rhi/common/access_state.hpp"
+
+#include <algorithm>
+#include <numeric>
+#include <utility>
+
+namespace rhi
+{
+namespace
+{
+uint64_t align_transient_heap_offset(uint64_t offset, uint64_t alignment) noexcept
+{
+    return (offset + alignment - 1) / alignment * alignment;
+}
+}
+
+std::expected<std::unique_ptr<Transient_Heap>, Result> Transient_Heap::create(
+    Graphics_Device* graphics_device, const Transient_Heap_Create_Info& create_info) noexcept
+{
+    if (!graphics_device || !create_info.fence)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    auto result = std::unique_ptr<Transient_Heap>(new Transient_Heap());
+    result->m_graphics_device = graphics_device;
+    result->m_fence = create_info.fence;
+    return result;
+}
+
+Transient_Heap::Transient_Heap() noexcept
+    : m_graphics_device(nullptr)
+    , m_fence(nullptr)
+    , m_memory_heap(nullptr)
+    , m_memory_heap_created(false)
+    , m_last_fence_value(0)
+    , m_declarations()
+    , m_compiled_declarations()
+    , m_placements()
+    , m_retired_last_stages(Barrier_Pipeline_Stage::None)
+    , m_retired_last_accesses(Barrier_Access::None)
+    , m_pass_barriers()
+{}
+
+Transient_Heap::~Transient_Heap() noexcept
+{
+    destroy_resources();
+    // Pushed after the placed resources, so the heap outlives them.
+    m_graphics_device->destroy_memory_heap_deferred(m_memory_heap, m_fence, m_last_fence_value);
+}
+
+uint32_t Transient_Heap::declare_image(
+    const Image_Create_Info& create_info, const Transient_Resource_Lifetime& lifetime) noexcept
+{
+    m_declarations.push_back({
+        .type = Resource_Type::Image,
+        .image_create_info = create_info,
+        .buffer_create_info = {},
+        .lifetime = lifetime
+    });
+    return uint32_t(m_declarations.size() - 1);
+}
+
+uint32_t Transient_Heap::declare_buffer(
+    const Buffer_Create_Info& create_info, const Transient_Resource_Lifetime& lifetime) noexcept
+{
+    m_declarations.push_back({
+        .type = Resource_Type::Buffer,
+        .image_create_info = {},
+        .buffer_create_info = create_info,
+        .lifetime = lifetime
+    });
+    return uint32_t(m_declarations.size() - 1);
+}
+
+Result Transient_Heap::compile() noexcept
+{
+    for (const auto& declaration : m_declarations)
+    {
+        if (declaration.lifetime.first_pass > declaration.lifetime.last_pass
+            || (declaration.type == Resource_Type::Buffer
+                && (declaration.buffer_create_info.size == 0
+                    || declaration.buffer_create_info.heap != Memory_Heap_Type::GPU)))
+        {
+            return Result::Error_Invalid_Parameters;
+        }
+    }
+
+    bool reused_placements = m_declarations == m_compiled_declarations;
+    if (reused_placements)
+    {
+        m_memory_heap_created = false;
+    }
+    else
+    {
+        // A failed compile left nothing behind, the stages of the layout before it still apply.
+        if (!m_compiled_declarations.empty())
+        {
+            m_retired_last_stages = Barrier_Pipeline_Stage::None;
+            m_retired_last_accesses = Barrier_Access::None;
+            for (const auto& declaration : m_compiled_declarations)
+            {
+                m_retired_last_stages = m_retired_last_stages | declaration.lifetime.last_stage;
+                m_retired_last_accesses = m_retired_last_accesses | declaration.lifetime.last_access;
+            }
+        }
+        destroy_resources();
+        m_compiled_declarations.clear();
+
+        auto result = place_resources();
+        if (result != Result::Success)
+        {
+            destroy_resources();
+            return result;
+        }
+        m_compiled_declarations = m_declarations;
+    }
+    build_pass_barriers(reused_placements);
+    return Result::Success;
+}
+
+Image* Transient_Heap::get_image(uint32_t handle) const noexcept
+{
+    return handle < m_placements.size()
+        ? m_placements[handle].image
+        : nullptr;
+}
+
+Buffer* Transient_Heap::get_buffer(uint32_t handle) const noexcept
+{
+    return handle < m_placements.size()
+        ? m_placements[handle].buffer
+        : nullptr;
+}
+
+Barrier_Info Transient_Heap::get_pass_barriers(uint32_t pass) noexcept
+{
+    auto pass_barriers = m_pass_barriers.find(pass);
+    if (pass_barriers == m_pass_barriers.end()) return {};
+
+    return {
+        .buffer_barriers = pass_barriers->second.buffer_barriers,
+        .image_barriers = pass_barriers->second.image_barriers,
+        .memory_barriers = pass_barriers->second.memory_barriers
+    };
+}
+
+void Transient_Heap::end_frame(uint64_t fence_value) noexcept
+{
+    m_last_fence_value = fence_value;
+    m_declarations.clear();
+}
+
+Transient_Heap_Statistics Transient_Heap::get_statistics() const noexcept
+{
+    return {
+        .heap_size = m_memory_heap ? m_memory_heap->size : 0,
+        .resource_size = std::accumulate(m_placements.begin(), m_placements.end(), uint64_t(0),
+            [](uint64_t size, const Placement& placement) { return size + placement.size; }),
+        .resource_count = m_placements.size()
+    };
+}
+
+Result Transient_Heap::place_resources() noexcept
+{
+    std::vector<Memory_Requirements> memory_requirements;
+    memory_requirements.reserve(m_declarations.size());
+    for (const auto& declaration : m_declarations)
+    {
+        memory_requirements.push_back(declaration.type == Resource_Type::Image
+            ? m_graphics_device->get_memory_requirements(declaration.image_create_info)
+            : m_graphics_device->get_memory_requirements(declaration.buffer_create_info));
+    }
+
+    // Greedy placement, largest first, at the lowest offset not used by any resource whose lifetime overlaps.
+    std::vector<uint32_t> placement_order(m_declarations.size());
+    std::iota(placement_order.begin(), placement_order.end(), 0u);
+    std::ranges::stable_sort(placement_order, [&memory_requirements](uint32_t a, uint32_t b)
+        {
+            return memory_requirements[a].size > memory_requirements[b].size;
+        });
+
+    m_placements.assign(m_declarations.size(), {});
+    std::vector<uint32_t> placed;
+    std::vector<std::pair<uint64_t, uint64_t>> live_ranges;
+    uint64_t heap_size = 0;
+    for (auto index : placement_order)
+    {
+        const auto& lifetime = m_declarations[index].lifetime;
+        live_ranges.clear();
+        for (auto other : placed)
+        {
+            const auto& other_lifetime = m_declarations[other].lifetime;
+            if (lifetime.first_pass <= other_lifetime.last_pass && other_lifetime.first_pass <= lifetime.last_pass)
+            {
+                live_ranges.emplace_back(m_placements[other].offset, m_placements[other].offset + m_placements[other].size);
+            }
+        }
+        std::ranges::sort(live_ranges);
+
+        auto [size, alignment] = memory_requirements[index];
+        uint64_t offset = 0;
+        for (auto [range_begin, range_end] : live_ranges)
+        {
+            offset = align_transient_heap_offset(offset, alignment);
+            if (offset + size <= range_begin) break;
+            offset = std::max(offset, range_end);
+        }
+        offset = align_transient_heap_offset(offset, alignment);
+
+        m_placements[index].offset = offset;
+        m_placements[index].size = size;
+        heap_size = std::max(heap_size, offset + size);
+        placed.push_back(index);
+    }
+
+    m_memory_heap_created = false;
+    if (heap_size > 0 && (!m_memory_heap || m_memory_heap->size < heap_size))
+    {
+        // Pushed after the resources destroyed by `compile`, so the old heap outlives them.
+        m_graphics_device->destroy_memory_heap_deferred(m_memory_heap, m_fence, m_last_fence_value);
+        m_memory_heap = nullptr;
+
+        auto memory_heap = m_graphics_device->create_memory_heap({
+            .size = heap_size,
+            .heap = Memory_Heap_Type::GPU
+        });
+        if (!memory_heap) return memory_heap.error();
+        m_memory_heap = *memory_heap;
+        m_memory_heap_created = true;
+    }
+
+    for (uint32_t index = 0; index < m_declarations.size(); ++index)
+    {
+        const auto& declaration = m_declarations[index];
+        auto& placement = m_placements[index];
+        if (declaration.type == Resource_Type::Image)
+        {
+            auto image = m_graphics_device->create_placed_image(
+                declaration.image_create_info, m_memory_heap, placement.offset);
+            if (!image) return image.error();
+            placement.image = *image;
+        }
+        else
+        {
+            auto buffer = m_graphics_device->create_placed_buffer(
+                declaration.buffer_create_info, m_memory_heap, placement.offset);
+            if (!buffer) return buffer.error();
+            placement.buffer = *buffer;
+        }
+    }
+    return Result::Success;
+}
+
+void Transient_Heap::build_pass_barriers(bool reused_placements) noexcept
+{
+    m_pass_barriers.clear();
+    for (uint32_t index = 0; index < m_declarations.size(); ++index)
+    {
+        const auto& declaration = m_declarations[index];
+        const auto& placement = m_placements[index];
+
+        // The previous frame used the same memory, its last users may still run on the queue.
+        // With unchanged placements only resources sharing this memory matter, including this resource itself.
+        bool retired_layout = !reused_placements && !m_memory_heap_created;
+        auto stage_before = retired_layout ? m_retired_last_stages : Barrier_Pipeline_Stage::None;
+        auto access_before = retired_layout ? m_retired_last_accesses : Barrier_Access::None;
+        for (uint32_t other = 0; other < m_declarations.size(); ++other)
+        {
+            const auto& other_placement = m_placements[other];
+            bool aliases = placement.offset < other_placement.offset + other_placement.size
+                && other_placement.offset < placement.offset + placement.size;
+            if (!aliases) continue;
+
+            const auto& other_lifetime = m_declarations[other].lifetime;
+            if (reused_placements || other_lifetime.last_pass < declaration.lifetime.first_pass)
+            {
+                stage_before = stage_before | other_lifetime.last_stage;
+                access_before = access_before | other_lifetime.last_access;
+            }
+        }
+
+        // Pending writes of the previous users have to be made available, otherwise they may land in the new resource.
+        // They may be of another resource type and D3D12 allows no access before an undefined layout,
+        // so they go into a global barrier and the aliasing barriers only order execution.
+        auto& pass_barriers = m_pass_barriers[declaration.lifetime.first_pass];
+        auto write_access_before = get_write_access(access_before);
+        if (write_access_before != Barrier_Access::None)
+        {
+            if (pass_barriers.memory_barriers.empty())
+            {
+                pass_barriers.memory_barriers.push_back({
+                    .stage_before = Barrier_Pipeline_Stage::None,
+                    .stage_after = Barrier_Pipeline_Stage::None,
+                    .access_before = Barrier_Access::None,
+                    .access_after = Barrier_Access::None
+                });
+            }
+            auto& memory_barrier = pass_barriers.memory_barriers.front();
+            memory_barrier.stage_before = memory_barrier.stage_before | stage_before;
+            memory_barrier.stage_after = memory_barrier.stage_after | declaration.lifetime.first_stage;
+            memory_barrier.access_before = memory_barrier.access_before | write_access_before;
+        }
+        if (declaration.type == Resource_Type::Image)
+        {
+            auto format_info = get_image_format_info(declaration.image_create_info.format);
+            pass_barriers.image_barriers.push_back({
+                .stage_before = stage_before,
+                .stage_after = declaration.lifetime.first_stage,
+                .access_before = Barrier_Access::None,
+                .access_after = declaration.lifetime.first_access,
+                .layout_before = Barrier_Image_Layout::Undefined,
+                .layout_after = declaration.lifetime.first_layout,
+                .queue_type_ownership_transfer_target_queue = Queue_Type::Graphics,
+                .queue_type_ownership_transfer_mode = Queue_Type_Ownership_Transfer_Mode::None,
+                .image = placement.image,
+                .subresource_range = {
+                    .first_mip_level = 0,
+                    .mip_count = declaration.image_create_info.mip_levels,
+                    .first_array_index = 0,
+                    .array_size = declaration.image_create_info.array_size,
+                    .first_plane = 0,
+                    .plane_count = format_info.is_depth && format_info.is_stencil ? 2u : 1u
+                },
+                .discard = true
+            });
+        }
+        else if (stage_before != Barrier_Pipeline_Stage::None)
+        {
+            pass_barriers.buffer_barriers.push_back({
+                .stage_before = stage_before,
+                .stage_after = declaration.lifetime.first_stage,
+                .access_before = Barrier_Access::None,
+                .access_after = declaration.lifetime.first_access,
+                .buffer = placement.buffer
+            });
+        }
+    }
+}
+
+void Transient_Heap::destroy_resources() noexcept
+{
+    for (const auto& placement : m_placements)
+    {
+        m_graphics_device->destroy_image_deferred(placement.image, m_fence, m_last_fence_value);
+        m_graphics_device->destroy_buffer_deferred(placement.buffer, m_fence, m_last_fence_value);
+    }
+    m_placements.clear();
+    m_pass_barriers.clear();
+}
+}
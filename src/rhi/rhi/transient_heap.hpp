@@ -0,0 +1,135 @@
+#pragma once
+
+#include "rhi/command_list.hpp"
+#include "rhi/resource.hpp"
+#include "rhi/result.hpp"
+
+#include <cstdint>
+#include <expected>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace rhi
+{
+class Graphics_Device;
+struct Fence;
+
+struct Transient_Heap_Create_Info
+{
+    Fence* fence; // Signaled with the values passed to `Transient_Heap::end_frame`.
+};
+
+// Passes are identified by their index in submission order, a resource is live from `first_pass` to `last_pass` inclusive.
+struct Transient_Resource_Lifetime
+{
+    uint32_t first_pass;
+    uint32_t last_pass;
+    // How the resource is first used, the destination of its aliasing barrier.
+    Barrier_Pipeline_Stage first_stage;
+    Barrier_Access first_access;
+    Barrier_Image_Layout first_layout; // Ignored for buffers.
+    // The last use, resources placed after it in the same memory wait for it and its writes.
+    Barrier_Pipeline_Stage last_stage;
+    Barrier_Access last_access;
+
+    auto operator<=>(const Transient_Resource_Lifetime&) const = default;
+};
+
+struct Transient_Heap_Statistics
+{
+    uint64_t heap_size;
+    uint64_t resource_size; // Memory the declared resources would need without aliasing.
+    uint64_t resource_count;
+};
+
+// Places frame-local images and `GPU` buffers such as render targets and scratch buffers into one shared memory heap.
+// Resources whose lifetimes do not overlap share memory. Every frame the same resources are declared, `compile`
+// places them and `get_pass_barriers` returns the aliasing barriers that must be recorded before each pass.
+// Placed resources are only recreated when the declarations change, the heap only grows.
+// All passes have to be recorded on one queue. Not thread safe.
+// Requires a device that can share a heap between buffers and images, `compile` fails on D3D12 resource heap tier 1.
+class Transient_Heap
+{
+public:
+    [[nodiscard]] static std::expected<std::unique_ptr<Transient_Heap>, Result> create(
+        Graphics_Device* graphics_device, const Transient_Heap_Create_Info& create_info) noexcept;
+    // The heap and its resources are destroyed once the fence reaches the value of the last `end_frame`.
+    ~Transient_Heap() noexcept;
+    Transient_Heap(const Transient_Heap& other) = delete;
+    Transient_Heap(Transient_Heap&& other) = delete;
+    Transient_Heap& operator=(const Transient_Heap& other) = delete;
+    Transient_Heap& operator=(Transient_Heap&& other) = delete;
+
+    // Return a handle that is valid until `end_frame`, handles are assigned in declaration order.
+    [[nodiscard]] uint32_t declare_image(
+        const Image_Create_Info& create_info, const Transient_Resource_Lifetime& lifetime) noexcept;
+    [[nodiscard]] uint32_t declare_buffer(
+        const Buffer_Create_Info& create_info, const Transient_Resource_Lifetime& lifetime) noexcept;
+    // Places every declared resource. Resources of the previous frame are reused if nothing was declared differently.
+    [[nodiscard]] Result compile() noexcept;
+
+    // Placed resources must only be accessed between their first and last pass.
+    [[nodiscard]] Image* get_image(uint32_t handle) const noexcept;
+    [[nodiscard]] Buffer* get_buffer(uint32_t handle) const noexcept;
+    // Images are discarded into their first layout, buffers wait for the previous users of their memory.
+    // The spans stay valid until the next `compile`.
+    [[nodiscard]] Barrier_Info get_pass_barriers(uint32_t pass) noexcept;
+    // Clears the declarations, the next frame declares its resources again.
+    void end_frame(uint64_t fence_value) noexcept;
+
+    [[nodiscard]] Transient_Heap_Statistics get_statistics() const noexcept;
+
+private:
+    enum class Resource_Type
+    {
+        Image,
+        Buffer
+    };
+
+    struct Declaration
+    {
+        Resource_Type type;
+        Image_Create_Info image_create_info;
+        Buffer_Create_Info buffer_create_info;
+        Transient_Resource_Lifetime lifetime;
+
+        auto operator<=>(const Declaration&) const = default;
+    };
+
+    struct Placement
+    {
+        uint64_t offset;
+        uint64_t size;
+        Image* image;
+        Buffer* buffer;
+    };
+
+    struct Pass_Barriers
+    {
+        std::vector<Image_Barrier_Info> image_barriers;
+        std::vector<Buffer_Barrier_Info> buffer_barriers;
+        std::vector<Memory_Barrier_Info> memory_barriers; // At most one, making pending writes of aliased memory available.
+    };
+
+    Transient_Heap() noexcept;
+
+    [[nodiscard]] Result place_resources() noexcept;
+    void build_pass_barriers(bool reused_placements) noexcept;
+    void destroy_resources() noexcept;
+
+private:
+    Graphics_Device* m_graphics_device;
+    Fence* m_fence;
+    Memory_Heap* m_memory_heap;
+    bool m_memory_heap_created; // The heap was created by the last `compile`, nothing used it before.
+    uint64_t m_last_fence_value;
+    std::vector<Declaration> m_declarations;
+    std::vector<Declaration> m_compiled_declarations;
+    std::vector<Placement> m_placements;
+    // Last uses of every resource of the previous layout, which the first users of a new layout wait for.
+    Barrier_Pipeline_Stage m_retired_last_stages;
+    Barrier_Access m_retired_last_accesses;
+    std::map<uint32_t, Pass_Barriers> m_pass_barriers;
+};
+}
@@ -0,0 +1,185 @@
+#include "rhi/upload_ring.hpp"
+
+#include "rhi/graphics_device.hpp"
+
+#include <algorithm>
+
+namespace rhi
+{
+namespace
+{
+uint64_t align_upload_ring_offset(uint64_t offset, uint64_t alignment) noexcept
+{
+    return (offset + alignment - 1) & ~(alignment - 1);
+}
+}
+
+std::expected<std::unique_ptr<Upload_Ring>, Result> Upload_Ring::create(
+    Graphics_Device* graphics_device, const Upload_Ring_Create_Info& create_info) noexcept
+{
+    if (!graphics_device || !create_info.fence || create_info.size == 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    auto buffer = graphics_device->create_buffer({
+        .size = create_info.size,
+        .heap = Memory_Heap_Type::CPU_Upload,
+        .acceleration_structure_memory = false
+    });
+    if (!buffer) return std::unexpected(buffer.error());
+
+    auto result = std::unique_ptr<Upload_Ring>(new Upload_Ring());
+    result->m_graphics_device = graphics_device;
+    result->m_fence = create_info.fence;
+    result->m_buffer = *buffer;
+    return result;
+}
+
+Upload_Ring::Upload_Ring() noexcept
+    : m_graphics_device(nullptr)
+    , m_fence(nullptr)
+    , m_buffer(nullptr)
+    , m_mutex()
+    , m_head(0)
+    , m_tail(0)
+    , m_last_fence_value(0)
+    , m_frames()
+    , m_frame_buffer_views()
+    , m_free_buffer_views()
+{}
+
+Upload_Ring::~Upload_Ring() noexcept
+{
+    if (m_buffer)
+    {
+        m_graphics_device->destroy_buffer_deferred(m_buffer, m_fence, m_last_fence_value);
+    }
+}
+
+std::expected<Upload_Allocation, Result> Upload_Ring::allocate(uint64_t size, uint64_t alignment) noexcept
+{
+    if (size == 0 || size > m_buffer->size || alignment == 0 || (alignment & (alignment - 1)) != 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    auto offset = allocate_range(size, alignment);
+    if (!offset) return std::unexpected(Result::Error_Out_Of_Memory);
+
+    return make_allocation(*offset, size, m_buffer->buffer_view);
+}
+
+std::expected<Upload_Allocation, Result> Upload_Ring::allocate_buffer_view(uint64_t size) noexcept
+{
+    if (size == 0 || size > m_buffer->size) return std::unexpected(Result::Error_Invalid_Parameters);
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    auto offset = allocate_range(size, UPLOAD_RING_BUFFER_VIEW_ALIGNMENT);
+    if (!offset) return std::unexpected(Result::Error_Out_Of_Memory);
+
+    // The range stays allocated if creating the view fails, it is reclaimed with the frame.
+    Buffer_View_Create_Info create_info = {
+        .size = size,
+        .offset = *offset
+    };
+    Buffer_View* buffer_view = nullptr;
+    if (!m_free_buffer_views.empty())
+    {
+        buffer_view = m_free_buffer_views.back();
+        auto result = m_graphics_device->update_buffer_view(buffer_view, create_info);
+        if (result != Result::Success) return std::unexpected(result);
+        m_free_buffer_views.pop_back();
+    }
+    else
+    {
+        // Views cannot be destroyed on their own, they live until the ring buffer is destroyed.
+        auto created_buffer_view = m_graphics_device->create_buffer_view(m_buffer, create_info);
+        if (!created_buffer_view) return std::unexpected(created_buffer_view.error());
+        buffer_view = *created_buffer_view;
+    }
+    m_frame_buffer_views.push_back(buffer_view);
+
+    return make_allocation(*offset, size, buffer_view);
+}
+
+void Upload_Ring::end_frame(uint64_t fence_value) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    m_frames.push_back({
+        .fence_value = fence_value,
+        .head = m_head,
+        .buffer_views = std::move(m_frame_buffer_views)
+    });
+    m_frame_buffer_views.clear();
+    m_last_fence_value = fence_value;
+    reclaim();
+}
+
+Buffer* Upload_Ring::get_buffer() const noexcept
+{
+    return m_buffer;
+}
+
+uint64_t Upload_Ring::get_size() const noexcept
+{
+    return m_buffer->size;
+}
+
+std::optional<uint64_t> Upload_Ring::allocate_range(uint64_t size, uint64_t alignment) noexcept
+{
+    auto offset = try_allocate_range(size, alignment);
+    if (!offset)
+    {
+        reclaim();
+        offset = try_allocate_range(size, alignment);
+    }
+    return offset;
+}
+
+std::optional<uint64_t> Upload_Ring::try_allocate_range(uint64_t size, uint64_t alignment) noexcept
+{
+    auto ring_size = m_buffer->size;
+    auto position = m_head % ring_size;
+    auto offset = align_upload_ring_offset(position, alignment);
+    auto head = m_head + (offset - position);
+    if (offset + size > ring_size)
+    {
+        // Allocations never wrap around, the rest of the buffer is skipped instead.
+        head = m_head + (ring_size - position);
+        offset = 0;
+    }
+    if (m_head == m_tail)
+    {
+        // Nothing is in flight, so the skipped bytes are free as well.
+        m_tail = head;
+    }
+    if (head + size - m_tail > ring_size) return std::nullopt;
+
+    m_head = head + size;
+    return offset;
+}
+
+Upload_Allocation Upload_Ring::make_allocation(uint64_t offset, uint64_t size, Buffer_View* buffer_view) const noexcept
+{
+    return Upload_Allocation {
+        .data = static_cast<uint8_t*>(m_buffer->data) + offset,
+        .gpu_address = m_buffer->gpu_address + offset,
+        .offset = offset,
+        .size = size,
+        .buffer_view = buffer_view
+    };
+}
+
+void Upload_Ring::reclaim() noexcept
+{
+    while (!m_frames.empty() && m_fence->get_status(m_frames.front().fence_value) == Result::Success)
+    {
+        auto& frame = m_frames.front();
+        m_tail = std::max(m_tail, frame.head);
+        m_free_buffer_views.insert(m_free_buffer_views.end(), frame.buffer_views.begin(), frame.buffer_views.end());
+        m_frames.pop_front();
+    }
+}
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "rhi/resource.hpp"
+#include "rhi/result.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <vector>
+
+namespace rhi
+{
+class Graphics_Device;
+struct Fence;
+
+constexpr static uint64_t UPLOAD_RING_DEFAULT_ALIGNMENT = 16;
+constexpr static uint64_t UPLOAD_RING_BUFFER_VIEW_ALIGNMENT = BUFFER_VIEW_OFFSET_ALIGNMENT;
+
+struct Upload_Ring_Create_Info
+{
+    uint64_t size;
+    Fence* fence; // Signaled with the values passed to `Upload_Ring::end_frame`.
+};
+
+struct Upload_Allocation
+{
+    void* data;
+    uint64_t gpu_address;
+    uint64_t offset; // Relative to the start of the ring buffer.
+    uint64_t size;
+    Buffer_View* buffer_view;
+};
+
+// Linear sub-allocator over a persistently mapped `CPU_Upload` buffer, meant for per-frame constants and dynamic geometry.
+// Allocations made before `end_frame` are reclaimed once the fence reaches the value passed to it.
+class Upload_Ring
+{
+public:
+    [[nodiscard]] static std::expected<std::unique_ptr<Upload_Ring>, Result> create(
+        Graphics_Device* graphics_device, const Upload_Ring_Create_Info& create_info) noexcept;
+    // The buffer is destroyed once the fence reaches the value of the last `end_frame`.
+    ~Upload_Ring() noexcept;
+    Upload_Ring(const Upload_Ring& other) = delete;
+    Upload_Ring(Upload_Ring&& other) = delete;
+    Upload_Ring& operator=(const Upload_Ring& other) = delete;
+    Upload_Ring& operator=(Upload_Ring&& other) = delete;
+
+    // `buffer_view` views the whole ring, shaders index it with `offset`. `alignment` must be a power of two.
+    // Returns `Error_Out_Of_Memory` if the ring is full, it never waits for the GPU.
+    [[nodiscard]] std::expected<Upload_Allocation, Result> allocate(
+        uint64_t size, uint64_t alignment = UPLOAD_RING_DEFAULT_ALIGNMENT) noexcept;
+    // Like `allocate`, but `buffer_view` views only the allocation. Views are recycled together with the memory.
+    [[nodiscard]] std::expected<Upload_Allocation, Result> allocate_buffer_view(uint64_t size) noexcept;
+    void end_frame(uint64_t fence_value) noexcept;
+
+    [[nodiscard]] Buffer* get_buffer() const noexcept;
+    [[nodiscard]] uint64_t get_size() const noexcept;
+
+private:
+    Upload_Ring() noexcept;
+
+    // Reclaims completed frames only if the range does not fit otherwise, polling the fence is not free.
+    [[nodiscard]] std::optional<uint64_t> allocate_range(uint64_t size, uint64_t alignment) noexcept;
+    [[nodiscard]] std::optional<uint64_t> try_allocate_range(uint64_t size, uint64_t alignment) noexcept;
+    [[nodiscard]] Upload_Allocation make_allocation(
+        uint64_t offset, uint64_t size, Buffer_View* buffer_view) const noexcept;
+    void reclaim() noexcept;
+
+private:
+    struct Frame
+    {
+        uint64_t fence_value;
+        uint64_t head;
+        std::vector<Buffer_View*> buffer_views;
+    };
+
+    Graphics_Device* m_graphics_device;
+    Fence* m_fence;
+    Buffer* m_buffer;
+    std::mutex m_mutex;
+    // Monotonic byte counters, the ring position is the counter modulo the buffer size.
+    uint64_t m_head;
+    uint64_t m_tail;
+    uint64_t m_last_fence_value;
+    std::deque<Frame> m_frames;
+    std::vector<Buffer_View*> m_frame_buffer_views;
+    std::vector<Buffer_View*> m_free_buffer_views;
+};
+}
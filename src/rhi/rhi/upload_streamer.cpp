@@ -0,0 +1,324 @@
+#include "rhi/upload_streamer.hpp"
+
+#include "rhi/graphics_device.hpp"
+#include "rhi/image_format.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <utility>
+
+namespace rhi
+{
+std::expected<std::unique_ptr<Upload_Streamer>, Result> Upload_Streamer::create(
+    Graphics_Device* graphics_device, const Upload_Streamer_Create_Info& create_info) noexcept
+{
+    if (!graphics_device || create_info.staging_size == 0 || create_info.destination_queue == Queue_Type::Copy)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    auto fence = graphics_device->create_fence(0);
+    if (!fence) return std::unexpected(fence.error());
+
+    auto staging_ring = Upload_Ring::create(graphics_device, {
+        .size = create_info.staging_size,
+        .fence = *fence
+    });
+    if (!staging_ring)
+    {
+        graphics_device->destroy_fence(*fence);
+        return std::unexpected(staging_ring.error());
+    }
+
+    auto result = std::unique_ptr<Upload_Streamer>(new Upload_Streamer());
+    result->m_graphics_device = graphics_device;
+    result->m_destination_queue = create_info.destination_queue;
+    result->m_fence = *fence;
+    result->m_staging_ring = std::move(*staging_ring);
+    return result;
+}
+
+Upload_Streamer::Upload_Streamer() noexcept
+    : m_graphics_device(nullptr)
+    , m_destination_queue(Queue_Type::Graphics)
+    , m_fence(nullptr)
+    , m_staging_ring()
+    , m_mutex()
+    , m_command_pool()
+    , m_command_list(nullptr)
+    , m_submitted_value(0)
+    , m_acquire_value(0)
+    , m_batches()
+    , m_free_command_pools()
+    , m_batch_acquire_barriers()
+    , m_acquire_barriers()
+{}
+
+Upload_Streamer::~Upload_Streamer() noexcept
+{
+    if (!m_fence) return;
+
+    flush();
+    m_fence->wait_for_value(m_submitted_value);
+    m_batches.clear();
+    m_free_command_pools.clear();
+    m_command_pool.reset();
+    // The staging buffer is destroyed deferred on the fence, which has to outlive it.
+    m_staging_ring.reset();
+    m_graphics_device->process_deferred_destructions();
+    m_graphics_device->destroy_fence(m_fence);
+}
+
+std::expected<uint64_t, Result> Upload_Streamer::upload_buffer(
+    Buffer* buffer, uint64_t offset, const void* data, uint64_t size) noexcept
+{
+    if (!buffer || !data || size == 0 || offset + size > buffer->size)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    // Large buffers are staged in chunks, so the copy queue works on earlier chunks while later ones are written.
+    auto chunk_size = std::max(m_staging_ring->get_size() / 4, uint64_t(1));
+    auto bytes = static_cast<const uint8_t*>(data);
+    for (uint64_t chunk_offset = 0; chunk_offset < size; chunk_offset += chunk_size)
+    {
+        auto copy_size = std::min(chunk_size, size - chunk_offset);
+        auto staging = allocate_staging(copy_size, UPLOAD_RING_DEFAULT_ALIGNMENT);
+        if (!staging) return std::unexpected(staging.error());
+        memcpy(staging->data, bytes + chunk_offset, copy_size);
+
+        auto result = begin_batch();
+        if (result != Result::Success) return std::unexpected(result);
+        m_command_list->copy_buffer(
+            m_staging_ring->get_buffer(), staging->offset, buffer, offset + chunk_offset, copy_size);
+    }
+    return m_submitted_value + 1;
+}
+
+std::expected<uint64_t, Result> Upload_Streamer::upload_image(const Image_Upload_Info& upload_info) noexcept
+{
+    auto image = upload_info.image;
+    if (!image || !upload_info.data || upload_info.mip_count == 0 || upload_info.array_size == 0
+        || upload_info.first_mip_level + upload_info.mip_count > image->mip_levels
+        || upload_info.first_array_index + upload_info.array_size > image->array_size)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    Image_Barrier_Subresource_Range subresource_range = {
+        .first_mip_level = upload_info.first_mip_level,
+        .mip_count = upload_info.mip_count,
+        .first_array_index = upload_info.first_array_index,
+        .array_size = upload_info.array_size,
+        .first_plane = 0,
+        .plane_count = 1
+    };
+
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    auto result = begin_batch();
+    if (result != Result::Success) return std::unexpected(result);
+
+    Image_Barrier_Info copy_barrier = {
+        .stage_before = Barrier_Pipeline_Stage::None,
+        .stage_after = Barrier_Pipeline_Stage::Copy,
+        .access_before = Barrier_Access::None,
+        .access_after = Barrier_Access::Transfer_Write,
+        .layout_before = Barrier_Image_Layout::Undefined,
+        .layout_after = Barrier_Image_Layout::Copy_Dst,
+        .queue_type_ownership_transfer_target_queue = Queue_Type::Copy,
+        .queue_type_ownership_transfer_mode = Queue_Type_Ownership_Transfer_Mode::None,
+        .image = image,
+        .subresource_range = subresource_range,
+        .discard = true
+    };
+    m_command_list->barrier({
+        .buffer_barriers = {},
+        .image_barriers = { &copy_barrier, 1 },
+        .memory_barriers = {}
+    });
+
+    auto source = static_cast<const uint8_t*>(upload_info.data);
+    for (auto array_index = upload_info.first_array_index;
+        array_index < upload_info.first_array_index + upload_info.array_size;
+        ++array_index)
+    {
+        for (auto mip_level = upload_info.first_mip_level;
+            mip_level < upload_info.first_mip_level + upload_info.mip_count;
+            ++mip_level)
+        {
+            Extent_3D extent = {
+                .x = std::max(image->width >> mip_level, 1u),
+                .y = std::max(image->height >> mip_level, 1u),
+                .z = std::max(image->depth >> mip_level, 1u)
+            };
+            auto footprint = get_image_copy_footprint(image->format, extent.x, extent.y, extent.z);
+            auto staging = allocate_staging(footprint.size, IMAGE_COPY_OFFSET_ALIGNMENT);
+            if (!staging) return std::unexpected(staging.error());
+
+            auto destination = static_cast<uint8_t*>(staging->data);
+            for (auto row = 0ull; row < uint64_t(footprint.row_count) * footprint.depth; ++row)
+            {
+                memcpy(destination + row * footprint.row_pitch, source, footprint.row_size);
+                source += footprint.row_size;
+            }
+
+            // Waiting for staging memory may have submitted the batch.
+            result = begin_batch();
+            if (result != Result::Success) return std::unexpected(result);
+            m_command_list->copy_buffer_to_image(
+                m_staging_ring->get_buffer(), staging->offset,
+                image, { 0, 0, 0 }, extent,
+                mip_level, array_index, footprint.row_pitch);
+        }
+    }
+
+    // The backends translate `Acquire` as handing the image to the target queue and `Release` as taking it over.
+    Image_Barrier_Info release_barrier = {
+        .stage_before = Barrier_Pipeline_Stage::Copy,
+        .stage_after = Barrier_Pipeline_Stage::None,
+        .access_before = Barrier_Access::Transfer_Write,
+        .access_after = Barrier_Access::None,
+        .layout_before = Barrier_Image_Layout::Copy_Dst,
+        .layout_after = Barrier_Image_Layout::Shader_Read_Only,
+        .queue_type_ownership_transfer_target_queue = m_destination_queue,
+        .queue_type_ownership_transfer_mode = Queue_Type_Ownership_Transfer_Mode::Acquire,
+        .image = image,
+        .subresource_range = subresource_range,
+        .discard = false
+    };
+    m_command_list->barrier({
+        .buffer_barriers = {},
+        .image_barriers = { &release_barrier, 1 },
+        .memory_barriers = {}
+    });
+    m_batch_acquire_barriers.push_back({
+        .stage_before = Barrier_Pipeline_Stage::None,
+        .stage_after = Barrier_Pipeline_Stage::All_Commands,
+        .access_before = Barrier_Access::None,
+        .access_after = Barrier_Access::Shader_Sampled_Read,
+        .layout_before = Barrier_Image_Layout::Copy_Dst,
+        .layout_after = Barrier_Image_Layout::Shader_Read_Only,
+        .queue_type_ownership_transfer_target_queue = Queue_Type::Copy,
+        .queue_type_ownership_transfer_mode = Queue_Type_Ownership_Transfer_Mode::Release,
+        .image = image,
+        .subresource_range = subresource_range,
+        .discard = false
+    });
+    return m_submitted_value + 1;
+}
+
+Result Upload_Streamer::flush() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    if (!m_command_list) return Result::Success;
+
+    return submit_batch();
+}
+
+uint64_t Upload_Streamer::acquire_uploads(Command_List* command_list) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex);
+    if (!m_acquire_barriers.empty())
+    {
+        command_list->barrier({
+            .buffer_barriers = {},
+            .image_barriers = m_acquire_barriers,
+            .memory_barriers = {}
+        });
+        m_acquire_barriers.clear();
+    }
+    return std::exchange(m_acquire_value, 0);
+}
+
+Fence* Upload_Streamer::get_fence() const noexcept
+{
+    return m_fence;
+}
+
+Result Upload_Streamer::begin_batch() noexcept
+{
+    if (m_command_list) return Result::Success;
+
+    reclaim_batches();
+    if (!m_free_command_pools.empty())
+    {
+        m_command_pool = std::move(m_free_command_pools.back());
+        m_free_command_pools.pop_back();
+    }
+    else
+    {
+        m_command_pool = m_graphics_device->create_command_pool({ .queue_type = Queue_Type::Copy, .thread_safe = false });
+        if (!m_command_pool) return Result::Error_Out_Of_Memory;
+    }
+    m_command_list = m_command_pool->acquire_command_list();
+    return Result::Success;
+}
+
+Result Upload_Streamer::submit_batch() noexcept
+{
+    auto fence_value = m_submitted_value + 1;
+    Submit_Fence_Info signal_info = {
+        .fence = m_fence,
+        .value = fence_value
+    };
+    Submit_Info submit_info = {
+        .queue_type = Queue_Type::Copy,
+        .wait_swapchain = nullptr,
+        .present_swapchain = nullptr,
+        .wait_infos = {},
+        .command_lists = { &m_command_list, 1 },
+        .signal_infos = { &signal_info, 1 }
+    };
+    auto result = m_graphics_device->submit(submit_info);
+
+    m_staging_ring->end_frame(fence_value);
+    m_batches.push_back({
+        .command_pool = std::move(m_command_pool),
+        .fence_value = fence_value
+    });
+    m_command_list = nullptr;
+    m_submitted_value = fence_value;
+    m_acquire_value = fence_value;
+    m_acquire_barriers.insert(
+        m_acquire_barriers.end(), m_batch_acquire_barriers.begin(), m_batch_acquire_barriers.end());
+    m_batch_acquire_barriers.clear();
+    return result;
+}
+
+void Upload_Streamer::reclaim_batches() noexcept
+{
+    while (!m_batches.empty() && m_fence->get_status(m_batches.front().fence_value) == Result::Success)
+    {
+        auto& batch = m_batches.front();
+        batch.command_pool->reset();
+        m_free_command_pools.push_back(std::move(batch.command_pool));
+        m_batches.pop_front();
+    }
+}
+
+std::expected<Upload_Allocation, Result> Upload_Streamer::allocate_staging(uint64_t size, uint64_t alignment) noexcept
+{
+    while (true)
+    {
+        auto allocation = m_staging_ring->allocate(size, alignment);
+        if (allocation || allocation.error() != Result::Error_Out_Of_Memory) return allocation;
+
+        // Staging memory is only freed by completed batches, submit the open one and wait for the oldest.
+        if (m_command_list)
+        {
+            auto result = submit_batch();
+            if (result != Result::Success) return std::unexpected(result);
+        }
+        else if (!m_batches.empty())
+        {
+            m_fence->wait_for_value(m_batches.front().fence_value);
+            reclaim_batches();
+        }
+        else
+        {
+            return allocation;
+        }
+    }
+}
+}
@@ -0,0 +1,97 @@
+#pragma once
+
+#include "rhi/command_list.hpp"
+#include "rhi/queue_type.hpp"
+#include "rhi/result.hpp"
+#include "rhi/upload_ring.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <expected>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace rhi
+{
+class Graphics_Device;
+struct Fence;
+
+struct Upload_Streamer_Create_Info
+{
+    uint64_t staging_size; // Must hold the largest image subresource, see `get_image_copy_footprint`.
+    Queue_Type destination_queue; // Takes over ownership of the uploaded images, must not be `Copy`.
+};
+
+struct Image_Upload_Info
+{
+    Image* image;
+    // Tightly packed subresources, array index by array index with every array index holding its mips in order.
+    const void* data;
+    uint32_t first_mip_level;
+    uint32_t mip_count;
+    uint32_t first_array_index;
+    uint32_t array_size;
+};
+
+// Streams buffer and image data through a staging ring on the copy queue, so uploads never stall the destination queue.
+// Uploads are recorded into batches which are submitted on `flush` and signal the streamer's fence once resident.
+// Uploaded images end in `Shader_Read_Only` and are owned by the destination queue after `acquire_uploads`.
+// All functions are thread safe, usually uploads come from a streaming thread while the render thread acquires them.
+class Upload_Streamer
+{
+public:
+    [[nodiscard]] static std::expected<std::unique_ptr<Upload_Streamer>, Result> create(
+        Graphics_Device* graphics_device, const Upload_Streamer_Create_Info& create_info) noexcept;
+    // Submits the open batch and waits for every batch to complete.
+    ~Upload_Streamer() noexcept;
+    Upload_Streamer(const Upload_Streamer& other) = delete;
+    Upload_Streamer(Upload_Streamer&& other) = delete;
+    Upload_Streamer& operator=(const Upload_Streamer& other) = delete;
+    Upload_Streamer& operator=(Upload_Streamer&& other) = delete;
+
+    // Return the fence value at which the data is resident. The destination must not be in use by the GPU.
+    // If the staging ring is full the open batch is submitted and the call waits for the copy queue to free space.
+    [[nodiscard]] std::expected<uint64_t, Result> upload_buffer(
+        Buffer* buffer, uint64_t offset, const void* data, uint64_t size) noexcept;
+    // Previous contents of the uploaded subresources are discarded.
+    [[nodiscard]] std::expected<uint64_t, Result> upload_image(const Image_Upload_Info& upload_info) noexcept;
+    // Submits the open batch, if any.
+    Result flush() noexcept;
+    // Records the ownership transfer barriers of every flushed image upload into `command_list`,
+    // which must be submitted on the destination queue.
+    // Returns the fence value that submission has to wait for, zero if nothing was flushed since the last call.
+    [[nodiscard]] uint64_t acquire_uploads(Command_List* command_list) noexcept;
+
+    [[nodiscard]] Fence* get_fence() const noexcept;
+
+private:
+    Upload_Streamer() noexcept;
+
+    [[nodiscard]] Result begin_batch() noexcept;
+    [[nodiscard]] Result submit_batch() noexcept;
+    void reclaim_batches() noexcept;
+    [[nodiscard]] std::expected<Upload_Allocation, Result> allocate_staging(uint64_t size, uint64_t alignment) noexcept;
+
+private:
+    struct Batch
+    {
+        std::unique_ptr<Command_Pool> command_pool;
+        uint64_t fence_value;
+    };
+
+    Graphics_Device* m_graphics_device;
+    Queue_Type m_destination_queue;
+    Fence* m_fence;
+    std::unique_ptr<Upload_Ring> m_staging_ring;
+    std::mutex m_mutex;
+    std::unique_ptr<Command_Pool> m_command_pool;
+    Command_List* m_command_list; // Open batch, nullptr if there is none.
+    uint64_t m_submitted_value; // The open batch signals the next value.
+    uint64_t m_acquire_value;
+    std::deque<Batch> m_batches;
+    std::vector<std::unique_ptr<Command_Pool>> m_free_command_pools;
+    std::vector<Image_Barrier_Info> m_batch_acquire_barriers;
+    std::vector<Image_Barrier_Info> m_acquire_barriers;
+};
+}
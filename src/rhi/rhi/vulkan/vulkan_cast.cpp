@@ -6,6 +6,7 @@
 #include "rhi/command_list.hpp"
 
 #include <bit>
+#include <utility>
 #include <vulkan/vulkan.h>
 
 namespace rhi::vulkan
@@ -2,6 +2,17 @@
 
 #include "rhi/vulkan/vulkan_graphics_device.hpp"
 #include "rhi/vulkan/vulkan_cast.hpp"
+#include "rhi/common/flag_translation_table.hpp"
+#include "rhi/common/scratch_array.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <iterator>
+#include <ranges>
+#include <thread>
+#include <utility>
+#include <vector>
 
 namespace rhi::vulkan
 {
@@ -9,6 +20,9 @@ Vulkan_Command_List::Vulkan_Command_List(VkCommandBuffer cmd, Vulkan_Graphics_De
     : m_cmd(cmd)
     , m_device(device)
     , m_bound_image_views()
+    , m_memory_barrier_spill()
+    , m_buffer_barrier_spill()
+    , m_image_barrier_spill()
 {
     m_queue_type = queue_type;
 }
@@ -53,146 +67,82 @@ auto translate_barrier_Image_layout(Barrier_Image_Layout layout)
     }
 }
 
+constexpr static auto VULKAN_PIPELINE_STAGE_TRANSLATION_TABLE = Flag_Translation_Table<Barrier_Pipeline_Stage, VkPipelineStageFlags2>(
+    std::to_array<Flag_Translation<Barrier_Pipeline_Stage, VkPipelineStageFlags2>>({
+        { Barrier_Pipeline_Stage::Draw_Indirect, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT },
+        { Barrier_Pipeline_Stage::Vertex_Input, VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT },
+        { Barrier_Pipeline_Stage::Vertex_Shader, VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT },
+        { Barrier_Pipeline_Stage::Hull_Shader, VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT },
+        { Barrier_Pipeline_Stage::Domain_Shader, VK_PIPELINE_STAGE_2_TESSELLATION_EVALUATION_SHADER_BIT },
+        { Barrier_Pipeline_Stage::Geometry_Shader, VK_PIPELINE_STAGE_2_GEOMETRY_SHADER_BIT },
+        { Barrier_Pipeline_Stage::Pixel_Shader, VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT },
+        { Barrier_Pipeline_Stage::Early_Fragment_Tests, VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT },
+        { Barrier_Pipeline_Stage::Late_Fragment_Tests, VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT },
+        { Barrier_Pipeline_Stage::Color_Attachment_Output, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT },
+        { Barrier_Pipeline_Stage::Compute_Shader, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT },
+        { Barrier_Pipeline_Stage::All_Transfer, VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT },
+        { Barrier_Pipeline_Stage::Host, VK_PIPELINE_STAGE_2_HOST_BIT },
+        { Barrier_Pipeline_Stage::All_Graphics, VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT },
+        { Barrier_Pipeline_Stage::All_Commands, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT },
+        { Barrier_Pipeline_Stage::Copy, VK_PIPELINE_STAGE_2_COPY_BIT },
+        { Barrier_Pipeline_Stage::Resolve, VK_PIPELINE_STAGE_2_RESOLVE_BIT },
+        { Barrier_Pipeline_Stage::Blit, VK_PIPELINE_STAGE_2_BLIT_BIT },
+        { Barrier_Pipeline_Stage::Clear, VK_PIPELINE_STAGE_2_CLEAR_BIT },
+        { Barrier_Pipeline_Stage::Index_Input, VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT },
+        { Barrier_Pipeline_Stage::Vertex_Attribute_Input, VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT },
+        { Barrier_Pipeline_Stage::Pre_Rasterization_Stages, VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT },
+        { Barrier_Pipeline_Stage::Video_Decode, VK_PIPELINE_STAGE_2_VIDEO_DECODE_BIT_KHR },
+        { Barrier_Pipeline_Stage::Video_Encode, VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR },
+        { Barrier_Pipeline_Stage::Acceleration_Structure_Build, VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR },
+        { Barrier_Pipeline_Stage::Ray_Tracing_Shader, VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR },
+        { Barrier_Pipeline_Stage::Amplification_Shader, VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT },
+        { Barrier_Pipeline_Stage::Mesh_Shader, VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT },
+        { Barrier_Pipeline_Stage::Acceleration_Structure_Copy, VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_COPY_BIT_KHR }
+    }));
+
+constexpr static auto VULKAN_ACCESS_TRANSLATION_TABLE = Flag_Translation_Table<Barrier_Access, VkAccessFlags2>(
+    std::to_array<Flag_Translation<Barrier_Access, VkAccessFlags2>>({
+        { Barrier_Access::Indirect_Command_Read, VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT },
+        { Barrier_Access::Index_Read, VK_ACCESS_2_INDEX_READ_BIT },
+        { Barrier_Access::Vertex_Attribute_Read, VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT },
+        { Barrier_Access::Constant_Buffer_View, VK_ACCESS_2_UNIFORM_READ_BIT },
+        { Barrier_Access::Shader_Read, VK_ACCESS_2_SHADER_READ_BIT },
+        { Barrier_Access::Shader_Write, VK_ACCESS_2_SHADER_WRITE_BIT },
+        { Barrier_Access::Color_Attachment_Read, VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT },
+        { Barrier_Access::Color_Attachment_Write, VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT },
+        { Barrier_Access::Depth_Stencil_Attachment_Read, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT },
+        { Barrier_Access::Depth_Stencil_Attachment_Write, VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT },
+        { Barrier_Access::Transfer_Read, VK_ACCESS_2_TRANSFER_READ_BIT },
+        { Barrier_Access::Transfer_Write, VK_ACCESS_2_TRANSFER_WRITE_BIT },
+        { Barrier_Access::Shader_Sampled_Read, VK_ACCESS_2_SHADER_SAMPLED_READ_BIT },
+        { Barrier_Access::Unordered_Access_Read, VK_ACCESS_2_SHADER_STORAGE_READ_BIT },
+        { Barrier_Access::Unordered_Access_Write, VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT },
+        { Barrier_Access::Video_Decode_Read, VK_ACCESS_2_VIDEO_DECODE_READ_BIT_KHR },
+        { Barrier_Access::Video_Decode_Write, VK_ACCESS_2_VIDEO_DECODE_WRITE_BIT_KHR },
+        { Barrier_Access::Video_Encode_Read, VK_ACCESS_2_VIDEO_ENCODE_READ_BIT_KHR },
+        { Barrier_Access::Video_Encode_Write, VK_ACCESS_2_VIDEO_ENCODE_WRITE_BIT_KHR },
+        { Barrier_Access::Shading_Rate_Attachment, VK_ACCESS_2_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR },
+        { Barrier_Access::Acceleration_Structure_Read, VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR },
+        { Barrier_Access::Acceleration_Structure_Write, VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR }
+    }));
+
 auto translate_barrier_pipeline_stage_flags(Barrier_Pipeline_Stage stage)
 {
-    auto check_stage = [stage](auto flag)
-        {
-            return ((flag & stage) != Barrier_Pipeline_Stage::None);
-        };
-    auto apply_stages = [&](auto flag, auto d3d12_flag)
-        {
-            return check_stage(flag) ? d3d12_flag : VK_PIPELINE_STAGE_2_NONE;
-        };
-    auto result = VK_PIPELINE_STAGE_2_NONE;
-    result |= apply_stages(Barrier_Pipeline_Stage::Draw_Indirect,
-        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Vertex_Input,
-        VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Vertex_Shader,
-        VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Hull_Shader,
-        VK_PIPELINE_STAGE_2_TESSELLATION_CONTROL_SHADER_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Domain_Shader,
-        VK_PIPELINE_STAGE_2_TESSELLATION_EVALUATION_SHADER_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Geometry_Shader,
-        VK_PIPELINE_STAGE_2_GEOMETRY_SHADER_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Pixel_Shader,
-        VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Early_Fragment_Tests,
-        VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Late_Fragment_Tests,
-        VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Color_Attachment_Output,
-        VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Compute_Shader,
-        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::All_Transfer,
-        VK_PIPELINE_STAGE_2_ALL_TRANSFER_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Host,
-        VK_PIPELINE_STAGE_2_HOST_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::All_Graphics,
-        VK_PIPELINE_STAGE_2_ALL_GRAPHICS_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::All_Commands,
-        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Copy,
-        VK_PIPELINE_STAGE_2_COPY_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Resolve,
-        VK_PIPELINE_STAGE_2_RESOLVE_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Blit,
-        VK_PIPELINE_STAGE_2_BLIT_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Clear,
-        VK_PIPELINE_STAGE_2_CLEAR_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Index_Input,
-        VK_PIPELINE_STAGE_2_INDEX_INPUT_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Vertex_Attribute_Input,
-        VK_PIPELINE_STAGE_2_VERTEX_ATTRIBUTE_INPUT_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Pre_Rasterization_Stages,
-        VK_PIPELINE_STAGE_2_PRE_RASTERIZATION_SHADERS_BIT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Video_Decode,
-        VK_PIPELINE_STAGE_2_VIDEO_DECODE_BIT_KHR);
-    result |= apply_stages(Barrier_Pipeline_Stage::Video_Encode,
-        VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR);
-    result |= apply_stages(Barrier_Pipeline_Stage::Acceleration_Structure_Build,
-        VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_BUILD_BIT_KHR);
-    result |= apply_stages(Barrier_Pipeline_Stage::Ray_Tracing_Shader,
-        VK_PIPELINE_STAGE_2_RAY_TRACING_SHADER_BIT_KHR);
-    result |= apply_stages(Barrier_Pipeline_Stage::Amplification_Shader,
-        VK_PIPELINE_STAGE_2_TASK_SHADER_BIT_EXT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Mesh_Shader,
-        VK_PIPELINE_STAGE_2_MESH_SHADER_BIT_EXT);
-    result |= apply_stages(Barrier_Pipeline_Stage::Acceleration_Structure_Copy,
-        VK_PIPELINE_STAGE_2_ACCELERATION_STRUCTURE_COPY_BIT_KHR);
-    return result;
+    return VULKAN_PIPELINE_STAGE_TRANSLATION_TABLE.translate(stage);
 }
 
 auto translate_barrier_access_flags(Barrier_Access access)
 {
-    auto check_access = [access](auto flag)
-        {
-            return ((flag & access) != Barrier_Access::None);
-        };
-    auto apply_access = [&](auto flag, auto d3d12_flag)
-        {
-            return check_access(flag) ? d3d12_flag : VK_ACCESS_2_NONE;
-        };
+    return VULKAN_ACCESS_TRANSLATION_TABLE.translate(access);
+}
 
-    if (access == Barrier_Access::None)
-    {
-        return VK_ACCESS_2_NONE;
-    }
+// Larger barrier batches use the spill storage of the command list.
+constexpr static std::size_t BARRIER_INLINE_CAPACITY = 16;
 
-    auto result = VK_ACCESS_2_NONE;
-    result |= apply_access(Barrier_Access::Indirect_Command_Read,
-        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT);
-    result |= apply_access(Barrier_Access::Index_Read,
-        VK_ACCESS_2_INDEX_READ_BIT);
-    result |= apply_access(Barrier_Access::Vertex_Attribute_Read,
-        VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT);
-    result |= apply_access(Barrier_Access::Constant_Buffer_View,
-        VK_ACCESS_2_UNIFORM_READ_BIT);
-    result |= apply_access(Barrier_Access::Shader_Read,
-        VK_ACCESS_2_SHADER_READ_BIT);
-    result |= apply_access(Barrier_Access::Shader_Write,
-        VK_ACCESS_2_SHADER_WRITE_BIT);
-    result |= apply_access(Barrier_Access::Color_Attachment_Read,
-        VK_ACCESS_2_COLOR_ATTACHMENT_READ_BIT);
-    result |= apply_access(Barrier_Access::Color_Attachment_Write,
-        VK_ACCESS_2_COLOR_ATTACHMENT_WRITE_BIT);
-    result |= apply_access(Barrier_Access::Depth_Stencil_Attachment_Read,
-        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_READ_BIT);
-    result |= apply_access(Barrier_Access::Depth_Stencil_Attachment_Write,
-        VK_ACCESS_2_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT);
-    result |= apply_access(Barrier_Access::Transfer_Read,
-        VK_ACCESS_2_TRANSFER_READ_BIT);
-    result |= apply_access(Barrier_Access::Transfer_Write,
-        VK_ACCESS_2_TRANSFER_WRITE_BIT);
-    result |= apply_access(Barrier_Access::Shader_Sampled_Read,
-        VK_ACCESS_2_SHADER_SAMPLED_READ_BIT);
-    result |= apply_access(Barrier_Access::Unordered_Access_Read,
-        VK_ACCESS_2_SHADER_STORAGE_READ_BIT);
-    result |= apply_access(Barrier_Access::Unordered_Access_Write,
-        VK_ACCESS_2_SHADER_STORAGE_WRITE_BIT);
-    result |= apply_access(Barrier_Access::Video_Decode_Read,
-        VK_ACCESS_2_VIDEO_DECODE_READ_BIT_KHR);
-    result |= apply_access(Barrier_Access::Video_Decode_Write,
-        VK_ACCESS_2_VIDEO_DECODE_WRITE_BIT_KHR);
-    result |= apply_access(Barrier_Access::Video_Encode_Read,
-        VK_ACCESS_2_VIDEO_ENCODE_READ_BIT_KHR);
-    result |= apply_access(Barrier_Access::Video_Encode_Write,
-        VK_ACCESS_2_VIDEO_ENCODE_WRITE_BIT_KHR);
-    result |= apply_access(Barrier_Access::Shading_Rate_Attachment,
-        VK_ACCESS_2_FRAGMENT_SHADING_RATE_ATTACHMENT_READ_BIT_KHR);
-    result |= apply_access(Barrier_Access::Acceleration_Structure_Read,
-        VK_ACCESS_2_ACCELERATION_STRUCTURE_READ_BIT_KHR);
-    result |= apply_access(Barrier_Access::Acceleration_Structure_Write,
-        VK_ACCESS_2_ACCELERATION_STRUCTURE_WRITE_BIT_KHR);
-    return result;
-}
-
-void Vulkan_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
-{
-    std::vector<VkMemoryBarrier2> memory_barriers;
-    memory_barriers.reserve(barrier_info.memory_barriers.size());
+void Vulkan_Command_List::record_barrier(const Barrier_Info& barrier_info) noexcept
+{
+    Scratch_Array<VkMemoryBarrier2, BARRIER_INLINE_CAPACITY> memory_barriers(
+        barrier_info.memory_barriers.size(), m_memory_barrier_spill);
     for (const auto& memory_barrier : barrier_info.memory_barriers)
     {
         memory_barriers.push_back({
@@ -205,8 +155,8 @@ void Vulkan_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
             });
     }
 
-    std::vector<VkBufferMemoryBarrier2> buffer_memory_barriers;
-    buffer_memory_barriers.reserve(barrier_info.buffer_barriers.size());
+    Scratch_Array<VkBufferMemoryBarrier2, BARRIER_INLINE_CAPACITY> buffer_memory_barriers(
+        barrier_info.buffer_barriers.size(), m_buffer_barrier_spill);
     for (const auto& buffer_memory_barrier : barrier_info.buffer_barriers)
     {
         buffer_memory_barriers.push_back({
@@ -224,8 +174,8 @@ void Vulkan_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
             });
     }
 
-    std::vector<VkImageMemoryBarrier2> image_memory_barriers;
-    image_memory_barriers.reserve(barrier_info.image_barriers.size());
+    Scratch_Array<VkImageMemoryBarrier2, BARRIER_INLINE_CAPACITY> image_memory_barriers(
+        barrier_info.image_barriers.size(), m_image_barrier_spill);
     for (const auto& image_memory_barrier : barrier_info.image_barriers)
     {
         auto queue_type_before = m_queue_type;
@@ -273,11 +223,11 @@ void Vulkan_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
         .sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO,
         .pNext = nullptr,
         .dependencyFlags = 0,
-        .memoryBarrierCount = static_cast<uint32_t>(memory_barriers.size()),
+        .memoryBarrierCount = memory_barriers.size(),
         .pMemoryBarriers = memory_barriers.data(),
-        .bufferMemoryBarrierCount = static_cast<uint32_t>(buffer_memory_barriers.size()),
+        .bufferMemoryBarrierCount = buffer_memory_barriers.size(),
         .pBufferMemoryBarriers = buffer_memory_barriers.data(),
-        .imageMemoryBarrierCount = static_cast<uint32_t>(image_memory_barriers.size()),
+        .imageMemoryBarrierCount = image_memory_barriers.size(),
         .pImageMemoryBarriers = image_memory_barriers.data()
     };
     vkCmdPipelineBarrier2(m_cmd, &dependency);
@@ -285,16 +235,19 @@ void Vulkan_Command_List::barrier(const Barrier_Info& barrier_info) noexcept
 
 void Vulkan_Command_List::dispatch(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept
 {
+    flush_barriers();
     vkCmdDispatch(m_cmd, groups_x, groups_y, groups_z);
 }
 
 void Vulkan_Command_List::dispatch_indirect(Buffer* buffer, uint64_t offset) noexcept
 {
+    flush_barriers();
     vkCmdDispatchIndirect(m_cmd, static_cast<Vulkan_Buffer*>(buffer)->buffer, offset);
 }
 
 void Vulkan_Command_List::copy_buffer(Buffer* src, uint64_t src_offset, Buffer* dst, uint64_t dst_offset, uint64_t size) noexcept
 {
+    flush_barriers();
     VkBufferCopy region = {
         .srcOffset = src_offset,
         .dstOffset = dst_offset,
@@ -310,11 +263,18 @@ void Vulkan_Command_List::copy_buffer(Buffer* src, uint64_t src_offset, Buffer*
 void Vulkan_Command_List::copy_buffer_to_image(
     Buffer* src, uint64_t src_offset,
     Image* dst, const Offset_3D& dst_offset, const Extent_3D& dst_extent,
-    uint32_t dst_mip_level, uint32_t dst_array_index) noexcept
+    uint32_t dst_mip_level, uint32_t dst_array_index, uint32_t src_row_pitch) noexcept
 {
+    flush_barriers();
+    // Vulkan takes the row length in texels, zero means tightly packed.
+    const auto info = get_image_format_info(dst->format);
+    uint32_t row_length = (src_row_pitch > 0 && info.bytes > 0)
+        ? src_row_pitch / info.bytes * info.block_size_x
+        : 0;
+
     VkBufferImageCopy region = {
         .bufferOffset = src_offset,
-        .bufferRowLength = 0,
+        .bufferRowLength = row_length,
         .bufferImageHeight = 0,
         .imageSubresource = {
             .aspectMask = get_aspect_mask(dst),
@@ -346,6 +306,7 @@ void Vulkan_Command_List::copy_image(
     Image* dst, const Offset_3D& dst_offset, uint32_t dst_mip_level, uint32_t dst_array_index,
     const Extent_3D& extent) noexcept
 {
+    flush_barriers();
     VkImageCopy region = {
         .srcSubresource = {
             .aspectMask = get_aspect_mask(src),
@@ -389,6 +350,7 @@ void Vulkan_Command_List::copy_image_to_buffer(
     uint32_t src_mip_level, uint32_t src_array_index,
     Buffer* dst, uint64_t dst_offset) noexcept
 {
+    flush_barriers();
     VkBufferImageCopy region = {
         .bufferOffset = dst_offset,
         .bufferRowLength = 0,
@@ -420,38 +382,40 @@ void Vulkan_Command_List::copy_image_to_buffer(
 
 void Vulkan_Command_List::fill_buffer(Buffer_View* dst, uint32_t value) noexcept
 {
+    flush_barriers();
     vkCmdFillBuffer(m_cmd, static_cast<Vulkan_Buffer*>(dst->buffer)->buffer, dst->offset, dst->size, value);
 }
 
 void Vulkan_Command_List::begin_debug_region(const char* name, float r, float g, float b) noexcept
 {
-    VkDebugMarkerMarkerInfoEXT marker = {
-        .sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT,
+    VkDebugUtilsLabelEXT label = {
+        .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
         .pNext = nullptr,
-        .pMarkerName = name,
+        .pLabelName = name,
         .color = { r, g, b, 1.f }
     };
-    vkCmdDebugMarkerBeginEXT(m_cmd, &marker);
+    vkCmdBeginDebugUtilsLabelEXT(m_cmd, &label);
 }
 
 void Vulkan_Command_List::add_debug_marker(const char* name, float r, float g, float b)  noexcept
 {
-    VkDebugMarkerMarkerInfoEXT marker = {
-        .sType = VK_STRUCTURE_TYPE_DEBUG_MARKER_MARKER_INFO_EXT,
+    VkDebugUtilsLabelEXT label = {
+        .sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT,
         .pNext = nullptr,
-        .pMarkerName = name,
+        .pLabelName = name,
         .color = { r, g, b, 1.f }
     };
-    vkCmdDebugMarkerInsertEXT(m_cmd, &marker);
+    vkCmdInsertDebugUtilsLabelEXT(m_cmd, &label);
 }
 
 void Vulkan_Command_List::end_debug_region() noexcept
 {
-    vkCmdDebugMarkerEndEXT(m_cmd);
+    vkCmdEndDebugUtilsLabelEXT(m_cmd);
 }
 
 void Vulkan_Command_List::clear_color_attachment(Image_View* image, float r, float g, float b, float a) noexcept
 {
+    flush_barriers();
     // TODO: change how indexing works?
     uint32_t color_attachment_index = 0;
     for (const auto [index, bound_view] : std::views::enumerate(m_bound_image_views))
@@ -492,6 +456,7 @@ void Vulkan_Command_List::clear_color_attachment(Image_View* image, float r, flo
 
 void Vulkan_Command_List::clear_depth_stencil_attachment(Image_View* image, float d, uint8_t s) noexcept
 {
+    flush_barriers();
     // TODO: rework clearing of images
     VkClearAttachment attachment = {
         .aspectMask = get_aspect_mask(image->image),
@@ -523,16 +488,19 @@ void Vulkan_Command_List::clear_depth_stencil_attachment(Image_View* image, floa
 
 void Vulkan_Command_List::draw(uint32_t vertex_count, uint32_t instance_count, uint32_t vertex_offset, uint32_t instance_offset) noexcept
 {
+    flush_barriers();
     vkCmdDraw(m_cmd, vertex_count, instance_count, vertex_offset, instance_offset);
 }
 
 void Vulkan_Command_List::draw_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
 {
+    flush_barriers();
     vkCmdDrawIndirect(m_cmd, static_cast<Vulkan_Buffer*>(buffer)->buffer, offset, count, INDIRECT_ARGUMENT_STRIDE);
 }
 
 void Vulkan_Command_List::draw_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept
 {
+    flush_barriers();
     vkCmdDrawIndirectCount(m_cmd,
         static_cast<Vulkan_Buffer*>(buffer)->buffer,
         offset,
@@ -544,16 +512,19 @@ void Vulkan_Command_List::draw_indirect_count(Buffer* buffer, uint64_t offset, u
 
 void Vulkan_Command_List::draw_indexed(uint32_t index_count, uint32_t instance_count, uint32_t index_offset, uint32_t vertex_offset, uint32_t instance_offset) noexcept
 {
+    flush_barriers();
     vkCmdDrawIndexed(m_cmd, index_count, instance_count, index_offset, vertex_offset, instance_offset);
 }
 
 void Vulkan_Command_List::draw_indexed_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
 {
+    flush_barriers();
     vkCmdDrawIndexedIndirect(m_cmd, static_cast<Vulkan_Buffer*>(buffer)->buffer, offset, count, INDIRECT_ARGUMENT_STRIDE);
 }
 
 void Vulkan_Command_List::draw_indexed_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept
 {
+    flush_barriers();
     vkCmdDrawIndexedIndirectCount(m_cmd,
         static_cast<Vulkan_Buffer*>(buffer)->buffer,
         offset,
@@ -565,16 +536,19 @@ void Vulkan_Command_List::draw_indexed_indirect_count(Buffer* buffer, uint64_t o
 
 void Vulkan_Command_List::draw_mesh_tasks(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept
 {
+    flush_barriers();
     vkCmdDrawMeshTasksEXT(m_cmd, groups_x, groups_y, groups_z);
 }
 
 void Vulkan_Command_List::draw_mesh_tasks_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept
 {
+    flush_barriers();
     vkCmdDrawMeshTasksIndirectEXT(m_cmd, static_cast<Vulkan_Buffer*>(buffer)->buffer, offset, count, INDIRECT_ARGUMENT_STRIDE);
 }
 
 void Vulkan_Command_List::draw_mesh_tasks_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept
 {
+    flush_barriers();
     vkCmdDrawMeshTasksIndirectCountEXT(m_cmd,
         static_cast<Vulkan_Buffer*>(buffer)->buffer,
         offset,
@@ -584,8 +558,16 @@ void Vulkan_Command_List::draw_mesh_tasks_indirect_count(Buffer* buffer, uint64_
         INDIRECT_ARGUMENT_STRIDE);
 }
 
+void Vulkan_Command_List::execute_secondary(Command_List* command_list) noexcept
+{
+    flush_barriers();
+    auto cmd = static_cast<Vulkan_Command_List*>(command_list)->get_internal_command_list();
+    vkCmdExecuteCommands(m_cmd, 1, &cmd);
+}
+
 void Vulkan_Command_List::begin_render_pass(const Render_Pass_Begin_Info& begin_info) noexcept
 {
+    flush_barriers();
     std::vector<VkRenderingAttachmentInfo> attachments;
     attachments.reserve(begin_info.color_attachments.size());
     auto attachment_index = 0;
@@ -664,7 +646,9 @@ void Vulkan_Command_List::begin_render_pass(const Render_Pass_Begin_Info& begin_
     VkRenderingInfo rendering_info = {
         .sType = VK_STRUCTURE_TYPE_RENDERING_INFO,
         .pNext = nullptr,
-        .flags = 0,
+        .flags = begin_info.secondary_command_lists
+            ? VkRenderingFlags(VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT)
+            : VkRenderingFlags(0),
         .renderArea = render_area,
         .layerCount = 1,
         .viewMask = 0,
@@ -678,6 +662,7 @@ void Vulkan_Command_List::begin_render_pass(const Render_Pass_Begin_Info& begin_
 
 void Vulkan_Command_List::end_render_pass() noexcept
 {
+    flush_barriers();
     vkCmdEndRendering(m_cmd);
     m_bound_image_views = {};
 }
@@ -758,6 +743,7 @@ void Vulkan_Command_List::set_stencil_reference(uint8_t reference) noexcept
 void Vulkan_Command_List::build_acceleration_structure(
     const Acceleration_Structure_Build_Geometry_Info& build_info, uint64_t scratch_memory_address) noexcept
 {
+    flush_barriers();
     std::vector<VkAccelerationStructureBuildRangeInfoKHR> build_ranges;
     std::vector<VkAccelerationStructureGeometryKHR> geometries;
 
@@ -892,6 +878,7 @@ void Vulkan_Command_List::build_acceleration_structure(
 
 void Vulkan_Command_List::dispatch_rays(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z, const Shader_Binding_Table& sbt) noexcept
 {
+    flush_barriers();
     VkStridedDeviceAddressRegionKHR sbt_ray_gen = {
         .deviceAddress = sbt.ray_gen.gpu_address,
         .stride = sbt.ray_gen.stride,
@@ -915,6 +902,11 @@ void Vulkan_Command_List::dispatch_rays(uint32_t groups_x, uint32_t groups_y, ui
     vkCmdTraceRaysKHR(m_cmd, &sbt_ray_gen, &sbt_miss, &sbt_hit, &sbt_callable, groups_x, groups_y, groups_z);
 }
 
+void Vulkan_Command_List::reset() noexcept
+{
+    reset_barrier_batching();
+}
+
 VkCommandBuffer Vulkan_Command_List::get_internal_command_list() const noexcept
 {
     return m_cmd;
@@ -925,89 +917,229 @@ Vulkan_Command_Pool::Vulkan_Command_Pool(
     const Command_Pool_Create_Info& create_info) noexcept
     : m_queue_type(create_info.queue_type)
     , m_device(device)
-    , m_unused()
-    , m_used()
+    , m_use_mutex(create_info.thread_safe)
+    , m_mutex()
+    , m_thread_pools()
+    , m_command_lists()
+    , m_secondary_allocators()
+    , m_secondary_command_lists()
 {}
 
 Vulkan_Command_Pool::~Vulkan_Command_Pool() noexcept
 {
-    reset();
-    for (auto cmd_alloc : m_unused)
+    for (const auto& thread_pool : m_thread_pools)
     {
-        vkDestroyCommandPool(*m_device, cmd_alloc.pool, nullptr);
+        vkDestroyCommandPool(*m_device, thread_pool.pool, nullptr);
     }
-    for (auto cmd_alloc : m_used)
+    for (auto cmd_alloc : m_secondary_allocators)
     {
         vkDestroyCommandPool(*m_device, cmd_alloc.pool, nullptr);
     }
     m_command_lists.clear();
+    m_secondary_command_lists.clear();
 }
 
 void Vulkan_Command_Pool::reset() noexcept
 {
-    m_unused.insert(m_unused.end(), m_used.begin(), m_used.end());
-    m_used.clear();
-    m_command_lists.clear();
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    // One reset per pool recycles every command buffer allocated from it.
+    for (auto& thread_pool : m_thread_pools)
+    {
+        if (thread_pool.used.empty()) continue;
+
+        vkResetCommandPool(*m_device, thread_pool.pool, 0);
+        for (auto command_list : thread_pool.used)
+        {
+            command_list->reset();
+        }
+        thread_pool.unused.insert(thread_pool.unused.end(), thread_pool.used.begin(), thread_pool.used.end());
+        thread_pool.used.clear();
+    }
 }
 
 Command_List* Vulkan_Command_Pool::acquire_command_list() noexcept
 {
-    auto cmd_alloc = Vulkan_Command_List_Allocator{};
-    if (m_unused.empty())
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
     {
-        auto queue_type = VK_QUEUE_GRAPHICS_BIT;
-        switch (m_queue_type)
-        {
-        case Queue_Type::Graphics: queue_type = VK_QUEUE_GRAPHICS_BIT; break;
-        case Queue_Type::Compute: queue_type = VK_QUEUE_COMPUTE_BIT; break;
-        case Queue_Type::Copy: queue_type = VK_QUEUE_TRANSFER_BIT; break;
-        case Queue_Type::Video_Decode: queue_type = VK_QUEUE_VIDEO_DECODE_BIT_KHR; break;
-        case Queue_Type::Video_Encode: queue_type = VK_QUEUE_VIDEO_ENCODE_BIT_KHR; break;
-        default: std::unreachable();
-        }
-
-        VkCommandPoolCreateInfo command_pool_create_info = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
-            .pNext = nullptr,
-            .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
-            .queueFamilyIndex = m_device->get_queue_family_index(queue_type)
-        };
-        vkCreateCommandPool(*m_device, &command_pool_create_info, nullptr, &cmd_alloc.pool);
+        lock_guard.lock();
+    }
+    // Without `thread_safe` only one thread acquires lists, so a single pool is enough.
+    auto thread_id = m_use_mutex ? std::this_thread::get_id() : std::thread::id();
+    auto thread_pool = std::ranges::find(m_thread_pools, thread_id, &Vulkan_Thread_Command_Pool::thread_id);
+    if (thread_pool == m_thread_pools.end())
+    {
+        m_thread_pools.push_back({
+            .thread_id = thread_id,
+            .pool = create_command_pool(),
+            .used = {},
+            .unused = {}
+        });
+        thread_pool = std::prev(m_thread_pools.end());
+    }
 
-        VkCommandBufferAllocateInfo command_buffer_allocate_info = {
-            .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
-            .pNext = nullptr,
-            .commandPool = cmd_alloc.pool,
-            .level = VK_COMMAND_BUFFER_LEVEL_PRIMARY,
-            .commandBufferCount = 1
-        };
-        vkAllocateCommandBuffers(*m_device, &command_buffer_allocate_info, &cmd_alloc.cmd);
+    Vulkan_Command_List* command_list = nullptr;
+    if (thread_pool->unused.empty())
+    {
+        auto cmd = allocate_command_buffer(thread_pool->pool, VK_COMMAND_BUFFER_LEVEL_PRIMARY);
+        command_list = &m_command_lists.emplace_back(cmd, m_device, m_queue_type);
     }
     else
     {
-        cmd_alloc = m_unused.back();
-        m_unused.pop_back();
+        command_list = thread_pool->unused.back();
+        thread_pool->unused.pop_back();
+    }
+    thread_pool->used.push_back(command_list);
+    if (m_use_mutex)
+    {
+        lock_guard.unlock();
     }
-    m_used.push_back(cmd_alloc);
-
-    vkResetCommandPool(*m_device, cmd_alloc.pool, 0);
 
+    auto cmd = command_list->get_internal_command_list();
     VkCommandBufferBeginInfo command_buffer_begin_info = {
         .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
         .pNext = nullptr,
         .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
         .pInheritanceInfo = nullptr
     };
+    vkBeginCommandBuffer(cmd, &command_buffer_begin_info);
+    bind_descriptor_sets(cmd);
+    return command_list;
+}
+
+Command_List* Vulkan_Command_Pool::create_secondary_command_list(
+    const Secondary_Command_List_Create_Info& create_info) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    auto cmd_alloc = Vulkan_Command_List_Allocator{};
+    cmd_alloc.pool = create_command_pool();
+    cmd_alloc.cmd = allocate_command_buffer(cmd_alloc.pool, VK_COMMAND_BUFFER_LEVEL_SECONDARY);
+    m_secondary_allocators.push_back(cmd_alloc);
+    auto command_list = m_secondary_command_lists.emplace_back(
+        std::make_unique<Vulkan_Command_List>(cmd_alloc.cmd, m_device, m_queue_type)).get();
+    if (m_use_mutex)
+    {
+        lock_guard.unlock();
+    }
+
+    std::vector<VkFormat> color_attachment_formats;
+    color_attachment_formats.reserve(create_info.color_attachment_formats.size());
+    for (auto format : create_info.color_attachment_formats)
+    {
+        color_attachment_formats.push_back(vulkan_cast<VkFormat>(format));
+    }
+    auto depth_stencil_format_info = get_image_format_info(create_info.depth_stencil_format);
+    auto depth_stencil_format = vulkan_cast<VkFormat>(create_info.depth_stencil_format);
+    VkCommandBufferInheritanceRenderingInfo inheritance_rendering_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .viewMask = 0,
+        .colorAttachmentCount = uint32_t(color_attachment_formats.size()),
+        .pColorAttachmentFormats = color_attachment_formats.data(),
+        .depthAttachmentFormat = depth_stencil_format_info.is_depth ? depth_stencil_format : VK_FORMAT_UNDEFINED,
+        .stencilAttachmentFormat = depth_stencil_format_info.is_stencil ? depth_stencil_format : VK_FORMAT_UNDEFINED,
+        .rasterizationSamples = static_cast<VkSampleCountFlagBits>(std::max(create_info.sample_count, 1u))
+    };
+    VkCommandBufferInheritanceInfo inheritance_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO,
+        .pNext = &inheritance_rendering_info,
+        .renderPass = VK_NULL_HANDLE,
+        .subpass = 0,
+        .framebuffer = VK_NULL_HANDLE,
+        .occlusionQueryEnable = VK_FALSE,
+        .queryFlags = 0,
+        .pipelineStatistics = 0
+    };
+    // Simultaneous use, frames in flight may execute the same list.
+    VkCommandBufferBeginInfo command_buffer_begin_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT | VK_COMMAND_BUFFER_USAGE_SIMULTANEOUS_USE_BIT,
+        .pInheritanceInfo = &inheritance_info
+    };
     vkBeginCommandBuffer(cmd_alloc.cmd, &command_buffer_begin_info);
+    bind_descriptor_sets(cmd_alloc.cmd);
+    return command_list;
+}
 
+void Vulkan_Command_Pool::end_secondary_command_list(Command_List* command_list) noexcept
+{
+    vkEndCommandBuffer(static_cast<Vulkan_Command_List*>(command_list)->get_internal_command_list());
+}
+
+void Vulkan_Command_Pool::destroy_secondary_command_list(Command_List* command_list) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+    auto secondary_command_list = std::ranges::find_if(m_secondary_command_lists,
+        [command_list](const auto& secondary_command_list) { return secondary_command_list.get() == command_list; });
+    if (secondary_command_list == m_secondary_command_lists.end()) return;
+
+    auto index = std::distance(m_secondary_command_lists.begin(), secondary_command_list);
+    vkDestroyCommandPool(*m_device, m_secondary_allocators[index].pool, nullptr);
+    m_secondary_allocators.erase(m_secondary_allocators.begin() + index);
+    m_secondary_command_lists.erase(secondary_command_list);
+}
+
+VkCommandPool Vulkan_Command_Pool::create_command_pool() noexcept
+{
+    auto queue_type = VK_QUEUE_GRAPHICS_BIT;
+    switch (m_queue_type)
+    {
+    case Queue_Type::Graphics: queue_type = VK_QUEUE_GRAPHICS_BIT; break;
+    case Queue_Type::Compute: queue_type = VK_QUEUE_COMPUTE_BIT; break;
+    case Queue_Type::Copy: queue_type = VK_QUEUE_TRANSFER_BIT; break;
+    case Queue_Type::Video_Decode: queue_type = VK_QUEUE_VIDEO_DECODE_BIT_KHR; break;
+    case Queue_Type::Video_Encode: queue_type = VK_QUEUE_VIDEO_ENCODE_BIT_KHR; break;
+    default: std::unreachable();
+    }
+
+    VkCommandPoolCreateInfo command_pool_create_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT,
+        .queueFamilyIndex = m_device->get_queue_family_index(queue_type)
+    };
+    VkCommandPool pool = VK_NULL_HANDLE;
+    vkCreateCommandPool(*m_device, &command_pool_create_info, nullptr, &pool);
+    return pool;
+}
+
+VkCommandBuffer Vulkan_Command_Pool::allocate_command_buffer(VkCommandPool pool, VkCommandBufferLevel level) noexcept
+{
+    VkCommandBufferAllocateInfo command_buffer_allocate_info = {
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO,
+        .pNext = nullptr,
+        .commandPool = pool,
+        .level = level,
+        .commandBufferCount = 1
+    };
+    VkCommandBuffer cmd = VK_NULL_HANDLE;
+    vkAllocateCommandBuffers(*m_device, &command_buffer_allocate_info, &cmd);
+    return cmd;
+}
+
+void Vulkan_Command_Pool::bind_descriptor_sets(VkCommandBuffer cmd) noexcept
+{
     if (m_queue_type == Queue_Type::Graphics || m_queue_type == Queue_Type::Compute)
     {
         VkPipelineLayout pipeline_layout = m_device->get_pipeline_layout();
         VkDescriptorSet descriptor_set = m_device->get_descriptor_set();
-        vkCmdBindDescriptorSets(cmd_alloc.cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
-        vkCmdBindDescriptorSets(cmd_alloc.cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
-        vkCmdBindDescriptorSets(cmd_alloc.cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
+        vkCmdBindDescriptorSets(cmd, VK_PIPELINE_BIND_POINT_RAY_TRACING_KHR, pipeline_layout, 0, 1, &descriptor_set, 0, nullptr);
     }
-    return m_command_lists.emplace_back(std::make_unique<Vulkan_Command_List>(cmd_alloc.cmd, m_device, m_queue_type)).get();
 }
 }
@@ -3,7 +3,11 @@
 #include "rhi/command_list.hpp"
 
 #include <array>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // #include <volk.h>
 #include <vulkan/vulkan.h>
@@ -18,16 +22,25 @@ struct Vulkan_Command_List_Allocator
     VkCommandPool pool;
 };
 
+class Vulkan_Command_List;
+
+// Command buffers of one `VkCommandPool` must not be recorded on different threads at once,
+// so every thread acquiring lists gets its own pool. It is reset once by `Vulkan_Command_Pool::reset`.
+struct Vulkan_Thread_Command_Pool
+{
+    std::thread::id thread_id;
+    VkCommandPool pool;
+    std::vector<Vulkan_Command_List*> used;
+    std::vector<Vulkan_Command_List*> unused;
+};
+
 class Vulkan_Command_List final : public Command_List
 {
 public:
     Vulkan_Command_List(VkCommandBuffer cmd, Vulkan_Graphics_Device* device, Queue_Type queue_type) noexcept;
 
     // Meta commands
-    virtual [[nodiscard]] Graphics_API get_graphics_api() const noexcept override;
-
-    // Barrier commands
-    virtual void barrier(const Barrier_Info& barrier_info) noexcept override;
+    [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept override;
 
     // Compute commands
     virtual void dispatch(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept override;
@@ -38,7 +51,7 @@ public:
     virtual void copy_buffer_to_image(
         Buffer* src, uint64_t src_offset,
         Image* dst, const Offset_3D& dst_offset, const Extent_3D& dst_extent,
-        uint32_t dst_mip_level, uint32_t dst_array_index) noexcept override;
+        uint32_t dst_mip_level, uint32_t dst_array_index, uint32_t src_row_pitch = 0) noexcept override;
     virtual void copy_image(
         Image* src, const Offset_3D& src_offset, uint32_t src_mip_level, uint32_t src_array_index,
         Image* dst, const Offset_3D& dst_offset, uint32_t dst_mip_level, uint32_t dst_array_index,
@@ -66,6 +79,7 @@ public:
     virtual void draw_mesh_tasks(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z) noexcept override;
     virtual void draw_mesh_tasks_indirect(Buffer* buffer, uint64_t offset, uint32_t count) noexcept override;
     virtual void draw_mesh_tasks_indirect_count(Buffer* buffer, uint64_t offset, uint32_t max_draw_count, Buffer* count_buffer, uint64_t count_offset) noexcept override;
+    virtual void execute_secondary(Command_List* command_list) noexcept override;
 
     // State commands
     virtual void begin_render_pass(const Render_Pass_Begin_Info& begin_info) noexcept override;
@@ -83,14 +97,24 @@ public:
         const Acceleration_Structure_Build_Geometry_Info& build_info, uint64_t scratch_memory_address) noexcept override;
     virtual void dispatch_rays(uint32_t groups_x, uint32_t groups_y, uint32_t groups_z, const Shader_Binding_Table& sbt) noexcept override;
 
+    // Called by the pool once the GPU is done with the list.
+    void reset() noexcept;
+
     [[nodiscard]] VkCommandBuffer get_internal_command_list() const noexcept;
 
+protected:
+    virtual void record_barrier(const Barrier_Info& barrier_info) noexcept override;
+
 private:
     VkCommandBuffer m_cmd;
     Vulkan_Graphics_Device* m_device;
 
     // TODO: should this be here?
     std::array<Image_View*, 8> m_bound_image_views;
+    // Reused by every `barrier` call that does not fit into the inline storage.
+    std::vector<VkMemoryBarrier2> m_memory_barrier_spill;
+    std::vector<VkBufferMemoryBarrier2> m_buffer_barrier_spill;
+    std::vector<VkImageMemoryBarrier2> m_image_barrier_spill;
 };
 
 class Vulkan_Command_Pool final : public Command_Pool
@@ -102,11 +126,25 @@ public:
     virtual void reset() noexcept override;
     virtual Command_List* acquire_command_list() noexcept override;
 
+    virtual Command_List* create_secondary_command_list(const Secondary_Command_List_Create_Info& create_info) noexcept override;
+    virtual void end_secondary_command_list(Command_List* command_list) noexcept override;
+    virtual void destroy_secondary_command_list(Command_List* command_list) noexcept override;
+
+private:
+    [[nodiscard]] VkCommandPool create_command_pool() noexcept;
+    [[nodiscard]] VkCommandBuffer allocate_command_buffer(VkCommandPool pool, VkCommandBufferLevel level) noexcept;
+    void bind_descriptor_sets(VkCommandBuffer cmd) noexcept;
+
 private:
     Queue_Type m_queue_type;
     Vulkan_Graphics_Device* m_device;
-    std::vector<Vulkan_Command_List_Allocator> m_used;
-    std::vector<Vulkan_Command_List_Allocator> m_unused;
-    std::vector<std::unique_ptr<Vulkan_Command_List>> m_command_lists;
+    bool m_use_mutex;
+    std::mutex m_mutex;
+    std::vector<Vulkan_Thread_Command_Pool> m_thread_pools;
+    // One wrapper per command buffer, reused across resets. The deque keeps their addresses stable.
+    std::deque<Vulkan_Command_List> m_command_lists;
+    // Every secondary list owns its allocator, stored at the same index.
+    std::vector<Vulkan_Command_List_Allocator> m_secondary_allocators;
+    std::vector<std::unique_ptr<Vulkan_Command_List>> m_secondary_command_lists;
 };
 }
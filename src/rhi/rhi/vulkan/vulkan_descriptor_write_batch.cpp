@@ -0,0 +1,132 @@
+#include "rhi/vulkan/vulkan_descriptor_write_batch.hpp"
+
+namespace rhi::vulkan
+{
+void Vulkan_Descriptor_Write_Batch::write_buffers(
+    VkDescriptorSet set,
+    uint32_t binding,
+    uint32_t first_array_element,
+    VkDescriptorType type,
+    std::span<const VkDescriptorBufferInfo> buffer_infos)
+{
+    auto first_info = static_cast<uint32_t>(m_buffer_infos.size());
+    m_buffer_infos.insert(m_buffer_infos.end(), buffer_infos.begin(), buffer_infos.end());
+    add_write(set, binding, first_array_element, static_cast<uint32_t>(buffer_infos.size()), type, Info_Type::Buffer, first_info);
+}
+
+void Vulkan_Descriptor_Write_Batch::write_images(
+    VkDescriptorSet set,
+    uint32_t binding,
+    uint32_t first_array_element,
+    VkDescriptorType type,
+    std::span<const VkDescriptorImageInfo> image_infos)
+{
+    auto first_info = static_cast<uint32_t>(m_image_infos.size());
+    m_image_infos.insert(m_image_infos.end(), image_infos.begin(), image_infos.end());
+    add_write(set, binding, first_array_element, static_cast<uint32_t>(image_infos.size()), type, Info_Type::Image, first_info);
+}
+
+void Vulkan_Descriptor_Write_Batch::write_acceleration_structure(
+    VkDescriptorSet set,
+    uint32_t binding,
+    uint32_t array_element,
+    VkAccelerationStructureKHR acceleration_structure)
+{
+    auto first_info = static_cast<uint32_t>(m_acceleration_structures.size());
+    m_acceleration_structures.push_back(acceleration_structure);
+    add_write(set, binding, array_element, 1, VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR, Info_Type::Acceleration_Structure, first_info);
+}
+
+void Vulkan_Descriptor_Write_Batch::flush(VkDevice device)
+{
+    if (m_pending_writes.empty()) return;
+
+    m_writes.clear();
+    m_acceleration_structure_writes.clear();
+    // Reserving up front keeps the pNext pointers into this vector stable.
+    m_acceleration_structure_writes.reserve(m_pending_writes.size());
+
+    for (const auto& pending_write : m_pending_writes)
+    {
+        VkWriteDescriptorSet write = {
+            .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+            .pNext = nullptr,
+            .dstSet = pending_write.set,
+            .dstBinding = pending_write.binding,
+            .dstArrayElement = pending_write.first_array_element,
+            .descriptorCount = pending_write.count,
+            .descriptorType = pending_write.type,
+            .pImageInfo = nullptr,
+            .pBufferInfo = nullptr,
+            .pTexelBufferView = nullptr
+        };
+        switch (pending_write.info_type)
+        {
+        case Info_Type::Buffer:
+            write.pBufferInfo = &m_buffer_infos[pending_write.first_info];
+            break;
+        case Info_Type::Image:
+            write.pImageInfo = &m_image_infos[pending_write.first_info];
+            break;
+        case Info_Type::Acceleration_Structure:
+            write.pNext = &m_acceleration_structure_writes.emplace_back(VkWriteDescriptorSetAccelerationStructureKHR {
+                .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
+                .pNext = nullptr,
+                .accelerationStructureCount = pending_write.count,
+                .pAccelerationStructures = &m_acceleration_structures[pending_write.first_info]
+                });
+            break;
+        default:
+            break;
+        }
+        m_writes.push_back(write);
+    }
+    vkUpdateDescriptorSets(device, static_cast<uint32_t>(m_writes.size()), m_writes.data(), 0, nullptr);
+
+    m_pending_writes.clear();
+    m_buffer_infos.clear();
+    m_image_infos.clear();
+    m_acceleration_structures.clear();
+}
+
+bool Vulkan_Descriptor_Write_Batch::empty() const noexcept
+{
+    return m_pending_writes.empty();
+}
+
+void Vulkan_Descriptor_Write_Batch::add_write(
+    VkDescriptorSet set,
+    uint32_t binding,
+    uint32_t first_array_element,
+    uint32_t count,
+    VkDescriptorType type,
+    Info_Type info_type,
+    uint32_t first_info)
+{
+    if (count == 0) return;
+
+    if (!m_pending_writes.empty())
+    {
+        auto& previous = m_pending_writes.back();
+        if (previous.set == set
+            && previous.binding == binding
+            && previous.type == type
+            && previous.info_type == info_type
+            && previous.first_array_element + previous.count == first_array_element
+            && previous.first_info + previous.count == first_info)
+        {
+            previous.count += count;
+            return;
+        }
+    }
+    m_pending_writes.push_back({
+        .set = set,
+        .binding = binding,
+        .first_array_element = first_array_element,
+        .count = count,
+        .type = type,
+        .info_type = info_type,
+        .first_info = first_info
+    });
+}
+}
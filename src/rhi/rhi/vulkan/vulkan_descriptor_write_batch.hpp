@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+#include <volk.h>
+
+namespace rhi::vulkan
+{
+// Accumulates descriptor writes so they can be issued with a single `vkUpdateDescriptorSets` call.
+// Writes to consecutive array elements of the same binding and type are merged into one `VkWriteDescriptorSet`.
+// Not synchronized, the owner is responsible for locking.
+class Vulkan_Descriptor_Write_Batch
+{
+public:
+    void write_buffers(
+        VkDescriptorSet set,
+        uint32_t binding,
+        uint32_t first_array_element,
+        VkDescriptorType type,
+        std::span<const VkDescriptorBufferInfo> buffer_infos);
+    void write_images(
+        VkDescriptorSet set,
+        uint32_t binding,
+        uint32_t first_array_element,
+        VkDescriptorType type,
+        std::span<const VkDescriptorImageInfo> image_infos);
+    void write_acceleration_structure(
+        VkDescriptorSet set,
+        uint32_t binding,
+        uint32_t array_element,
+        VkAccelerationStructureKHR acceleration_structure);
+
+    void flush(VkDevice device);
+    [[nodiscard]] bool empty() const noexcept;
+
+private:
+    enum class Info_Type
+    {
+        Buffer,
+        Image,
+        Acceleration_Structure
+    };
+
+    // Info pointers are resolved on flush, the info vectors may reallocate until then.
+    struct Pending_Write
+    {
+        VkDescriptorSet set;
+        uint32_t binding;
+        uint32_t first_array_element;
+        uint32_t count;
+        VkDescriptorType type;
+        Info_Type info_type;
+        uint32_t first_info;
+    };
+
+    void add_write(
+        VkDescriptorSet set,
+        uint32_t binding,
+        uint32_t first_array_element,
+        uint32_t count,
+        VkDescriptorType type,
+        Info_Type info_type,
+        uint32_t first_info);
+
+private:
+    std::vector<Pending_Write> m_pending_writes;
+    std::vector<VkDescriptorBufferInfo> m_buffer_infos;
+    std::vector<VkDescriptorImageInfo> m_image_infos;
+    std::vector<VkAccelerationStructureKHR> m_acceleration_structures;
+
+    std::vector<VkWriteDescriptorSet> m_writes;
+    std::vector<VkWriteDescriptorSetAccelerationStructureKHR> m_acceleration_structure_writes;
+};
+}
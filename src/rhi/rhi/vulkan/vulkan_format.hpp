@@ -1,6 +1,7 @@
 #pragma once
 
 #include "rhi/image_format.hpp"
+#include <utility>
 #include <vulkan/vulkan.h>
 
 namespace rhi::vulkan
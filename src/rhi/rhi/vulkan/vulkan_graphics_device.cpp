@@ -1,11 +1,27 @@
 #include "rhi/vulkan/vulkan_graphics_device.hpp"
 
+#include "rhi/shader_archive.hpp"
+#include "rhi/shader_container.hpp"
 #include "rhi/vulkan/vulkan_init.hpp"
+#include "rhi/common/pipeline_cache_file.hpp"
+#include "rhi/common/pipeline_hash.hpp"
+#include "rhi/common/pipeline_reflection.hpp"
 #include "rhi/vulkan/vulkan_cast.hpp"
 #include "rhi/vulkan/vulkan_command_list.hpp"
 #include "rhi/vulkan/vulkan_resource.hpp"
 #include "rhi/vulkan/vulkan_result.hpp"
+#ifndef RHI_VULKAN_HEADLESS
 #include "rhi/vulkan/vulkan_swapchain.hpp"
+#endif
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cstring>
+#include <shared_mutex>
+#include <span>
+#include <utility>
 
 namespace rhi::vulkan
 {
@@ -26,6 +42,11 @@ Vulkan_Graphics_Device::Vulkan_Graphics_Device(const Graphics_Device_Create_Info
                     buffer->buffer = VK_NULL_HANDLE;
                     buffer->allocation = VK_NULL_HANDLE;
                 }
+                else if (buffer && buffer->buffer != VK_NULL_HANDLE)
+                {
+                    vkDestroyBuffer(m_device, buffer->buffer, nullptr);
+                    buffer->buffer = VK_NULL_HANDLE;
+                }
             },
             .buffer_view_delete_function = [this](Vulkan_Buffer_View* buffer_view) {
                 if (buffer_view && buffer_view->buffer_view != VK_NULL_HANDLE)
@@ -41,6 +62,12 @@ Vulkan_Graphics_Device::Vulkan_Graphics_Device(const Graphics_Device_Create_Info
                     image->image = VK_NULL_HANDLE;
                     image->allocation = VK_NULL_HANDLE;
                 }
+                else if (image && image->image != VK_NULL_HANDLE && image->is_placed)
+                {
+                    vkDestroyImage(m_device, image->image, nullptr);
+                    image->image = VK_NULL_HANDLE;
+                    image->is_placed = false;
+                }
             },
             .image_view_delete_function = [this](Vulkan_Image_View* image_view) {
                 if (image_view && image_view->image_view != VK_NULL_HANDLE)
@@ -64,6 +91,12 @@ Vulkan_Graphics_Device::Vulkan_Graphics_Device(const Graphics_Device_Create_Info
                 }
             }
         }))
+    , m_deferred_destruction_queue()
+    , m_descriptor_write_batch()
+    , m_resource_batch_depth(0)
+    , m_pipeline_registry()
+    , m_pipeline_compiler([this](Pipeline* pipeline) { return compile_pipeline(static_cast<Vulkan_Pipeline*>(pipeline)); })
+    , m_pipeline_cache_mutex()
 {
     volkInitialize();
 
@@ -113,6 +146,7 @@ Vulkan_Graphics_Device::Vulkan_Graphics_Device(const Graphics_Device_Create_Info
     m_descriptor_pool = create_descriptor_pool(m_device);
     m_descriptor_set = create_descriptor_set(m_device, m_descriptor_set_layout, m_descriptor_pool);
     m_pipeline_layout = create_pipeline_layout(m_device, m_descriptor_set_layout, PUSH_CONSTANT_MAX_SIZE);
+    m_pipeline_cache = create_pipeline_cache(m_device, nullptr, 0);
 
     { // Query and set ray tracing pipeline properties
         auto ray_tracing_pipeline_properties = query_ray_tracing_pipeline_properties(m_physical_device);
@@ -123,17 +157,29 @@ Vulkan_Graphics_Device::Vulkan_Graphics_Device(const Graphics_Device_Create_Info
             .max_recursion_depth = ray_tracing_pipeline_properties.maxRayRecursionDepth
         };
     }
+
+    { // Query buffer image granularity, placed resources are padded to it
+        VkPhysicalDeviceProperties physical_device_properties = {};
+        vkGetPhysicalDeviceProperties(m_physical_device, &physical_device_properties);
+        m_buffer_image_granularity = physical_device_properties.limits.bufferImageGranularity;
+    }
 }
 
 Vulkan_Graphics_Device::~Vulkan_Graphics_Device() noexcept
 {
+    m_pipeline_compiler.shutdown();
     wait_idle();
     m_resource_pool.reset();
+    for (auto& memory_heap : m_memory_heaps)
+    {
+        vmaFreeMemory(m_allocator, memory_heap.allocation);
+    }
     for (auto& pipeline : m_pipelines)
     {
         vkDestroyPipeline(m_device, pipeline.pipeline, nullptr);
     }
     vkDestroyDescriptorPool(m_device, m_descriptor_pool, nullptr);
+    vkDestroyPipelineCache(m_device, m_pipeline_cache, nullptr);
     vkDestroyPipelineLayout(m_device, m_pipeline_layout, nullptr);
     vkDestroyDescriptorSetLayout(m_device, m_descriptor_set_layout, nullptr);
     vmaDestroyAllocator(m_allocator);
@@ -170,9 +216,14 @@ Graphics_API Vulkan_Graphics_Device::get_graphics_api() const noexcept
     return Graphics_API::Vulkan;
 }
 
-std::unique_ptr<Swapchain> Vulkan_Graphics_Device::create_swapchain(const Swapchain_Win32_Create_Info& create_info) noexcept
+std::unique_ptr<Swapchain> Vulkan_Graphics_Device::create_swapchain([[maybe_unused]] const Swapchain_Win32_Create_Info& create_info) noexcept
 {
+#ifndef RHI_VULKAN_HEADLESS
     return std::make_unique<Vulkan_Swapchain>(this, create_info);
+#else
+    // Headless builds have no surface extensions enabled.
+    return nullptr;
+#endif
 }
 
 std::unique_ptr<Command_Pool> Vulkan_Graphics_Device::create_command_pool(const Command_Pool_Create_Info& create_info) noexcept
@@ -231,8 +282,37 @@ void Vulkan_Graphics_Device::destroy_fence(Fence* fence) noexcept
     m_fences.erase(m_fences.get_iterator(vulkan_fence));
 }
 
+VkBufferCreateInfo make_buffer_create_info(
+    const Buffer_Create_Info& create_info, std::span<const uint32_t> queue_families) noexcept
+{
+    return {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .size = create_info.size,
+        .usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
+            | (create_info.acceleration_structure_memory ? VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR : static_cast<VkBufferUsageFlags>(0))
+            | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
+            | VK_BUFFER_USAGE_TRANSFER_DST_BIT
+            | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
+            | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+            | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+            | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR
+            | VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR,
+        .sharingMode = VK_SHARING_MODE_CONCURRENT,
+        .queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size()),
+        .pQueueFamilyIndices = queue_families.data()
+    };
+}
+
 std::expected<Buffer*, Result> Vulkan_Graphics_Device::create_buffer(
     const Buffer_Create_Info& create_info, uint32_t index) noexcept
+{
+    return create_buffer_in_memory(create_info, index, nullptr, 0);
+}
+
+std::expected<Buffer*, Result> Vulkan_Graphics_Device::create_buffer_in_memory(
+    const Buffer_Create_Info& create_info, uint32_t index, Vulkan_Memory_Heap* memory_heap, uint64_t offset) noexcept
 {
     std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
     if (m_use_mutex)
@@ -245,71 +325,83 @@ std::expected<Buffer*, Result> Vulkan_Graphics_Device::create_buffer(
         m_compute_queue,
         m_copy_queue
         });
+    auto buffer_create_info = make_buffer_create_info(create_info, queue_families);
 
     VkBuffer vulkan_buffer = VK_NULL_HANDLE;
     VmaAllocation allocation = VK_NULL_HANDLE;
-    VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO;
-    if (create_info.heap == Memory_Heap_Type::CPU_Upload ||
-        create_info.heap == Memory_Heap_Type::CPU_Readback)
+    void* mapped_data = nullptr;
+    if (memory_heap)
     {
-        memory_usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+        auto buffer_result = vmaCreateAliasingBuffer2(
+            m_allocator, memory_heap->allocation, offset, &buffer_create_info, &vulkan_buffer);
+        if (buffer_result != VK_SUCCESS)
+        {
+            return std::unexpected(translate_result(buffer_result));
+        }
+        mapped_data = memory_heap->data
+            ? static_cast<uint8_t*>(memory_heap->data) + offset
+            : nullptr;
     }
     else
     {
-        memory_usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
-    }
-    VmaAllocationCreateInfo allocation_create_info = {
-        .flags = create_info.heap != Memory_Heap_Type::GPU
-            ? VMA_ALLOCATION_CREATE_MAPPED_BIT
-            : static_cast<VmaAllocationCreateFlags>(0),
-        .usage = memory_usage,
-        .requiredFlags = 0,
-        .preferredFlags = 0,
-        .memoryTypeBits = 0,
-        .pool = VK_NULL_HANDLE,
-        .pUserData = nullptr,
-        .priority = 0.f
-    };
+        VmaMemoryUsage memory_usage = VMA_MEMORY_USAGE_AUTO;
+        if (create_info.heap == Memory_Heap_Type::CPU_Upload ||
+            create_info.heap == Memory_Heap_Type::CPU_Readback)
+        {
+            memory_usage = VMA_MEMORY_USAGE_AUTO_PREFER_HOST;
+        }
+        else
+        {
+            memory_usage = VMA_MEMORY_USAGE_AUTO_PREFER_DEVICE;
+        }
+        VmaAllocationCreateInfo allocation_create_info = {
+            .flags = create_info.heap != Memory_Heap_Type::GPU
+                ? VMA_ALLOCATION_CREATE_MAPPED_BIT
+                : static_cast<VmaAllocationCreateFlags>(0),
+            .usage = memory_usage,
+            .requiredFlags = 0,
+            .preferredFlags = 0,
+            .memoryTypeBits = 0,
+            .pool = VK_NULL_HANDLE,
+            .pUserData = nullptr,
+            .priority = 0.f
+        };
 
-    if (create_info.heap == Memory_Heap_Type::CPU_Readback)
-    {
-        allocation_create_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
-    }
-    else
-    {
-        allocation_create_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
-    }
+        if (create_info.heap == Memory_Heap_Type::CPU_Readback)
+        {
+            allocation_create_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_RANDOM_BIT;
+        }
+        else
+        {
+            allocation_create_info.flags |= VMA_ALLOCATION_CREATE_HOST_ACCESS_SEQUENTIAL_WRITE_BIT;
+        }
 
-    VkBufferCreateInfo buffer_create_info = {
-        .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
-        .pNext = nullptr,
-        .flags = 0,
-        .size = create_info.size,
-        .usage = VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT
-            | (create_info.acceleration_structure_memory ? VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_STORAGE_BIT_KHR : static_cast<VkBufferUsageFlags>(0))
-            | VK_BUFFER_USAGE_TRANSFER_SRC_BIT
-            | VK_BUFFER_USAGE_TRANSFER_DST_BIT
-            | VK_BUFFER_USAGE_INDEX_BUFFER_BIT
-            | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
-            | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
-            | VK_BUFFER_USAGE_ACCELERATION_STRUCTURE_BUILD_INPUT_READ_ONLY_BIT_KHR
-            | VK_BUFFER_USAGE_SHADER_BINDING_TABLE_BIT_KHR,
-        .sharingMode = VK_SHARING_MODE_CONCURRENT,
-        .queueFamilyIndexCount = static_cast<uint32_t>(queue_families.size()),
-        .pQueueFamilyIndices = queue_families.data()
-    };
-    VmaAllocationInfo allocation_info = {};
-    auto buffer_result = vmaCreateBuffer(m_allocator, &buffer_create_info, &allocation_create_info, &vulkan_buffer, &allocation, &allocation_info);
+        VmaAllocationInfo allocation_info = {};
+        auto buffer_result = vmaCreateBuffer(m_allocator, &buffer_create_info, &allocation_create_info, &vulkan_buffer, &allocation, &allocation_info);
 
-    if (buffer_result != VK_SUCCESS)
-    {
-        return std::unexpected(translate_result(buffer_result));
+        if (buffer_result != VK_SUCCESS)
+        {
+            return std::unexpected(translate_result(buffer_result));
+        }
+        mapped_data = allocation_info.pMappedData;
     }
 
     auto* buffer = m_resource_pool->acquire_buffer(create_info, index);
+    if (!buffer)
+    {
+        if (allocation != VK_NULL_HANDLE)
+        {
+            vmaDestroyBuffer(m_allocator, vulkan_buffer, allocation);
+        }
+        else
+        {
+            vkDestroyBuffer(m_device, vulkan_buffer, nullptr);
+        }
+        return std::unexpected(Result::Error_Out_Of_Descriptors);
+    }
     buffer->buffer = vulkan_buffer;
     buffer->allocation = allocation;
-    buffer->data = allocation_info.pMappedData;
+    buffer->data = mapped_data;
 
     VkBufferDeviceAddressInfo buffer_device_address_info = {
         .sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO,
@@ -357,6 +449,11 @@ std::expected<Buffer_View*, Result> Vulkan_Graphics_Device::create_buffer_view(
     }
 
     auto* buffer_view = m_resource_pool->acquire_buffer_view(buffer, create_info, index);
+    if (!buffer_view)
+    {
+        vkDestroyBufferView(m_device, vulkan_buffer_view, nullptr);
+        return std::unexpected(Result::Error_Out_Of_Descriptors);
+    }
     buffer_view->buffer_view = vulkan_buffer_view;
 
     create_buffer_view_descriptors(buffer_view);
@@ -364,6 +461,50 @@ std::expected<Buffer_View*, Result> Vulkan_Graphics_Device::create_buffer_view(
     return buffer_view;
 }
 
+Result Vulkan_Graphics_Device::update_buffer_view(
+    Buffer_View* buffer_view, const Buffer_View_Create_Info& create_info) noexcept
+{
+    if (!buffer_view) return Result::Error_Invalid_Parameters;
+
+    if (create_info.size + create_info.offset > buffer_view->buffer->size)
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    VkBufferViewCreateInfo buffer_view_create_info = {
+        .sType = VK_STRUCTURE_TYPE_BUFFER_VIEW_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .buffer = static_cast<Vulkan_Buffer*>(buffer_view->buffer)->buffer,
+        .format = VK_FORMAT_R8_UINT,
+        .offset = create_info.offset,
+        .range = create_info.size
+    };
+    VkBufferView vulkan_buffer_view = VK_NULL_HANDLE;
+    auto buffer_view_result = vkCreateBufferView(m_device, &buffer_view_create_info, nullptr, &vulkan_buffer_view);
+
+    if (buffer_view_result != VK_SUCCESS)
+    {
+        return translate_result(buffer_view_result);
+    }
+
+    auto vulkan_view = static_cast<Vulkan_Buffer_View*>(buffer_view);
+    vkDestroyBufferView(m_device, vulkan_view->buffer_view, nullptr);
+    vulkan_view->buffer_view = vulkan_buffer_view;
+    vulkan_view->size = create_info.size;
+    vulkan_view->offset = create_info.offset;
+
+    create_buffer_view_descriptors(vulkan_view);
+
+    return Result::Success;
+}
+
 void Vulkan_Graphics_Device::destroy_buffer(Buffer* buffer) noexcept
 {
     if (!buffer) return;
@@ -374,6 +515,8 @@ void Vulkan_Graphics_Device::destroy_buffer(Buffer* buffer) noexcept
         lock_guard.lock();
     }
 
+    // Pending descriptor writes may still reference the resource.
+    m_descriptor_write_batch.flush(m_device);
     m_resource_pool->release_buffer(buffer);
 }
 
@@ -401,14 +544,8 @@ Result Vulkan_Fence::wait_for_value(uint64_t value) noexcept
     return(translate_result(vkWaitSemaphores(device, &wait_info, ~0ull)));
 }
 
-std::expected<Image*, Result> Vulkan_Graphics_Device::create_image(const Image_Create_Info& create_info, uint32_t index) noexcept
+VkImageCreateInfo make_image_create_info(const Image_Create_Info& create_info) noexcept
 {
-    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
-    if (m_use_mutex)
-    {
-        lock_guard.lock();
-    }
-
     VkImageCreateFlags image_create_flags = 0;
     if (create_info.primary_view_type == Image_View_Type::Texture_3D)
         image_create_flags |= VK_IMAGE_CREATE_2D_ARRAY_COMPATIBLE_BIT;
@@ -416,7 +553,7 @@ std::expected<Image*, Result> Vulkan_Graphics_Device::create_image(const Image_C
         || create_info.primary_view_type == Image_View_Type::Texture_Cube_Array)
         image_create_flags |= VK_IMAGE_CREATE_CUBE_COMPATIBLE_BIT;
 
-    VkImageCreateInfo image_create_info = {
+    return {
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
         .pNext = nullptr,
         .flags = image_create_flags,
@@ -439,21 +576,47 @@ std::expected<Image*, Result> Vulkan_Graphics_Device::create_image(const Image_C
         .pQueueFamilyIndices = nullptr,
         .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED
     };
+}
+
+std::expected<Image*, Result> Vulkan_Graphics_Device::create_image(const Image_Create_Info& create_info, uint32_t index) noexcept
+{
+    return create_image_in_memory(create_info, index, nullptr, 0);
+}
+
+std::expected<Image*, Result> Vulkan_Graphics_Device::create_image_in_memory(
+    const Image_Create_Info& create_info, uint32_t index, Vulkan_Memory_Heap* memory_heap, uint64_t offset) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto image_create_info = make_image_create_info(create_info);
 
     VkImage vulkan_image = VK_NULL_HANDLE;
     VmaAllocation allocation = VK_NULL_HANDLE;
-    VmaAllocationCreateInfo allocation_create_info = {
-        .flags = 0,
-        .usage = VMA_MEMORY_USAGE_AUTO,
-        .requiredFlags = 0,
-        .preferredFlags = 0,
-        .memoryTypeBits = 0,
-        .pool = VK_NULL_HANDLE,
-        .pUserData = nullptr,
-        .priority = 0.f
-    };
-    VmaAllocationInfo allocation_info = {};
-    auto image_result = vmaCreateImage(m_allocator, &image_create_info, &allocation_create_info, &vulkan_image, &allocation, &allocation_info);
+    VkResult image_result = VK_SUCCESS;
+    if (memory_heap)
+    {
+        image_result = vmaCreateAliasingImage2(
+            m_allocator, memory_heap->allocation, offset, &image_create_info, &vulkan_image);
+    }
+    else
+    {
+        VmaAllocationCreateInfo allocation_create_info = {
+            .flags = 0,
+            .usage = VMA_MEMORY_USAGE_AUTO,
+            .requiredFlags = 0,
+            .preferredFlags = 0,
+            .memoryTypeBits = 0,
+            .pool = VK_NULL_HANDLE,
+            .pUserData = nullptr,
+            .priority = 0.f
+        };
+        VmaAllocationInfo allocation_info = {};
+        image_result = vmaCreateImage(m_allocator, &image_create_info, &allocation_create_info, &vulkan_image, &allocation, &allocation_info);
+    }
 
     if (image_result != VK_SUCCESS)
     {
@@ -461,8 +624,21 @@ std::expected<Image*, Result> Vulkan_Graphics_Device::create_image(const Image_C
     }
 
     auto* image = m_resource_pool->acquire_image(create_info, index);
+    if (!image)
+    {
+        if (allocation != VK_NULL_HANDLE)
+        {
+            vmaDestroyImage(m_allocator, vulkan_image, allocation);
+        }
+        else
+        {
+            vkDestroyImage(m_device, vulkan_image, nullptr);
+        }
+        return std::unexpected(Result::Error_Out_Of_Descriptors);
+    }
     image->image = vulkan_image;
     image->allocation = allocation;
+    image->is_placed = memory_heap != nullptr;
 
     VkImageViewCreateInfo image_view_create_info = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -487,6 +663,256 @@ std::expected<Image*, Result> Vulkan_Graphics_Device::create_image(const Image_C
     return image;
 }
 
+std::expected<Memory_Heap*, Result> Vulkan_Graphics_Device::create_memory_heap(
+    const Memory_Heap_Create_Info& create_info) noexcept
+{
+    if (create_info.size == 0)
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    auto memory_type_bits = get_memory_heap_type_bits(create_info.heap);
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    VkMemoryPropertyFlags required_flags = 0;
+    switch (create_info.heap)
+    {
+    case Memory_Heap_Type::GPU:
+        required_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT;
+        break;
+    case Memory_Heap_Type::CPU_Upload:
+        required_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+        break;
+    case Memory_Heap_Type::CPU_Readback:
+        required_flags = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT;
+        break;
+    case Memory_Heap_Type::CPU_Visible_GPU:
+        required_flags = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT | VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT;
+        break;
+    default:
+        break;
+    }
+
+    VkMemoryRequirements memory_requirements = {
+        .size = create_info.size,
+        .alignment = 64 * 1024,
+        .memoryTypeBits = memory_type_bits
+    };
+    VmaAllocationCreateInfo allocation_create_info = {
+        .flags = VMA_ALLOCATION_CREATE_DEDICATED_MEMORY_BIT
+            | (create_info.heap != Memory_Heap_Type::GPU
+                ? VMA_ALLOCATION_CREATE_MAPPED_BIT
+                : static_cast<VmaAllocationCreateFlags>(0)),
+        .usage = VMA_MEMORY_USAGE_UNKNOWN,
+        .requiredFlags = required_flags,
+        .preferredFlags = 0,
+        .memoryTypeBits = 0,
+        .pool = VK_NULL_HANDLE,
+        .pUserData = nullptr,
+        .priority = 0.f
+    };
+    VmaAllocation allocation = VK_NULL_HANDLE;
+    VmaAllocationInfo allocation_info = {};
+    auto memory_result = vmaAllocateMemory(
+        m_allocator, &memory_requirements, &allocation_create_info, &allocation, &allocation_info);
+    if (memory_result != VK_SUCCESS)
+    {
+        return std::unexpected(translate_result(memory_result));
+    }
+
+    auto* memory_heap = &*m_memory_heaps.emplace();
+    memory_heap->size = create_info.size;
+    memory_heap->heap_type = create_info.heap;
+    memory_heap->allocation = allocation;
+    memory_heap->data = allocation_info.pMappedData;
+    memory_heap->memory_type_index = allocation_info.memoryType;
+
+    return memory_heap;
+}
+
+void Vulkan_Graphics_Device::destroy_memory_heap(Memory_Heap* memory_heap) noexcept
+{
+    if (!memory_heap) return;
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    auto* vulkan_memory_heap = static_cast<Vulkan_Memory_Heap*>(memory_heap);
+    vmaFreeMemory(m_allocator, vulkan_memory_heap->allocation);
+    m_memory_heaps.erase(m_memory_heaps.get_iterator(vulkan_memory_heap));
+}
+
+VkMemoryRequirements Vulkan_Graphics_Device::get_vulkan_memory_requirements(
+    const Buffer_Create_Info& create_info) noexcept
+{
+    const auto queue_families = std::to_array<uint32_t>({
+        m_graphics_queue,
+        m_compute_queue,
+        m_copy_queue
+        });
+    auto buffer_create_info = make_buffer_create_info(create_info, queue_families);
+    VkDeviceBufferMemoryRequirements buffer_memory_requirements = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS,
+        .pNext = nullptr,
+        .pCreateInfo = &buffer_create_info
+    };
+    VkMemoryRequirements2 memory_requirements = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = nullptr,
+        .memoryRequirements = {}
+    };
+    vkGetDeviceBufferMemoryRequirements(m_device, &buffer_memory_requirements, &memory_requirements);
+    return memory_requirements.memoryRequirements;
+}
+
+VkMemoryRequirements Vulkan_Graphics_Device::get_vulkan_memory_requirements(
+    const Image_Create_Info& create_info) noexcept
+{
+    auto image_create_info = make_image_create_info(create_info);
+    VkDeviceImageMemoryRequirements image_memory_requirements = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+        .pNext = nullptr,
+        .pCreateInfo = &image_create_info,
+        .planeAspect = VK_IMAGE_ASPECT_NONE
+    };
+    VkMemoryRequirements2 memory_requirements = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = nullptr,
+        .memoryRequirements = {}
+    };
+    vkGetDeviceImageMemoryRequirements(m_device, &image_memory_requirements, &memory_requirements);
+    return memory_requirements.memoryRequirements;
+}
+
+Memory_Requirements Vulkan_Graphics_Device::get_memory_requirements(const Buffer_Create_Info& create_info) noexcept
+{
+    return pad_memory_requirements(get_vulkan_memory_requirements(create_info));
+}
+
+Memory_Requirements Vulkan_Graphics_Device::get_memory_requirements(const Image_Create_Info& create_info) noexcept
+{
+    return pad_memory_requirements(get_vulkan_memory_requirements(create_info));
+}
+
+std::expected<Buffer*, Result> Vulkan_Graphics_Device::create_placed_buffer(
+    const Buffer_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset, uint32_t index) noexcept
+{
+    if (!memory_heap || create_info.heap != memory_heap->heap_type
+        || !is_placement_valid(get_vulkan_memory_requirements(create_info), memory_heap, offset))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    return create_buffer_in_memory(create_info, index, static_cast<Vulkan_Memory_Heap*>(memory_heap), offset);
+}
+
+std::expected<Image*, Result> Vulkan_Graphics_Device::create_placed_image(
+    const Image_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset, uint32_t index) noexcept
+{
+    if (!memory_heap || memory_heap->heap_type != Memory_Heap_Type::GPU
+        || !is_placement_valid(get_vulkan_memory_requirements(create_info), memory_heap, offset))
+    {
+        return std::unexpected(Result::Error_Invalid_Parameters);
+    }
+
+    return create_image_in_memory(create_info, index, static_cast<Vulkan_Memory_Heap*>(memory_heap), offset);
+}
+
+uint32_t Vulkan_Graphics_Device::get_memory_heap_type_bits(Memory_Heap_Type heap_type) noexcept
+{
+    auto get_memory_type_bits = [this](const VkImageCreateInfo& image_create_info)
+    {
+        VkDeviceImageMemoryRequirements image_memory_requirements = {
+            .sType = VK_STRUCTURE_TYPE_DEVICE_IMAGE_MEMORY_REQUIREMENTS,
+            .pNext = nullptr,
+            .pCreateInfo = &image_create_info,
+            .planeAspect = VK_IMAGE_ASPECT_NONE
+        };
+        VkMemoryRequirements2 memory_requirements = {
+            .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+            .pNext = nullptr,
+            .memoryRequirements = {}
+        };
+        vkGetDeviceImageMemoryRequirements(m_device, &image_memory_requirements, &memory_requirements);
+        return memory_requirements.memoryRequirements.memoryTypeBits;
+    };
+
+    const auto queue_families = std::to_array<uint32_t>({
+        m_graphics_queue,
+        m_compute_queue,
+        m_copy_queue
+        });
+    auto buffer_create_info = make_buffer_create_info({
+        .size = 1,
+        .heap = heap_type,
+        .acceleration_structure_memory = true
+        }, queue_families);
+    VkDeviceBufferMemoryRequirements buffer_memory_requirements = {
+        .sType = VK_STRUCTURE_TYPE_DEVICE_BUFFER_MEMORY_REQUIREMENTS,
+        .pNext = nullptr,
+        .pCreateInfo = &buffer_create_info
+    };
+    VkMemoryRequirements2 memory_requirements = {
+        .sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2,
+        .pNext = nullptr,
+        .memoryRequirements = {}
+    };
+    vkGetDeviceBufferMemoryRequirements(m_device, &buffer_memory_requirements, &memory_requirements);
+    auto memory_type_bits = memory_requirements.memoryRequirements.memoryTypeBits;
+    if (heap_type != Memory_Heap_Type::GPU) return memory_type_bits;
+
+    // Color and depth targets are the most restrictive images in practice.
+    memory_type_bits &= get_memory_type_bits(make_image_create_info({
+        .format = Image_Format::R8G8B8A8_UNORM,
+        .width = 1,
+        .height = 1,
+        .depth = 1,
+        .array_size = 1,
+        .mip_levels = 1,
+        .usage = Image_Usage::Sampled | Image_Usage::Unordered_Access | Image_Usage::Color_Attachment,
+        .primary_view_type = Image_View_Type::Texture_2D
+        }));
+    memory_type_bits &= get_memory_type_bits(make_image_create_info({
+        .format = Image_Format::D32_SFLOAT,
+        .width = 1,
+        .height = 1,
+        .depth = 1,
+        .array_size = 1,
+        .mip_levels = 1,
+        .usage = Image_Usage::Sampled | Image_Usage::Depth_Stencil_Attachment,
+        .primary_view_type = Image_View_Type::Texture_2D
+        }));
+    return memory_type_bits;
+}
+
+Memory_Requirements Vulkan_Graphics_Device::pad_memory_requirements(
+    const VkMemoryRequirements& memory_requirements) const noexcept
+{
+    // Buffers are linear and images use optimal tiling, so no placed neighbour of another kind shares a page.
+    return {
+        .size = (memory_requirements.size + m_buffer_image_granularity - 1) & ~(m_buffer_image_granularity - 1),
+        .alignment = std::max(memory_requirements.alignment, m_buffer_image_granularity)
+    };
+}
+
+bool Vulkan_Graphics_Device::is_placement_valid(
+    const VkMemoryRequirements& memory_requirements, Memory_Heap* memory_heap, uint64_t offset) const noexcept
+{
+    auto padded_memory_requirements = pad_memory_requirements(memory_requirements);
+    auto memory_type_index = static_cast<Vulkan_Memory_Heap*>(memory_heap)->memory_type_index;
+    return (memory_requirements.memoryTypeBits & (1u << memory_type_index)) != 0
+        && offset % padded_memory_requirements.alignment == 0
+        && offset + padded_memory_requirements.size <= memory_heap->size;
+}
+
 std::expected<Image_View*, Result> Vulkan_Graphics_Device::create_image_view(
     Image* image, const Image_View_Create_Info& create_info, uint32_t index) noexcept
 {
@@ -500,6 +926,7 @@ std::expected<Image_View*, Result> Vulkan_Graphics_Device::create_image_view(
 
     auto vulkan_image = static_cast<Vulkan_Image*>(image);
     auto image_view = m_resource_pool->acquire_image_view(image, create_info, index);
+    if (!image_view) return std::unexpected(Result::Error_Out_Of_Descriptors);
 
     VkImageViewCreateInfo image_view_create_info = {
         .sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO,
@@ -534,6 +961,7 @@ void Vulkan_Graphics_Device::destroy_image(Image* image) noexcept
         lock_guard.lock();
     }
 
+    m_descriptor_write_batch.flush(m_device);
     m_resource_pool->release_image(image);
 }
 
@@ -575,6 +1003,7 @@ std::expected<Sampler*, Result> Vulkan_Graphics_Device::create_sampler(const Sam
     }
 
     auto* sampler = m_resource_pool->acquire_sampler(index);
+    if (!sampler) return std::unexpected(Result::Error_Out_Of_Descriptors);
 
     VkSamplerCreateInfo sampler_create_info = {
         .sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO,
@@ -603,17 +1032,9 @@ std::expected<Sampler*, Result> Vulkan_Graphics_Device::create_sampler(const Sam
         .imageView = nullptr,
         .imageLayout = VK_IMAGE_LAYOUT_UNDEFINED
     };
-    VkWriteDescriptorSet write_descriptor_set = {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext = nullptr,
-        .dstSet = m_descriptor_set,
-        .dstBinding = 2,
-        .dstArrayElement = sampler->bindless_index,
-        .descriptorCount = 1,
-        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLER,
-        .pImageInfo = &image_info
-    };
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    m_descriptor_write_batch.write_images(
+        m_descriptor_set, 2, sampler->bindless_index, VK_DESCRIPTOR_TYPE_SAMPLER, { &image_info, 1 });
+    maybe_flush_descriptor_writes();
 
     return sampler;
 }
@@ -628,6 +1049,7 @@ void Vulkan_Graphics_Device::destroy_sampler(Sampler* sampler) noexcept
         lock_guard.lock();
     }
 
+    m_descriptor_write_batch.flush(m_device);
     m_resource_pool->release_sampler(sampler);
 }
 
@@ -641,6 +1063,7 @@ std::expected<Acceleration_Structure*, Result> Vulkan_Graphics_Device::create_ac
     }
 
     auto* acceleration_structure = m_resource_pool->acquire_acceleration_structure(NO_RESOURCE_INDEX);
+    if (!acceleration_structure) return std::unexpected(Result::Error_Out_Of_Descriptors);
 
     VkAccelerationStructureCreateInfoKHR acceleration_structure_create_info = {
         .sType = VK_STRUCTURE_TYPE_ACCELERATION_STRUCTURE_CREATE_INFO_KHR,
@@ -677,6 +1100,7 @@ void Vulkan_Graphics_Device::destroy_acceleration_structure(Acceleration_Structu
         lock_guard.lock();
     }
 
+    m_descriptor_write_batch.flush(m_device);
     m_resource_pool->release_acceleration_structure(acceleration_structure);
 }
 
@@ -691,6 +1115,9 @@ std::expected<Shader_Blob*, Result> Vulkan_Graphics_Device::create_shader_blob(c
         return std::unexpected(Result::Error_Invalid_Parameters);
     }
 
+    auto content_hash = hash_shader_blob_contents(
+        create_info.data, create_info.data_size, create_info.groups_x, create_info.groups_y, create_info.groups_z);
+
     std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
     if (m_use_mutex)
     {
@@ -698,11 +1125,14 @@ std::expected<Shader_Blob*, Result> Vulkan_Graphics_Device::create_shader_blob(c
     }
 
     auto blob = &*m_shader_blobs.emplace();
-    blob->data.resize(create_info.data_size);
+    blob->storage.assign(
+        static_cast<const uint8_t*>(create_info.data),
+        static_cast<const uint8_t*>(create_info.data) + create_info.data_size);
+    blob->data = blob->storage;
     blob->groups_x = create_info.groups_x;
     blob->groups_y = create_info.groups_y;
     blob->groups_z = create_info.groups_z;
-    memcpy(blob->data.data(), create_info.data, create_info.data_size);
+    blob->content_hash = content_hash;
     return blob;
 }
 
@@ -710,42 +1140,79 @@ Result Vulkan_Graphics_Device::recreate_shader_blob(Shader_Blob* shader_blob, co
 {
     if (!shader_blob) return Result::Error_Invalid_Parameters;
 
-    shader_blob->data.clear();
-    shader_blob->data.resize(create_info.data_size);
+    shader_blob->storage.assign(
+        static_cast<const uint8_t*>(create_info.data),
+        static_cast<const uint8_t*>(create_info.data) + create_info.data_size);
+    shader_blob->data = shader_blob->storage;
     shader_blob->groups_x = create_info.groups_x;
     shader_blob->groups_y = create_info.groups_y;
     shader_blob->groups_z = create_info.groups_z;
-    memcpy(shader_blob->data.data(), create_info.data, create_info.data_size);
+    shader_blob->reflection = {};
+    shader_blob->content_hash = hash_shader_blob_contents(
+        shader_blob->data.data(),
+        shader_blob->data.size(),
+        shader_blob->groups_x,
+        shader_blob->groups_y,
+        shader_blob->groups_z);
 
     return Result::Success;
 }
 
-Result Vulkan_Graphics_Device::recreate_shader_blob_deserialize_memory(Shader_Blob* shader_blob, void* memory) noexcept
+Result Vulkan_Graphics_Device::recreate_shader_blob_deserialize_memory(
+    Shader_Blob* shader_blob, const void* memory, uint64_t memory_size) noexcept
 {
     if (!shader_blob || !memory) return Result::Error_Invalid_Parameters;
 
-    uint8_t* blob_ptr = static_cast<uint8_t*>(memory);
-    memcpy(&shader_blob->groups_x, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    memcpy(&shader_blob->groups_y, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    memcpy(&shader_blob->groups_z, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    uint32_t dxil_blob_size = 0;
-    memcpy(&dxil_blob_size, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    uint32_t spirv_blob_size = 0;
-    memcpy(&spirv_blob_size, blob_ptr, sizeof(uint32_t));
-    blob_ptr += sizeof(uint32_t);
-    blob_ptr += dxil_blob_size;
-
-    shader_blob->data.clear();
-    shader_blob->data.resize(spirv_blob_size);
-    memcpy(shader_blob->data.data(), blob_ptr, spirv_blob_size);
+    auto contents = read_shader_container({ static_cast<const uint8_t*>(memory), memory_size });
+    if (!contents) return contents.error();
+    if (contents->spirv.empty()) return Result::Error_Invalid_Parameters;
+    auto reflection = read_shader_reflection(contents->reflection);
+    if (!reflection) return reflection.error();
+
+    shader_blob->storage.assign(contents->spirv.begin(), contents->spirv.end());
+    shader_blob->data = shader_blob->storage;
+    shader_blob->groups_x = contents->groups_x;
+    shader_blob->groups_y = contents->groups_y;
+    shader_blob->groups_z = contents->groups_z;
+    shader_blob->reflection = std::move(*reflection);
+    shader_blob->content_hash = hash_shader_blob_contents(
+        shader_blob->data.data(),
+        shader_blob->data.size(),
+        shader_blob->groups_x,
+        shader_blob->groups_y,
+        shader_blob->groups_z);
 
     return Result::Success;
 }
 
+std::expected<Shader_Blob*, Result> Vulkan_Graphics_Device::create_shader_blob(
+    const Shader_Archive& archive, uint32_t entry_index) noexcept
+{
+    if (entry_index >= archive.get_entry_count()) return std::unexpected(Result::Error_Invalid_Parameters);
+
+    const auto& entry = archive.get_entry(entry_index);
+    auto data = archive.get_section_data(entry.spirv);
+    if (data.empty()) return std::unexpected(Result::Error_Invalid_Parameters);
+    auto reflection = read_shader_reflection(archive.get_section_data(entry.reflection));
+    if (!reflection) return std::unexpected(reflection.error());
+
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    // Only the SPIR-V section is referenced, its pages are loaded by the driver on pipeline creation.
+    auto blob = &*m_shader_blobs.emplace();
+    blob->data = data;
+    blob->groups_x = entry.groups_x;
+    blob->groups_y = entry.groups_y;
+    blob->groups_z = entry.groups_z;
+    blob->reflection = std::move(*reflection);
+    blob->content_hash = entry.spirv.content_hash;
+    return blob;
+}
+
 void Vulkan_Graphics_Device::destroy_shader_blob(Shader_Blob* shader_blob) noexcept
 {
     if (shader_blob == nullptr) return;
@@ -761,15 +1228,45 @@ void Vulkan_Graphics_Device::destroy_shader_blob(Shader_Blob* shader_blob) noexc
 
 std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const Graphics_Pipeline_Create_Info& create_info) noexcept
 {
+    auto pipeline_hash = hash_pipeline(create_info);
+    if (auto pipeline = acquire_registered_pipeline(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    VkPipeline vulkan_pipeline = VK_NULL_HANDLE;
+    auto result = compile_pipeline(create_info, &vulkan_pipeline);
+    if (result != Result::Success)
+    {
+        return std::unexpected(result);
+    }
+
     std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
     if (m_use_mutex)
     {
         lock_guard.lock();
     }
 
+    // Another thread may have compiled the same pipeline in the meantime.
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        vkDestroyPipeline(m_device, vulkan_pipeline, nullptr);
+        return pipeline;
+    }
+
     auto pipeline = &*m_pipelines.emplace();
     pipeline->type = Pipeline_Type::Vertex_Shading;
     pipeline->vertex_shading_info = create_info;
+    pipeline->pipeline = vulkan_pipeline;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
+
+    return pipeline;
+}
+
+Result Vulkan_Graphics_Device::compile_pipeline(const Graphics_Pipeline_Create_Info& create_info, VkPipeline* pipeline) noexcept
+{
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return validation_result;
 
     std::vector<VkShaderModuleCreateInfo> shader_module_create_infos;
     shader_module_create_infos.reserve(5);
@@ -786,7 +1283,7 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const G
             .pNext = nullptr,
             .flags = 0,
             .codeSize = static_cast<uint32_t>(blob->data.size()),
-            .pCode = reinterpret_cast<uint32_t*>(blob->data.data())
+            .pCode = reinterpret_cast<const uint32_t*>(blob->data.data())
         };
         auto& stage = shader_stage_create_infos.emplace_back();
         stage = {
@@ -904,6 +1401,8 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const G
         .maxDepthBounds = create_info.depth_stencil_info.depth_bounds_max
     };
 
+    // Attachments the pixel shader never writes are masked, so the driver can skip them.
+    auto written_color_attachments = get_written_color_attachment_mask(create_info.ps);
     std::vector<VkPipelineColorBlendAttachmentState> color_blend_attachment_states;
     color_blend_attachment_states.reserve(create_info.color_attachment_count);
     for (auto i = 0; i < create_info.color_attachment_count; ++i)
@@ -918,7 +1417,9 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const G
             .srcAlphaBlendFactor = vulkan_cast<VkBlendFactor>(attachment_create_info.alpha_src_blend),
             .dstAlphaBlendFactor = vulkan_cast<VkBlendFactor>(attachment_create_info.alpha_dst_blend),
             .alphaBlendOp = vulkan_cast<VkBlendOp>(attachment_create_info.alpha_blend_op),
-            .colorWriteMask = vulkan_cast<VkColorComponentFlags>(attachment_create_info.color_write_mask)
+            .colorWriteMask = (written_color_attachments & (1u << i)) != 0
+                ? vulkan_cast<VkColorComponentFlags>(attachment_create_info.color_write_mask)
+                : 0
         };
     }
     VkPipelineColorBlendStateCreateInfo color_blend_state_create_info = {
@@ -1001,29 +1502,58 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const G
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0
     };
-    vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline->pipeline);
-
-    return pipeline;
+    std::shared_lock<std::shared_mutex> pipeline_cache_lock_guard(m_pipeline_cache_mutex);
+    return translate_result(vkCreateGraphicsPipelines(m_device, m_pipeline_cache, 1, &pipeline_create_info, nullptr, pipeline));
 }
 
 std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const Compute_Pipeline_Create_Info& create_info) noexcept
 {
+    auto pipeline_hash = hash_pipeline(create_info);
+    if (auto pipeline = acquire_registered_pipeline(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    VkPipeline vulkan_pipeline = VK_NULL_HANDLE;
+    auto result = compile_pipeline(create_info, &vulkan_pipeline);
+    if (result != Result::Success)
+    {
+        return std::unexpected(result);
+    }
+
     std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
     if (m_use_mutex)
     {
         lock_guard.lock();
     }
 
+    // Another thread may have compiled the same pipeline in the meantime.
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        vkDestroyPipeline(m_device, vulkan_pipeline, nullptr);
+        return pipeline;
+    }
+
     auto pipeline = &*m_pipelines.emplace();
     pipeline->type = Pipeline_Type::Compute;
     pipeline->compute_shading_info = create_info;
+    pipeline->pipeline = vulkan_pipeline;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
+
+    return pipeline;
+}
+
+Result Vulkan_Graphics_Device::compile_pipeline(const Compute_Pipeline_Create_Info& create_info, VkPipeline* pipeline) noexcept
+{
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return validation_result;
 
     VkShaderModuleCreateInfo stage_create_info = {
         .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
         .pNext = nullptr,
         .flags = 0,
         .codeSize = static_cast<uint32_t>(create_info.cs->data.size()),
-        .pCode = reinterpret_cast<uint32_t*>(create_info.cs->data.data())
+        .pCode = reinterpret_cast<const uint32_t*>(create_info.cs->data.data())
     };
     VkComputePipelineCreateInfo pipeline_create_info = {
         .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
@@ -1042,22 +1572,51 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const C
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0
     };
-    vkCreateComputePipelines(m_device, VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline->pipeline);
-
-    return pipeline;
+    std::shared_lock<std::shared_mutex> pipeline_cache_lock_guard(m_pipeline_cache_mutex);
+    return translate_result(vkCreateComputePipelines(m_device, m_pipeline_cache, 1, &pipeline_create_info, nullptr, pipeline));
 }
 
 std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept
 {
+    auto pipeline_hash = hash_pipeline(create_info);
+    if (auto pipeline = acquire_registered_pipeline(pipeline_hash))
+    {
+        return pipeline;
+    }
+
+    VkPipeline vulkan_pipeline = VK_NULL_HANDLE;
+    auto result = compile_pipeline(create_info, &vulkan_pipeline);
+    if (result != Result::Success)
+    {
+        return std::unexpected(result);
+    }
+
     std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
     if (m_use_mutex)
     {
         lock_guard.lock();
     }
 
+    // Another thread may have compiled the same pipeline in the meantime.
+    if (auto pipeline = m_pipeline_registry.acquire(pipeline_hash))
+    {
+        vkDestroyPipeline(m_device, vulkan_pipeline, nullptr);
+        return pipeline;
+    }
+
     auto pipeline = &*m_pipelines.emplace();
     pipeline->type = Pipeline_Type::Mesh_Shading;
     pipeline->mesh_shading_info = create_info;
+    pipeline->pipeline = vulkan_pipeline;
+    m_pipeline_registry.insert(pipeline_hash, pipeline);
+
+    return pipeline;
+}
+
+Result Vulkan_Graphics_Device::compile_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info, VkPipeline* pipeline) noexcept
+{
+    auto validation_result = validate_pipeline_reflection(create_info);
+    if (validation_result != Result::Success) return validation_result;
 
     std::vector<VkShaderModuleCreateInfo> shader_module_create_infos;
     shader_module_create_infos.reserve(5);
@@ -1074,7 +1633,7 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const M
             .pNext = nullptr,
             .flags = 0,
             .codeSize = static_cast<uint32_t>(blob->data.size()),
-            .pCode = reinterpret_cast<uint32_t*>(blob->data.data())
+            .pCode = reinterpret_cast<const uint32_t*>(blob->data.data())
         };
         auto& stage = shader_stage_create_infos.emplace_back();
         stage = {
@@ -1168,6 +1727,8 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const M
         .maxDepthBounds = create_info.depth_stencil_info.depth_bounds_max
     };
 
+    // Attachments the pixel shader never writes are masked, so the driver can skip them.
+    auto written_color_attachments = get_written_color_attachment_mask(create_info.ps);
     std::vector<VkPipelineColorBlendAttachmentState> color_blend_attachment_states;
     color_blend_attachment_states.reserve(create_info.color_attachment_count);
     for (auto i = 0; i < create_info.color_attachment_count; ++i)
@@ -1182,7 +1743,9 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const M
             .srcAlphaBlendFactor = vulkan_cast<VkBlendFactor>(attachment_create_info.alpha_src_blend),
             .dstAlphaBlendFactor = vulkan_cast<VkBlendFactor>(attachment_create_info.alpha_dst_blend),
             .alphaBlendOp = vulkan_cast<VkBlendOp>(attachment_create_info.alpha_blend_op),
-            .colorWriteMask = vulkan_cast<VkColorComponentFlags>(attachment_create_info.color_write_mask)
+            .colorWriteMask = (written_color_attachments & (1u << i)) != 0
+                ? vulkan_cast<VkColorComponentFlags>(attachment_create_info.color_write_mask)
+                : 0
         };
     }
     VkPipelineColorBlendStateCreateInfo color_blend_state_create_info = {
@@ -1265,9 +1828,8 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const M
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0
     };
-    vkCreateGraphicsPipelines(m_device, VK_NULL_HANDLE, 1, &pipeline_create_info, nullptr, &pipeline->pipeline);
-
-    return pipeline;
+    std::shared_lock<std::shared_mutex> pipeline_cache_lock_guard(m_pipeline_cache_mutex);
+    return translate_result(vkCreateGraphicsPipelines(m_device, m_pipeline_cache, 1, &pipeline_create_info, nullptr, pipeline));
 }
 
 std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept
@@ -1306,7 +1868,7 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const R
             .pNext = nullptr,
             .flags = 0,
             .codeSize = shader.blob->data.size(),
-            .pCode = reinterpret_cast<uint32_t*>(shader.blob->data.data())
+            .pCode = reinterpret_cast<const uint32_t*>(shader.blob->data.data())
         };
         auto& stage = stages.emplace_back();
         stage = {
@@ -1405,7 +1967,8 @@ std::expected<Pipeline*, Result> Vulkan_Graphics_Device::create_pipeline(const R
         .basePipelineHandle = VK_NULL_HANDLE,
         .basePipelineIndex = 0
     };
-    vkCreateRayTracingPipelinesKHR(m_device, VK_NULL_HANDLE, VK_NULL_HANDLE, 1, &ray_tracing_pipeline_create_info, nullptr, &pipeline->pipeline);
+    std::shared_lock<std::shared_mutex> pipeline_cache_lock_guard(m_pipeline_cache_mutex);
+    vkCreateRayTracingPipelinesKHR(m_device, VK_NULL_HANDLE, m_pipeline_cache, 1, &ray_tracing_pipeline_create_info, nullptr, &pipeline->pipeline);
 
     return pipeline;
 }
@@ -1420,6 +1983,8 @@ void Vulkan_Graphics_Device::destroy_pipeline(Pipeline* pipeline) noexcept
         lock_guard.lock();
     }
 
+    if (!m_pipeline_registry.release(pipeline)) return;
+
     auto vulkan_pipeline = static_cast<Vulkan_Pipeline*>(pipeline);
     if (vulkan_pipeline->pipeline)
         vkDestroyPipeline(m_device, vulkan_pipeline->pipeline, nullptr);
@@ -1428,6 +1993,104 @@ void Vulkan_Graphics_Device::destroy_pipeline(Pipeline* pipeline) noexcept
     m_pipelines.erase(m_pipelines.get_iterator(vulkan_pipeline));
 }
 
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> Vulkan_Graphics_Device::create_pipelines_async(
+    std::span<const Graphics_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Vertex_Shading;
+            pipeline->vertex_shading_info = create_info;
+            pipeline->pipeline = VK_NULL_HANDLE;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> Vulkan_Graphics_Device::create_pipelines_async(
+    std::span<const Compute_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Compute;
+            pipeline->compute_shading_info = create_info;
+            pipeline->pipeline = VK_NULL_HANDLE;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+std::vector<std::shared_ptr<Pipeline_Compile_Task>> Vulkan_Graphics_Device::create_pipelines_async(
+    std::span<const Mesh_Shading_Pipeline_Create_Info> create_infos) noexcept
+{
+    std::vector<Pipeline*> pipelines;
+    pipelines.reserve(create_infos.size());
+    {
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+
+        for (const auto& create_info : create_infos)
+        {
+            auto pipeline = &*m_pipelines.emplace();
+            pipeline->type = Pipeline_Type::Mesh_Shading;
+            pipeline->mesh_shading_info = create_info;
+            pipeline->pipeline = VK_NULL_HANDLE;
+            pipelines.push_back(pipeline);
+        }
+    }
+    return m_pipeline_compiler.enqueue(pipelines);
+}
+
+Pipeline* Vulkan_Graphics_Device::acquire_registered_pipeline(uint64_t pipeline_hash) noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    return m_pipeline_registry.acquire(pipeline_hash);
+}
+
+Result Vulkan_Graphics_Device::compile_pipeline(Vulkan_Pipeline* pipeline) noexcept
+{
+    switch (pipeline->type)
+    {
+    case Pipeline_Type::Vertex_Shading:
+        return compile_pipeline(pipeline->vertex_shading_info, &pipeline->pipeline);
+    case Pipeline_Type::Compute:
+        return compile_pipeline(pipeline->compute_shading_info, &pipeline->pipeline);
+    case Pipeline_Type::Mesh_Shading:
+        return compile_pipeline(pipeline->mesh_shading_info, &pipeline->pipeline);
+    default:
+        return Result::Error_Invalid_Parameters;
+    }
+}
+
 Acceleration_Structure_Build_Sizes Vulkan_Graphics_Device::get_acceleration_structure_build_sizes(
     const Acceleration_Structure_Build_Geometry_Info& build_info) noexcept
 {
@@ -1601,6 +2264,18 @@ Result Vulkan_Graphics_Device::get_ray_tracing_shader_group_handles(
 
 Result Vulkan_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
 {
+    process_deferred_destructions();
+
+    {
+        // Resources created inside a still open resource batch may be used by this submission.
+        std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+        if (m_use_mutex)
+        {
+            lock_guard.lock();
+        }
+        m_descriptor_write_batch.flush(m_device);
+    }
+
     std::mutex* queue_mutex = nullptr;
     VkQueue queue = VK_NULL_HANDLE;
     switch (submit_info.queue_type)
@@ -1647,6 +2322,7 @@ Result Vulkan_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
             .deviceIndex = 0
             });
     }
+#ifndef RHI_VULKAN_HEADLESS
     if (submit_info.wait_swapchain != nullptr)
     {
         semaphore_submit_wait_infos.push_back({
@@ -1658,11 +2334,13 @@ Result Vulkan_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
             .deviceIndex = 0
             });
     }
+#endif
 
     std::vector<VkCommandBufferSubmitInfo> command_buffer_submit_infos;
     command_buffer_submit_infos.reserve(submit_info.command_lists.size());
-    for (const auto* command_list : submit_info.command_lists)
+    for (auto* command_list : submit_info.command_lists)
     {
+        command_list->flush_barriers();
         vkEndCommandBuffer(static_cast<const Vulkan_Command_List*>(command_list)->get_internal_command_list());
 
         command_buffer_submit_infos.push_back({
@@ -1686,6 +2364,7 @@ Result Vulkan_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
             .deviceIndex = 0
             });
     }
+#ifndef RHI_VULKAN_HEADLESS
     if (submit_info.present_swapchain != nullptr)
     {
         semaphore_submit_signal_infos.push_back({
@@ -1697,6 +2376,7 @@ Result Vulkan_Graphics_Device::submit(const Submit_Info& submit_info) noexcept
             .deviceIndex = 0
             });
     }
+#endif
 
     VkSubmitInfo2 submit = {
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2,
@@ -1736,6 +2416,104 @@ void Vulkan_Graphics_Device::name_resource(Image* image, const char* name) noexc
     vkSetDebugUtilsObjectNameEXT(m_device, &name_info);
 }
 
+void Vulkan_Graphics_Device::begin_resource_batch() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    ++m_resource_batch_depth;
+}
+
+void Vulkan_Graphics_Device::end_resource_batch() noexcept
+{
+    std::unique_lock<std::mutex> lock_guard(m_resource_mutex, std::defer_lock);
+    if (m_use_mutex)
+    {
+        lock_guard.lock();
+    }
+
+    if (m_resource_batch_depth == 0) return;
+
+    --m_resource_batch_depth;
+    maybe_flush_descriptor_writes();
+}
+
+void Vulkan_Graphics_Device::destroy_buffer_deferred(Buffer* buffer, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(buffer, fence, value);
+}
+
+void Vulkan_Graphics_Device::destroy_image_deferred(Image* image, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(image, fence, value);
+}
+
+void Vulkan_Graphics_Device::destroy_sampler_deferred(Sampler* sampler, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(sampler, fence, value);
+}
+
+void Vulkan_Graphics_Device::destroy_acceleration_structure_deferred(
+    Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(acceleration_structure, fence, value);
+}
+
+void Vulkan_Graphics_Device::destroy_memory_heap_deferred(Memory_Heap* memory_heap, Fence* fence, uint64_t value) noexcept
+{
+    m_deferred_destruction_queue.push(memory_heap, fence, value);
+}
+
+void Vulkan_Graphics_Device::process_deferred_destructions() noexcept
+{
+    m_deferred_destruction_queue.process(this);
+}
+
+Result Vulkan_Graphics_Device::load_pipeline_cache(const std::filesystem::path& path) noexcept
+{
+    auto data = read_pipeline_cache_file(path, Graphics_API::Vulkan);
+    if (!data) return data.error();
+    if (!is_pipeline_cache_data_compatible(m_physical_device, data->data(), data->size()))
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    auto loaded_pipeline_cache = create_pipeline_cache(m_device, data->data(), data->size());
+    if (loaded_pipeline_cache == VK_NULL_HANDLE) return Result::Error_Unknown;
+
+    // The destination of a merge must be externally synchronized with pipeline creation.
+    std::unique_lock<std::shared_mutex> lock_guard(m_pipeline_cache_mutex);
+
+    auto result = vkMergePipelineCaches(m_device, m_pipeline_cache, 1, &loaded_pipeline_cache);
+    vkDestroyPipelineCache(m_device, loaded_pipeline_cache, nullptr);
+    return translate_result(result);
+}
+
+Result Vulkan_Graphics_Device::save_pipeline_cache(const std::filesystem::path& path) noexcept
+{
+    std::vector<uint8_t> data;
+    {
+        std::shared_lock<std::shared_mutex> lock_guard(m_pipeline_cache_mutex);
+
+        // Pipelines created in between the two calls may grow the cache, retry until the data fits.
+        auto result = VK_INCOMPLETE;
+        while (result == VK_INCOMPLETE)
+        {
+            size_t data_size = 0;
+            result = vkGetPipelineCacheData(m_device, m_pipeline_cache, &data_size, nullptr);
+            if (result != VK_SUCCESS) return translate_result(result);
+            data.resize(data_size);
+            result = vkGetPipelineCacheData(m_device, m_pipeline_cache, &data_size, data.data());
+            data.resize(data_size);
+        }
+        if (result != VK_SUCCESS) return translate_result(result);
+    }
+    return write_pipeline_cache_file(path, Graphics_API::Vulkan, data);
+}
+
 uint32_t Vulkan_Graphics_Device::get_queue_family_index(VkQueueFlagBits queue_type) const noexcept
 {
     switch (queue_type)
@@ -1776,22 +2554,9 @@ const VkQueue Vulkan_Graphics_Device::get_queue(Queue_Type queue_type) const noe
 
 void Vulkan_Graphics_Device::create_acceleration_structure_descriptor(Vulkan_Acceleration_Structure* acceleration_structure)
 {
-    VkWriteDescriptorSetAccelerationStructureKHR write_acceleration_structure = {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET_ACCELERATION_STRUCTURE_KHR,
-        .pNext = nullptr,
-        .accelerationStructureCount = 1,
-        .pAccelerationStructures = &acceleration_structure->acceleration_structure
-    };
-    VkWriteDescriptorSet write_descriptor_set = {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext = &write_acceleration_structure,
-        .dstSet = m_descriptor_set,
-        .dstBinding = 1,
-        .dstArrayElement = acceleration_structure->bindless_index,
-        .descriptorCount = 1,
-        .descriptorType = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR
-    };
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    m_descriptor_write_batch.write_acceleration_structure(
+        m_descriptor_set, 1, acceleration_structure->bindless_index, acceleration_structure->acceleration_structure);
+    maybe_flush_descriptor_writes();
 }
 
 void Vulkan_Graphics_Device::create_buffer_descriptors(Vulkan_Buffer* buffer)
@@ -1801,20 +2566,13 @@ void Vulkan_Graphics_Device::create_buffer_descriptors(Vulkan_Buffer* buffer)
         .offset = 0,
         .range = VK_WHOLE_SIZE
     };
-    VkWriteDescriptorSet write_descriptor_set = {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext = nullptr,
-        .dstSet = m_descriptor_set,
-        .dstBinding = 0,
-        .dstArrayElement = buffer->buffer_view->bindless_index,
-        .descriptorCount = 1,
-        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // TODO: use two descriptors?
-        .pBufferInfo = &buffer_info
-    };
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
-
-    write_descriptor_set.dstArrayElement += 1;
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    // Both the SRV and UAV slot of the bindless index are written with a single write.
+    std::array<VkDescriptorBufferInfo, 2> buffer_infos = { buffer_info, buffer_info };
+    m_descriptor_write_batch.write_buffers(
+        m_descriptor_set, 0, buffer->buffer_view->bindless_index,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // TODO: use two descriptors?
+        buffer_infos);
+    maybe_flush_descriptor_writes();
 }
 
 void Vulkan_Graphics_Device::create_buffer_view_descriptors(Vulkan_Buffer_View* buffer_view)
@@ -1824,20 +2582,12 @@ void Vulkan_Graphics_Device::create_buffer_view_descriptors(Vulkan_Buffer_View*
         .offset = buffer_view->offset,
         .range = buffer_view->size
     };
-    VkWriteDescriptorSet write_descriptor_set = {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext = nullptr,
-        .dstSet = m_descriptor_set,
-        .dstBinding = 0,
-        .dstArrayElement = buffer_view->bindless_index,
-        .descriptorCount = 1,
-        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // TODO: use two descriptors?
-        .pBufferInfo = &buffer_info
-    };
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
-
-    write_descriptor_set.dstArrayElement += 1;
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    std::array<VkDescriptorBufferInfo, 2> buffer_infos = { buffer_info, buffer_info };
+    m_descriptor_write_batch.write_buffers(
+        m_descriptor_set, 0, buffer_view->bindless_index,
+        VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, // TODO: use two descriptors?
+        buffer_infos);
+    maybe_flush_descriptor_writes();
 }
 
 void Vulkan_Graphics_Device::create_image_descriptors(Vulkan_Image* image, bool create_storage_image_descriptor)
@@ -1847,27 +2597,16 @@ void Vulkan_Graphics_Device::create_image_descriptors(Vulkan_Image* image, bool
         .imageView = static_cast<Vulkan_Image_View*>(image->image_view)->image_view,
         .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
     };
-    VkWriteDescriptorSet write_descriptor_set = {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext = nullptr,
-        .dstSet = m_descriptor_set,
-        .dstBinding = 0,
-        .dstArrayElement = image->image_view->bindless_index,
-        .descriptorCount = 1,
-        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-        .pImageInfo = &image_info
-    };
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    m_descriptor_write_batch.write_images(
+        m_descriptor_set, 0, image->image_view->bindless_index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, { &image_info, 1 });
 
-    if (!create_storage_image_descriptor)
+    if (create_storage_image_descriptor)
     {
-        return;
+        image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        m_descriptor_write_batch.write_images(
+            m_descriptor_set, 0, image->image_view->bindless_index + 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, { &image_info, 1 });
     }
-
-    image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    write_descriptor_set.dstArrayElement += 1;
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    maybe_flush_descriptor_writes();
 }
 
 void Vulkan_Graphics_Device::create_image_view_descriptors(
@@ -1878,26 +2617,22 @@ void Vulkan_Graphics_Device::create_image_view_descriptors(
         .imageView = static_cast<Vulkan_Image_View*>(image_view)->image_view,
         .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL
     };
-    VkWriteDescriptorSet write_descriptor_set = {
-        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
-        .pNext = nullptr,
-        .dstSet = m_descriptor_set,
-        .dstBinding = 0,
-        .dstArrayElement = image_view->bindless_index,
-        .descriptorCount = 1,
-        .descriptorType = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE,
-        .pImageInfo = &image_info
-    };
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    m_descriptor_write_batch.write_images(
+        m_descriptor_set, 0, image_view->bindless_index, VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, { &image_info, 1 });
 
-    if (!create_storage_image_descriptor)
+    if (create_storage_image_descriptor)
     {
-        return;
+        image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+        m_descriptor_write_batch.write_images(
+            m_descriptor_set, 0, image_view->bindless_index + 1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, { &image_info, 1 });
     }
+    maybe_flush_descriptor_writes();
+}
+
+void Vulkan_Graphics_Device::maybe_flush_descriptor_writes() noexcept
+{
+    if (m_resource_batch_depth > 0) return;
 
-    image_info.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
-    write_descriptor_set.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
-    write_descriptor_set.dstArrayElement += 1;
-    vkUpdateDescriptorSets(m_device, 1, &write_descriptor_set, 0, nullptr);
+    m_descriptor_write_batch.flush(m_device);
 }
 }
@@ -1,12 +1,17 @@
 #pragma once
 
 #include "rhi/graphics_device.hpp"
+#include "rhi/common/deferred_destruction_queue.hpp"
+#include "rhi/common/pipeline_compiler.hpp"
+#include "rhi/common/pipeline_registry.hpp"
 #include "rhi/common/resource_pool.hpp"
+#include "rhi/vulkan/vulkan_descriptor_write_batch.hpp"
 #include "rhi/vulkan/vulkan_resource.hpp"
 
 #include <volk.h>
 #include <mutex>
 #include <plf_colony.h>
+#include <shared_mutex>
 #include <vk_mem_alloc.h>
 
 namespace rhi::vulkan
@@ -16,7 +21,7 @@ struct Vulkan_Fence : public Fence
     VkSemaphore semaphore;
     VkDevice device;
 
-    virtual [[nodiscard]] Result get_status(uint64_t value) noexcept override;
+    [[nodiscard]] virtual Result get_status(uint64_t value) noexcept override;
     virtual Result wait_for_value(uint64_t value) noexcept override;
 };
 
@@ -37,59 +42,83 @@ public:
     virtual Result wait_idle() noexcept override;
     virtual Result queue_wait_idle(Queue_Type queue, uint64_t timeout) noexcept override;
 
-    virtual [[nodiscard]] Graphics_API get_graphics_api() const noexcept override;
+    [[nodiscard]] virtual Graphics_API get_graphics_api() const noexcept override;
 
-    virtual [[nodiscard]] std::unique_ptr<Swapchain> create_swapchain(
+    [[nodiscard]] virtual std::unique_ptr<Swapchain> create_swapchain(
         const Swapchain_Win32_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::unique_ptr<Command_Pool> create_command_pool(
+    [[nodiscard]] virtual std::unique_ptr<Command_Pool> create_command_pool(
         const Command_Pool_Create_Info& create_info) noexcept override;
 
-    virtual [[nodsicard]] std::expected<Fence*, Result> create_fence(uint64_t initial_value) noexcept override;
+    [[nodiscard]] virtual std::expected<Fence*, Result> create_fence(uint64_t initial_value) noexcept override;
     virtual void destroy_fence(Fence* fence) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Buffer*, Result> create_buffer(
+    [[nodiscard]] virtual std::expected<Buffer*, Result> create_buffer(
         const Buffer_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
-    virtual [[nodiscard]] std::expected<Buffer_View*, Result> create_buffer_view(
+    [[nodiscard]] virtual std::expected<Buffer_View*, Result> create_buffer_view(
         Buffer* buffer, const Buffer_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual Result update_buffer_view(
+        Buffer_View* buffer_view, const Buffer_View_Create_Info& create_info) noexcept override;
     virtual void destroy_buffer(Buffer* buffer) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Image*, Result> create_image(
+    [[nodiscard]] virtual std::expected<Memory_Heap*, Result> create_memory_heap(
+        const Memory_Heap_Create_Info& create_info) noexcept override;
+    virtual void destroy_memory_heap(Memory_Heap* memory_heap) noexcept override;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Buffer_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual Memory_Requirements get_memory_requirements(const Image_Create_Info& create_info) noexcept override;
+    [[nodiscard]] virtual std::expected<Buffer*, Result> create_placed_buffer(
+        const Buffer_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+    [[nodiscard]] virtual std::expected<Image*, Result> create_placed_image(
+        const Image_Create_Info& create_info, Memory_Heap* memory_heap, uint64_t offset,
+        uint32_t index = NO_RESOURCE_INDEX) noexcept override;
+
+    [[nodiscard]] virtual std::expected<Image*, Result> create_image(
         const Image_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
-    virtual [[nodiscard]] std::expected<Image_View*, Result> create_image_view(
+    [[nodiscard]] virtual std::expected<Image_View*, Result> create_image_view(
         Image* image, const Image_View_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
     virtual void destroy_image(Image* image) noexcept override;
 
     [[nodiscard]] Vulkan_Image* create_proxy_image() noexcept;
     void destroy_proxy_image(Vulkan_Image* image) noexcept;
 
-    virtual [[nodiscard]] std::expected<Sampler*, Result> create_sampler(
+    [[nodiscard]] virtual std::expected<Sampler*, Result> create_sampler(
         const Sampler_Create_Info& create_info, uint32_t index = NO_RESOURCE_INDEX) noexcept override;
     virtual void destroy_sampler(Sampler* sampler) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Acceleration_Structure*, Result> create_acceleration_structure(
+    [[nodiscard]] virtual std::expected<Acceleration_Structure*, Result> create_acceleration_structure(
         const Acceleration_Structure_Create_Info& create_info) noexcept override;
     virtual void destroy_acceleration_structure(Acceleration_Structure* acceleration_structure) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Shader_Blob*, Result> create_shader_blob(
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
         const Shader_Blob_Create_Info& create_info) noexcept override;
     virtual Result recreate_shader_blob(Shader_Blob* shader_blob, const Shader_Blob_Create_Info& create_info) noexcept override;
-    virtual Result recreate_shader_blob_deserialize_memory(Shader_Blob* shader_blob, void* memory) noexcept override;
+    virtual Result recreate_shader_blob_deserialize_memory(
+        Shader_Blob* shader_blob, const void* memory, uint64_t memory_size) noexcept override;
+    [[nodiscard]] virtual std::expected<Shader_Blob*, Result> create_shader_blob(
+        const Shader_Archive& archive, uint32_t entry_index) noexcept override;
     virtual void destroy_shader_blob(Shader_Blob* shader_blob) noexcept override;
 
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Graphics_Pipeline_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Compute_Pipeline_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Mesh_Shading_Pipeline_Create_Info& create_info) noexcept override;
-    virtual [[nodiscard]] std::expected<Pipeline*, Result> create_pipeline(
+    [[nodiscard]] virtual std::expected<Pipeline*, Result> create_pipeline(
         const Ray_Tracing_Pipeline_Create_Info& create_info) noexcept override;
     virtual void destroy_pipeline(Pipeline* pipeline) noexcept override;
 
-    virtual [[nodiscard]] Acceleration_Structure_Build_Sizes get_acceleration_structure_build_sizes(
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Graphics_Pipeline_Create_Info> create_infos) noexcept override;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Compute_Pipeline_Create_Info> create_infos) noexcept override;
+    [[nodiscard]] virtual std::vector<std::shared_ptr<Pipeline_Compile_Task>> create_pipelines_async(
+        std::span<const Mesh_Shading_Pipeline_Create_Info> create_infos) noexcept override;
+
+    [[nodiscard]] virtual Acceleration_Structure_Build_Sizes get_acceleration_structure_build_sizes(
         const Acceleration_Structure_Build_Geometry_Info& build_info) noexcept override;
-    virtual [[nodiscard]] const Ray_Tracing_Pipeline_Properties& get_ray_tracing_pipeline_properties() const noexcept override;
-    virtual [[nodiscard]] Result get_ray_tracing_shader_group_handles(
+    [[nodiscard]] virtual const Ray_Tracing_Pipeline_Properties& get_ray_tracing_pipeline_properties() const noexcept override;
+    [[nodiscard]] virtual Result get_ray_tracing_shader_group_handles(
         Pipeline* pipeline, uint32_t first_group, uint32_t group_count, void* dst) const noexcept override;
 
     virtual Result submit(const Submit_Info& submit_info) noexcept override;
@@ -97,6 +126,20 @@ public:
     virtual void name_resource(Buffer* buffer, const char* name) noexcept override;
     virtual void name_resource(Image* image, const char* name) noexcept override;
 
+    virtual void begin_resource_batch() noexcept override;
+    virtual void end_resource_batch() noexcept override;
+
+    virtual void destroy_buffer_deferred(Buffer* buffer, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_image_deferred(Image* image, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_sampler_deferred(Sampler* sampler, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_acceleration_structure_deferred(
+        Acceleration_Structure* acceleration_structure, Fence* fence, uint64_t value) noexcept override;
+    virtual void destroy_memory_heap_deferred(Memory_Heap* memory_heap, Fence* fence, uint64_t value) noexcept override;
+    virtual void process_deferred_destructions() noexcept override;
+
+    virtual Result load_pipeline_cache(const std::filesystem::path& path) noexcept override;
+    virtual Result save_pipeline_cache(const std::filesystem::path& path) noexcept override;
+
     [[nodiscard]] uint32_t get_queue_family_index(VkQueueFlagBits queue_type) const noexcept;
 
     [[nodiscard]] operator VkInstance() const noexcept { return m_instance; }
@@ -109,12 +152,36 @@ public:
     [[nodiscard]] const VkPipelineLayout get_pipeline_layout() const noexcept { return m_pipeline_layout; }
 
 private:
+    // Both allocate dedicated memory if `memory_heap` is nullptr and place the resource in it otherwise.
+    [[nodiscard]] std::expected<Buffer*, Result> create_buffer_in_memory(
+        const Buffer_Create_Info& create_info, uint32_t index, Vulkan_Memory_Heap* memory_heap, uint64_t offset) noexcept;
+    [[nodiscard]] std::expected<Image*, Result> create_image_in_memory(
+        const Image_Create_Info& create_info, uint32_t index, Vulkan_Memory_Heap* memory_heap, uint64_t offset) noexcept;
+    [[nodiscard]] VkMemoryRequirements get_vulkan_memory_requirements(const Buffer_Create_Info& create_info) noexcept;
+    [[nodiscard]] VkMemoryRequirements get_vulkan_memory_requirements(const Image_Create_Info& create_info) noexcept;
+    // Pads to `bufferImageGranularity`, which is what the placed resource functions expect.
+    [[nodiscard]] Memory_Requirements pad_memory_requirements(const VkMemoryRequirements& memory_requirements) const noexcept;
+    // Memory types that can back every buffer and, for GPU heaps, common color and depth images.
+    [[nodiscard]] uint32_t get_memory_heap_type_bits(Memory_Heap_Type heap_type) noexcept;
+    // Rejects resources that can't live in the memory type the heap was allocated from.
+    [[nodiscard]] bool is_placement_valid(
+        const VkMemoryRequirements& memory_requirements, Memory_Heap* memory_heap, uint64_t offset) const noexcept;
+
     void create_acceleration_structure_descriptor(Vulkan_Acceleration_Structure* acceleration_structure);
     void create_buffer_descriptors(Vulkan_Buffer* buffer);
     void create_buffer_view_descriptors(Vulkan_Buffer_View* buffer_view);
     void create_image_descriptors(Vulkan_Image* image, bool create_storage_image_descriptor);
     void create_image_view_descriptors(
         Vulkan_Image_View* image_view, const Image_View_Create_Info& create_info, bool create_storage_image_descriptor);
+    // Expects `m_resource_mutex` to be held. Flushes unless a resource batch is open.
+    void maybe_flush_descriptor_writes() noexcept;
+
+    // Thread safe and never touch `m_resource_mutex`, so pipelines can be compiled on any number of threads.
+    [[nodiscard]] Result compile_pipeline(const Graphics_Pipeline_Create_Info& create_info, VkPipeline* pipeline) noexcept;
+    [[nodiscard]] Result compile_pipeline(const Compute_Pipeline_Create_Info& create_info, VkPipeline* pipeline) noexcept;
+    [[nodiscard]] Result compile_pipeline(const Mesh_Shading_Pipeline_Create_Info& create_info, VkPipeline* pipeline) noexcept;
+    [[nodiscard]] Result compile_pipeline(Vulkan_Pipeline* pipeline) noexcept;
+    [[nodiscard]] Pipeline* acquire_registered_pipeline(uint64_t pipeline_hash) noexcept;
 
 private:
     VkInstance m_instance;
@@ -141,8 +208,10 @@ private:
     VkDescriptorPool m_descriptor_pool;
     VkDescriptorSet m_descriptor_set;
     VkPipelineLayout m_pipeline_layout;
+    VkPipelineCache m_pipeline_cache;
 
     Ray_Tracing_Pipeline_Properties m_ray_tracing_pipeline_properties;
+    VkDeviceSize m_buffer_image_granularity;
 
     bool m_use_mutex;
     std::mutex m_resource_mutex;
@@ -153,8 +222,19 @@ private:
     std::mutex m_video_encode_queue_mutex;
 
     std::unique_ptr<Vulkan_Resource_Pool> m_resource_pool;
+    Deferred_Destruction_Queue m_deferred_destruction_queue;
+    // Guarded by `m_resource_mutex`.
+    Vulkan_Descriptor_Write_Batch m_descriptor_write_batch;
+    uint32_t m_resource_batch_depth;
+
+    // Guarded by `m_resource_mutex`.
+    Pipeline_Registry m_pipeline_registry;
+    Pipeline_Compiler m_pipeline_compiler;
+    // Shared by pipeline creation, exclusive while merging into `m_pipeline_cache`.
+    std::shared_mutex m_pipeline_cache_mutex;
 
     plf::colony<Vulkan_Fence> m_fences;
+    plf::colony<Vulkan_Memory_Heap> m_memory_heaps;
     plf::colony<Shader_Blob> m_shader_blobs;
     plf::colony<Vulkan_Pipeline> m_pipelines;
 };
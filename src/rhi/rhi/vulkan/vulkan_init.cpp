@@ -3,6 +3,7 @@
 #include "rhi/resource.hpp"
 
 #include <array>
+#include <cstring>
 #include <vector>
 #include <ranges>
 
@@ -17,11 +18,15 @@ VkInstance create_instance(bool enable_validation_layers, bool enable_gpu_valida
     }
 
     std::vector<const char*> enabled_extensions;
+#ifndef RHI_VULKAN_HEADLESS
     enabled_extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
     enabled_extensions.push_back(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
+#ifdef VK_USE_PLATFORM_WIN32_KHR
     enabled_extensions.push_back(VK_KHR_WIN32_SURFACE_EXTENSION_NAME);
+#endif
     enabled_extensions.push_back(VK_KHR_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
     enabled_extensions.push_back(VK_EXT_SWAPCHAIN_COLOR_SPACE_EXTENSION_NAME);
+#endif
     enabled_extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     enabled_extensions.push_back(VK_EXT_DEBUG_REPORT_EXTENSION_NAME);
 
@@ -363,16 +368,22 @@ VkDevice create_device(VkPhysicalDevice physical_device)
         .pNext = &REQUIRED_VK14_FEATURES,
         .mutableDescriptorType = VK_TRUE
     };
+#ifndef RHI_VULKAN_HEADLESS
     VkPhysicalDeviceSwapchainMaintenance1FeaturesKHR REQUIRED_SWAPCHAIN_MAINTENANCE1_FEATURES = {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT,
         .pNext = &REQUIRED_MUTABLE_DESCRIPTOR_TYPE_FEATURES,
         .swapchainMaintenance1 = VK_TRUE
     };
+#endif
 
     // Ray tracing
     VkPhysicalDeviceAccelerationStructureFeaturesKHR REQUIRED_ACCELERATION_STRUCTURE_FEATURES = {
         .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ACCELERATION_STRUCTURE_FEATURES_KHR,
+#ifndef RHI_VULKAN_HEADLESS
         .pNext = &REQUIRED_SWAPCHAIN_MAINTENANCE1_FEATURES,
+#else
+        .pNext = &REQUIRED_MUTABLE_DESCRIPTOR_TYPE_FEATURES,
+#endif
         .accelerationStructure = VK_TRUE,
         .accelerationStructureCaptureReplay = VK_FALSE,
         .accelerationStructureIndirectBuild = VK_FALSE,
@@ -419,9 +430,10 @@ VkDevice create_device(VkPhysicalDevice physical_device)
     };
 
     const auto extensions = std::to_array<const char*>({
+#ifndef RHI_VULKAN_HEADLESS
         VK_KHR_SWAPCHAIN_EXTENSION_NAME,
         VK_KHR_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME,
-        VK_EXT_DEBUG_MARKER_EXTENSION_NAME,
+#endif
         VK_EXT_MUTABLE_DESCRIPTOR_TYPE_EXTENSION_NAME,
         VK_KHR_DEFERRED_HOST_OPERATIONS_EXTENSION_NAME,
         VK_KHR_ACCELERATION_STRUCTURE_EXTENSION_NAME,
@@ -650,6 +662,37 @@ VkDescriptorSet create_descriptor_set(VkDevice device, VkDescriptorSetLayout des
     return result;
 }
 
+VkPipelineCache create_pipeline_cache(VkDevice device, const void* initial_data, size_t initial_data_size)
+{
+    VkPipelineCacheCreateInfo pipeline_cache_create_info = {
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .pNext = nullptr,
+        .flags = 0,
+        .initialDataSize = initial_data_size,
+        .pInitialData = initial_data
+    };
+
+    VkPipelineCache result = VK_NULL_HANDLE;
+    vkCreatePipelineCache(device, &pipeline_cache_create_info, nullptr, &result);
+    return result;
+}
+
+bool is_pipeline_cache_data_compatible(VkPhysicalDevice physical_device, const void* data, size_t data_size)
+{
+    VkPipelineCacheHeaderVersionOne header = {};
+    if (data_size < sizeof(header)) return false;
+    memcpy(&header, data, sizeof(header));
+
+    VkPhysicalDeviceProperties properties = {};
+    vkGetPhysicalDeviceProperties(physical_device, &properties);
+
+    return header.headerSize >= sizeof(header)
+        && header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE
+        && header.vendorID == properties.vendorID
+        && header.deviceID == properties.deviceID
+        && memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
 VkPhysicalDeviceRayTracingPipelinePropertiesKHR query_ray_tracing_pipeline_properties(VkPhysicalDevice physical_device)
 {
     VkPhysicalDeviceRayTracingPipelinePropertiesKHR ray_tracing_pipeline_properties = {
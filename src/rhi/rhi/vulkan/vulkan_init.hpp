@@ -21,6 +21,9 @@ VkDescriptorSetLayout create_descriptor_set_layout(VkDevice device);
 VkPipelineLayout create_pipeline_layout(VkDevice device, VkDescriptorSetLayout descriptor_set_layout, uint32_t push_constant_size);
 VkDescriptorPool create_descriptor_pool(VkDevice device);
 VkDescriptorSet create_descriptor_set(VkDevice device, VkDescriptorSetLayout descriptor_set_layout, VkDescriptorPool descriptor_pool);
+VkPipelineCache create_pipeline_cache(VkDevice device, const void* initial_data, size_t initial_data_size);
+// Checks the header of serialized pipeline cache data, the driver silently ignores data of other devices.
+bool is_pipeline_cache_data_compatible(VkPhysicalDevice physical_device, const void* data, size_t data_size);
 
 VkPhysicalDeviceRayTracingPipelinePropertiesKHR query_ray_tracing_pipeline_properties(VkPhysicalDevice physical_device);
 }
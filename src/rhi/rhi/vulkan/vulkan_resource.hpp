@@ -10,7 +10,14 @@ namespace rhi::vulkan
 struct Vulkan_Buffer : public Buffer
 {
     VkBuffer buffer;
+    VmaAllocation allocation; // VK_NULL_HANDLE for placed buffers.
+};
+
+struct Vulkan_Memory_Heap : public Memory_Heap
+{
     VmaAllocation allocation;
+    void* data; // Persistently mapped for CPU visible heaps.
+    uint32_t memory_type_index;
 };
 
 struct Vulkan_Buffer_View : public Buffer_View
@@ -22,6 +29,8 @@ struct Vulkan_Image : public Image
 {
     VkImage image;
     VmaAllocation allocation;
+    // Placed images have no allocation but, unlike swapchain images, are still destroyed by the device.
+    bool is_placed;
 };
 
 struct Vulkan_Image_View : public Image_View
@@ -24,11 +24,11 @@ public:
     virtual void present() noexcept override;
     virtual void change_format(Image_Format format) noexcept override;
 
-    virtual [[nodiscard]] Swapchain_Resize_Info query_resize() noexcept override;
-    virtual [[nodiscard]] Image_Format get_image_format() noexcept override;
-    virtual [[nodiscard]] Image_View* get_current_image_view() noexcept override;
-    virtual [[nodiscard]] uint32_t get_width() const noexcept override;
-    virtual [[nodiscard]] uint32_t get_height() const noexcept override;
+    [[nodiscard]] virtual Swapchain_Resize_Info query_resize() noexcept override;
+    [[nodiscard]] virtual Image_Format get_image_format() noexcept override;
+    [[nodiscard]] virtual Image_View* get_current_image_view() noexcept override;
+    [[nodiscard]] virtual uint32_t get_width() const noexcept override;
+    [[nodiscard]] virtual uint32_t get_height() const noexcept override;
 
     VkSemaphore get_current_acquire_semaphore() const noexcept;
     VkSemaphore get_current_present_semaphore() const noexcept;
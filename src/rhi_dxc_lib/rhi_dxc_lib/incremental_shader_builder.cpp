@@ -0,0 +1,192 @@
+#include "rhi_dxc_lib/incremental_shader_builder.hpp"
+
+#include <algorithm>
+#include <fstream>
+#include <map>
+#include <iterator>
+#include <string>
+
+namespace rhi::dxc
+{
+namespace
+{
+std::filesystem::file_time_type get_last_write_time(const std::filesystem::path& path)
+{
+    // Missing files compare unequal to any real time, so deleting an include triggers a rebuild as well.
+    std::error_code error;
+    auto last_write_time = std::filesystem::last_write_time(path, error);
+    return error ? std::filesystem::file_time_type::min() : last_write_time;
+}
+
+std::string read_source_file(const std::filesystem::path& path)
+{
+    std::ifstream file(path, std::ios::binary);
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
+}
+
+Incremental_Shader_Builder::Incremental_Shader_Builder(
+    rhi::Graphics_Device* graphics_device,
+    Shader_Compile_Service* compile_service)
+    : m_graphics_device(graphics_device)
+    , m_compile_service(compile_service)
+    , m_shaders()
+    , m_files()
+{}
+
+void Incremental_Shader_Builder::add_shader(
+    rhi::Shader_Blob* shader_blob,
+    const std::filesystem::path& source_path,
+    const Shader_Compiler_Settings& settings,
+    const Shader_Compile_Info& compile_info)
+{
+    // Canonical like the include paths recorded by the compiler, so a source included elsewhere is one node.
+    std::error_code error;
+    auto canonical_path = std::filesystem::weakly_canonical(source_path, error);
+
+    auto& shader = m_shaders[shader_blob];
+    shader.source_path = error ? source_path : canonical_path;
+    shader.settings = settings;
+    shader.compile_info = compile_info;
+    shader.compile_info.data = nullptr;
+    shader.compile_info.data_size = 0;
+    shader.is_dirty = true;
+}
+
+void Incremental_Shader_Builder::remove_shader(rhi::Shader_Blob* shader_blob)
+{
+    auto it = m_shaders.find(shader_blob);
+    if (it == m_shaders.end()) return;
+
+    set_dependencies(shader_blob, it->second, {}, {}, std::filesystem::file_time_type::min());
+    m_shaders.erase(it);
+}
+
+std::vector<rhi::Shader_Blob*> Incremental_Shader_Builder::rebuild()
+{
+    // Every file is checked once, no matter how many shaders include it.
+    for (auto& [path, file] : m_files)
+    {
+        auto last_write_time = get_last_write_time(path);
+        if (last_write_time == file.last_write_time) continue;
+
+        file.last_write_time = last_write_time;
+        for (auto shader_blob : file.dependents)
+        {
+            m_shaders.at(shader_blob).is_dirty = true;
+        }
+    }
+
+    // Times of the files a compile is known to read are taken before it starts, edits made while it runs trigger
+    // the next rebuild. Includes only discovered by the compile are compared against its start instead.
+    auto compile_start_time = std::filesystem::file_time_type::clock::now();
+    std::map<std::filesystem::path, std::filesystem::file_time_type> last_write_times;
+    std::vector<rhi::Shader_Blob*> dirty_blobs;
+    std::vector<std::string> sources;
+    for (auto& [shader_blob, shader] : m_shaders)
+    {
+        if (!shader.is_dirty) continue;
+
+        shader.is_dirty = false;
+        dirty_blobs.push_back(shader_blob);
+        last_write_times.try_emplace(shader.source_path, get_last_write_time(shader.source_path));
+        for (const auto& path : shader.dependencies)
+        {
+            last_write_times.try_emplace(path, get_last_write_time(path));
+        }
+        sources.push_back(read_source_file(shader.source_path));
+    }
+    if (dirty_blobs.empty())
+    {
+        return {};
+    }
+
+    std::vector<Shader_Compile_Job> jobs;
+    jobs.reserve(dirty_blobs.size());
+    for (auto i = 0ull; i < dirty_blobs.size(); ++i)
+    {
+        const auto& shader = m_shaders.at(dirty_blobs[i]);
+        auto& job = jobs.emplace_back(Shader_Compile_Job{ .settings = &shader.settings, .compile_info = shader.compile_info });
+        job.compile_info.data = sources[i].data();
+        job.compile_info.data_size = sources[i].size();
+    }
+    auto shaders = m_compile_service->compile(jobs);
+
+    std::vector<rhi::Shader_Blob*> recreated_blobs;
+    for (auto i = 0ull; i < dirty_blobs.size(); ++i)
+    {
+        auto shader_blob = dirty_blobs[i];
+        auto& tracked_shader = m_shaders.at(shader_blob);
+        auto& shader = shaders[i];
+        bool compiled = !shader.dxil.empty() && !shader.spirv.empty();
+
+        auto dependencies = std::move(shader.includes);
+        dependencies.push_back(tracked_shader.source_path);
+        if (!compiled)
+        {
+            // The failed compile may have stopped before reaching some includes, a fix to any of them has to retry.
+            dependencies.insert(dependencies.end(), tracked_shader.dependencies.begin(), tracked_shader.dependencies.end());
+        }
+        deduplicate_includes(dependencies);
+        set_dependencies(shader_blob, tracked_shader, std::move(dependencies), last_write_times, compile_start_time);
+        if (!compiled) continue;
+
+        auto container = shader.serialize();
+        auto result = m_graphics_device->recreate_shader_blob_deserialize_memory(
+            shader_blob, container.data(), container.size());
+        if (result == rhi::Result::Success)
+        {
+            recreated_blobs.push_back(shader_blob);
+        }
+    }
+    return recreated_blobs;
+}
+
+void Incremental_Shader_Builder::set_dependencies(
+    rhi::Shader_Blob* shader_blob,
+    Tracked_Shader& shader,
+    std::vector<std::filesystem::path>&& dependencies,
+    const std::map<std::filesystem::path, std::filesystem::file_time_type>& last_write_times,
+    std::filesystem::file_time_type compile_start_time)
+{
+    // New edges are added first, files that stay tracked keep the time of the last check,
+    // so edits made while the shader was compiling are picked up by the next rebuild.
+    for (const auto& path : dependencies)
+    {
+        auto [it, inserted] = m_files.try_emplace(path);
+        if (inserted)
+        {
+            auto last_write_time = last_write_times.find(path);
+            if (last_write_time != last_write_times.end())
+            {
+                it->second.last_write_time = last_write_time->second;
+            }
+            else
+            {
+                // A time after the start may be an edit the compile did not see, `min` forces a rebuild.
+                auto current_write_time = get_last_write_time(path);
+                it->second.last_write_time = current_write_time < compile_start_time
+                    ? current_write_time
+                    : std::filesystem::file_time_type::min();
+            }
+        }
+        it->second.dependents.insert(shader_blob);
+    }
+
+    // Both lists are sorted.
+    for (const auto& path : shader.dependencies)
+    {
+        if (std::ranges::binary_search(dependencies, path)) continue;
+
+        auto it = m_files.find(path);
+        if (it == m_files.end()) continue;
+
+        it->second.dependents.erase(shader_blob);
+        if (it->second.dependents.empty())
+        {
+            m_files.erase(it);
+        }
+    }
+    shader.dependencies = std::move(dependencies);
+}
+}
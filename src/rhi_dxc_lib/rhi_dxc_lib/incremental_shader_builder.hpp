@@ -0,0 +1,66 @@
+#pragma once
+
+#include "rhi_dxc_lib/shader_compile_service.hpp"
+
+#include <rhi/graphics_device.hpp>
+
+#include <filesystem>
+#include <map>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace rhi::dxc
+{
+// Keeps shader blobs in sync with their sources on disk. The include graph of every shader is recorded
+// while it is compiled, so a changed file only recompiles the shaders that transitively include it.
+class Incremental_Shader_Builder
+{
+public:
+    Incremental_Shader_Builder(rhi::Graphics_Device* graphics_device, Shader_Compile_Service* compile_service);
+
+    // `compile_info.data` is ignored, the source is read from `source_path`. The shader is compiled by the next `rebuild`.
+    void add_shader(
+        rhi::Shader_Blob* shader_blob,
+        const std::filesystem::path& source_path,
+        const Shader_Compiler_Settings& settings,
+        const Shader_Compile_Info& compile_info);
+    void remove_shader(rhi::Shader_Blob* shader_blob);
+
+    // Recompiles the shaders added since the last call and the shaders whose source or includes changed on disk,
+    // then recreates their blobs. Shaders that fail to compile keep their previous blob.
+    // Returns the recreated blobs, pipelines using them have to be recreated to pick up the changes.
+    // The synchronization rules of `Graphics_Device::recreate_shader_blob` apply.
+    std::vector<rhi::Shader_Blob*> rebuild();
+
+private:
+    struct Tracked_Shader
+    {
+        std::filesystem::path source_path;
+        Shader_Compiler_Settings settings;
+        Shader_Compile_Info compile_info;
+        std::vector<std::filesystem::path> dependencies; // The source and every transitive include.
+        bool is_dirty;
+    };
+
+    struct Tracked_File
+    {
+        std::filesystem::file_time_type last_write_time;
+        std::unordered_set<rhi::Shader_Blob*> dependents;
+    };
+
+    void set_dependencies(
+        rhi::Shader_Blob* shader_blob,
+        Tracked_Shader& shader,
+        std::vector<std::filesystem::path>&& dependencies,
+        const std::map<std::filesystem::path, std::filesystem::file_time_type>& last_write_times,
+        std::filesystem::file_time_type compile_start_time);
+
+private:
+    rhi::Graphics_Device* m_graphics_device;
+    Shader_Compile_Service* m_compile_service;
+    std::unordered_map<rhi::Shader_Blob*, Tracked_Shader> m_shaders;
+    // Reverse edges of the include graph.
+    std::map<std::filesystem::path, Tracked_File> m_files;
+};
+}
@@ -0,0 +1,287 @@
+#include "rhi_dxc_lib/shader_compile_service.hpp"
+
+#include <rhi/shader_container.hpp>
+#include <rhi/common/hash.hpp>
+
+#include <algorithm>
+#include <array>
+#include <fstream>
+#include <functional>
+#include <latch>
+#include <string>
+#include <thread>
+
+namespace rhi::dxc
+{
+constexpr static std::array<Shader_Target, 2> SHADER_TARGETS = { Shader_Target::DXIL, Shader_Target::SPIRV };
+
+uint32_t get_service_thread_count(uint32_t thread_count)
+{
+    return thread_count > 0 ? thread_count : std::max(std::thread::hardware_concurrency(), 1u);
+}
+
+Shader_Compile_Service::Shader_Compile_Service(const Shader_Compile_Service_Create_Info& create_info)
+    : m_cache_directory(create_info.cache_directory)
+    , m_compiler_version(0)
+    , m_compiler_mutex()
+    , m_compilers()
+    , m_free_compilers()
+    , m_thread_pool(get_service_thread_count(create_info.thread_count))
+{
+    // At most one task per worker runs at a time, so a compiler per worker never leaves a task waiting.
+    for (auto i = 0u; i < m_thread_pool.get_thread_count(); ++i)
+    {
+        m_free_compilers.push_back(m_compilers.emplace_back(std::make_unique<Shader_Compiler>()).get());
+    }
+    m_compiler_version = m_compilers.front()->get_version();
+
+    if (!m_cache_directory.empty())
+    {
+        std::error_code error;
+        std::filesystem::create_directories(m_cache_directory, error);
+    }
+}
+
+Shader_Compile_Service::~Shader_Compile_Service() = default;
+
+std::vector<Shader> Shader_Compile_Service::compile(
+    const Shader_Compiler_Settings& settings,
+    std::span<const Shader_Compile_Info> compile_infos)
+{
+    std::vector<Shader_Compile_Job> jobs;
+    jobs.reserve(compile_infos.size());
+    for (const auto& compile_info : compile_infos)
+    {
+        jobs.push_back({ .settings = &settings, .compile_info = compile_info });
+    }
+    return compile(jobs);
+}
+
+std::vector<Shader> Shader_Compile_Service::compile(std::span<const Shader_Compile_Job> jobs)
+{
+    std::vector<Shader> shaders(jobs.size());
+    // Both targets write disjoint members of the same shader, their includes are merged once both finished.
+    std::vector<std::vector<std::filesystem::path>> target_includes(jobs.size() * SHADER_TARGETS.size());
+    auto failed = std::make_unique<std::atomic<bool>[]>(jobs.size());
+    run_tasks(jobs.size() * SHADER_TARGETS.size(), [&](std::size_t task_index) {
+        auto i = task_index / SHADER_TARGETS.size();
+        const auto& job = jobs[i];
+        if (!compile_target(*job.settings, job.compile_info, SHADER_TARGETS[task_index % SHADER_TARGETS.size()], shaders[i], target_includes[task_index]))
+        {
+            failed[i].store(true, std::memory_order_relaxed);
+        }
+    });
+
+    for (auto i = 0ull; i < shaders.size(); ++i)
+    {
+        if (failed[i].load(std::memory_order_relaxed))
+        {
+            shaders[i] = Shader();
+        }
+        for (auto j = 0ull; j < SHADER_TARGETS.size(); ++j)
+        {
+            auto& includes = target_includes[i * SHADER_TARGETS.size() + j];
+            shaders[i].includes.insert(shaders[i].includes.end(), includes.begin(), includes.end());
+        }
+        deduplicate_includes(shaders[i].includes);
+    }
+    return shaders;
+}
+
+std::vector<std::optional<uint64_t>> Shader_Compile_Service::hash_preprocessed(std::span<const Shader_Compile_Job> jobs)
+{
+    // The SPIR-V target defines `__spirv__`, so both preprocessed sources have to match.
+    std::vector<std::optional<uint64_t>> target_hashes(jobs.size() * SHADER_TARGETS.size());
+    run_tasks(jobs.size() * SHADER_TARGETS.size(), [&](std::size_t task_index) {
+        const auto& job = jobs[task_index / SHADER_TARGETS.size()];
+        auto compiler = acquire_compiler();
+        auto preprocessed = compiler->preprocess(*job.settings, job.compile_info, SHADER_TARGETS[task_index % SHADER_TARGETS.size()]);
+        release_compiler(compiler);
+        if (!preprocessed.empty())
+        {
+            target_hashes[task_index] = rhi::hash_bytes(preprocessed.data(), preprocessed.size());
+        }
+    });
+
+    std::vector<std::optional<uint64_t>> hashes(jobs.size());
+    for (auto i = 0ull; i < jobs.size(); ++i)
+    {
+        const auto& dxil_hash = target_hashes[i * SHADER_TARGETS.size()];
+        const auto& spirv_hash = target_hashes[i * SHADER_TARGETS.size() + 1];
+        if (dxil_hash && spirv_hash)
+        {
+            hashes[i] = rhi::hash_value(*spirv_hash, *dxil_hash);
+        }
+    }
+    return hashes;
+}
+
+void Shader_Compile_Service::run_tasks(std::size_t task_count, const std::function<void(std::size_t)>& task)
+{
+    std::latch remaining_tasks(static_cast<std::ptrdiff_t>(task_count));
+    for (auto i = 0ull; i < task_count; ++i)
+    {
+        m_thread_pool.enqueue([&task, &remaining_tasks, i] {
+            task(i);
+            remaining_tasks.count_down();
+        });
+    }
+    remaining_tasks.wait();
+}
+
+bool Shader_Compile_Service::compile_target(
+    const Shader_Compiler_Settings& settings,
+    const Shader_Compile_Info& compile_info,
+    Shader_Target target,
+    Shader& shader,
+    std::vector<std::filesystem::path>& includes)
+{
+    auto compiler = acquire_compiler();
+    bool success = false;
+    if (m_cache_directory.empty())
+    {
+        success = compiler->compile_target(settings, compile_info, target, shader, &includes);
+        release_compiler(compiler);
+        return success;
+    }
+
+    // The preprocessed source already contains every resolved include and define.
+    auto preprocessed = compiler->preprocess(settings, compile_info, target, &includes);
+    if (preprocessed.empty())
+    {
+        release_compiler(compiler);
+        return false;
+    }
+    auto key = rhi::hash_bytes(preprocessed.data(), preprocessed.size());
+    for (const auto& argument : get_compile_args(settings, compile_info, target))
+    {
+        key = rhi::hash_bytes(argument.data(), argument.size() * sizeof(wchar_t), key);
+    }
+    key = rhi::hash_value(m_compiler_version, key);
+    key = rhi::hash_value(uint32_t(target), key);
+
+    success = load_cached_target(key, target, shader);
+    if (!success)
+    {
+        success = compiler->compile_target(settings, compile_info, target, shader);
+        if (success)
+        {
+            store_cached_target(key, target, shader);
+        }
+    }
+    release_compiler(compiler);
+    return success;
+}
+
+Shader_Compiler* Shader_Compile_Service::acquire_compiler()
+{
+    std::unique_lock<std::mutex> lock_guard(m_compiler_mutex);
+    auto compiler = m_free_compilers.back();
+    m_free_compilers.pop_back();
+    return compiler;
+}
+
+void Shader_Compile_Service::release_compiler(Shader_Compiler* compiler)
+{
+    std::unique_lock<std::mutex> lock_guard(m_compiler_mutex);
+    m_free_compilers.push_back(compiler);
+}
+
+std::filesystem::path Shader_Compile_Service::get_cache_path(uint64_t key) const
+{
+    return m_cache_directory / (std::to_string(key) + ".rtsc");
+}
+
+bool Shader_Compile_Service::load_cached_target(uint64_t key, Shader_Target target, Shader& shader) const
+{
+    std::ifstream file(get_cache_path(key), std::ios::binary | std::ios::ate);
+    if (!file)
+    {
+        return false;
+    }
+    std::vector<uint8_t> data(std::size_t(file.tellg()));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), std::streamsize(data.size())))
+    {
+        return false;
+    }
+
+    // Corrupted entries fail validation and are simply recompiled and overwritten.
+    auto contents = rhi::read_shader_container(data);
+    if (!contents)
+    {
+        return false;
+    }
+    if (target == Shader_Target::DXIL)
+    {
+        // Entries written before reflection was stored are recompiled.
+        if (contents->dxil.empty() || contents->reflection.empty()) return false;
+        auto stage_reflection = rhi::read_shader_reflection(contents->reflection);
+        if (!stage_reflection) return false;
+        shader.reflection = {
+            .workgroups_x = contents->groups_x,
+            .workgroups_y = contents->groups_y,
+            .workgroups_z = contents->groups_z,
+            .stage = std::move(*stage_reflection)
+        };
+        shader.dxil.assign(contents->dxil.begin(), contents->dxil.end());
+    }
+    else
+    {
+        if (contents->spirv.empty()) return false;
+        shader.spirv.assign(contents->spirv.begin(), contents->spirv.end());
+    }
+    return true;
+}
+
+void Shader_Compile_Service::store_cached_target(uint64_t key, Shader_Target target, const Shader& shader) const
+{
+    rhi::Shader_Container_Contents contents = {};
+    std::vector<uint8_t> stage_reflection;
+    if (target == Shader_Target::DXIL)
+    {
+        auto written_reflection = rhi::write_shader_reflection(shader.reflection.stage);
+        if (!written_reflection)
+        {
+            return;
+        }
+        stage_reflection = std::move(*written_reflection);
+        contents.groups_x = shader.reflection.workgroups_x;
+        contents.groups_y = shader.reflection.workgroups_y;
+        contents.groups_z = shader.reflection.workgroups_z;
+        contents.dxil = shader.dxil;
+        contents.reflection = stage_reflection;
+    }
+    else
+    {
+        contents.spirv = shader.spirv;
+    }
+    auto container = rhi::write_shader_container(contents);
+    if (!container)
+    {
+        return;
+    }
+
+    // Identical shaders may be stored by two workers at once, each writes its own temporary file.
+    auto path = get_cache_path(key);
+    auto temp_path = path;
+    temp_path += "." + std::to_string(std::hash<std::thread::id>()(std::this_thread::get_id())) + ".tmp";
+    bool written = false;
+    {
+        std::ofstream file(temp_path, std::ios::binary | std::ios::trunc);
+        written = file.write(reinterpret_cast<const char*>(container->data()), std::streamsize(container->size()))
+            && file.flush();
+    }
+    std::error_code error;
+    if (!written)
+    {
+        std::filesystem::remove(temp_path, error);
+        return;
+    }
+    std::filesystem::rename(temp_path, path, error);
+    if (error)
+    {
+        std::filesystem::remove(temp_path, error);
+    }
+}
+}
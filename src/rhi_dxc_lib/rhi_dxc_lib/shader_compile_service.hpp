@@ -0,0 +1,79 @@
+#pragma once
+
+#include "rhi_dxc_lib/shader_compiler.hpp"
+
+#include <rhi/common/thread_pool.hpp>
+
+#include <atomic>
+#include <filesystem>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <vector>
+
+namespace rhi::dxc
+{
+struct Shader_Compile_Service_Create_Info
+{
+    uint32_t thread_count; // Zero uses every hardware thread.
+    std::filesystem::path cache_directory; // Empty disables the disk cache.
+};
+
+struct Shader_Compile_Job
+{
+    const Shader_Compiler_Settings* settings;
+    Shader_Compile_Info compile_info;
+};
+
+// Compiles batches of shaders on a thread pool, each worker owns its own `Shader_Compiler`.
+// DXIL and SPIR-V of a shader are compiled as separate tasks, so both run concurrently.
+// Each target is cached on disk, keyed by its preprocessed source, the compile arguments and the compiler version.
+class Shader_Compile_Service
+{
+public:
+    explicit Shader_Compile_Service(const Shader_Compile_Service_Create_Info& create_info);
+    ~Shader_Compile_Service();
+
+    Shader_Compile_Service(const Shader_Compile_Service&) = delete;
+    Shader_Compile_Service& operator=(const Shader_Compile_Service&) = delete;
+
+    // Thread safe, blocks until the whole batch is compiled. The results are in the order of `compile_infos`.
+    // Shaders that failed to compile for either target are returned empty, like with `Shader_Compiler::compile_from_memory`.
+    // Only their `includes` are kept, so a fix to any included file can be detected.
+    std::vector<Shader> compile(
+        const Shader_Compiler_Settings& settings,
+        std::span<const Shader_Compile_Info> compile_infos);
+    // Like the above, with separate settings per shader.
+    std::vector<Shader> compile(std::span<const Shader_Compile_Job> jobs);
+    // Thread safe, hashes the preprocessed DXIL and SPIR-V sources of every job without compiling them.
+    // Jobs with equal hashes compile to identical shaders. Jobs that failed to preprocess have no hash.
+    std::vector<std::optional<uint64_t>> hash_preprocessed(std::span<const Shader_Compile_Job> jobs);
+
+private:
+    // Runs `task(i)` for every `i` below `task_count` on the workers and waits for all of them.
+    void run_tasks(std::size_t task_count, const std::function<void(std::size_t)>& task);
+    bool compile_target(
+        const Shader_Compiler_Settings& settings,
+        const Shader_Compile_Info& compile_info,
+        Shader_Target target,
+        Shader& shader,
+        std::vector<std::filesystem::path>& includes);
+    [[nodiscard]] Shader_Compiler* acquire_compiler();
+    void release_compiler(Shader_Compiler* compiler);
+
+    [[nodiscard]] std::filesystem::path get_cache_path(uint64_t key) const;
+    bool load_cached_target(uint64_t key, Shader_Target target, Shader& shader) const;
+    void store_cached_target(uint64_t key, Shader_Target target, const Shader& shader) const;
+
+private:
+    std::filesystem::path m_cache_directory;
+    uint64_t m_compiler_version;
+    std::mutex m_compiler_mutex;
+    std::vector<std::unique_ptr<Shader_Compiler>> m_compilers;
+    std::vector<Shader_Compiler*> m_free_compilers;
+    // Declared last, the workers are joined before the compilers are destroyed.
+    rhi::Thread_Pool m_thread_pool;
+};
+}
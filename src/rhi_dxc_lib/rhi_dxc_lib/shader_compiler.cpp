@@ -1,50 +1,122 @@
 #include "rhi_dxc_lib/shader_compiler.hpp"
 
+#include <rhi/shader_container.hpp>
 #include <directx_shader_compiler/inc/d3d12shader.h>
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+
 namespace rhi::dxc
 {
 using Microsoft::WRL::ComPtr;
 
-constexpr std::vector<std::wstring> get_default_compile_args()
+// Built once, the argument lists never change between compiles.
+const std::vector<const wchar_t*>& get_default_compile_args()
 {
-    std::vector<std::wstring> result = {};
-    result.push_back(L"-enable-16bit-types");
-    result.push_back(L"-HV");
-    result.push_back(L"2021");
-    result.push_back(L"-O3");
+    static const std::vector<const wchar_t*> result = {
+        L"-enable-16bit-types",
+        L"-HV",
+        L"2021",
+        L"-O3"
+    };
     return result;
 }
 
-constexpr std::vector<const wchar_t*> get_spirv_args()
+const std::vector<const wchar_t*>& get_spirv_args()
 {
-    std::vector<const wchar_t*> result = {};
-    result.push_back(L"-spirv");
-    result.push_back(L"-fspv-target-env=vulkan1.3");
-    result.push_back(L"-fvk-use-dx-position-w");
-    result.push_back(L"-fvk-use-dx-layout");
-    result.push_back(L"-fvk-bind-resource-heap");
-    result.push_back(L"0"); // binding 0
-    result.push_back(L"0"); // set 0
-    result.push_back(L"-fvk-bind-sampler-heap");
-    result.push_back(L"2"); // binding 2
-    result.push_back(L"0"); // set 0
-    result.push_back(L"-fspv-extension=SPV_EXT_descriptor_indexing");
-    result.push_back(L"-fvk-support-nonzero-base-instance");
-    result.push_back(L"-fvk-support-nonzero-base-vertex");
-    // result.push_back(L"-fspv-extension=SPV_EXT_descriptor_heap");
-    // result.push_back(L"-fspv-use-descriptor-heap");
-    // result.push_back(L"-fspv-extension=SPV_KHR_untyped_pointers");
-    result.push_back(L"-fspv-extension=SPV_KHR_16bit_storage");
+    static const std::vector<const wchar_t*> result = {
+        L"-spirv",
+        L"-fspv-target-env=vulkan1.3",
+        L"-fvk-use-dx-position-w",
+        L"-fvk-use-dx-layout",
+        L"-fvk-bind-resource-heap",
+        L"0", // binding 0
+        L"0", // set 0
+        L"-fvk-bind-sampler-heap",
+        L"2", // binding 2
+        L"0", // set 0
+        L"-fspv-extension=SPV_EXT_descriptor_indexing",
+        L"-fvk-support-nonzero-base-instance",
+        L"-fvk-support-nonzero-base-vertex",
+        // L"-fspv-extension=SPV_EXT_descriptor_heap",
+        // L"-fspv-use-descriptor-heap",
+        // L"-fspv-extension=SPV_KHR_untyped_pointers",
+        L"-fspv-extension=SPV_KHR_16bit_storage"
+    };
     return result;
 }
 
+// Resolves includes like the default handler and records every file it opened.
+// It lives on the stack for the duration of a single compile, so reference counting is a no-op.
+class Recording_Include_Handler final : public IDxcIncludeHandler
+{
+public:
+    Recording_Include_Handler(IDxcUtils* utils, std::vector<std::filesystem::path>* includes)
+        : m_utils(utils)
+        , m_includes(includes)
+    {}
+
+    HRESULT STDMETHODCALLTYPE LoadSource(LPCWSTR filename, IDxcBlob** include_source) override
+    {
+        ComPtr<IDxcBlobEncoding> source = nullptr;
+        auto result = m_utils->LoadFile(filename, nullptr, source.GetAddressOf());
+        if (FAILED(result))
+        {
+            // DXC probes every include directory, only files that exist are dependencies.
+            return result;
+        }
+        if (m_includes != nullptr)
+        {
+            std::error_code error;
+            auto path = std::filesystem::weakly_canonical(filename, error);
+            m_includes->push_back(error ? std::filesystem::path(filename) : path);
+        }
+        *include_source = source.Detach();
+        return S_OK;
+    }
+
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** object) override
+    {
+        if (riid == __uuidof(IDxcIncludeHandler) || riid == __uuidof(IUnknown))
+        {
+            *object = this;
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override
+    {
+        return 1;
+    }
+
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        return 1;
+    }
+
+private:
+    IDxcUtils* m_utils;
+    std::vector<std::filesystem::path>* m_includes;
+};
+
+void deduplicate_includes(std::vector<std::filesystem::path>& includes)
+{
+    std::ranges::sort(includes);
+    auto duplicates = std::ranges::unique(includes);
+    includes.erase(duplicates.begin(), duplicates.end());
+}
+
 Shader_Compiler::Shader_Compiler()
     : m_compiler()
     , m_utils()
+    , m_container_reflection()
 {
     DxcCreateInstance(CLSID_DxcUtils, IID_PPV_ARGS(&m_utils));
     DxcCreateInstance(CLSID_DxcCompiler, IID_PPV_ARGS(&m_compiler));
+    DxcCreateInstance(CLSID_DxcContainerReflection, IID_PPV_ARGS(&m_container_reflection));
 }
 
 std::wstring shader_model_from_args(Shader_Type type, Shader_Version version)
@@ -99,21 +171,13 @@ std::wstring shader_model_from_args(Shader_Type type, Shader_Version version)
     return shader_model_string;
 }
 
-Shader Shader_Compiler::compile_from_memory(
+std::vector<std::wstring> get_compile_args(
     const Shader_Compiler_Settings& settings,
-    const Shader_Compile_Info& compile_info)
+    const Shader_Compile_Info& compile_info,
+    Shader_Target target)
 {
-    Shader result = {};
-
-    ComPtr<IDxcResult> result_dxil = nullptr;
-    ComPtr<IDxcResult> result_spirv = nullptr;
-
-    std::vector<const wchar_t*> arguments_wchar_ptr = {};
     std::vector<std::wstring> arguments = {};
 
-    ComPtr<IDxcIncludeHandler> include_handler;
-    m_utils->CreateDefaultIncludeHandler(include_handler.GetAddressOf());
-
     for (const auto& argument : settings.defines)
     {
         arguments.emplace_back(L"-D");
@@ -148,53 +212,225 @@ Shader Shader_Compiler::compile_from_memory(
         arguments.emplace_back(L"-Qsource_in_debug_module");
     }
 
-    arguments_wchar_ptr.reserve(arguments.size());
-    for (const auto& arg : arguments)
+    const auto& default_args = get_default_compile_args();
+    arguments.insert(arguments.end(), default_args.begin(), default_args.end());
+
+    if (target == Shader_Target::DXIL)
     {
-        arguments_wchar_ptr.push_back(arg.c_str());
+        return arguments;
     }
 
-    const auto default_args = get_default_compile_args();
-    for (const auto& arg : default_args)
+    const auto& spv_args = get_spirv_args();
+    arguments.insert(arguments.end(), spv_args.begin(), spv_args.end());
+
+    switch (compile_info.shader_type)
     {
-        arguments_wchar_ptr.push_back(arg.c_str());
+    case Shader_Type::Mesh:
+        arguments.emplace_back(L"-fspv-extension=SPV_EXT_mesh_shader");
+        [[fallthrough]];
+    case Shader_Type::Vertex:
+        arguments.emplace_back(L"-fvk-invert-y");
+        break;
+    case Shader_Type::Compute:
+        arguments.emplace_back(L"-fspv-extension=SPV_KHR_ray_query");
+        break;
+    case Shader_Type::Ray_Gen:
+        [[fallthrough]];
+    case Shader_Type::Ray_Any_Hit:
+        [[fallthrough]];
+    case Shader_Type::Ray_Closest_Hit:
+        [[fallthrough]];
+    case Shader_Type::Ray_Miss:
+        [[fallthrough]];
+    case Shader_Type::Ray_Intersection:
+        [[fallthrough]];
+    case Shader_Type::Ray_Callable:
+        arguments.emplace_back(L"-fvk-invert-y");
+        arguments.emplace_back(L"-fspv-extension=SPV_KHR_ray_tracing");
+        break;
+    default:
+        break;
     }
 
-    DxcBuffer source = {
-        .Ptr = compile_info.data,
-        .Size = compile_info.data_size,
-        .Encoding = DXC_CP_ACP
+    if (compile_info.embed_debug)
+    {
+        // arguments.emplace_back(L"-fspv-debug=vulkan-with-source");
+    }
+    return arguments;
+}
+
+const char* get_target_name(Shader_Target target)
+{
+    return target == Shader_Target::DXIL ? "dxil" : "spirv";
+}
+
+namespace
+{
+rhi::Shader_System_Value translate_system_value(D3D_NAME system_value)
+{
+    switch (system_value)
+    {
+    case D3D_NAME_UNDEFINED:
+        return rhi::Shader_System_Value::None;
+    case D3D_NAME_POSITION:
+        return rhi::Shader_System_Value::Position;
+    case D3D_NAME_TARGET:
+        return rhi::Shader_System_Value::Target;
+    case D3D_NAME_DEPTH:
+        [[fallthrough]];
+    case D3D_NAME_DEPTH_GREATER_EQUAL:
+        [[fallthrough]];
+    case D3D_NAME_DEPTH_LESS_EQUAL:
+        return rhi::Shader_System_Value::Depth;
+    default:
+        return rhi::Shader_System_Value::Other;
+    }
+}
+
+rhi::Shader_Signature_Element translate_signature_element(const D3D12_SIGNATURE_PARAMETER_DESC& desc, bool is_input)
+{
+    return {
+        .semantic_hash = rhi::hash_shader_semantic(desc.SemanticName),
+        .semantic_index = desc.SemanticIndex,
+        .system_value = translate_system_value(desc.SystemValueType),
+        // `ReadWriteMask` holds the components an input reads, but those an output does not always write.
+        .component_mask = is_input ? desc.ReadWriteMask : desc.Mask,
+        .reserved = 0
     };
+}
 
-    m_compiler->Compile(
-        &source,
-        arguments_wchar_ptr.data(),
-        arguments_wchar_ptr.size(),
-        include_handler.Get(),
-        IID_PPV_ARGS(&result_dxil));
+void reflect_stage(ID3D12ShaderReflection* d3d12_reflection, rhi::Shader_Reflection& reflection)
+{
+    D3D12_SHADER_DESC shader_desc = {};
+    if (FAILED(d3d12_reflection->GetDesc(&shader_desc)))
+    {
+        return;
+    }
+    reflection.flags = rhi::Shader_Reflection_Flags::Valid;
+
+    auto requires_flags = d3d12_reflection->GetRequiresFlags();
+    if (requires_flags & D3D_SHADER_REQUIRES_NATIVE_16BIT_OPS)
+    {
+        reflection.flags = reflection.flags | rhi::Shader_Reflection_Flags::Uses_16_Bit_Types;
+    }
+    // Heap indices are only known at runtime, usually from push constants, so only the heaps are recorded.
+    if (requires_flags & D3D_SHADER_REQUIRES_RESOURCE_DESCRIPTOR_HEAP_INDEXING)
+    {
+        reflection.flags = reflection.flags | rhi::Shader_Reflection_Flags::Uses_Resource_Heap;
+    }
+    if (requires_flags & D3D_SHADER_REQUIRES_SAMPLER_DESCRIPTOR_HEAP_INDEXING)
+    {
+        reflection.flags = reflection.flags | rhi::Shader_Reflection_Flags::Uses_Sampler_Heap;
+    }
+
+    for (auto i = 0u; i < shader_desc.BoundResources; ++i)
+    {
+        D3D12_SHADER_INPUT_BIND_DESC bind_desc = {};
+        d3d12_reflection->GetResourceBindingDesc(i, &bind_desc);
+        // Push constants are the root constants at `b0, space0`, see `DECLARE_PUSH_CONSTANTS`.
+        if (bind_desc.Type == D3D_SIT_CBUFFER && bind_desc.BindPoint == 0 && bind_desc.Space == 0)
+        {
+            D3D12_SHADER_BUFFER_DESC buffer_desc = {};
+            d3d12_reflection->GetConstantBufferByName(bind_desc.Name)->GetDesc(&buffer_desc);
+            reflection.push_constant_size = buffer_desc.Size;
+        }
+    }
 
-    ComPtr<IDxcBlobUtf8> dxil_errors = nullptr;
-    result_dxil->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&dxil_errors), nullptr);
-    if (dxil_errors != nullptr && dxil_errors->GetStringLength() != 0)
+    reflection.inputs.reserve(shader_desc.InputParameters);
+    for (auto i = 0u; i < shader_desc.InputParameters; ++i)
     {
-        wprintf(L"DXC Warnings and Errors (dxil):\n%S\n", dxil_errors->GetStringPointer());
+        D3D12_SIGNATURE_PARAMETER_DESC parameter_desc = {};
+        d3d12_reflection->GetInputParameterDesc(i, &parameter_desc);
+        reflection.inputs.push_back(translate_signature_element(parameter_desc, true));
     }
-    HRESULT dxil_compile_status = S_OK;
-    result_dxil->GetStatus(&dxil_compile_status);
-    if (FAILED(dxil_compile_status))
+    reflection.outputs.reserve(shader_desc.OutputParameters);
+    for (auto i = 0u; i < shader_desc.OutputParameters; ++i)
+    {
+        D3D12_SIGNATURE_PARAMETER_DESC parameter_desc = {};
+        d3d12_reflection->GetOutputParameterDesc(i, &parameter_desc);
+        reflection.outputs.push_back(translate_signature_element(parameter_desc, false));
+    }
+}
+
+// The wave size is not part of the shader reflection, DXC records it in the pipeline state validation part.
+void reflect_wave_size(IDxcContainerReflection* container_reflection, IDxcBlob* dxil, rhi::Shader_Reflection& reflection)
+{
+    UINT32 part_index = 0;
+    ComPtr<IDxcBlob> part = nullptr;
+    if (container_reflection == nullptr
+        || FAILED(container_reflection->Load(dxil))
+        || FAILED(container_reflection->FindFirstPartKind(DXC_PART_PIPELINE_STATE_VALIDATION, &part_index))
+        || FAILED(container_reflection->GetPartContent(part_index, &part)))
+    {
+        return;
+    }
+
+    // The part starts with the size of `PSVRuntimeInfo0`, which ends with the expected wave lane count range
+    // after a 16 byte union of stage specific information.
+    constexpr static std::size_t WAVE_SIZE_OFFSET = sizeof(uint32_t) + 16;
+    uint32_t runtime_info_size = 0;
+    std::array<uint32_t, 2> wave_size = {};
+    if (part->GetBufferSize() < WAVE_SIZE_OFFSET + sizeof(wave_size))
+    {
+        return;
+    }
+    memcpy(&runtime_info_size, part->GetBufferPointer(), sizeof(runtime_info_size));
+    if (runtime_info_size < WAVE_SIZE_OFFSET - sizeof(uint32_t) + sizeof(wave_size))
+    {
+        return;
+    }
+    memcpy(wave_size.data(), static_cast<const uint8_t*>(part->GetBufferPointer()) + WAVE_SIZE_OFFSET, sizeof(wave_size));
+    // Shaders without `[WaveSize]` expect the full range of 0 to ~0u.
+    if (wave_size[0] != 0 && wave_size[1] != ~0u)
+    {
+        reflection.wave_size_min = wave_size[0];
+        reflection.wave_size_max = wave_size[1];
+    }
+}
+}
+
+Shader Shader_Compiler::compile_from_memory(
+    const Shader_Compiler_Settings& settings,
+    const Shader_Compile_Info& compile_info)
+{
+    Shader result = {};
+    if (!compile_target(settings, compile_info, Shader_Target::DXIL, result, &result.includes)
+        || !compile_target(settings, compile_info, Shader_Target::SPIRV, result, &result.includes))
     {
-        printf("DXC Failed to compile shader (dxil).\n");
         return Shader();
     }
+    deduplicate_includes(result.includes);
+    return result;
+}
 
-    ComPtr<IDxcBlob> dxil_blob = nullptr;
-    result_dxil->GetOutput(
+bool Shader_Compiler::compile_target(
+    const Shader_Compiler_Settings& settings,
+    const Shader_Compile_Info& compile_info,
+    Shader_Target target,
+    Shader& shader,
+    std::vector<std::filesystem::path>* includes)
+{
+    auto compile_result = compile(compile_info, get_compile_args(settings, compile_info, target), target, includes);
+    if (compile_result == nullptr)
+    {
+        return false;
+    }
+
+    ComPtr<IDxcBlob> blob = nullptr;
+    compile_result->GetOutput(
         DXC_OUT_OBJECT,
-        IID_PPV_ARGS(dxil_blob.GetAddressOf()),
+        IID_PPV_ARGS(blob.GetAddressOf()),
         nullptr);
 
+    if (target == Shader_Target::SPIRV)
+    {
+        shader.spirv.resize(blob->GetBufferSize());
+        memcpy(shader.spirv.data(), blob->GetBufferPointer(), blob->GetBufferSize());
+        return true;
+    }
+
     ComPtr<IDxcBlob> reflection = nullptr;
-    result_dxil->GetOutput(
+    compile_result->GetOutput(
         DXC_OUT_REFLECTION,
         IID_PPV_ARGS(&reflection),
         nullptr);
@@ -208,121 +444,130 @@ Shader Shader_Compiler::compile_from_memory(
         ComPtr<ID3D12ShaderReflection> d3d12_reflection = nullptr;
         auto reflection_result = m_utils->CreateReflection(&reflection_data, IID_PPV_ARGS(&d3d12_reflection));
 
-        result.reflection = {
+        shader.reflection = {
             .workgroups_x = 0,
             .workgroups_y = 0,
-            .workgroups_z = 0
+            .workgroups_z = 0,
+            .stage = {}
         };
 
         if (SUCCEEDED(reflection_result))
         {
             d3d12_reflection->GetThreadGroupSize(
-                &result.reflection.workgroups_x,
-                &result.reflection.workgroups_y,
-                &result.reflection.workgroups_z);
+                &shader.reflection.workgroups_x,
+                &shader.reflection.workgroups_y,
+                &shader.reflection.workgroups_z);
+            reflect_stage(d3d12_reflection.Get(), shader.reflection.stage);
+            reflect_wave_size(m_container_reflection.Get(), blob.Get(), shader.reflection.stage);
         }
     }
     else
     {
         printf("DXC Warning: Shader reflection failed.\n");
     }
-    auto spv_args = get_spirv_args();
-    arguments_wchar_ptr.insert(arguments_wchar_ptr.end(), spv_args.begin(), spv_args.end());
 
-    switch (compile_info.shader_type)
+    shader.dxil.resize(blob->GetBufferSize());
+    memcpy(shader.dxil.data(), blob->GetBufferPointer(), blob->GetBufferSize());
+    return true;
+}
+
+std::string Shader_Compiler::preprocess(
+    const Shader_Compiler_Settings& settings,
+    const Shader_Compile_Info& compile_info,
+    Shader_Target target,
+    std::vector<std::filesystem::path>* includes)
+{
+    auto arguments = get_compile_args(settings, compile_info, target);
+    arguments.emplace_back(L"-P");
+
+    auto compile_result = compile(compile_info, arguments, target, includes);
+    if (compile_result == nullptr)
     {
-    case Shader_Type::Mesh:
-        arguments_wchar_ptr.push_back(L"-fspv-extension=SPV_EXT_mesh_shader");
-        [[fallthrough]];
-    case Shader_Type::Vertex:
-        arguments_wchar_ptr.push_back(L"-fvk-invert-y");
-        break;
-    case Shader_Type::Compute:
-        arguments_wchar_ptr.push_back(L"-fspv-extension=SPV_KHR_ray_query");
-        break;
-    case Shader_Type::Ray_Gen:
-        [[fallthrough]];
-    case Shader_Type::Ray_Any_Hit:
-        [[fallthrough]];
-    case Shader_Type::Ray_Closest_Hit:
-        [[fallthrough]];
-    case Shader_Type::Ray_Miss:
-        [[fallthrough]];
-    case Shader_Type::Ray_Intersection:
-        [[fallthrough]];
-    case Shader_Type::Ray_Callable:
-        arguments_wchar_ptr.push_back(L"-fvk-invert-y");
-        arguments_wchar_ptr.push_back(L"-fspv-extension=SPV_KHR_ray_tracing");
-        break;
-    default:
-        break;
+        return {};
     }
 
-    if (compile_info.embed_debug)
+    ComPtr<IDxcBlobUtf8> preprocessed = nullptr;
+    compile_result->GetOutput(DXC_OUT_HLSL, IID_PPV_ARGS(&preprocessed), nullptr);
+    if (preprocessed == nullptr)
     {
-        // arguments_wchar_ptr.push_back(L"-fspv-debug=vulkan-with-source");
+        return {};
     }
+    return std::string(preprocessed->GetStringPointer(), preprocessed->GetStringLength());
+}
+
+uint64_t Shader_Compiler::get_version() const
+{
+    ComPtr<IDxcVersionInfo> version_info = nullptr;
+    uint32_t major = 0;
+    uint32_t minor = 0;
+    if (SUCCEEDED(m_compiler.As(&version_info)))
+    {
+        version_info->GetVersion(&major, &minor);
+    }
+    return (uint64_t(major) << 32) | minor;
+}
 
+ComPtr<IDxcResult> Shader_Compiler::compile(
+    const Shader_Compile_Info& compile_info,
+    const std::vector<std::wstring>& arguments,
+    Shader_Target target,
+    std::vector<std::filesystem::path>* includes)
+{
+    std::vector<const wchar_t*> arguments_wchar_ptr = {};
+    arguments_wchar_ptr.reserve(arguments.size());
+    for (const auto& arg : arguments)
+    {
+        arguments_wchar_ptr.push_back(arg.c_str());
+    }
+
+    Recording_Include_Handler include_handler(m_utils.Get(), includes);
+
+    DxcBuffer source = {
+        .Ptr = compile_info.data,
+        .Size = compile_info.data_size,
+        .Encoding = DXC_CP_ACP
+    };
+
+    ComPtr<IDxcResult> result = nullptr;
     m_compiler->Compile(
         &source,
         arguments_wchar_ptr.data(),
-        arguments_wchar_ptr.size(),
-        include_handler.Get(),
-        IID_PPV_ARGS(&result_spirv));
+        uint32_t(arguments_wchar_ptr.size()),
+        &include_handler,
+        IID_PPV_ARGS(&result));
 
-    ComPtr<IDxcBlobUtf8> spirv_errors = nullptr;
-    result_spirv->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&spirv_errors), nullptr);
-    if (spirv_errors != nullptr && spirv_errors->GetStringLength() != 0)
+    ComPtr<IDxcBlobUtf8> errors = nullptr;
+    result->GetOutput(DXC_OUT_ERRORS, IID_PPV_ARGS(&errors), nullptr);
+    if (errors != nullptr && errors->GetStringLength() != 0)
     {
-        wprintf(L"DXC Warnings and Errors (spirv):\n%S\n", spirv_errors->GetStringPointer());
+        wprintf(L"DXC Warnings and Errors (%S):\n%S\n", get_target_name(target), errors->GetStringPointer());
     }
-    HRESULT spirv_compile_status = S_OK;
-    result_spirv->GetStatus(&spirv_compile_status);
-    if (FAILED(spirv_compile_status))
+    HRESULT compile_status = S_OK;
+    result->GetStatus(&compile_status);
+    if (FAILED(compile_status))
     {
-        printf("DXC Failed to compile shader (spirv).\n");
-        return Shader();
+        printf("DXC Failed to compile shader (%s).\n", get_target_name(target));
+        return nullptr;
     }
-
-    ComPtr<IDxcBlob> spirv_blob = {};
-    result_spirv->GetOutput(
-        DXC_OUT_OBJECT,
-        IID_PPV_ARGS(spirv_blob.GetAddressOf()),
-        nullptr);
-
-    result.dxil.resize(dxil_blob->GetBufferSize());
-    memcpy(result.dxil.data(), dxil_blob->GetBufferPointer(), dxil_blob->GetBufferSize());
-    result.spirv.resize(spirv_blob->GetBufferSize());
-    memcpy(result.spirv.data(), spirv_blob->GetBufferPointer(), spirv_blob->GetBufferSize());
     return result;
 }
 
-struct Serialized_Shader_Blob_Sizes
-{
-    uint32_t dxil_size;
-    uint32_t spirv_size;
-};
-
 std::vector<uint8_t> Shader::serialize()
 {
-    std::vector<uint8_t> result{};
-    result.reserve(sizeof(Shader_Reflection_Data) + sizeof(Serialized_Shader_Blob_Sizes) + dxil.size() + spirv.size());
-
-    Serialized_Shader_Blob_Sizes blob_sizes = {
-        .dxil_size = uint32_t(dxil.size()),
-        .spirv_size = uint32_t(spirv.size())
-    };
-
-    auto dst = result.data();
-    memcpy(dst, &reflection, sizeof(Shader_Reflection_Data));
-    dst += sizeof(Shader_Reflection_Data);
-    memcpy(dst, &blob_sizes, sizeof(Serialized_Shader_Blob_Sizes));
-    dst += sizeof(Serialized_Shader_Blob_Sizes);
-    memcpy(dst, dxil.data(), dxil.size());
-    dst += dxil.size();
-    memcpy(dst, spirv.data(), spirv.size());
-
-    return result;
+    auto stage_reflection = rhi::write_shader_reflection(reflection.stage);
+    if (!stage_reflection)
+    {
+        return {};
+    }
+    auto container = rhi::write_shader_container({
+        .groups_x = reflection.workgroups_x,
+        .groups_y = reflection.workgroups_y,
+        .groups_z = reflection.workgroups_z,
+        .dxil = dxil,
+        .spirv = spirv,
+        .reflection = *stage_reflection
+    });
+    return container ? std::move(*container) : std::vector<uint8_t>();
 }
 
 }
@@ -1,14 +1,20 @@
 #pragma once
 
+#include <rhi/shader_reflection.hpp>
+
 #include <wrl.h>
 #include <directx_shader_compiler/inc/dxcapi.h>
+#include <filesystem>
 #include <string>
 #include <vector>
 
 namespace rhi::dxc
 {
-constexpr static auto SERIALIZED_MAGIC_NUM = { 'r', 'h', 'i', '_', 's', 'h', 'a', 'd', 'e', 'r' };
-constexpr static auto SERIALIZED_MAGIC_NUM_SIZE = 10;
+enum class Shader_Target
+{
+    DXIL,
+    SPIRV
+};
 
 enum class Matrix_Majorness
 {
@@ -61,6 +67,7 @@ struct Shader_Reflection_Data
     uint32_t workgroups_x;
     uint32_t workgroups_y;
     uint32_t workgroups_z;
+    rhi::Shader_Reflection stage; // Push constants, descriptor heap usage, wave size and the stage I/O signature.
 };
 
 struct Shader
@@ -68,10 +75,22 @@ struct Shader
     Shader_Reflection_Data reflection;
     std::vector<uint8_t> dxil;
     std::vector<uint8_t> spirv;
+    // Every file opened through `#include` for either target, transitively, sorted and without duplicates.
+    std::vector<std::filesystem::path> includes;
 
+    // Writes an `rhi` shader container, see `rhi/shader_container.hpp`. Returns an empty vector on failure.
     std::vector<uint8_t> serialize();
 };
 
+// Sorts and removes duplicate include paths.
+void deduplicate_includes(std::vector<std::filesystem::path>& includes);
+
+// Every argument passed to DXC for the target, including the defines and include directories of `settings`.
+std::vector<std::wstring> get_compile_args(
+    const Shader_Compiler_Settings& settings,
+    const Shader_Compile_Info& compile_info,
+    Shader_Target target);
+
 class Shader_Compiler
 {
 public:
@@ -79,8 +98,34 @@ public:
 
     Shader compile_from_memory(const Shader_Compiler_Settings& settings, const Shader_Compile_Info& compile_info);
 
+    // Compiles a single target into `shader`, only the DXIL target fills the reflection data.
+    // The reflection describes the SPIR-V as well, both targets are compiled from the same source.
+    // The files opened through `#include` are appended to `includes` if it is not null, even if compilation failed.
+    bool compile_target(
+        const Shader_Compiler_Settings& settings,
+        const Shader_Compile_Info& compile_info,
+        Shader_Target target,
+        Shader& shader,
+        std::vector<std::filesystem::path>* includes = nullptr);
+    // Returns the source with includes and defines resolved for the target, empty on failure.
+    std::string preprocess(
+        const Shader_Compiler_Settings& settings,
+        const Shader_Compile_Info& compile_info,
+        Shader_Target target,
+        std::vector<std::filesystem::path>* includes = nullptr);
+    // Major version in the upper, minor version in the lower 32 bits.
+    [[nodiscard]] uint64_t get_version() const;
+
+private:
+    Microsoft::WRL::ComPtr<IDxcResult> compile(
+        const Shader_Compile_Info& compile_info,
+        const std::vector<std::wstring>& arguments,
+        Shader_Target target,
+        std::vector<std::filesystem::path>* includes);
+
 private:
     Microsoft::WRL::ComPtr<IDxcCompiler3> m_compiler;
     Microsoft::WRL::ComPtr<IDxcUtils> m_utils;
+    Microsoft::WRL::ComPtr<IDxcContainerReflection> m_container_reflection;
 };
 }
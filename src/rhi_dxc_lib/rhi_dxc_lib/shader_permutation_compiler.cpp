@@ -0,0 +1,168 @@
+#include "rhi_dxc_lib/shader_permutation_compiler.hpp"
+
+#include <rhi/shader_archive.hpp>
+#include <rhi/common/hash.hpp>
+
+#include <unordered_map>
+
+namespace rhi::dxc
+{
+namespace
+{
+std::wstring widen_ascii(const std::string& string)
+{
+    return std::wstring(string.begin(), string.end());
+}
+}
+
+std::string get_shader_variant_name(
+    const Shader_Permutation_Info& permutation_info,
+    std::span<const uint32_t> value_indices)
+{
+    auto name = permutation_info.name;
+    for (auto i = 0ull; i < permutation_info.axes.size(); ++i)
+    {
+        const auto& axis = permutation_info.axes[i];
+        name += ":" + axis.name + "=" + axis.values[value_indices[i]];
+    }
+    return name;
+}
+
+Result compile_shader_permutations(
+    Shader_Compile_Service& compile_service,
+    std::span<const Shader_Permutation_Info> permutation_infos,
+    const std::filesystem::path& archive_path,
+    Shader_Permutation_Statistics* statistics)
+{
+    auto variant_count = 0ull;
+    for (const auto& permutation_info : permutation_infos)
+    {
+        auto permutation_variant_count = 1ull;
+        for (const auto& axis : permutation_info.axes)
+        {
+            if (axis.values.empty()) return Result::Error_Invalid_Parameters;
+            permutation_variant_count *= axis.values.size();
+        }
+        variant_count += permutation_variant_count;
+    }
+
+    // Jobs point into `variant_settings`, it must not reallocate once they were created.
+    std::vector<std::string> variant_names;
+    std::vector<Shader_Compiler_Settings> variant_settings;
+    std::vector<std::size_t> variant_permutations;
+    variant_names.reserve(variant_count);
+    variant_settings.reserve(variant_count);
+    variant_permutations.reserve(variant_count);
+    for (auto i = 0ull; i < permutation_infos.size(); ++i)
+    {
+        const auto& permutation_info = permutation_infos[i];
+        // Mixed radix counter over the axes, the first axis changes fastest.
+        std::vector<uint32_t> value_indices(permutation_info.axes.size(), 0);
+        bool done = false;
+        while (!done)
+        {
+            auto& settings = variant_settings.emplace_back(permutation_info.settings);
+            for (auto j = 0ull; j < permutation_info.axes.size(); ++j)
+            {
+                const auto& axis = permutation_info.axes[j];
+                settings.defines.push_back(widen_ascii(axis.name + "=" + axis.values[value_indices[j]]));
+            }
+            variant_names.push_back(get_shader_variant_name(permutation_info, value_indices));
+            variant_permutations.push_back(i);
+
+            done = true;
+            for (auto j = 0ull; j < value_indices.size(); ++j)
+            {
+                if (++value_indices[j] < permutation_info.axes[j].values.size())
+                {
+                    done = false;
+                    break;
+                }
+                value_indices[j] = 0;
+            }
+        }
+    }
+
+    std::vector<Shader_Compile_Job> variant_jobs;
+    variant_jobs.reserve(variant_count);
+    for (auto i = 0ull; i < variant_count; ++i)
+    {
+        variant_jobs.push_back({
+            .settings = &variant_settings[i],
+            .compile_info = permutation_infos[variant_permutations[i]].compile_info
+        });
+    }
+
+    // Defines that the source never reads leave the preprocessed source unchanged.
+    // Only variants of the same permutation are merged, others may differ in their compile info.
+    auto hashes = compile_service.hash_preprocessed(variant_jobs);
+    std::unordered_map<uint64_t, std::size_t> compiled_variants;
+    std::vector<Shader_Compile_Job> compile_jobs;
+    std::vector<std::size_t> variant_shaders(variant_count);
+    for (auto i = 0ull; i < variant_count; ++i)
+    {
+        // Variants that failed to preprocess are compiled on their own, so they report their errors.
+        if (hashes[i])
+        {
+            auto [it, inserted] = compiled_variants.try_emplace(
+                rhi::hash_value(uint64_t(variant_permutations[i]), *hashes[i]), compile_jobs.size());
+            variant_shaders[i] = it->second;
+            if (!inserted) continue;
+        }
+        else
+        {
+            variant_shaders[i] = compile_jobs.size();
+        }
+        compile_jobs.push_back(variant_jobs[i]);
+    }
+
+    auto shaders = compile_service.compile(compile_jobs);
+    auto failed_count = 0ull;
+    for (const auto& shader : shaders)
+    {
+        if (shader.dxil.empty() || shader.spirv.empty())
+        {
+            failed_count += 1;
+        }
+    }
+    if (statistics)
+    {
+        *statistics = {
+            .variant_count = variant_count,
+            .compiled_count = compile_jobs.size(),
+            .failed_count = failed_count
+        };
+    }
+    if (failed_count > 0)
+    {
+        return Result::Error_Invalid_Parameters;
+    }
+
+    std::vector<std::vector<uint8_t>> reflections;
+    reflections.reserve(shaders.size());
+    for (const auto& shader : shaders)
+    {
+        auto reflection = rhi::write_shader_reflection(shader.reflection.stage);
+        if (!reflection) return reflection.error();
+        reflections.push_back(std::move(*reflection));
+    }
+
+    // Merged variants pass the same bytecode and reflection, so the archive stores them once.
+    std::vector<rhi::Shader_Archive_Source> sources;
+    sources.reserve(variant_count);
+    for (auto i = 0ull; i < variant_count; ++i)
+    {
+        const auto& shader = shaders[variant_shaders[i]];
+        sources.push_back({
+            .name = variant_names[i],
+            .dxil = shader.dxil,
+            .spirv = shader.spirv,
+            .reflection = reflections[variant_shaders[i]],
+            .groups_x = shader.reflection.workgroups_x,
+            .groups_y = shader.reflection.workgroups_y,
+            .groups_z = shader.reflection.workgroups_z
+        });
+    }
+    return rhi::write_shader_archive(archive_path, sources);
+}
+}
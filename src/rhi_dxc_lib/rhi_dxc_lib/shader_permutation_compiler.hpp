@@ -0,0 +1,51 @@
+#pragma once
+
+#include "rhi_dxc_lib/shader_compile_service.hpp"
+
+#include <rhi/result.hpp>
+
+#include <filesystem>
+#include <span>
+#include <string>
+#include <vector>
+
+namespace rhi::dxc
+{
+// Every value is passed as `-D name=value`, names and values must be ASCII.
+struct Shader_Define_Axis
+{
+    std::string name;
+    std::vector<std::string> values;
+};
+
+struct Shader_Permutation_Info
+{
+    std::string name;
+    Shader_Compiler_Settings settings;
+    Shader_Compile_Info compile_info;
+    std::vector<Shader_Define_Axis> axes;
+};
+
+struct Shader_Permutation_Statistics
+{
+    uint64_t variant_count;
+    uint64_t compiled_count; // Variants left after merging the ones with identical preprocessed sources.
+    uint64_t failed_count;
+};
+
+// Archive entry name of a variant, the permutation name followed by `:name=value` for every axis in order.
+// `value_indices` holds one index into `values` per axis.
+[[nodiscard]] std::string get_shader_variant_name(
+    const Shader_Permutation_Info& permutation_info,
+    std::span<const uint32_t> value_indices);
+
+// Compiles every combination of the define axes of every permutation and writes them into one `Shader_Archive`.
+// Variants are preprocessed first, variants whose preprocessed sources match are compiled only once
+// and share their sections in the archive.
+// Returns `Error_Invalid_Parameters` without writing the archive if any variant failed to compile.
+Result compile_shader_permutations(
+    Shader_Compile_Service& compile_service,
+    std::span<const Shader_Permutation_Info> permutation_infos,
+    const std::filesystem::path& archive_path,
+    Shader_Permutation_Statistics* statistics = nullptr);
+}